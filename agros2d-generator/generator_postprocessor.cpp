@@ -527,8 +527,13 @@ void Agros2DGeneratorModule::createFilterExpression(ctemplate::TemplateDictionar
         expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
         expression->SetValue("PHYSICFIELDVARIABLECOMP_TYPE", Agros2DGenerator::physicFieldVariableCompStringEnum(physicFieldVariableComp).toStdString());
+        expression->SetValue("KERNEL", QString("kernel_%1_%2_%3_%4").
+                             arg(variable).
+                             arg(analysisTypeToStringKey(analysisType)).
+                             arg(coordinateTypeToStringKey(coordinateType)).
+                             arg(physicFieldVariableCompToStringKey(physicFieldVariableComp)).toStdString());
         ParserModuleInfo pmi(*m_module, analysisType, coordinateType, LinearityType_Linear);
-        expression->SetValue("EXPRESSION", m_parser->parseFilterExpression(pmi, expr).toStdString());
+        expression->SetValue("EXPRESSION", createKernelMaterials(expression, m_parser->parseFilterExpression(pmi, expr)).toStdString());
     }
 }
 
@@ -567,8 +572,93 @@ void Agros2DGeneratorModule::createIntegralExpression(ctemplate::TemplateDiction
         expression->SetValue("VARIABLE", variable.toStdString());
         expression->SetValue("ANALYSIS_TYPE", Agros2DGenerator::analysisTypeStringEnum(analysisType).toStdString());
         expression->SetValue("COORDINATE_TYPE", Agros2DGenerator::coordinateTypeStringEnum(coordinateType).toStdString());
-        expression->SetValue("EXPRESSION", m_parser->parsePostprocessorExpression(pmi, expr).toStdString());
+        expression->SetValue("KERNEL", QString("kernel_%1_%2_%3").
+                             arg(variable).
+                             arg(analysisTypeToStringKey(analysisType)).
+                             arg(coordinateTypeToStringKey(coordinateType)).toStdString());
+        QString kernelExpr = createKernelMaterials(expression, m_parser->parsePostprocessorExpression(pmi, expr));
+        expression->SetValue("EXPRESSION", kernelExpr.toStdString());
         expression->SetValue("POSITION", QString::number(pos).toStdString());
+
+        // quadrature order from expression (otherwise fixed order is used)
+        QString orderExpr = createOrderExpression(kernelExpr);
+        if (!orderExpr.isEmpty())
+        {
+            ctemplate::TemplateDictionary *order = expression->AddSectionDictionary("ORDER_SOURCE");
+            order->SetValue("ORDER_EXPRESSION", orderExpr.toStdString());
+        }
+    }
+}
+
+QString Agros2DGeneratorModule::createKernelMaterials(ctemplate::TemplateDictionary *expression, const QString &expr)
+{
+    // kernel reads only the material values used in expression,
+    // linear values are read once per element (loop over integration points without calls)
+    QString kernelExpr = expr;
+
+    foreach (XMLModule::quantity quantity, m_module->volume().quantity())
+    {
+        if (quantity.shortname().present())
+        {
+            QString id = QString::fromStdString(quantity.id());
+
+            QString number = QString("material_%1->number()").arg(id);
+            if (kernelExpr.contains(number))
+            {
+                kernelExpr.replace(number, QString("material_%1_number").arg(id));
+
+                ctemplate::TemplateDictionary *variable = expression->AddSectionDictionary("KERNEL_MATERIAL_NUMBER");
+                variable->SetValue("MATERIAL_VARIABLE", id.toStdString());
+            }
+
+            if (kernelExpr.contains(QString("material_%1->").arg(id)))
+            {
+                ctemplate::TemplateDictionary *variable = expression->AddSectionDictionary("KERNEL_MATERIAL");
+                variable->SetValue("MATERIAL_VARIABLE", id.toStdString());
+            }
+        }
     }
+
+    return kernelExpr;
+}
+
+QString Agros2DGeneratorModule::createOrderExpression(const QString &kernelExpr)
+{
+    // expression evaluated with Hermes::Ord (constant material values do not increase order,
+    // nonlinear materials have the order of their argument)
+    QString orderExpr = kernelExpr;
+
+    foreach (XMLModule::quantity quantity, m_module->volume().quantity())
+    {
+        if (quantity.shortname().present())
+        {
+            QString id = QString::fromStdString(quantity.id());
+
+            orderExpr.replace(QString("material_%1_number").arg(id), "1.0");
+            orderExpr.replace(QString("material_%1->numberFromTable(").arg(id), "orderFromTable(");
+        }
+    }
+
+    // only functions and operators with Hermes::Ord arithmetic
+    QStringList functions;
+    functions << "sqrt" << "pow" << "orderFromTable" << "frequency" << "size";
+
+    QRegExp rx("([A-Za-z_][A-Za-z0-9_]*)\\s*\\(");
+    int pos = 0;
+    while ((pos = rx.indexIn(orderExpr, pos)) != -1)
+    {
+        if (!functions.contains(rx.cap(1)))
+            return "";
+
+        pos += rx.matchedLength();
+    }
+
+    QString operators = orderExpr;
+    operators.remove("->");
+    if (operators.contains("?") || operators.contains("<") || operators.contains(">")
+            || operators.contains("(double)") || operators.contains("material_"))
+        return "";
+
+    return orderExpr;
 }
 
@@ -31,6 +31,7 @@
 #include "hermes2d/field.h"
 #include "hermes2d/problem.h"
 #include "hermes2d/solutionstore.h"
+#include "hermes2d/timeseries.h"
 #include "hermes2d/problem_config.h"
 #include "pythonlab/pythonengine_agros.h"
 
@@ -423,30 +424,33 @@ void ChartWidget::plotGeometry()
     {
         if (physicFieldVariable.id() != variable.id()) continue;
 
-        foreach (Point point, points)
-        {
-            LocalValue *localValue = fieldWidget->selectedField()->plugin()->localValue(fieldWidget->selectedField(),
-                                                                                        fieldWidget->selectedTimeStep(),
-                                                                                        fieldWidget->selectedAdaptivityStep(),
-                                                                                        fieldWidget->selectedAdaptivitySolutionType(),
-                                                                                        point);
-            QMap<QString, LocalPointValue> values = localValue->values();
+        // all points at once
+        LocalValueBatch *localValues = fieldWidget->selectedField()->plugin()->localValueBatch(fieldWidget->selectedField(),
+                                                                                              fieldWidget->selectedTimeStep(),
+                                                                                              fieldWidget->selectedAdaptivityStep(),
+                                                                                              fieldWidget->selectedAdaptivitySolutionType(),
+                                                                                              points.toVector());
+        LocalPointValues values = localValues->values().value(variable.id());
+        delete localValues;
+
+        if (values.scalar.isEmpty())
+            values.scalar = values.vectorX = values.vectorY = QVector<double>(points.count(), 0.0);
 
+        for (int i = 0; i < points.count(); i++)
+        {
             if (variable.isScalar())
             {
-                yval.append(values[variable.id()].scalar);
+                yval.append(values.scalar[i]);
             }
             else
             {
                 if (physicFieldVariableComp == PhysicFieldVariableComp_X)
-                    yval.append(values[variable.id()].vector.x);
+                    yval.append(values.vectorX[i]);
                 else if (physicFieldVariableComp == PhysicFieldVariableComp_Y)
-                    yval.append(values[variable.id()].vector.y);
+                    yval.append(values.vectorY[i]);
                 else
-                    yval.append(values[variable.id()].vector.magnitude());
+                    yval.append(sqrt(values.vectorX[i] * values.vectorX[i] + values.vectorY[i] * values.vectorY[i]));
             }
-
-            delete localValue;
         }
     }
 
@@ -476,9 +480,6 @@ void ChartWidget::plotTime()
     PhysicFieldVariableComp physicFieldVariableComp = (PhysicFieldVariableComp) cmbFieldVariableComp->itemData(cmbFieldVariableComp->currentIndex()).toInt();
     if (physicFieldVariableComp == PhysicFieldVariableComp_Undefined) return;
 
-    // time levels
-    QList<double> timeLevels = Agros2D::solutionStore()->timeLevels(fieldWidget->selectedField());
-
     // chart
     m_chart->chart()->xAxis->setLabel(tr("time (s)"));
     m_chart->chart()->yAxis->setLabel(QString("%1 (%2)").
@@ -491,40 +492,23 @@ void ChartWidget::plotTime()
 
     createChartLine();
 
-    foreach (Module::LocalVariable variable, fieldWidget->selectedField()->localPointVariables())
-    {
-        if (physicFieldVariable.id() != variable.id()) continue;
+    // time steps are walked once
+    TimeSeries timeSeries(fieldWidget->selectedField());
+    timeSeries.addPoint(Point(txtTimeX->value(), txtTimeY->value()));
+    timeSeries.extract();
 
-        for (int i = 0; i < timeLevels.count(); i++)
-        {
-            // change time level
-            xval.append(timeLevels.at(i));
-
-            Point point(txtTimeX->value(), txtTimeY->value());
-            int timeLevelIndex = Agros2D::solutionStore()->nthCalculatedTimeStep(fieldWidget->selectedField(), i);
-            LocalValue *localValue = fieldWidget->selectedField()->plugin()->localValue(fieldWidget->selectedField(),
-                                                                                        timeLevelIndex,
-                                                                                        Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeLevelIndex),
-                                                                                        SolutionMode_Normal,
-                                                                                        point);
-            QMap<QString, LocalPointValue> values = localValue->values();
-
-            if (variable.isScalar())
-                yval.append(values[variable.id()].scalar);
-            else
-            {
-                if (physicFieldVariableComp == PhysicFieldVariableComp_X)
-                    yval.append(values[variable.id()].vector.x);
-                else if (physicFieldVariableComp == PhysicFieldVariableComp_Y)
-                    yval.append(values[variable.id()].vector.y);
-                else
-                    yval.append(values[variable.id()].vector.magnitude());
-            }
-
-            delete localValue;
-        }
+    QString column = physicFieldVariable.shortname();
+    if (!physicFieldVariable.isScalar())
+    {
+        if (physicFieldVariableComp == PhysicFieldVariableComp_X)
+            column += Agros2D::problem()->config()->labelX().toLower();
+        else if (physicFieldVariableComp == PhysicFieldVariableComp_Y)
+            column += Agros2D::problem()->config()->labelY().toLower();
     }
 
+    xval = timeSeries.times();
+    yval = timeSeries.column(TimeSeries::pointColumnName(0, column));
+
     m_chart->chart()->graph(0)->setData(xval, yval);
 }
 
@@ -690,19 +674,20 @@ void ChartWidget::doExportData()
     else if (tbxAnalysisType->currentWidget() == widTime)
     {
         Point point(txtTimeX->value(), txtTimeY->value());
-        foreach (double timeLevel, Agros2D::solutionStore()->timeLevels(fieldWidget->selectedField()))
-        {
-            int timeStep = Agros2D::solutionStore()->timeLevelIndex(fieldWidget->selectedField(), timeLevel);
-            QMap<QString, double> data = getData(point,
-                                                 timeStep,
-                                                 Agros2D::solutionStore()->lastAdaptiveStep(fieldWidget->selectedField(), SolutionMode_Normal, timeStep),
-                                                 SolutionMode_Normal);
-            foreach (QString key, data.keys())
-            {
-                QList<double> *values = &table.operator [](key);
-                values->append(data.value(key));
-            }
-        }
+
+        TimeSeries timeSeries(fieldWidget->selectedField());
+        timeSeries.addPoint(point);
+        timeSeries.extract();
+
+        QVector<double> times = timeSeries.times();
+        table["t"] = times.toList();
+        table[Agros2D::problem()->config()->labelX()] = QVector<double>(times.size(), point.x).toList();
+        table[Agros2D::problem()->config()->labelY()] = QVector<double>(times.size(), point.y).toList();
+
+        QString prefix = TimeSeries::pointColumnName(0, "");
+        foreach (QString name, timeSeries.columnNames())
+            if (name.startsWith(prefix))
+                table[name.mid(prefix.length())] = timeSeries.column(name).toList();
     }
 
     if (table.values().size() > 0)
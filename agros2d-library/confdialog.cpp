@@ -67,9 +67,13 @@ void ConfigComputerDialog::load()
 
     // number of threads
     txtNumOfThreads->setValue(Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt());
+    txtNumOfConcurrentBlocks->setValue(Agros2D::configComputer()->value(Config::Config_NumberOfConcurrentBlocks).toInt());
+
+    // external solver
+    chkExternalSolverDaemon->setChecked(Agros2D::configComputer()->value(Config::Config_ExternalSolverDaemon).toBool());
 
     // cache size
-    txtCacheSize->setValue(Agros2D::configComputer()->value(Config::Config_CacheSize).toInt());
+    txtCacheSize->setValue(Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt());
 
     // std log
     chkLogStdOut->setChecked(Agros2D::configComputer()->value(Config::Config_LogStdOut).toBool());
@@ -107,9 +111,13 @@ void ConfigComputerDialog::save()
 
     // number of threads
     Agros2D::configComputer()->setValue(Config::Config_NumberOfThreads, txtNumOfThreads->value());
+    Agros2D::configComputer()->setValue(Config::Config_NumberOfConcurrentBlocks, txtNumOfConcurrentBlocks->value());
+
+    // external solver
+    Agros2D::configComputer()->setValue(Config::Config_ExternalSolverDaemon, chkExternalSolverDaemon->isChecked());
 
     // cache size
-    Agros2D::configComputer()->setValue(Config::Config_CacheSize, txtCacheSize->value());
+    Agros2D::configComputer()->setValue(Config::Config_CacheMemorySize, txtCacheSize->value());
 
     // std log
     Agros2D::configComputer()->setValue(Config::Config_LogStdOut, chkLogStdOut->isChecked());
@@ -268,18 +276,29 @@ QWidget *ConfigComputerDialog::createSolverWidget()
 {
     // general
     txtCacheSize = new QSpinBox(this);
-    txtCacheSize->setMinimum(2);
-    txtCacheSize->setMaximum(50);
+    txtCacheSize->setMinimum(32);
+    txtCacheSize->setMaximum(262144);
+    txtCacheSize->setSingleStep(128);
+    txtCacheSize->setSuffix(" MB");
 
     txtNumOfThreads = new QSpinBox(this);
     txtNumOfThreads->setMinimum(1);
     txtNumOfThreads->setMaximum(omp_get_max_threads());
 
+    txtNumOfConcurrentBlocks = new QSpinBox(this);
+    txtNumOfConcurrentBlocks->setMinimum(1);
+    txtNumOfConcurrentBlocks->setMaximum(omp_get_max_threads());
+
+    chkExternalSolverDaemon = new QCheckBox(tr("Keep external solver running between solves"));
+
     QGridLayout *layoutSolver = new QGridLayout();
     layoutSolver->addWidget(new QLabel(tr("Number of threads:")), 0, 0);
     layoutSolver->addWidget(txtNumOfThreads, 0, 1);
-    layoutSolver->addWidget(new QLabel(tr("Number of cache slots:")), 1, 0);
-    layoutSolver->addWidget(txtCacheSize, 1, 1);
+    layoutSolver->addWidget(new QLabel(tr("Concurrently solved blocks:")), 1, 0);
+    layoutSolver->addWidget(txtNumOfConcurrentBlocks, 1, 1);
+    layoutSolver->addWidget(new QLabel(tr("Solution cache size:")), 2, 0);
+    layoutSolver->addWidget(txtCacheSize, 2, 1);
+    layoutSolver->addWidget(chkExternalSolverDaemon, 3, 0, 1, 2);
 
     QGroupBox *grpSolver = new QGroupBox(tr("Solver"));
     grpSolver->setLayout(layoutSolver);
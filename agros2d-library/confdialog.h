@@ -66,6 +66,10 @@ private:
 
     // threads
     QSpinBox *txtNumOfThreads;
+    QSpinBox *txtNumOfConcurrentBlocks;
+
+    // external solver
+    QCheckBox *chkExternalSolverDaemon;
 
     // grid
     QCheckBox *chkShowGrid;
@@ -168,18 +168,24 @@ QSharedPointer<ProblemSolver<double> > Block::prepareSolver()
 {
     QSharedPointer<ProblemSolver<double> > solver = QSharedPointer<ProblemSolver<double> >(new ProblemSolver<double>());
 
+    if (!solveInitVariables())
+        return QSharedPointer<ProblemSolver<double> >();
+
+    solver.data()->init(this);
+
+    return solver;
+}
+
+bool Block::solveInitVariables()
+{
     foreach (Field* field, m_fields)
     {
         // evaluate all values
         if (!field->solveInitVariables())
-        {
-            return QSharedPointer<ProblemSolver<double> >();
-        }
+            return false;
     }
 
-    solver.data()->init(this);
-
-    return solver;
+    return true;
 }
 
 bool Block::isTransient() const
@@ -201,7 +207,7 @@ double Block::timeSkip() const
         if (field->fieldInfo()->analysisType() == AnalysisType_Transient)
             continue;
 
-        double sActual = field->fieldInfo()->value(FieldInfo::TransientTimeSkip).toDouble();
+        double sActual = field->fieldInfo()->snapshot().toDouble(FieldInfo::TransientTimeSkip);
         if ((skip == 0.) || (sActual < skip))
             skip = sActual;
     }
@@ -223,12 +229,12 @@ AdaptivityType Block::adaptivityType() const
 
 int Block::adaptivitySteps() const
 {
-    int as = m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivitySteps).toInt();
+    int as = m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivitySteps);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert(field->fieldInfo()->value(FieldInfo::AdaptivitySteps).toInt() == as);
+        assert(field->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivitySteps) == as);
     }
 
     return as;
@@ -236,12 +242,12 @@ int Block::adaptivitySteps() const
 
 int Block::adaptivityBackSteps() const
 {
-    int abs = m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivityTransientBackSteps).toInt();
+    int abs = m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityTransientBackSteps);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert(field->fieldInfo()->value(FieldInfo::AdaptivityTransientBackSteps).toInt() == abs);
+        assert(field->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityTransientBackSteps) == abs);
     }
 
     return abs;
@@ -249,12 +255,12 @@ int Block::adaptivityBackSteps() const
 
 int Block::adaptivityRedoneEach() const
 {
-    int re = m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivityTransientRedoneEach).toInt();
+    int re = m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityTransientRedoneEach);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert(field->fieldInfo()->value(FieldInfo::AdaptivityTransientRedoneEach).toInt() == re);
+        assert(field->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityTransientRedoneEach) == re);
     }
 
     return re;
@@ -267,8 +273,8 @@ double Block::adaptivityTolerance() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::AdaptivityTolerance).toDouble() < tolerance)
-            tolerance = fieldInfo->value(FieldInfo::AdaptivityTolerance).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::AdaptivityTolerance) < tolerance)
+            tolerance = fieldInfo->snapshot().toDouble(FieldInfo::AdaptivityTolerance);
     }
 
     return tolerance;
@@ -276,12 +282,12 @@ double Block::adaptivityTolerance() const
 
 AdaptivityStoppingCriterionType Block::adaptivityStoppingCriterionType() const
 {
-    AdaptivityStoppingCriterionType sc = (AdaptivityStoppingCriterionType) m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivityStoppingCriterion).toInt();
+    AdaptivityStoppingCriterionType sc = (AdaptivityStoppingCriterionType) m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityStoppingCriterion);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert((AdaptivityStoppingCriterionType) field->fieldInfo()->value(FieldInfo::AdaptivityStoppingCriterion).toInt() == sc);
+        assert((AdaptivityStoppingCriterionType) field->fieldInfo()->snapshot().toInt(FieldInfo::AdaptivityStoppingCriterion) == sc);
     }
 
     return sc;
@@ -294,8 +300,8 @@ double Block::adaptivityThreshold() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::AdaptivityThreshold).toDouble() < threshold)
-            threshold = fieldInfo->value(FieldInfo::AdaptivityThreshold).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::AdaptivityThreshold) < threshold)
+            threshold = fieldInfo->snapshot().toDouble(FieldInfo::AdaptivityThreshold);
     }
 
     return threshold;
@@ -303,12 +309,12 @@ double Block::adaptivityThreshold() const
 
 bool Block::adaptivityUseAniso() const
 {
-    bool useAniso = m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivityUseAniso).toBool();
+    bool useAniso = m_fields.at(0)->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityUseAniso);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert(field->fieldInfo()->value(FieldInfo::AdaptivityUseAniso).toBool() == useAniso);
+        assert(field->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityUseAniso) == useAniso);
     }
 
     return useAniso;
@@ -316,17 +322,30 @@ bool Block::adaptivityUseAniso() const
 
 bool Block::adaptivityFinerReference() const
 {
-    bool finerReference = m_fields.at(0)->fieldInfo()->value(FieldInfo::AdaptivityFinerReference).toBool();
+    bool finerReference = m_fields.at(0)->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityFinerReference);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert(field->fieldInfo()->value(FieldInfo::AdaptivityFinerReference).toBool() == finerReference);
+        assert(field->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityFinerReference) == finerReference);
     }
 
     return finerReference;
 }
 
+bool Block::adaptivityWarmStart() const
+{
+    bool warmStart = m_fields.at(0)->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityWarmStart);
+
+    foreach (Field *field, m_fields)
+    {
+        // todo: ensure in GUI
+        assert(field->fieldInfo()->snapshot().toBool(FieldInfo::AdaptivityWarmStart) == warmStart);
+    }
+
+    return warmStart;
+}
+
 int Block::numSolutions() const
 {
     int num = 0;
@@ -399,8 +418,8 @@ double Block::nonlinearResidualNorm() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NonlinearResidualNorm).toDouble() < tolerance)
-            tolerance = fieldInfo->value(FieldInfo::NonlinearResidualNorm).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::NonlinearResidualNorm) < tolerance)
+            tolerance = fieldInfo->snapshot().toDouble(FieldInfo::NonlinearResidualNorm);
     }
 
     // if we do not want to use this stopping criterion, the value is 0.
@@ -418,8 +437,8 @@ double Block::nonlinearRelativeChangeOfSolutions() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NonlinearRelativeChangeOfSolutions).toDouble() < tolerance)
-            tolerance = fieldInfo->value(FieldInfo::NonlinearRelativeChangeOfSolutions).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::NonlinearRelativeChangeOfSolutions) < tolerance)
+            tolerance = fieldInfo->snapshot().toDouble(FieldInfo::NonlinearRelativeChangeOfSolutions);
     }
 
     // if we do not want to use this stopping criterion, the value is 0.
@@ -436,7 +455,7 @@ DampingType Block::nonlinearDampingType() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        DampingType dt = (DampingType)fieldInfo->value(FieldInfo::NonlinearDampingType).toInt();
+        DampingType dt = (DampingType)fieldInfo->snapshot().toInt(FieldInfo::NonlinearDampingType);
         assert(dt != DampingType_Undefined);
         if(blockDt != DampingType_Undefined)
             assert (blockDt == dt);
@@ -453,8 +472,8 @@ double Block::nonlinearDampingCoeff() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NonlinearDampingCoeff).toDouble() < coeff)
-            coeff = fieldInfo->value(FieldInfo::NonlinearDampingCoeff).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::NonlinearDampingCoeff) < coeff)
+            coeff = fieldInfo->snapshot().toDouble(FieldInfo::NonlinearDampingCoeff);
     }
 
     return coeff;
@@ -465,7 +484,7 @@ bool Block::newtonReuseJacobian() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (!fieldInfo->value(FieldInfo::NewtonReuseJacobian).toBool())
+        if (!fieldInfo->snapshot().toBool(FieldInfo::NewtonReuseJacobian))
             return false;
     }
 
@@ -479,8 +498,8 @@ int Block::nonlinearStepsToIncreaseDampingFactor() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NonlinearStepsToIncreaseDampingFactor).toInt() > number)
-            number = fieldInfo->value(FieldInfo::NonlinearStepsToIncreaseDampingFactor).toInt();
+        if (fieldInfo->snapshot().toInt(FieldInfo::NonlinearStepsToIncreaseDampingFactor) > number)
+            number = fieldInfo->snapshot().toInt(FieldInfo::NonlinearStepsToIncreaseDampingFactor);
     }
 
     return number;
@@ -493,8 +512,8 @@ double Block::newtonSufficientImprovementFactorForJacobianReuse() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NewtonJacobianReuseRatio).toDouble() < number)
-            number = fieldInfo->value(FieldInfo::NewtonJacobianReuseRatio).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::NewtonJacobianReuseRatio) < number)
+            number = fieldInfo->snapshot().toDouble(FieldInfo::NewtonJacobianReuseRatio);
     }
 
     return number;
@@ -507,8 +526,8 @@ double Block::nonlinearDampingFactorDecreaseRatio() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NonlinearDampingFactorDecreaseRatio).toDouble() < number)
-            number = fieldInfo->value(FieldInfo::NonlinearDampingFactorDecreaseRatio).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::NonlinearDampingFactorDecreaseRatio) < number)
+            number = fieldInfo->snapshot().toDouble(FieldInfo::NonlinearDampingFactorDecreaseRatio);
     }
 
     return number;
@@ -516,13 +535,13 @@ double Block::nonlinearDampingFactorDecreaseRatio() const
 
 int Block::newtonMaxStepsWithReusedJacobian() const
 {
-    int number = 10;
+    int number = 100;
 
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::NewtonMaxStepsReuseJacobian).toInt() < number)
-            number = fieldInfo->value(FieldInfo::NewtonMaxStepsReuseJacobian).toInt();
+        if (fieldInfo->snapshot().toInt(FieldInfo::NewtonMaxStepsReuseJacobian) < number)
+            number = fieldInfo->snapshot().toInt(FieldInfo::NewtonMaxStepsReuseJacobian);
     }
 
     return number;
@@ -533,7 +552,7 @@ bool Block::picardAndersonAcceleration() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (!fieldInfo->value(FieldInfo::PicardAndersonAcceleration).toBool())
+        if (!fieldInfo->snapshot().toBool(FieldInfo::PicardAndersonAcceleration))
             return false;
     }
 
@@ -548,8 +567,8 @@ double Block::picardAndersonBeta() const
     {
         FieldInfo* fieldInfo = field->fieldInfo();
         // TODO: check ">"
-        if (fieldInfo->value(FieldInfo::PicardAndersonBeta).toDouble() > number)
-            number = fieldInfo->value(FieldInfo::PicardAndersonBeta).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::PicardAndersonBeta) > number)
+            number = fieldInfo->snapshot().toDouble(FieldInfo::PicardAndersonBeta);
     }
 
     return number;
@@ -562,8 +581,8 @@ int Block::picardAndersonNumberOfLastVectors() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::PicardAndersonNumberOfLastVectors).toInt() > number)
-            number = fieldInfo->value(FieldInfo::PicardAndersonNumberOfLastVectors).toInt();
+        if (fieldInfo->snapshot().toInt(FieldInfo::PicardAndersonNumberOfLastVectors) > number)
+            number = fieldInfo->snapshot().toInt(FieldInfo::PicardAndersonNumberOfLastVectors);
     }
 
     return number;
@@ -572,12 +591,12 @@ int Block::picardAndersonNumberOfLastVectors() const
 IterSolverType Block::iterLinearSolverType() const
 {
     Hermes::Solvers::IterSolverType method
-            = (Hermes::Solvers::IterSolverType) m_fields.at(0)->fieldInfo()->value(FieldInfo::LinearSolverIterMethod).toInt();
+            = (Hermes::Solvers::IterSolverType) m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::LinearSolverIterMethod);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert((Hermes::Solvers::IterSolverType) field->fieldInfo()->value(FieldInfo::LinearSolverIterMethod).toInt() == method );
+        assert((Hermes::Solvers::IterSolverType) field->fieldInfo()->snapshot().toInt(FieldInfo::LinearSolverIterMethod) == method );
     }
 
     return method ;
@@ -586,12 +605,12 @@ IterSolverType Block::iterLinearSolverType() const
 Hermes::Solvers::PreconditionerType Block::iterPreconditionerType() const
 {
     Hermes::Solvers::PreconditionerType type
-            = (Hermes::Solvers::PreconditionerType) m_fields.at(0)->fieldInfo()->value(FieldInfo::LinearSolverIterPreconditioner).toInt();
+            = (Hermes::Solvers::PreconditionerType) m_fields.at(0)->fieldInfo()->snapshot().toInt(FieldInfo::LinearSolverIterPreconditioner);
 
     foreach (Field *field, m_fields)
     {
         // todo: ensure in GUI
-        assert((Hermes::Solvers::PreconditionerType) field->fieldInfo()->value(FieldInfo::LinearSolverIterPreconditioner).toInt() == type );
+        assert((Hermes::Solvers::PreconditionerType) field->fieldInfo()->snapshot().toInt(FieldInfo::LinearSolverIterPreconditioner) == type );
     }
 
     return type ;
@@ -604,8 +623,8 @@ double Block::iterLinearSolverToleranceAbsolute() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::LinearSolverIterToleranceAbsolute).toDouble() < coeff)
-            coeff = fieldInfo->value(FieldInfo::LinearSolverIterToleranceAbsolute).toDouble();
+        if (fieldInfo->snapshot().toDouble(FieldInfo::LinearSolverIterToleranceAbsolute) < coeff)
+            coeff = fieldInfo->snapshot().toDouble(FieldInfo::LinearSolverIterToleranceAbsolute);
     }
 
     return coeff;
@@ -618,13 +637,27 @@ int Block::iterLinearSolverIters() const
     foreach (Field* field, m_fields)
     {
         FieldInfo* fieldInfo = field->fieldInfo();
-        if (fieldInfo->value(FieldInfo::LinearSolverIterIters).toInt() > iters)
-            iters = fieldInfo->value(FieldInfo::LinearSolverIterIters).toInt();
+        if (fieldInfo->snapshot().toInt(FieldInfo::LinearSolverIterIters) > iters)
+            iters = fieldInfo->snapshot().toInt(FieldInfo::LinearSolverIterIters);
     }
 
     return iters;
 }
 
+MatrixReuseType Block::matrixReuseType() const
+{
+    MatrixReuseType type = MatrixReuseType_Factorization;
+
+    foreach (Field* field, m_fields)
+    {
+        FieldInfo* fieldInfo = field->fieldInfo();
+        if ((MatrixReuseType) fieldInfo->snapshot().toInt(FieldInfo::LinearSolverReuse) < type)
+            type = (MatrixReuseType) fieldInfo->snapshot().toInt(FieldInfo::LinearSolverReuse);
+    }
+
+    return type;
+}
+
 bool Block::contains(const FieldInfo *fieldInfo) const
 {
     foreach(Field* field, m_fields)
@@ -47,6 +47,8 @@ public:
     ~Block();
 
     QSharedPointer<ProblemSolver<double> > prepareSolver();
+    // evaluate values of all fields
+    bool solveInitVariables();
     void createBoundaryConditions();
 
     inline WeakFormAgros<double> *weakForm() { return m_wf;}
@@ -73,6 +75,8 @@ public:
     double adaptivityThreshold() const;
     bool adaptivityUseAniso() const;
     bool adaptivityFinerReference() const;
+    // previous reference solution as the initial guess of the next reference solve
+    bool adaptivityWarmStart() const;
 
     // minimal nonlinear tolerance of individual fields
     double nonlinearResidualNorm() const;
@@ -116,6 +120,9 @@ public:
     double iterLinearSolverToleranceAbsolute() const;
     int iterLinearSolverIters() const;
 
+    // the most restrictive reuse of matrix structure and factorization over all fields
+    MatrixReuseType matrixReuseType() const;
+
     bool contains(const FieldInfo *fieldInfo) const;
     Field* field(const FieldInfo* fieldInfo) const;
 
@@ -50,7 +50,7 @@ bool Field::solveInitVariables()
 int FieldInfo::numberIdNext = 0;
 
 FieldInfo::FieldInfo(QString fieldId)
-    : m_plugin(NULL), m_numberOfSolutions(0), m_hermesMarkerToAgrosLabelConversion(nullptr), m_labelAreas(nullptr)
+    : m_plugin(NULL), m_numberOfSolutions(0), m_hermesMarkerToAgrosLabelConversion(nullptr), m_hermesMarkerToAgrosLabelConversionSize(0), m_labelAreas(nullptr)
 {    
     assert(!fieldId.isEmpty());
     m_fieldId = fieldId;
@@ -93,6 +93,7 @@ void FieldInfo::deleteValuePointerTable()
         delete[] m_hermesMarkerToAgrosLabelConversion;
 
     m_hermesMarkerToAgrosLabelConversion = nullptr;
+    m_hermesMarkerToAgrosLabelConversionSize = 0;
 
     if(m_labelAreas)
         delete[] m_labelAreas;
@@ -110,6 +111,7 @@ void FieldInfo::createValuePointerTable()
 
     int num = Agros2D::scene()->labels->count();
     m_hermesMarkerToAgrosLabelConversion = new int[num+1];
+    m_hermesMarkerToAgrosLabelConversionSize = num+1;
     m_labelAreas = new double[num+1];
 
     for(int i = 0; i < num+1; i++)
@@ -183,10 +185,47 @@ double FieldInfo::labelArea(int agrosLabel) const
     return m_labelAreas[agrosLabel];
 }
 
+SceneMaterial *FieldInfo::elementMaterial(int hermesMarker) const
+{
+    if ((hermesMarker < 0) || (hermesMarker >= m_hermesMarkerToAgrosLabelConversionSize))
+        return NULL;
+
+    int labelIndex = m_hermesMarkerToAgrosLabelConversion[hermesMarker];
+    if (labelIndex == LABEL_OUTSIDE_FIELD)
+        return NULL;
+
+    return Agros2D::scene()->labels->at(labelIndex)->marker(this);
+}
+
+QVector<SceneMaterial *> FieldInfo::materialTable() const
+{
+    QVector<SceneMaterial *> table(m_hermesMarkerToAgrosLabelConversionSize, NULL);
+
+    for (int marker = 0; marker < m_hermesMarkerToAgrosLabelConversionSize; marker++)
+        if (m_hermesMarkerToAgrosLabelConversion[marker] != LABEL_OUTSIDE_FIELD)
+            table[marker] = Agros2D::scene()->labels->at(m_hermesMarkerToAgrosLabelConversion[marker])->marker(this);
+
+    return table;
+}
+
+QVector<const Value *> FieldInfo::materialValueTable(const QString &id, const QVector<SceneMaterial *> &materials) const
+{
+    QVector<const Value *> table(materials.size(), NULL);
+
+    for (int marker = 0; marker < materials.size(); marker++)
+        if (materials[marker] && !materials[marker]->isNone())
+            table[marker] = materials[marker]->valueNakedPtr(id);
+
+    return table;
+}
+
 void FieldInfo::setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh)
 {
     clearInitialMesh();
     m_initialMesh = mesh;
+
+    // marker conversion for post-processing (solution could be read from file without solving)
+    createValuePointerTable();
 }
 
 void FieldInfo::setAnalysisType(AnalysisType at)
@@ -294,6 +333,7 @@ void FieldInfo::clear()
     setDefaultValues();
 
     m_setting = m_settingDefault;
+    updateSnapshot();
 
     m_edgesRefinement.clear();
     m_labelsRefinement.clear();
@@ -887,6 +927,8 @@ void FieldInfo::load(XMLProblem::field_config *configxsd)
                 qDebug() << "Key not found" << QString::fromStdString(configxsd->field_item().at(i).field_key()) << QString::fromStdString(configxsd->field_item().at(i).field_value());
         }
     }
+
+    updateSnapshot();
 }
 
 void FieldInfo::save(XMLProblem::field_config *configxsd)
@@ -927,6 +969,7 @@ void FieldInfo::setStringKeys()
     m_settingKey[AdaptivityErrorCalculator] = "AdaptivityErrorCalculator";
     m_settingKey[AdaptivityUseAniso] = "AdaptivityUseAniso";
     m_settingKey[AdaptivityFinerReference] = "AdaptivityFinerReference";
+    m_settingKey[AdaptivityWarmStart] = "AdaptivityWarmStart";
     m_settingKey[AdaptivityOrderIncrease] = "AdaptivityOrderIncrease";
     m_settingKey[AdaptivitySpaceRefinement] = "AdaptivitySpaceRefinement";
     m_settingKey[TransientTimeSkip] = "TransientTimeSkip";
@@ -935,6 +978,7 @@ void FieldInfo::setStringKeys()
     m_settingKey[LinearSolverIterPreconditioner] = "LinearSolverIterPreconditioner";
     m_settingKey[LinearSolverIterToleranceAbsolute] = "LinearSolverIterToleranceAbsolute";
     m_settingKey[LinearSolverIterIters] = "LinearSolverIterIters";
+    m_settingKey[LinearSolverReuse] = "LinearSolverReuse";
     m_settingKey[TimeUnit] = "TimeUnit";
 
 }
@@ -966,6 +1010,7 @@ void FieldInfo::setDefaultValues()
     m_settingDefault[AdaptivityErrorCalculator] = "h1";
     m_settingDefault[AdaptivityUseAniso] = true;
     m_settingDefault[AdaptivityFinerReference] = false;
+    m_settingDefault[AdaptivityWarmStart] = false;
     m_settingDefault[AdaptivityOrderIncrease] = 1;
     m_settingDefault[AdaptivitySpaceRefinement] = true;
     m_settingDefault[TransientTimeSkip] = 0.0;
@@ -974,5 +1019,9 @@ void FieldInfo::setDefaultValues()
     m_settingDefault[LinearSolverIterPreconditioner] = Hermes::Solvers::ILU;
     m_settingDefault[LinearSolverIterToleranceAbsolute] = 1e-16;
     m_settingDefault[LinearSolverIterIters] = 1000;
+    // note: factorization is reused while the matrix inputs are unchanged (time dependent values are checked),
+    // transient problems previously reused it whenever the BDF coefficients were unchanged,
+    // "disabled" assembles and factorizes the matrix in every step
+    m_settingDefault[LinearSolverReuse] = MatrixReuseType_Factorization;
     m_settingDefault[TimeUnit] = "s";
 }
@@ -21,6 +21,7 @@
 #define FIELD_H
 
 #include "util.h"
+#include "util/setting_snapshot.h"
 #include "value.h"
 #include "sceneedge.h"
 #include "scenelabel.h"
@@ -40,6 +41,7 @@ class CouplingInfo;
 class LocalForceValue;
 class PluginInterface;
 class Value;
+class SceneMaterial;
 
 const int LABEL_OUTSIDE_FIELD = -10000;
 
@@ -59,7 +61,7 @@ public:
     inline int numberId() const { return m_numberId; }
 
     inline Hermes::Hermes2D::MeshSharedPtr initialMesh() const { return m_initialMesh; }
-    inline void clearInitialMesh() { m_initialMesh = Hermes::Hermes2D::MeshSharedPtr();}
+    inline void clearInitialMesh() { m_initialMesh = Hermes::Hermes2D::MeshSharedPtr(); }
     void setInitialMesh(Hermes::Hermes2D::MeshSharedPtr mesh);
 
     enum Type
@@ -88,6 +90,7 @@ public:
         AdaptivityErrorCalculator,
         AdaptivityUseAniso,
         AdaptivityFinerReference,
+        AdaptivityWarmStart,
         AdaptivityOrderIncrease,
         AdaptivitySpaceRefinement,
         TransientTimeSkip,
@@ -96,6 +99,7 @@ public:
         LinearSolverIterPreconditioner,
         LinearSolverIterToleranceAbsolute,
         LinearSolverIterIters,
+        LinearSolverReuse,
         TimeUnit
     };
 
@@ -143,15 +147,19 @@ public:
     inline QStringList stringKeys() { return m_settingKey.values(); }
 
     inline QVariant value(Type type) const { return m_setting[type]; }
-    inline void setValue(Type type, int value, bool emitChanged = true) {  m_setting[type] = value; if (emitChanged) emit changed(); }
-    inline void setValue(Type type, double value, bool emitChanged = true) {  m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
-    inline void setValue(Type type, bool value, bool emitChanged = true) {  m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, int value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, double value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, bool value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
     inline void setValue(Type type, const std::string &value, bool emitChanged = true) { setValue(type, QString::fromStdString(value), emitChanged); }
-    inline void setValue(Type type, const QString &value, bool emitChanged = true) { m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
-    inline void setValue(Type type, const QStringList &value, bool emitChanged = true) { m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, const QString &value, bool emitChanged = true) { m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, const QStringList &value, bool emitChanged = true) { m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
 
     inline QVariant defaultValue(Type type) {  return m_settingDefault[type]; }
 
+    // typed settings for loops (solver, post-processing)
+    inline const SettingSnapshot<Type> &snapshot() const { return m_snapshot; }
+    inline bool isSnapshotValid() const { return m_snapshot.isEqual(m_setting); }
+
     // refine mesh
     void refineMesh(Hermes::Hermes2D::MeshSharedPtr mesh);
 
@@ -237,6 +245,12 @@ public:
     QList<QWeakPointer<Value> > valuePointerTable(QString id) const;
     int hermesMarkerToAgrosLabel(int hermesMarker) const;
     double labelArea(int agrosLabel) const;
+
+    // post-processing, material of hermes element marker (through the marker conversion table)
+    SceneMaterial *elementMaterial(int hermesMarker) const;
+    // dense tables indexed by hermes element marker
+    QVector<SceneMaterial *> materialTable() const;
+    QVector<const Value *> materialValueTable(const QString &id, const QVector<SceneMaterial *> &materials) const;
     inline double frequency() const { return m_frequency; }
 
 
@@ -279,13 +293,16 @@ private:
     QMap<Type, QVariant> m_setting;
     QMap<Type, QVariant> m_settingDefault;
     QMap<Type, QString> m_settingKey;
+    SettingSnapshot<Type> m_snapshot;
 
     void setDefaultValues();
     void setStringKeys();
+    inline void updateSnapshot() { m_snapshot = SettingSnapshot<Type>(m_settingDefault, m_setting); }
 
     // for speed optimisations
     QMap<QString, QList<QWeakPointer<Value> > > m_valuePointersTable;
     int* m_hermesMarkerToAgrosLabelConversion;
+    int m_hermesMarkerToAgrosLabelConversionSize;
     double* m_labelAreas;
     double m_frequency;
 
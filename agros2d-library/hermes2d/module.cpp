@@ -608,6 +608,9 @@ Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > WeakFormAgros<S
             solutionID.solutionMode = SolutionMode_Normal;
         assert(Agros2D::solutionStore()->contains(solutionID));
 
+        // keep previous time levels in the cache during the time step
+        Agros2D::solutionStore()->pinSolution(m_block, solutionID);
+
         for (int comp = 0; comp < solutionID.group->numberOfSolutions(); comp++)
             result.push_back(Agros2D::solutionStore()->multiArray(solutionID).solutions().at(comp));
     }
@@ -636,6 +639,9 @@ void WeakFormAgros<Scalar>::updateExtField()
     for(int i = 0; i < MAX_FIELDS; i++)
         m_positionInfos[i] = PositionInfo();
 
+    // previous time levels of the last time step are no longer needed
+    Agros2D::solutionStore()->unpinSolutions(m_block);
+
     // register two types of external functions. Quantities and special functions of all fields go to externalUSlns
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > externalUSlns;
     Hermes::vector<Hermes::Hermes2D::UExtFunctionSharedPtr<Scalar> > fieldUExt;
@@ -1186,6 +1192,27 @@ Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> Module::readMeshFromFileBSON(con
     return meshes;
 }
 
+Hermes::Hermes2D::MeshSharedPtr Module::readSingleMeshFromFileBSON(const QString &fileName)
+{
+    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr > meshes;
+    meshes.push_back(Hermes::Hermes2D::MeshSharedPtr(new Hermes::Hermes2D::Mesh()));
+
+    Hermes::Hermes2D::MeshReaderH2DBSON meshloader;
+    try
+    {
+        Hermes::HermesCommonApi.set_integral_param_value(Hermes::checkMeshesOnLoad, false);
+
+        meshloader.load(compatibleFilename(QFileInfo(fileName).absoluteFilePath()).toStdString().c_str(), meshes);
+    }
+    catch (Hermes::Exceptions::MeshLoadFailureException& e)
+    {
+        qDebug() << e.info().c_str();
+        throw;
+    }
+
+    return meshes.at(0);
+}
+
 void Module::writeMeshToFileXML(const QString &fileName, Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes)
 {
     // save locale
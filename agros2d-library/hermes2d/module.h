@@ -487,6 +487,7 @@ AGROS_LIBRARY_API QMap<QString, QString> availableModules();
 // index of quantity in the list of quantities at the begining of the volume section of the XML (NOT the reduced list in individual analysis)
 void AGROS_LIBRARY_API volumeQuantityProperties(XMLModule::field *module, QMap<QString, int> &quantityOrder, QMap<QString, bool> &quantityIsNonlin, QMap<QString, int> &functionOrder);
 Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> readMeshFromFileBSON(const QString &fileName);
+Hermes::Hermes2D::MeshSharedPtr readSingleMeshFromFileBSON(const QString &fileName);
 Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> readMeshFromFileXML(const QString &fileName);
 void writeMeshToFileXML(const QString &fileName, Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes);
 void writeMeshToFileBSON(const QString &fileName, Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes);
@@ -176,6 +176,77 @@ protected:
     QMap<QString, LocalPointValue> m_values;
 };
 
+// values of one variable in all points of the batch (contiguous arrays in order of the points)
+struct LocalPointValues
+{
+    QVector<double> scalar;
+    QVector<double> vectorX;
+    QVector<double> vectorY;
+};
+
+class LocalValueBatch
+{
+public:
+    LocalValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const QVector<Point> &points)
+        : m_fieldInfo(fieldInfo), m_timeStep(timeStep), m_adaptivityStep(adaptivityStep), m_solutionType(solutionType), m_points(points) {}
+    virtual ~LocalValueBatch()
+    {
+        m_values.clear();
+    }
+
+    // points
+    inline QVector<Point> points() const { return m_points; }
+    // point lies in the domain (values of points outside are zero)
+    inline QVector<bool> isFound() const { return m_found; }
+
+    // variables
+    QMap<QString, LocalPointValues> values() const { return m_values; }
+
+    virtual void calculate() = 0;
+
+protected:
+    // points
+    QVector<Point> m_points;
+    QVector<bool> m_found;
+    // field info
+    const FieldInfo *m_fieldInfo;
+    int m_timeStep;
+    int m_adaptivityStep;
+    SolutionMode m_solutionType;
+
+    // variables
+    QMap<QString, LocalPointValues> m_values;
+};
+
+// quadrature order of integrals (fixed mode and upper limit of automatic mode)
+const int INTEGRAL_ORDER_FIXED = 20;
+// relative difference of adaptive check (order and order + 2)
+const double INTEGRAL_ORDER_TOLERANCE = 1e-6;
+
+// geometry of expression order (straight element, curvature is added by calculator)
+struct IntegralOrderGeometry
+{
+    IntegralOrderGeometry()
+    {
+        x[0] = Hermes::Ord(1);
+        y[0] = Hermes::Ord(1);
+        tx[0] = Hermes::Ord(0);
+        ty[0] = Hermes::Ord(0);
+    }
+
+    Hermes::Ord x[1];
+    Hermes::Ord y[1];
+    Hermes::Ord tx[1];
+    Hermes::Ord ty[1];
+};
+
+// order of nonlinear material (see Value::numberFromTable)
+// table is interpolated between its points (linear in the key), material has the order of its argument
+inline Hermes::Ord orderFromTable(Hermes::Ord key)
+{
+    return key;
+}
+
 class IntegralValue
 {
 public:
@@ -194,6 +265,41 @@ protected:
 
     // variables
     QMap<QString, double> m_values;
+
+    // integrals with given quadrature order type (result is allocated by malloc)
+    template <typename Calculator>
+    double *calculateIntegrals(IntegralOrderType orderType,
+                               Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutions,
+                               Hermes::vector<std::string> markers, int count) const
+    {
+        Calculator calc(m_fieldInfo, solutions, count);
+        calc.setOrder(orderType != IntegralOrder_Fixed, 0);
+        double *values = calc.calculate(markers);
+
+        if (orderType != IntegralOrder_Adaptive)
+            return values;
+
+        // check against order + 2
+        Calculator calcCheck(m_fieldInfo, solutions, count);
+        calcCheck.setOrder(true, 2);
+        double *valuesCheck = calcCheck.calculate(markers);
+
+        bool accurate = true;
+        for (int i = 0; i < count; i++)
+            if (fabs(values[i] - valuesCheck[i]) > INTEGRAL_ORDER_TOLERANCE * qMax(fabs(valuesCheck[i]), EPS_ZERO))
+                accurate = false;
+
+        ::free(values);
+        if (accurate)
+            return valuesCheck;
+
+        // fallback to fixed order
+        ::free(valuesCheck);
+
+        Calculator calcFixed(m_fieldInfo, solutions, count);
+        calcFixed.setOrder(false, 0);
+        return calcFixed.calculate(markers);
+    }
 };
 
 const int OFFSET_NON_DEF = -100;
@@ -319,6 +425,7 @@ public:
 
     // local values
     virtual LocalValue *localValue(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) = 0;
+    virtual LocalValueBatch *localValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const QVector<Point> &points) = 0;
     // surface integrals
     virtual IntegralValue *surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) = 0;
     // volume integrals
@@ -29,6 +29,7 @@
 
 #include "scene.h"
 #include "scenemarker.h"
+#include "scenemarkerdialog.h"
 #include "scenebasic.h"
 #include "scenenode.h"
 #include "sceneedge.h"
@@ -164,6 +165,11 @@ bool Problem::determineIsNonlinear() const
 }
 
 void Problem::clearSolution()
+{
+    clearSolution(false);
+}
+
+void Problem::clearSolution(bool keepMesh)
 {
     m_abort = false;
 
@@ -173,8 +179,16 @@ void Problem::clearSolution()
     updateActualTimeDuringCalculation();
     m_timeHistory.clear();
 
-    foreach (FieldInfo* fieldInfo, m_fieldInfos)
-        fieldInfo->clearInitialMesh();
+    if (!keepMesh)
+    {
+        foreach (FieldInfo* fieldInfo, m_fieldInfos)
+            fieldInfo->clearInitialMesh();
+
+        m_sweepBoundaries.clear();
+        m_sweepMaterials.clear();
+        m_sweepGeometry.clear();
+        m_sweepSolvers.clear();
+    }
 
     Agros2D::solutionStore()->clearAll();
 
@@ -191,6 +205,7 @@ void Problem::clearFieldsAndConfig()
     foreach (Block* block, m_blocks)
         delete block;
     m_blocks.clear();
+    m_blockLevels.clear();
 
     // clear couplings
     foreach (CouplingInfo* couplingInfo, m_couplingInfos)
@@ -252,6 +267,8 @@ void Problem::removeField(FieldInfo *field)
 
 void Problem::createStructure()
 {
+    m_sweepSolvers.clear();
+
     foreach (Block* block, m_blocks)
         delete block;
     m_blocks.clear();
@@ -331,6 +348,26 @@ void Problem::createStructure()
         m_blocks.append(new Block(blockFieldInfos, blockCouplingInfos));
     }
 
+    // dependency levels, block depends on blocks of the source fields of its weak couplings
+    // blocks are created in the dependency order, sources are always processed first
+    m_blockLevels.clear();
+    QMap<Block *, int> blockLevel;
+    foreach (Block* block, m_blocks)
+    {
+        int level = 0;
+        foreach (FieldInfo *sourceFieldInfo, block->sourceFieldInfosCoupling())
+        {
+            Block *sourceBlock = blockOfField(sourceFieldInfo);
+            assert(blockLevel.contains(sourceBlock));
+            level = qMax(level, blockLevel[sourceBlock] + 1);
+        }
+
+        blockLevel[block] = level;
+        while (m_blockLevels.count() <= level)
+            m_blockLevels.append(QList<Block *>());
+        m_blockLevels[level].append(block);
+    }
+
     foreach (Block* block, m_blocks)
     {
         // todo: is released?
@@ -535,7 +572,7 @@ double Problem::actualTimeStepLength() const
     return m_timeStepLengths.last();
 }
 
-void Problem::solveInit(bool reCreateStructure)
+void Problem::solveInit(bool reCreateStructure, bool remesh)
 {
     m_timeStepLengths.clear();
     updateActualTimeDuringCalculation();
@@ -577,7 +614,7 @@ void Problem::solveInit(bool reCreateStructure)
 
     // todo: we should not mesh always, but we would need to refine signals to determine when is it neccesary
     // (whether, e.g., parameters of the mesh have been changed)
-    if (!mesh(false))
+    if (remesh && !mesh(false))
         throw AgrosSolverException(tr("Could not create mesh"));
 
     if (reCreateStructure || m_blocks.isEmpty())
@@ -608,13 +645,21 @@ void Problem::solve()
     m_calculationThread->startCalculation(CalculationThread::CalculationType_Solve);
 }
 
-void Problem::solve(bool commandLine)
+void Problem::solveSweepPoint()
+{
+    solve(false, true);
+}
+
+void Problem::solve(bool commandLine, bool sweep)
 {
     if (!isPreparedForAction())
         return;
 
+    // stages still valid for the actual sweep point
+    Invalidation invalidation = sweep ? sweepInvalidation() : Invalidation_Geometry;
+
     // clear solution
-    clearSolution();
+    clearSolution(invalidation != Invalidation_Geometry);
 
 //    if (numTransientFields() > 1)
 //    {
@@ -659,7 +704,7 @@ void Problem::solve(bool commandLine)
 
         m_isSolving = true;
 
-        solveAction();
+        solveAction(invalidation, sweep);
 
         m_lastTimeElapsed = milisecondsToTime(timeCounter.elapsed());
 
@@ -760,12 +805,14 @@ void Problem::solve(bool commandLine)
 //time step: from 0 (initial condition), if block is not transient, calculate allways (todo: timeskipping)
 //if no block transient, everything in timestep 0
 
-void Problem::solveAction()
+void Problem::solveAction(Invalidation invalidation, bool sweep)
 {
+    bool reuseMesh = (invalidation != Invalidation_Geometry);
+
     // clear solution
-    clearSolution();
+    clearSolution(reuseMesh);
 
-    solveInit();
+    solveInit(!reuseMesh, !reuseMesh);
 
     assert(isMeshed());
 
@@ -775,6 +822,18 @@ void Problem::solveAction()
 
     foreach (Block* block, m_blocks)
     {
+        if (invalidation == Invalidation_Boundary && m_sweepSolvers.contains(block))
+        {
+            // spaces and factorized matrix are kept, only the right hand side is assembled
+            if (!block->solveInitVariables())
+                throw AgrosSolverException(tr("Cannot create solver."));
+
+            solvers[block] = m_sweepSolvers[block];
+            solvers[block].data()->setMatrixUnchanged(true);
+
+            continue;
+        }
+
         QSharedPointer<ProblemSolver<double> > solver = block->prepareSolver();
         if (solver.isNull())
             throw AgrosSolverException(tr("Cannot create solver."));
@@ -787,24 +846,40 @@ void Problem::solveAction()
     bool doNextTimeStep = true;
     do
     {
-        foreach (Block* block, m_blocks)
+        // time dependent values of all fields, once per time step before the blocks are solved
+        // (weak couplings can use values of the source fields)
+        if (isTransient())
+            Module::updateTimeFunctions(actualTime());
+
+        QList<Block *> solvedBlocks;
+        foreach (QList<Block *> level, m_blockLevels)
         {
-            // qDebug() << "solving " << block->fields().at(0)->fieldInfo()->fieldId();
-            if (block->isTransient() && (actualTimeStep() == 0))
+            // blocks of one level are independent
+            QList<Block *> simpleBlocks;
+            foreach (Block* block, level)
             {
-                solvers[block]->solveInitialTimeStep();
-            }
-            else if(!skipThisTimeStep(block))
-            {
-                stepMessage(block);
-                if (block->adaptivityType() == AdaptivityType_None)
+                if (block->isTransient() && (actualTimeStep() == 0))
+                {
+                    solvers[block]->solveInitialTimeStep();
+                }
+                else if (!skipThisTimeStep(block))
                 {
-                    // no adaptivity
-                    solvers[block]->solveSimple(actualTimeStep(), 0);
+                    stepMessage(block);
+                    solvedBlocks.append(block);
+
+                    if (block->adaptivityType() == AdaptivityType_None)
+                        simpleBlocks.append(block);
                 }
-                else
+            }
+
+            // no adaptivity
+            solveSimpleBlocks(simpleBlocks, solvers);
+
+            foreach (Block* block, level)
+            {
+                if (solvedBlocks.contains(block) && block->adaptivityType() != AdaptivityType_None)
                 {
-                    // adaptivity
+                    // adaptivity (serial, Python callback)
                     int adaptStep = 1;
                     bool doContinueAdaptivity = true;
                     while (doContinueAdaptivity && (adaptStep <= block->adaptivitySteps()) && !m_abort)
@@ -837,19 +912,23 @@ void Problem::solveAction()
                         adaptStep++;
                     }
                 }
+            }
+        }
 
-                // TODO: it should be estimated in the first step as well
-                // TODO: what if more blocks are transient? (take minimum? )
+        // in the order of blocks
+        foreach (Block* block, m_blocks)
+        {
+            // TODO: it should be estimated in the first step as well
+            // TODO: what if more blocks are transient? (take minimum? )
 
-                // TODO: space + time adaptivity
-                if (block->isTransient() && (actualTimeStep() >= 1))
-                {
-                    nextTimeStep = solvers[block]->estimateTimeStepLength(actualTimeStep(), 0);
+            // TODO: space + time adaptivity
+            if (solvedBlocks.contains(block) && block->isTransient() && (actualTimeStep() >= 1))
+            {
+                nextTimeStep = solvers[block]->estimateTimeStepLength(actualTimeStep(), 0);
 
-                    //save actual time and indicator, whether calculation on this time was refused
-                    m_timeHistory.push_back(QPair<double, bool>(actualTime(), nextTimeStep.refuse));
-                    //qDebug() << nextTimeStep.length << ", " << actualTime() << ", " << nextTimeStep.refuse;
-                }
+                //save actual time and indicator, whether calculation on this time was refused
+                m_timeHistory.push_back(QPair<double, bool>(actualTime(), nextTimeStep.refuse));
+                //qDebug() << nextTimeStep.length << ", " << actualTime() << ", " << nextTimeStep.refuse;
             }
         }
 
@@ -890,6 +969,170 @@ void Problem::solveAction()
                 doNextTimeStep = defineActualTimeStepLength(nextTimeStep.length);
         }
     } while (doNextTimeStep && !m_abort);
+
+    // state of the solved point, next sweep point reuses what it does not change
+    m_sweepSolvers.clear();
+    if (sweep && !m_abort)
+    {
+        sweepState(m_sweepBoundaries, m_sweepMaterials, m_sweepGeometry);
+
+        foreach (Block* block, m_blocks)
+            if (isMatrixReusable(block))
+                m_sweepSolvers[block] = solvers[block];
+    }
+}
+
+void Problem::sweepState(QMap<QString, QString> &boundaries, QMap<QString, QString> &materials, QString &geometry) const
+{
+    boundaries.clear();
+    materials.clear();
+
+    foreach (SceneBoundary *boundary, Agros2D::scene()->boundaries->items())
+    {
+        if (boundary->isNone())
+            continue;
+
+        QStringList values;
+        foreach (QString id, boundary->values().keys())
+            values.append(QString("%1=%2").arg(id).arg(boundary->value(id)->toString()));
+        values.sort();
+
+        boundaries[boundary->fieldId() + "/" + boundary->name()] = boundary->type() + ";" + values.join(";");
+    }
+
+    foreach (SceneMaterial *material, Agros2D::scene()->materials->items())
+    {
+        if (material->isNone())
+            continue;
+
+        QStringList values;
+        foreach (QString id, material->values().keys())
+            values.append(QString("%1=%2").arg(id).arg(material->value(id)->toString()));
+        values.sort();
+
+        materials[material->fieldId() + "/" + material->name()] = values.join(";");
+    }
+
+    // geometry changes usually invalidate the scene (and remove the mesh), this is a safeguard
+    QList<SceneNode *> nodes = Agros2D::scene()->nodes->items();
+
+    QStringList items;
+    foreach (SceneNode *node, nodes)
+        items.append(QString("%1,%2").arg(node->point().x, 0, 'e', 15).arg(node->point().y, 0, 'e', 15));
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+        items.append(QString("%1,%2,%3").
+                     arg(nodes.indexOf(edge->nodeStart())).
+                     arg(nodes.indexOf(edge->nodeEnd())).
+                     arg(edge->angle(), 0, 'e', 15));
+    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
+        items.append(QString("%1,%2,%3").arg(label->point().x, 0, 'e', 15).arg(label->point().y, 0, 'e', 15).arg(label->area(), 0, 'e', 15));
+    geometry = items.join(";");
+}
+
+Problem::Invalidation Problem::sweepInvalidation() const
+{
+    // mesh is removed by any change of the geometry, fields or problem configuration
+    if (!isMeshed() || m_blocks.isEmpty() || m_sweepGeometry.isEmpty())
+        return Invalidation_Geometry;
+
+    QMap<QString, QString> boundaries;
+    QMap<QString, QString> materials;
+    QString geometry;
+    sweepState(boundaries, materials, geometry);
+
+    if (geometry != m_sweepGeometry || boundaries.keys() != m_sweepBoundaries.keys() || materials.keys() != m_sweepMaterials.keys())
+        return Invalidation_Geometry;
+
+    if (materials != m_sweepMaterials)
+        return Invalidation_Material;
+
+    foreach (QString key, boundaries.keys())
+    {
+        if (boundaries[key] == m_sweepBoundaries[key])
+            continue;
+
+        // type of the boundary condition or its matrix forms (e.g. heat transfer coefficient) change the matrix
+        SceneBoundary *boundary = Agros2D::scene()->getBoundary(m_fieldInfos[key.section("/", 0, 0)], key.section("/", 1));
+        if (boundaries[key].section(";", 0, 0) != m_sweepBoundaries[key].section(";", 0, 0) ||
+                !boundary->fieldInfo()->boundaryType(boundary->type()).wfMatrixSurface().isEmpty())
+            return Invalidation_Material;
+    }
+
+    return Invalidation_Boundary;
+}
+
+bool Problem::isMatrixReusable(Block *block) const
+{
+    // matrix of linear steady state blocks without adaptivity depends on geometry and materials only
+    if (block->isTransient() || block->linearityType() != LinearityType_Linear || block->adaptivityType() != AdaptivityType_None)
+        return false;
+
+    // external solver releases the matrix after solution
+    if (block->matrixSolver() == Hermes::SOLVER_EXTERNAL)
+        return false;
+
+    // reuse disabled by the user
+    if (block->matrixReuseType() != MatrixReuseType_Factorization)
+        return false;
+
+    // source fields of weak couplings can change the matrix
+    return block->sourceFieldInfosCoupling().isEmpty();
+}
+
+void Problem::solveSimpleBlocks(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers)
+{
+    // time dependent values are evaluated once per time step (Python engine is not reentrant),
+    // material and boundary values of the matrix are read before the blocks are dispatched
+    foreach (Block* block, blocks)
+        if (block->isTransient())
+            solvers[block]->updateMarkerValuesInputs();
+
+    int numberOfBlocks = qMin(blocks.count(), Agros2D::configComputer()->value(Config::Config_NumberOfConcurrentBlocks).toInt());
+    if (numberOfBlocks <= 1)
+    {
+        foreach (Block* block, blocks)
+            solvers[block]->solveSimple(actualTimeStep(), 0);
+
+        return;
+    }
+
+    // threads are split between concurrently solved blocks
+    // number of assembling threads is a global Hermes parameter, the split is the same for all blocks of the level
+    int numberOfThreads = Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt();
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, qMax(1, numberOfThreads / numberOfBlocks));
+    int nested = omp_get_nested();
+    omp_set_nested(1);
+
+    QVector<QSharedPointer<ProblemSolver<double> > > blockSolvers;
+    foreach (Block* block, blocks)
+        blockSolvers.append(solvers[block]);
+
+    int timeStep = actualTimeStep();
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic) num_threads(numberOfBlocks)
+    for (int i = 0; i < blockSolvers.count(); i++)
+    {
+        try
+        {
+            blockSolvers[i]->solveSimple(timeStep, 0);
+        }
+        catch (...)
+        {
+            // exception cannot leave the parallel region, the first one is rethrown
+#pragma omp critical(solveSimpleBlocks)
+            {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    }
+
+    omp_set_nested(nested);
+    Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, numberOfThreads);
+
+    if (exception)
+        std::rethrow_exception(exception);
 }
 
 void Problem::stepMessage(Block* block)
@@ -1048,7 +1291,8 @@ void Problem::readSolutionsFromFile()
 {
     Agros2D::log()->printMessage(tr("Problem"), tr("Loading spaces and solutions from disk"));
 
-    if (QFile::exists(QString("%1/runtime.xml").arg(cacheProblemDir())))
+    if (QFile::exists(QString("%1/runtime.xml").arg(cacheProblemDir())) ||
+            QFile::exists(QString("%1/runtime.journal").arg(cacheProblemDir())))
     {
         // load structure
         Agros2D::solutionStore()->loadRunTimeDetails();
@@ -16,6 +16,9 @@ class ProblemConfig;
 class ProblemSetting;
 class PyProblem;
 
+template <typename Scalar>
+class ProblemSolver;
+
 class CalculationThread : public QThread
 {
    Q_OBJECT
@@ -86,6 +89,8 @@ public:
     void mesh();
     // solve
     void solve();
+    // solve a point of the parametric sweep, stages not invalidated since the last point are reused
+    void solveSweepPoint();
 
     // check geometry
     bool checkGeometry();
@@ -161,10 +166,20 @@ public:
     void setIsPostprocessingRunning(bool pr = true) { m_isPostprocessingRunning = pr; }
 
 private:
+    // stages invalidated by a change of the problem (parametric sweep)
+    enum Invalidation
+    {
+        Invalidation_Geometry, // mesh, spaces and matrices
+        Invalidation_Material, // spaces and matrices, mesh is reused
+        Invalidation_Boundary  // right hand side, factorized matrices of linear steady state blocks are reused
+    };
+
     ProblemConfig *m_config;
     ProblemSetting *m_setting;
 
     QList<Block *> m_blocks;
+    // blocks grouped by weak coupling dependencies, blocks of one level are independent
+    QList<QList<Block *> > m_blockLevels;
 
     QMap<QString, FieldInfo *> m_fieldInfos;
     QMap<QPair<FieldInfo*, FieldInfo* >, CouplingInfo* > m_couplingInfos;
@@ -193,14 +208,29 @@ private:
 
     QList<QPair<double, bool> > m_timeHistory;
 
+    // parametric sweep, markers and geometry of the last solved point and solvers with reusable matrices
+    QMap<QString, QString> m_sweepBoundaries;
+    QMap<QString, QString> m_sweepMaterials;
+    QString m_sweepGeometry;
+    QMap<Block *, QSharedPointer<ProblemSolver<double> > > m_sweepSolvers;
+
     bool skipThisTimeStep(Block* block);
 
+    void clearSolution(bool keepMesh);
+
     bool mesh(bool emitMeshed);
     bool meshAction(bool emitMeshed);
-    void solveInit(bool reCreateStructure = true);
-    void solve(bool commandLine);
-    void solveAction(); // called by solve, can throw SolverException
+    void solveInit(bool reCreateStructure = true, bool remesh = true);
+    void solve(bool commandLine, bool sweep = false);
+    void solveAction(Invalidation invalidation = Invalidation_Geometry, bool sweep = false); // called by solve, can throw SolverException
+
+    // parametric sweep
+    void sweepState(QMap<QString, QString> &boundaries, QMap<QString, QString> &materials, QString &geometry) const;
+    Invalidation sweepInvalidation() const;
+    bool isMatrixReusable(Block *block) const;
 
+    // solves independent blocks without adaptivity (concurrently if allowed)
+    void solveSimpleBlocks(const QList<Block *> &blocks, QMap<Block *, QSharedPointer<ProblemSolver<double> > > &solvers);
     void stepMessage(Block* block);    
 
     friend class CalculationThread;
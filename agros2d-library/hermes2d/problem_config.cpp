@@ -62,6 +62,7 @@ void ProblemConfig::clear()
     setDefaultValues();
 
     m_setting = m_settingDefault;
+    updateSnapshot();
 }
 
 bool ProblemConfig::isTransientAdaptive() const
@@ -122,6 +123,8 @@ void ProblemConfig::load(XMLProblem::problem_config *configxsd)
                 qDebug() << "Key not found" << QString::fromStdString(configxsd->problem_item().at(i).problem_key()) << QString::fromStdString(configxsd->problem_item().at(i).problem_value());
         }
     }
+
+    updateSnapshot();
 }
 
 void ProblemConfig::save(XMLProblem::problem_config *configxsd)
@@ -142,6 +145,7 @@ void ProblemConfig::setStringKeys()
     m_settingKey[Frequency] = "Frequency";
     m_settingKey[TimeMethod] = "TimeMethod";
     m_settingKey[TimeMethodTolerance] = "TimeMethodTolerance";
+    m_settingKey[TimeMethodErrorEstimator] = "TimeMethodErrorEstimator";
     m_settingKey[TimeInitialStepSize] = "TimeInitialStepSize";
     m_settingKey[TimeOrder] = "TimeOrder";
     m_settingKey[TimeConstantTimeSteps] = "TimeSteps";
@@ -155,6 +159,7 @@ void ProblemConfig::setDefaultValues()
     m_settingDefault[Frequency] = 50.0;
     m_settingDefault[TimeMethod] = TimeStepMethod_BDFNumSteps;
     m_settingDefault[TimeMethodTolerance] = 0.05;
+    m_settingDefault[TimeMethodErrorEstimator] = TimeErrorEstimator_LowerOrder;
     m_settingDefault[TimeInitialStepSize] = 0.0;
     m_settingDefault[TimeOrder] = 2;
     m_settingDefault[TimeConstantTimeSteps] = 10;
@@ -182,11 +187,13 @@ void ProblemSetting::clear()
     setDefaultValues();
 
     m_setting = m_settingDefault;
+    updateSnapshot();
 }
 
 void ProblemSetting::setStringKeys()
 {
     m_settingKey[Problem_StartupScript] = "Problem_StartupScript";
+    m_settingKey[Problem_IntegralOrder] = "Problem_IntegralOrder";
     m_settingKey[View_GridStep] = "View_GridStep";
     m_settingKey[View_SnapToGrid] = "View_SnapToGrid";
     m_settingKey[View_ScalarView3DMode] = "View_ScalarView3DMode";
@@ -259,6 +266,7 @@ void ProblemSetting::setStringKeys()
     m_settingKey[View_ParticleCustomForceZ] = "View_ParticleCustomForceZ";
     m_settingKey[View_ParticleP2PElectricForce] = "View_ParticleP2PElectricForce";
     m_settingKey[View_ParticleP2PMagneticForce] = "View_ParticleP2PMagneticForce";
+    m_settingKey[View_ParticleP2POpeningAngle] = "View_ParticleP2POpeningAngle";
     m_settingKey[View_ChartStartX] = "View_ChartStartX";
     m_settingKey[View_ChartStartY] = "View_ChartStartY";
     m_settingKey[View_ChartEndX] = "View_ChartEndX";
@@ -276,6 +284,7 @@ void ProblemSetting::setDefaultValues()
     m_settingDefault.clear();
 
     m_settingDefault[Problem_StartupScript] = QString();
+    m_settingDefault[Problem_IntegralOrder] = IntegralOrder_Automatic;
     m_settingDefault[View_SnapToGrid] = true;
     m_settingDefault[View_GridStep] = 0.05;
     m_settingDefault[View_ScalarView3DMode] = SceneViewPost3DMode_None;
@@ -348,6 +357,7 @@ void ProblemSetting::setDefaultValues()
     m_settingDefault[View_ParticleCustomForceZ] = 0.0;
     m_settingDefault[View_ParticleP2PElectricForce] = false;
     m_settingDefault[View_ParticleP2PMagneticForce] = false;
+    m_settingDefault[View_ParticleP2POpeningAngle] = 0.0;
     m_settingDefault[View_ChartStartX] = 0.0;
     m_settingDefault[View_ChartStartY] = 0.0;
     m_settingDefault[View_ChartEndX] = 0.0;
@@ -387,6 +397,8 @@ void ProblemSetting::load21(QDomElement *config)
                 qDebug() << "Key not found" << attribute.toAttr().name() << attribute.toAttr().value();
         }
     }
+
+    updateSnapshot();
 }
 
 void ProblemSetting::save21(QDomElement *config)
@@ -420,6 +432,8 @@ void ProblemSetting::load(XMLProblem::config *configxsd)
                 qDebug() << "Key not found" << QString::fromStdString(configxsd->item().at(i).key()) << QString::fromStdString(configxsd->item().at(i).value());
         }
     }
+
+    updateSnapshot();
 }
 
 void ProblemSetting::save(XMLProblem::config *configxsd)
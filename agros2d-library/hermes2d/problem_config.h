@@ -21,6 +21,7 @@
 #define PROBLEM_CONFIG_H
 
 #include "util.h"
+#include "util/setting_snapshot.h"
 #include "value.h"
 #include "solutiontypes.h"
 
@@ -46,6 +47,7 @@ public:
         Frequency,
         TimeMethod,
         TimeMethodTolerance,
+        TimeMethodErrorEstimator,
         TimeInitialStepSize,
         TimeOrder,
         TimeConstantTimeSteps,
@@ -79,14 +81,18 @@ public:
     inline Type stringKeyToType(const QString &key) { return m_settingKey.key(key); }
 
     inline QVariant value(Type type) const { return m_setting[type]; }
-    inline void setValue(Type type, int value, bool emitChanged = true) {  m_setting[type] = value; if (emitChanged) emit changed(); }
-    inline void setValue(Type type, double value, bool emitChanged = true) {  m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
-    inline void setValue(Type type, bool value, bool emitChanged = true) {  m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
-    inline void setValue(Type type, const QString &value, bool emitChanged = true) { m_setting[type] = value; emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, int value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, double value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, bool value, bool emitChanged = true) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
+    inline void setValue(Type type, const QString &value, bool emitChanged = true) { m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); emit changed(); if (emitChanged) emit changed(); }
 
     inline QVariant defaultValue(Type type) {  return m_settingDefault[type]; }
 
-    inline double constantTimeStepLength() { return value(ProblemConfig::TimeTotal).toDouble() / value(ProblemConfig::TimeConstantTimeSteps).toInt(); }
+    // typed settings for loops
+    inline const SettingSnapshot<Type> &snapshot() const { return m_snapshot; }
+    inline bool isSnapshotValid() const { return m_snapshot.isEqual(m_setting); }
+
+    inline double constantTimeStepLength() { return m_snapshot.toDouble(ProblemConfig::TimeTotal) / m_snapshot.toInt(ProblemConfig::TimeConstantTimeSteps); }
     double initialTimeStepLength();
     bool isTransientAdaptive() const;
 
@@ -105,9 +111,11 @@ private:
     QMap<Type, QVariant> m_setting;
     QMap<Type, QVariant> m_settingDefault;
     QMap<Type, QString> m_settingKey;
+    SettingSnapshot<Type> m_snapshot;
 
     void setDefaultValues();
     void setStringKeys();
+    inline void updateSnapshot() { m_snapshot = SettingSnapshot<Type>(m_settingDefault, m_setting); }
 };
 
 class ProblemSetting : public QObject
@@ -122,6 +130,7 @@ public:
     {
         Unknown,
         Problem_StartupScript,
+        Problem_IntegralOrder,
         View_GridStep,
         View_SnapToGrid,
         View_ScalarView3DMode,
@@ -194,6 +203,7 @@ public:
         View_ParticleCustomForceZ,
         View_ParticleP2PElectricForce,
         View_ParticleP2PMagneticForce,
+        View_ParticleP2POpeningAngle,
         View_ChartStartX,
         View_ChartStartY,
         View_ChartEndX,
@@ -217,21 +227,27 @@ public:
     inline Type stringKeyToType(const QString &key) { return m_settingKey.key(key); }
 
     inline QVariant value(Type type) {  return m_setting[type]; }
-    inline void setValue(Type type, int value) {  m_setting[type] = value; }
-    inline void setValue(Type type, double value) {  m_setting[type] = value; }
-    inline void setValue(Type type, bool value) {  m_setting[type] = value; }
-    inline void setValue(Type type, const QString &value) { m_setting[type] = value; }
-    inline void setValue(Type type, const QStringList &value) { m_setting[type] = value; }
+    inline void setValue(Type type, int value) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); }
+    inline void setValue(Type type, double value) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); }
+    inline void setValue(Type type, bool value) {  m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); }
+    inline void setValue(Type type, const QString &value) { m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); }
+    inline void setValue(Type type, const QStringList &value) { m_setting[type] = value; m_snapshot.setValue(type, m_setting[type]); }
 
     inline QVariant defaultValue(Type type) {  return m_settingDefault[type]; }
 
+    // typed settings for drawing loops
+    inline const SettingSnapshot<Type> &snapshot() const { return m_snapshot; }
+    inline bool isSnapshotValid() const { return m_snapshot.isEqual(m_setting); }
+
 private:
     QMap<Type, QVariant> m_setting;
     QMap<Type, QVariant> m_settingDefault;
     QMap<Type, QString> m_settingKey;
+    SettingSnapshot<Type> m_snapshot;
 
     void setDefaultValues();
     void setStringKeys();
+    inline void updateSnapshot() { m_snapshot = SettingSnapshot<Type>(m_settingDefault, m_setting); }
 };
 
 #endif // PROBLEM_CONFIG_H
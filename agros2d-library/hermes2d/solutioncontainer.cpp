@@ -0,0 +1,242 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "solutioncontainer.h"
+
+const QByteArray SOLUTION_CONTAINER_MAGIC = "AGROSSOL";
+const int SOLUTION_CONTAINER_VERSION = 1;
+const qint64 SOLUTION_CONTAINER_BUFFER = 4 * 1024 * 1024;
+
+SolutionContainer::SolutionContainer() : m_data(NULL)
+{
+}
+
+SolutionContainer::~SolutionContainer()
+{
+    close();
+}
+
+bool SolutionContainer::isContainer(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    return (file.read(SOLUTION_CONTAINER_MAGIC.size()) == SOLUTION_CONTAINER_MAGIC);
+}
+
+bool SolutionContainer::write(const QString &fileName, const QString &dir)
+{
+    // temporary file in the same directory (rename does not move data)
+    QString tempFileName = fileName + ".tmp";
+    if (QFile::exists(tempFileName) && !QFile::remove(tempFileName))
+        return false;
+
+    QFile file(tempFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    bool ok = writeEntries(file, dir);
+    file.close();
+    ok = ok && (file.error() == QFile::NoError);
+
+    // existing container is kept if any entry fails
+    if (!ok)
+    {
+        QFile::remove(tempFileName);
+        return false;
+    }
+
+    if (QFile::exists(fileName) && !QFile::remove(fileName))
+    {
+        QFile::remove(tempFileName);
+        return false;
+    }
+
+    return QFile::rename(tempFileName, fileName);
+}
+
+bool SolutionContainer::writeEntries(QFile &file, const QString &dir)
+{
+    if (file.write(SOLUTION_CONTAINER_MAGIC) != SOLUTION_CONTAINER_MAGIC.size())
+        return false;
+
+    // data
+    QMap<QString, Entry> index;
+    foreach (QFileInfo fileInfo, QDir(dir).entryInfoList(QDir::Files))
+    {
+        QFile entry(fileInfo.absoluteFilePath());
+        if (!entry.open(QIODevice::ReadOnly))
+            return false;
+
+        index.insert(fileInfo.fileName(), Entry(file.pos(), entry.size()));
+
+        qint64 written = 0;
+        while (!entry.atEnd())
+        {
+            QByteArray data = entry.read(SOLUTION_CONTAINER_BUFFER);
+            if (data.isEmpty() || file.write(data) != data.size())
+                return false;
+
+            written += data.size();
+        }
+
+        if (written != entry.size() || entry.error() != QFile::NoError)
+            return false;
+    }
+
+    // index
+    qint64 indexOffset = file.pos();
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_8);
+    out << (qint32) SOLUTION_CONTAINER_VERSION;
+    out << (qint32) index.count();
+    foreach (QString name, index.keys())
+        out << name << index[name].offset << index[name].size;
+
+    // trailer
+    out << indexOffset;
+    if (out.status() != QDataStream::Ok || file.write(SOLUTION_CONTAINER_MAGIC) != SOLUTION_CONTAINER_MAGIC.size())
+        return false;
+
+    return (file.error() == QFile::NoError);
+}
+
+bool SolutionContainer::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    // trailer
+    qint64 trailerSize = sizeof(qint64) + SOLUTION_CONTAINER_MAGIC.size();
+    if (m_file.size() < SOLUTION_CONTAINER_MAGIC.size() + trailerSize)
+    {
+        close();
+        return false;
+    }
+
+    m_file.seek(m_file.size() - trailerSize);
+    QDataStream in(&m_file);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    qint64 indexOffset;
+    in >> indexOffset;
+    if (m_file.read(SOLUTION_CONTAINER_MAGIC.size()) != SOLUTION_CONTAINER_MAGIC)
+    {
+        close();
+        return false;
+    }
+
+    // index
+    if (indexOffset < SOLUTION_CONTAINER_MAGIC.size() || indexOffset > m_file.size() - trailerSize)
+    {
+        close();
+        return false;
+    }
+    m_file.seek(indexOffset);
+
+    qint32 version;
+    qint32 count;
+    in >> version >> count;
+    if (version != SOLUTION_CONTAINER_VERSION)
+    {
+        close();
+        return false;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        QString name;
+        Entry entry;
+        in >> name >> entry.offset >> entry.size;
+
+        // entry must lie in the data section
+        if (in.status() != QDataStream::Ok
+                || entry.offset < SOLUTION_CONTAINER_MAGIC.size() || entry.size < 0
+                || entry.offset + entry.size > indexOffset)
+        {
+            close();
+            return false;
+        }
+
+        m_index.insert(name, entry);
+    }
+
+    // memory map (fails for large files on 32-bit systems, entries are read by seek in that case)
+    m_data = m_file.map(0, m_file.size());
+
+    return (in.status() == QDataStream::Ok);
+}
+
+void SolutionContainer::close()
+{
+    if (m_data)
+    {
+        m_file.unmap(m_data);
+        m_data = NULL;
+    }
+
+    if (m_file.isOpen())
+        m_file.close();
+
+    m_index.clear();
+}
+
+bool SolutionContainer::extract(const QString &name, const QString &dir)
+{
+    if (!m_index.contains(name))
+        return false;
+
+    // truncated or damaged container
+    Entry entry = m_index[name];
+    if (entry.offset < 0 || entry.size < 0 || entry.offset + entry.size > m_file.size())
+        return false;
+
+    QFile file(QString("%1/%2").arg(dir).arg(name));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    if (m_data)
+    {
+        file.write((const char *) m_data + entry.offset, entry.size);
+    }
+    else
+    {
+        m_file.seek(entry.offset);
+        qint64 remaining = entry.size;
+        while (remaining > 0)
+        {
+            QByteArray data = m_file.read(qMin(remaining, SOLUTION_CONTAINER_BUFFER));
+            if (data.isEmpty())
+            {
+                file.remove();
+                return false;
+            }
+
+            file.write(data);
+            remaining -= data.size();
+        }
+    }
+
+    return (file.error() == QFile::NoError);
+}
@@ -0,0 +1,67 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SOLUTIONCONTAINER_H
+#define SOLUTIONCONTAINER_H
+
+#include "util.h"
+
+// single file, indexed solution container (meshes, spaces, solutions and run time details)
+// layout: magic | data of entries | index (name, offset, size) | index offset | magic
+// entries are read from the memory mapped file, without extraction of the others
+class AGROS_LIBRARY_API SolutionContainer
+{
+public:
+    SolutionContainer();
+    ~SolutionContainer();
+
+    // returns true if file is a solution container (older solutions are zip archives)
+    static bool isContainer(const QString &fileName);
+    // writes all files in the directory to the container
+    // container is written to a temporary file and replaces the existing one only if all entries are written
+    static bool write(const QString &fileName, const QString &dir);
+
+    bool open(const QString &fileName);
+    void close();
+    inline bool isOpen() const { return m_file.isOpen(); }
+    inline QString fileName() const { return m_file.fileName(); }
+
+    inline bool contains(const QString &name) const { return m_index.contains(name); }
+    inline QStringList entries() const { return m_index.keys(); }
+
+    // extracts one entry to the directory
+    bool extract(const QString &name, const QString &dir);
+
+private:
+    struct Entry
+    {
+        Entry(qint64 offset = 0, qint64 size = 0) : offset(offset), size(size) {}
+
+        qint64 offset;
+        qint64 size;
+    };
+
+    static bool writeEntries(QFile &file, const QString &dir);
+
+    QFile m_file;
+    uchar *m_data;
+    QMap<QString, Entry> m_index;
+};
+
+#endif // SOLUTIONCONTAINER_H
@@ -28,11 +28,104 @@
 #include "scene.h"
 #include "problem.h"
 #include "problem_config.h"
+#include "particle/mesh_hash.h"
 
 #include "../../resources_source/classes/structure_xml.h"
 
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace Hermes::Hermes2D;
 
+const QString RUNTIME_DETAILS = "runtime.xml";
+const QString RUNTIME_JOURNAL = "runtime.journal";
+// number of journal records written before the journal is synchronized with the disk
+const int RUNTIME_JOURNAL_SYNC_INTERVAL = 64;
+// prefix of content addressed mesh files (one mesh per file)
+const QString MESH_FILE_PREFIX = "mesh_";
+
+// background writer
+const int SOLUTION_WRITER_THREADS = 2;
+const int SOLUTION_WRITER_QUEUE_SIZE = 24;
+
+static QString doubleVectorToString(const QVector<double> &values)
+{
+    QStringList list;
+    foreach (double value, values)
+        list.append(QString::number(value, 'g', 17));
+
+    return list.join(",");
+}
+
+static QVector<double> doubleVectorFromString(const QString &str)
+{
+    QVector<double> values;
+    foreach (QString value, str.split(",", QString::SkipEmptyParts))
+        values.append(value.toDouble());
+
+    return values;
+}
+
+// record: A, field, time step, adaptivity step, solution type, time step length, adaptivity error, DOFs,
+//         jacobian calculations, files (mesh|space|solution;...), residuals, damping, relative change of solutions
+static QString runTimeJournalRecord(FieldSolutionID solutionID, const SolutionStore::SolutionRunTimeDetails &runTime)
+{
+    QStringList files;
+    foreach (SolutionStore::SolutionRunTimeDetails::FileName fileName, runTime.fileNames())
+        files.append(QString("%1|%2|%3").
+                     arg(fileName.meshFileName()).
+                     arg(fileName.spaceFileName()).
+                     arg(fileName.solutionFileName()));
+
+    return QString("A\t%1\t%2\t%3\t%4\t%5\t%6\t%7\t%8\t%9\t%10\t%11\t%12").
+            arg(solutionID.group->fieldId()).
+            arg(solutionID.timeStep).
+            arg(solutionID.adaptivityStep).
+            arg(solutionTypeToStringKey(solutionID.solutionMode)).
+            arg(QString::number(runTime.timeStepLength(), 'g', 17)).
+            arg(QString::number(runTime.adaptivityError(), 'g', 17)).
+            arg(runTime.DOFs()).
+            arg(runTime.jacobianCalculations()).
+            arg(files.join(";")).
+            arg(doubleVectorToString(runTime.newtonResidual())).
+            arg(doubleVectorToString(runTime.nonlinearDamping())).
+            arg(doubleVectorToString(runTime.relativeChangeOfSolutions()));
+}
+
+// estimate of memory held by meshes, spaces and solution coefficients
+// shared meshes and spaces are counted for every solution (upper bound)
+static qint64 multiArrayMemorySize(MultiArray<double> &multiArray)
+{
+    qint64 size = 0;
+
+    for (int comp = 0; comp < multiArray.size(); comp++)
+    {
+        SpaceSharedPtr<double> space = multiArray.spaces().at(comp);
+        MeshSharedPtr mesh = space->get_mesh();
+
+        // mesh
+        size += mesh->get_max_element_id() * sizeof(Element);
+        size += mesh->get_max_node_id() * sizeof(Node);
+
+        // space (element and node data)
+        size += (mesh->get_max_element_id() + mesh->get_max_node_id()) * 4 * sizeof(int);
+
+        // solution (monomial coefficients of active elements)
+        Element *e;
+        for_all_active_elements(e, mesh)
+        {
+            int order = space->get_element_order(e->id);
+            int numCoeffs = (H2D_GET_H_ORDER(order) + 1) * (H2D_GET_V_ORDER(order) + 1);
+            size += numCoeffs * sizeof(double) + sizeof(int);
+        }
+    }
+
+    return size;
+}
+
 void SolutionStore::printDebugCacheStatus()
 {
     assert(m_multiSolutionCacheIDOrder.size() == m_multiSolutionCache.keys().size());
@@ -40,13 +133,199 @@ void SolutionStore::printDebugCacheStatus()
     foreach(FieldSolutionID fsid, m_multiSolutionCacheIDOrder)
     {
         assert(m_multiSolutionCache.keys().contains(fsid));
-        qDebug() << fsid.toString();
+        qDebug() << fsid.toString() << m_multiSolutionCacheMemorySize[fsid] << (isPinned(fsid) ? "pinned" : "");
+    }
+    qDebug() << "memory:" << m_cacheMemorySize << "hits:" << m_cacheStatistics.hits << "misses:" << m_cacheStatistics.misses << "evictions:" << m_cacheStatistics.evictions;
+}
+
+SolutionStoreWriter::SolutionStoreWriter(int numberOfThreads, int queueSize)
+    : m_queueSize(queueSize), m_running(0), m_stop(false)
+{
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        WorkerThread *thread = new WorkerThread(this);
+        thread->start();
+
+        m_threads.append(thread);
+    }
+}
+
+SolutionStoreWriter::~SolutionStoreWriter()
+{
+    flush();
+
+    m_mutex.lock();
+    m_stop = true;
+    m_queueNotEmpty.wakeAll();
+    m_mutex.unlock();
+
+    foreach (WorkerThread *thread, m_threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+    m_threads.clear();
+}
+
+void SolutionStoreWriter::enqueue(const Task &task)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // back-pressure
+    while (m_queue.size() >= m_queueSize)
+        m_queueNotFull.wait(&m_mutex);
+
+    m_queue.append(task);
+    m_pending.insert(task.fileName);
+
+    m_queueNotEmpty.wakeOne();
+}
+
+void SolutionStoreWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_queue.isEmpty() || (m_running > 0))
+        m_taskFinished.wait(&m_mutex);
+}
+
+void SolutionStoreWriter::flush(const QStringList &fileNames)
+{
+    QMutexLocker locker(&m_mutex);
+
+    foreach (QString fileName, fileNames)
+        while (m_pending.contains(fileName))
+            m_taskFinished.wait(&m_mutex);
+}
+
+void SolutionStoreWriter::process()
+{
+    while (true)
+    {
+        m_mutex.lock();
+        while (m_queue.isEmpty() && !m_stop)
+            m_queueNotEmpty.wait(&m_mutex);
+
+        if (m_queue.isEmpty() && m_stop)
+        {
+            m_mutex.unlock();
+            return;
+        }
+
+        Task task = m_queue.takeFirst();
+        m_running++;
+        m_queueNotFull.wakeOne();
+        m_mutex.unlock();
+
+        write(task);
+
+        m_mutex.lock();
+        m_running--;
+        m_pending.remove(task.fileName);
+        m_taskFinished.wakeAll();
+        m_mutex.unlock();
+    }
+}
+
+void SolutionStoreWriter::write(const Task &task)
+{
+    try
+    {
+        switch (task.type)
+        {
+        case Task::Task_Mesh:
+            Module::writeMeshToFileBSON(task.fileName, task.meshes);
+            break;
+        case Task::Task_Space:
+            task.space->save_bson(compatibleFilename(task.fileName).toStdString().c_str());
+            break;
+        case Task::Task_Solution:
+            dynamic_cast<Hermes::Hermes2D::Solution<double> *>(task.solution.get())->save_bson(compatibleFilename(task.fileName).toStdString().c_str());
+            break;
+        default:
+            assert(0);
+        }
+    }
+    catch (Hermes::Exceptions::Exception &e)
+    {
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Cannot write '%1' (%2)").arg(QFileInfo(task.fileName).fileName()).arg(QString::fromStdString(e.info())));
+    }
+    catch (std::exception &e)
+    {
+        // exception must not leave the worker thread (I/O, allocation)
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Cannot write '%1' (%2)").arg(QFileInfo(task.fileName).fileName()).arg(e.what()));
+    }
+    catch (...)
+    {
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Cannot write '%1' (unknown exception)").arg(QFileInfo(task.fileName).fileName()));
     }
 }
 
+// *********************************************************************************************
+
+SolutionStore::SolutionStore() : m_cacheMemorySize(0), m_cacheMutex(QMutex::Recursive), m_runTimeJournalUnsynced(0)
+{
+    m_writer = new SolutionStoreWriter(SOLUTION_WRITER_THREADS, SOLUTION_WRITER_QUEUE_SIZE);
+}
+
 SolutionStore::~SolutionStore()
 {
     clearAll();
+
+    delete m_writer;
+}
+
+void SolutionStore::flush()
+{
+    m_writer->flush();
+}
+
+bool SolutionStore::openContainer(const QString &fileName)
+{
+    if (!m_container.open(fileName))
+    {
+        Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Solution file '%1' is corrupted").arg(fileName));
+        return false;
+    }
+
+    // run time details and initial mesh, data of solutions are extracted on demand
+    foreach (QString name, m_container.entries())
+    {
+        QString suffix = QFileInfo(name).suffix();
+        if ((suffix != "mbs") && (suffix != "spc") && (suffix != "sln"))
+        {
+            if (!m_container.extract(name, cacheProblemDir()))
+            {
+                Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Solution file '%1' is corrupted").arg(fileName));
+                m_container.close();
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void SolutionStore::detachContainer()
+{
+    if (!m_container.isOpen())
+        return;
+
+    foreach (QString name, m_container.entries())
+        if (!QFile::exists(QString("%1/%2").arg(cacheProblemDir()).arg(name)))
+            m_container.extract(name, cacheProblemDir());
+
+    m_container.close();
+}
+
+void SolutionStore::extractFromContainer(const QStringList &fileNames)
+{
+    if (!m_container.isOpen())
+        return;
+
+    foreach (QString fileName, fileNames)
+        if (m_container.contains(fileName) && !QFile::exists(QString("%1/%2").arg(cacheProblemDir()).arg(fileName)))
+            m_container.extract(fileName, cacheProblemDir());
 }
 
 QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
@@ -58,24 +337,104 @@ QString SolutionStore::baseStoreFileName(FieldSolutionID solutionID) const
     return fn;
 }
 
+QString SolutionStore::meshStoreFileName(MeshSharedPtr mesh) const
+{
+    // topology and refinement state
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    Node *node;
+    for_all_vertex_nodes(node, mesh)
+    {
+        hash.addData((const char *) &node->id, sizeof(int));
+        hash.addData((const char *) &node->x, sizeof(double));
+        hash.addData((const char *) &node->y, sizeof(double));
+    }
+
+    Element *e;
+    for_all_elements(e, mesh)
+    {
+        int data[4] = { e->id, e->marker, e->active, e->nvert };
+        hash.addData((const char *) data, sizeof(data));
+
+        for (unsigned int i = 0; i < e->get_nvert(); i++)
+            hash.addData((const char *) &e->vn[i]->id, sizeof(int));
+
+        bool curved = e->is_curved();
+        hash.addData((const char *) &curved, sizeof(bool));
+    }
+
+    return QString("%1/%2%3.mbs").arg(cacheProblemDir()).arg(MESH_FILE_PREFIX).arg(QString(hash.result().toHex()));
+}
+
+void SolutionStore::addMeshFileReferences(const SolutionRunTimeDetails &runTime)
+{
+    foreach (SolutionRunTimeDetails::FileName fileName, runTime.fileNames())
+        if (!fileName.meshFileName().isEmpty())
+            m_meshFileReferences[fileName.meshFileName()]++;
+}
+
+QStringList SolutionStore::releaseMeshFileReferences(const SolutionRunTimeDetails &runTime)
+{
+    QStringList unreferenced;
+    foreach (SolutionRunTimeDetails::FileName fileName, runTime.fileNames())
+    {
+        QMap<QString, int>::iterator it = m_meshFileReferences.find(fileName.meshFileName());
+        if (it == m_meshFileReferences.end())
+            continue;
+
+        if (--it.value() == 0)
+        {
+            unreferenced.append(it.key());
+            m_meshFileReferences.erase(it);
+        }
+    }
+
+    return unreferenced;
+}
+
 void SolutionStore::clearAll()
 {
+    // files in the queue
+    m_writer->flush();
+
+    // files are removed with the cache
+    m_container.close();
+
     // fast remove of all files
     foreach (FieldSolutionID sid, m_multiSolutions)
         removeSolution(sid, false);
 
     // remove runtime
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QString fn = QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_DETAILS);
     if (QFile::exists(fn))
         QFile::remove(fn);
 
+    // remove journal
+    closeRunTimeJournal();
+    QString fnJournal = QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_JOURNAL);
+    if (QFile::exists(fnJournal))
+        QFile::remove(fnJournal);
+
+    // pinned solutions
+    m_multiSolutionCachePinned.clear();
+
+    // time series slot
+    releaseStream();
+
+    // point location
+    m_meshHashes.clear();
+
     assert(m_multiSolutions.isEmpty());
     assert(m_multiSolutionRunTimeDetails.isEmpty());
+    assert(m_meshFileReferences.isEmpty());
     assert(m_multiSolutionCache.isEmpty());
+    assert(m_cacheMemorySize == 0);
 }
 
 MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     if(solutionID.solutionMode == SolutionMode_Finer)
     {
         solutionID.solutionMode = SolutionMode_Reference;
@@ -85,44 +444,134 @@ MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
 
     assert(m_multiSolutions.contains(solutionID));
 
+    // time series extraction
+    if ((m_streamMultiArray.size() > 0) && (m_streamSolutionID == solutionID))
+    {
+        m_cacheStatistics.hits++;
+
+        return m_streamMultiArray;
+    }
+
     if (!m_multiSolutionCache.contains(solutionID))
     {
         //qDebug() << "Read from disk: " << solutionID.toString();
+        m_cacheStatistics.misses++;
+
+        MultiArray<double> msa = readMultiArray(solutionID);
+
+        // insert to the cache
+        insertMultiSolutionToCache(solutionID, msa);
+
+        //printDebugCacheStatus();
+
+        return msa;
+    }
+    else
+    {
+        m_cacheStatistics.hits++;
+
+        // most recently used
+        m_multiSolutionCacheIDOrder.removeOne(solutionID);
+        m_multiSolutionCacheIDOrder.append(solutionID);
+
+        return m_multiSolutionCache[solutionID];
+    }
+}
+
+void SolutionStore::streamSolution(FieldSolutionID solutionID)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    assert(m_multiSolutions.contains(solutionID));
+
+    if (m_multiSolutionCache.contains(solutionID) ||
+            ((m_streamMultiArray.size() > 0) && (m_streamSolutionID == solutionID)))
+        return;
+
+    // previous slot is released after the read (its mesh and space can be reused)
+    MultiArray<double> msa = readMultiArray(solutionID);
+
+    m_streamSolutionID = solutionID;
+    m_streamMultiArray = msa;
+
+    removeUnusedMeshHashes();
+}
+
+void SolutionStore::releaseStream()
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    m_streamSolutionID = FieldSolutionID();
+    m_streamMultiArray.clear();
+
+    removeUnusedMeshHashes();
+}
+
+MultiArray<double> SolutionStore::readMultiArray(FieldSolutionID solutionID)
+{
+    QStringList fileNames;
+    foreach (SolutionRunTimeDetails::FileName fileName, m_multiSolutionRunTimeDetails[solutionID].fileNames())
+        fileNames << fileName.meshFileName() << fileName.spaceFileName() << fileName.solutionFileName();
+
+    // files could be still in the queue
+    QStringList absoluteFileNames;
+    foreach (QString fileName, fileNames)
+        absoluteFileNames << QString("%1/%2").arg(cacheProblemDir()).arg(fileName);
+    m_writer->flush(absoluteFileNames);
+
+    // lazy loading from the solution container
+    extractFromContainer(fileNames);
 
-        const FieldInfo *fieldInfo = solutionID.group;
-        const Block *block = Agros2D::problem()->blockOfField(fieldInfo);
+    const FieldInfo *fieldInfo = solutionID.group;
+    const Block *block = Agros2D::problem()->blockOfField(fieldInfo);
 
-        MultiArray<double> msa;
-        SolutionRunTimeDetails runTime = m_multiSolutionRunTimeDetails[solutionID];
+    MultiArray<double> msa;
+    SolutionRunTimeDetails runTime = m_multiSolutionRunTimeDetails[solutionID];
 
-        for (int fieldCompIdx = 0; fieldCompIdx < solutionID.group->numberOfSolutions(); fieldCompIdx++)
+    for (int fieldCompIdx = 0; fieldCompIdx < solutionID.group->numberOfSolutions(); fieldCompIdx++)
+    {
+        // reuse space and mesh (time series slot first, file names are unchanged between most time steps)
+        Hermes::Hermes2D::SpaceSharedPtr<double> space;
+        QList<FieldSolutionID> searchSolutionIDs = m_multiSolutionCacheIDOrder;
+        if (m_streamMultiArray.size() > 0)
+            searchSolutionIDs.prepend(m_streamSolutionID);
+
+        foreach (FieldSolutionID searchSolutionID, searchSolutionIDs)
         {
-            // reuse space and mesh
-            Hermes::Hermes2D::SpaceSharedPtr<double> space;
-            foreach (FieldSolutionID searchSolutionID, m_multiSolutionCacheIDOrder)
+            SolutionRunTimeDetails searchRunTime = m_multiSolutionRunTimeDetails[searchSolutionID];
+            if ((fieldCompIdx < searchRunTime.fileNames().size()) &&
+                    (runTime.fileNames()[fieldCompIdx].meshFileName() == searchRunTime.fileNames()[fieldCompIdx].meshFileName()) &&
+                    (runTime.fileNames()[fieldCompIdx].spaceFileName() == searchRunTime.fileNames()[fieldCompIdx].spaceFileName()))
             {
-                SolutionRunTimeDetails searchRunTime = m_multiSolutionRunTimeDetails[searchSolutionID];
-                if ((fieldCompIdx < searchRunTime.fileNames().size()) &&
-                        (runTime.fileNames()[fieldCompIdx].meshFileName() == searchRunTime.fileNames()[fieldCompIdx].meshFileName()) &&
-                        (runTime.fileNames()[fieldCompIdx].spaceFileName() == searchRunTime.fileNames()[fieldCompIdx].spaceFileName()))
-                {
+                if (m_multiSolutionCache.contains(searchSolutionID))
                     space = m_multiSolutionCache[searchSolutionID].spaces().at(fieldCompIdx);
-                    break;
-                }
+                else
+                    space = m_streamMultiArray.spaces().at(fieldCompIdx);
+                break;
             }
+        }
+
+        // read space and mesh from file
+        if (!space.get())
+        {
+            // load the mesh file
+            QString fn = QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].meshFileName());
 
-            // read space and mesh from file
-            if (!space.get())
+            Hermes::Hermes2D::MeshSharedPtr mesh;
+            if (QFileInfo(fn).fileName().startsWith(MESH_FILE_PREFIX))
             {
-                // load the mesh file
-                QString fn = QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].meshFileName());
+                // only the mesh of the field
+                mesh = Module::readSingleMeshFromFileBSON(fn);
+            }
+            else
+            {
+                // meshes of all fields (older format)
                 Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
                 if (QFileInfo(fn).suffix() == "msh")
                     meshes = Module::readMeshFromFileXML(fn);
                 else
                     meshes = Module::readMeshFromFileBSON(fn);
 
-                Hermes::Hermes2D::MeshSharedPtr mesh;
                 int globalFieldIdx = 0;
                 foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
                 {
@@ -133,56 +582,49 @@ MultiArray<double> SolutionStore::multiArray(FieldSolutionID solutionID)
                     }
                     globalFieldIdx++;
                 }
-                assert(mesh);
+            }
+            assert(mesh);
 
-                try
-                {
-                    EssentialBCs<double>* essentialBcs = NULL;
-                    if((fieldInfo->spaces()[fieldCompIdx].type() != HERMES_L2_SPACE) && (fieldInfo->spaces()[fieldCompIdx].type() != HERMES_L2_MARKERWISE_CONST_SPACE))
-                    {
-                        int bcIndex = fieldCompIdx + block->offset(block->field(fieldInfo));
-                        essentialBcs = block->bcs().at(bcIndex);
-                    }
-                    QString spaceFileName = QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].spaceFileName());       
-                    // space = Space<double>::load(compatibleFilename(spaceFileName).toStdString().c_str(), mesh, false, essentialBcs);
-                    space = Space<double>::load_bson(compatibleFilename(spaceFileName).toStdString().c_str(), mesh, essentialBcs);
-                }
-                catch (Hermes::Exceptions::Exception &e)
+            try
+            {
+                EssentialBCs<double>* essentialBcs = NULL;
+                if((fieldInfo->spaces()[fieldCompIdx].type() != HERMES_L2_SPACE) && (fieldInfo->spaces()[fieldCompIdx].type() != HERMES_L2_MARKERWISE_CONST_SPACE))
                 {
-                    Agros2D::log()->printError(QObject::tr("Solver"), QString::fromStdString(e.info()));
-                    throw;
+                    int bcIndex = fieldCompIdx + block->offset(block->field(fieldInfo));
+                    essentialBcs = block->bcs().at(bcIndex);
                 }
+                QString spaceFileName = QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].spaceFileName());       
+                // space = Space<double>::load(compatibleFilename(spaceFileName).toStdString().c_str(), mesh, false, essentialBcs);
+                space = Space<double>::load_bson(compatibleFilename(spaceFileName).toStdString().c_str(), mesh, essentialBcs);
+            }
+            catch (Hermes::Exceptions::Exception &e)
+            {
+                Agros2D::log()->printError(QObject::tr("Solver"), QString::fromStdString(e.info()));
+                throw;
             }
-
-            // read solution
-            Solution<double> *sln = new Solution<double>();
-            sln->set_validation(false);
-            // QTime time;
-            // time.start();
-            sln->load_bson(QString("%1/%2").
-                            arg(compatibleFilename(cacheProblemDir())).
-                            arg(runTime.fileNames()[fieldCompIdx].solutionFileName()).toStdString().c_str(), space);
-            // sln->load((QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].solutionFileName())).toLatin1().data(), space);
-            // qDebug() << "LOAD" << time.elapsed();
-
-            msa.append(space, sln);
         }
 
-        // insert to the cache
-        insertMultiSolutionToCache(solutionID, msa);
-
-        //printDebugCacheStatus();
-
-        return msa;
-    }
-    else
-    {
-        return m_multiSolutionCache[solutionID];
+        // read solution
+        Solution<double> *sln = new Solution<double>();
+        sln->set_validation(false);
+        // QTime time;
+        // time.start();
+        sln->load_bson(QString("%1/%2").
+                        arg(compatibleFilename(cacheProblemDir())).
+                        arg(runTime.fileNames()[fieldCompIdx].solutionFileName()).toStdString().c_str(), space);
+        // sln->load((QString("%1/%2").arg(cacheProblemDir()).arg(runTime.fileNames()[fieldCompIdx].solutionFileName())).toLatin1().data(), space);
+        // qDebug() << "LOAD" << time.elapsed();
+
+        msa.append(space, sln);
     }
+
+    return msa;
 }
 
 bool SolutionStore::contains(FieldSolutionID solutionID) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     return m_multiSolutions.contains(solutionID);
 }
 
@@ -200,6 +642,8 @@ MultiArray<double> SolutionStore::multiArray(BlockSolutionID solutionID)
 
 void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     // qDebug() << "saving solution " << solutionID;
     assert(!m_multiSolutions.contains(solutionID));
     assert(solutionID.timeStep >= 0);
@@ -227,25 +671,24 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
         }
     }
 
+    // meshes, spaces and solutions are written by the background writer
     // meshes
     for (int i = 0; i < multiSolution.size(); i++)
     {
         if (fileNames[i].meshFileName().isEmpty())
         {
-            Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
-            foreach(FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+            QString meshFN = meshStoreFileName(multiSolution.spaces().at(i)->get_mesh());
+
+            // same mesh is already stored
+            if (!QFile::exists(meshFN) && !m_writer->isPending(meshFN))
             {
-                if (fieldInfo == solutionID.group)
-                    meshes.push_back(multiSolution.spaces().at(i)->get_mesh());
-                else
-                    meshes.push_back(fieldInfo->initialMesh());
+                SolutionStoreWriter::Task task;
+                task.type = SolutionStoreWriter::Task::Task_Mesh;
+                task.fileName = meshFN;
+                task.meshes.push_back(multiSolution.spaces().at(i)->get_mesh());
+                m_writer->enqueue(task);
             }
 
-            // QString meshFN = QString("%1_%2.msh").arg(baseFN).arg(i);
-            // Module::writeMeshToFileXML(meshFN, meshes);
-            QString meshFN = QString("%1_%2.mbs").arg(baseFN).arg(i);
-            Module::writeMeshToFileBSON(meshFN, meshes);
-
             fileNames[i].setMeshFileName(QFileInfo(meshFN).fileName());
         }
     }
@@ -256,8 +699,12 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
         if (fileNames[i].spaceFileName().isEmpty())
         {
             QString spaceFN = QString("%1_%2.spc").arg(baseFN).arg(i);
-            // multiSolution.spaces().at(i)->save(compatibleFilename(spaceFN).toStdString().c_str());
-            multiSolution.spaces().at(i)->save_bson(compatibleFilename(spaceFN).toStdString().c_str());
+
+            SolutionStoreWriter::Task task;
+            task.type = SolutionStoreWriter::Task::Task_Space;
+            task.fileName = spaceFN;
+            task.space = multiSolution.spaces().at(i);
+            m_writer->enqueue(task);
 
             fileNames[i].setSpaceFileName(QFileInfo(spaceFN).fileName());
         }
@@ -269,11 +716,12 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
         if (fileNames[i].solutionFileName().isEmpty())
         {
             QString solutionFN = QString("%1_%2.sln").arg(baseFN).arg(i);
-            // QTime time;
-            // time.start();
-            // dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save(solutionFN.toLatin1().data());
-            dynamic_cast<Hermes::Hermes2D::Solution<double> *>(multiSolution.solutions().at(i).get())->save_bson(compatibleFilename(solutionFN).toStdString().c_str());
-            // qDebug() << "SAVE" << time.elapsed();
+
+            SolutionStoreWriter::Task task;
+            task.type = SolutionStoreWriter::Task::Task_Solution;
+            task.fileName = solutionFN;
+            task.solution = multiSolution.solutions().at(i);
+            m_writer->enqueue(task);
 
             fileNames[i].setSolutionFileName(QFileInfo(solutionFN).fileName());
         }
@@ -286,14 +734,15 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
     // append properties
     m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
+    addMeshFileReferences(runTime);
 
     // insert to the cache
     insertMultiSolutionToCache(solutionID, multiSolution);
 
     //printDebugCacheStatus();
 
-    // save run time details to the file
-    saveRunTimeDetails();
+    // append run time details to the journal
+    appendRunTimeJournal(runTimeJournalRecord(solutionID, runTime));
 
     // save to the memory info (for debug purposes)
     // m_memoryInfos[solutionID] = tr1::shared_ptr<MemoryInfo>(new MemoryInfo(multiSolution));
@@ -301,20 +750,22 @@ void SolutionStore::addSolution(FieldSolutionID solutionID, MultiArray<double> m
 
 void SolutionStore::removeSolution(FieldSolutionID solutionID, bool saveRunTime)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     assert(m_multiSolutions.contains(solutionID));
 
+    // shared mesh files are removed with the last solution
+    QStringList unreferencedMeshFileNames = releaseMeshFileReferences(m_multiSolutionRunTimeDetails[solutionID]);
+
     // remove from list
     m_multiSolutions.removeOne(solutionID);
     // remove properties
     m_multiSolutionRunTimeDetails.remove(solutionID);
     // remove from cache
     if (m_multiSolutionCache.contains(solutionID))
-    {
-        // free ma
-        m_multiSolutionCache[solutionID].clear();
-        m_multiSolutionCache.remove(solutionID);
-        m_multiSolutionCacheIDOrder.removeOne(solutionID);
-    }
+        removeMultiSolutionFromCache(solutionID);
+    if (m_streamSolutionID == solutionID)
+        releaseStream();
 
     // remove old files
     QFileInfo info(Agros2D::problem()->config()->fileName());
@@ -324,9 +775,9 @@ void SolutionStore::removeSolution(FieldSolutionID solutionID, bool saveRunTime)
 
         for (int solutionIndex = 0; solutionIndex < solutionID.group->numberOfSolutions(); solutionIndex++)
         {
-            QString fnMesh = QString("%1_%2.msh").arg(fn).arg(solutionIndex);
-            if (QFile::exists(fnMesh))
-                QFile::remove(fnMesh);
+            // files could be still in the queue
+            m_writer->flush(QStringList() << QString("%1_%2.spc").arg(fn).arg(solutionIndex)
+                            << QString("%1_%2.sln").arg(fn).arg(solutionIndex));
 
             QString fnSpace = QString("%1_%2.spc").arg(fn).arg(solutionIndex);
             if (QFile::exists(fnSpace))
@@ -336,11 +787,23 @@ void SolutionStore::removeSolution(FieldSolutionID solutionID, bool saveRunTime)
             if (QFile::exists(fnSolution))
                 QFile::remove(fnSolution);
         }
+
+        foreach (QString meshFileName, unreferencedMeshFileNames)
+        {
+            QString fnMesh = QString("%1/%2").arg(cacheProblemDir()).arg(meshFileName);
+            m_writer->flush(QStringList() << fnMesh);
+            if (QFile::exists(fnMesh))
+                QFile::remove(fnMesh);
+        }
     }
 
-    // save structure to the file
+    // append remove record to the journal
     if (saveRunTime)
-        saveRunTimeDetails();
+        appendRunTimeJournal(QString("R\t%1\t%2\t%3\t%4").
+                             arg(solutionID.group->fieldId()).
+                             arg(solutionID.timeStep).
+                             arg(solutionID.adaptivityStep).
+                             arg(solutionTypeToStringKey(solutionID.solutionMode)));
 }
 
 void SolutionStore::addSolution(BlockSolutionID blockSolutionID, MultiArray<double> multiSolution, SolutionRunTimeDetails runTime)
@@ -366,6 +829,8 @@ void SolutionStore::removeSolution(BlockSolutionID solutionID)
 
 void SolutionStore::removeTimeStep(int timeStep)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     foreach (FieldSolutionID sid, m_multiSolutions)
     {
         if (sid.timeStep == timeStep)
@@ -376,6 +841,8 @@ void SolutionStore::removeTimeStep(int timeStep)
 
 int SolutionStore::lastTimeStep(const FieldInfo *fieldInfo, SolutionMode solutionType) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     int timeStep = NOT_FOUND_SO_FAR;
     foreach (FieldSolutionID sid, m_multiSolutions)
     {
@@ -415,6 +882,8 @@ MultiArray<double> SolutionStore::multiSolutionPreviousCalculatedTS(BlockSolutio
 
 int SolutionStore::nthCalculatedTimeStep(const FieldInfo *fieldInfo, int n) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     int count = 0;
     for(int step = 0; step <= lastTimeStep(fieldInfo, SolutionMode_Normal); step++)
     {
@@ -432,6 +901,8 @@ int SolutionStore::nthCalculatedTimeStep(const FieldInfo *fieldInfo, int n) cons
 
 int SolutionStore::nearestTimeStep(const FieldInfo *fieldInfo, int timeStep) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     int ts = timeStep;
     while (!this->contains(FieldSolutionID(fieldInfo, ts, 0, SolutionMode_Normal)))
     {
@@ -444,6 +915,8 @@ int SolutionStore::nearestTimeStep(const FieldInfo *fieldInfo, int timeStep) con
 
 double SolutionStore::lastTime(const FieldInfo *fieldInfo)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     int timeStep = lastTimeStep(fieldInfo, SolutionMode_Normal);
     double time = NOT_FOUND_SO_FAR;
 
@@ -476,6 +949,8 @@ double SolutionStore::lastTime(const Block *block)
 
 int SolutionStore::lastAdaptiveStep(const FieldInfo *fieldInfo, SolutionMode solutionType, int timeStep) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     if (timeStep == -1)
         timeStep = lastTimeStep(fieldInfo, solutionType);
 
@@ -503,6 +978,8 @@ int SolutionStore::lastAdaptiveStep(const Block *block, SolutionMode solutionTyp
 
 FieldSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const FieldInfo *fieldInfo, SolutionMode solutionType)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     FieldSolutionID solutionID;
     if (solutionType == SolutionMode_Finer) {
         FieldSolutionID solutionIDNormal = lastTimeAndAdaptiveSolution(fieldInfo, SolutionMode_Normal);
@@ -544,6 +1021,8 @@ BlockSolutionID SolutionStore::lastTimeAndAdaptiveSolution(const Block *block, S
 
 QList<double> SolutionStore::timeLevels(const FieldInfo *fieldInfo) const
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     QList<double> list;
 
     foreach(FieldSolutionID fsid, m_multiSolutions)
@@ -586,88 +1065,301 @@ void SolutionStore::insertMultiSolutionToCache(FieldSolutionID solutionID, Multi
 {
     if (!m_multiSolutionCache.contains(solutionID))
     {
-        // flush cache
-        if (m_multiSolutionCache.count() > Agros2D::configComputer()->value(Config::Config_CacheSize).toInt())
-        {
-            assert(! m_multiSolutionCacheIDOrder.empty());
-            FieldSolutionID idRemove = m_multiSolutionCacheIDOrder[0];
-            m_multiSolutionCacheIDOrder.removeFirst();
-
-            // free ma
-            m_multiSolutionCache[idRemove].clear();
-            m_multiSolutionCache.remove(idRemove);
-        }
+        qint64 size = multiArrayMemorySize(multiSolution);
 
         // add solution
         m_multiSolutionCache.insert(solutionID, multiSolution);
         m_multiSolutionCacheIDOrder.append(solutionID);
+        m_multiSolutionCacheMemorySize.insert(solutionID, size);
+        m_cacheMemorySize += size;
+
+        // flush cache
+        flushCache();
     }
 }
 
-void SolutionStore::loadRunTimeDetails()
+void SolutionStore::removeMultiSolutionFromCache(FieldSolutionID solutionID)
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    assert(m_multiSolutionCache.contains(solutionID));
 
-    try
+    // free ma
+    m_multiSolutionCache[solutionID].clear();
+    m_multiSolutionCache.remove(solutionID);
+    m_multiSolutionCacheIDOrder.removeOne(solutionID);
+    m_cacheMemorySize -= m_multiSolutionCacheMemorySize.take(solutionID);
+
+    removeUnusedMeshHashes();
+}
+
+QSharedPointer<MeshHash> SolutionStore::meshHash(Hermes::Hermes2D::MeshSharedPtr mesh)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    QSharedPointer<MeshHash> hash = m_meshHashes.value(mesh.get());
+
+    // mesh could be refined in place
+    if (hash.isNull() || hash->meshSeq() != mesh->get_seq())
+    {
+        hash = QSharedPointer<MeshHash>(new MeshHash(mesh));
+        m_meshHashes[mesh.get()] = hash;
+    }
+
+    return hash;
+}
+
+void SolutionStore::removeUnusedMeshHashes()
+{
+    // mesh is referenced only by its hash
+    QMutableMapIterator<Hermes::Hermes2D::Mesh *, QSharedPointer<MeshHash> > it(m_meshHashes);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.value()->mesh().use_count() == 1)
+            it.remove();
+    }
+}
+
+void SolutionStore::flushCache()
+{
+    qint64 memoryLimit = (qint64) Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt() * 1024 * 1024;
+
+    // least recently used solutions go first, the most recent one is always kept
+    int index = 0;
+    while ((m_cacheMemorySize > memoryLimit) && (index < m_multiSolutionCacheIDOrder.size() - 1))
+    {
+        FieldSolutionID idRemove = m_multiSolutionCacheIDOrder[index];
+        if (isPinned(idRemove))
+        {
+            index++;
+            continue;
+        }
+
+        removeMultiSolutionFromCache(idRemove);
+        m_cacheStatistics.evictions++;
+    }
+}
+
+bool SolutionStore::isPinned(FieldSolutionID solutionID) const
+{
+    foreach (QList<FieldSolutionID> pinned, m_multiSolutionCachePinned)
+        if (pinned.contains(solutionID))
+            return true;
+
+    return false;
+}
+
+void SolutionStore::pinSolution(const Block *block, FieldSolutionID solutionID)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    if (!m_multiSolutionCachePinned[block].contains(solutionID))
+        m_multiSolutionCachePinned[block].append(solutionID);
+}
+
+void SolutionStore::unpinSolutions(const Block *block)
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    m_multiSolutionCachePinned.remove(block);
+
+    // pinned solutions could exceed the limit
+    flushCache();
+}
+
+SolutionStore::CacheStatistics SolutionStore::cacheStatistics() const
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    CacheStatistics statistics = m_cacheStatistics;
+
+    statistics.entries = m_multiSolutionCache.count();
+    statistics.pinned = 0;
+    foreach (FieldSolutionID solutionID, m_multiSolutionCacheIDOrder)
+        if (isPinned(solutionID))
+            statistics.pinned++;
+    statistics.memorySize = m_cacheMemorySize;
+    statistics.memoryLimit = (qint64) Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt() * 1024 * 1024;
+
+    return statistics;
+}
+
+void SolutionStore::insertRunTimeDetails(FieldSolutionID solutionID, SolutionRunTimeDetails runTime, int &timeStep)
+{
+    // append multisolution
+    if (!m_multiSolutions.contains(solutionID))
+        m_multiSolutions.append(solutionID);
+
+    // TODO: remove "problem time step structures"
+    // define transient time step
+    if (solutionID.timeStep > timeStep)
     {
-        std::auto_ptr<XMLStructure::structure> structure_xsd = XMLStructure::structure_(compatibleFilename(fn).toStdString(), xml_schema::flags::dont_validate);
-        XMLStructure::structure *structure = structure_xsd.get();
+        // new time step
+        timeStep = solutionID.timeStep;
+
+        Agros2D::problem()->defineActualTimeStepLength(runTime.timeStepLength());
+    }
+
+    // append (or replace) run time details
+    if (m_multiSolutionRunTimeDetails.contains(solutionID))
+        releaseMeshFileReferences(m_multiSolutionRunTimeDetails[solutionID]);
+    m_multiSolutionRunTimeDetails.insert(solutionID, runTime);
+    addMeshFileReferences(runTime);
+}
 
-        int time_step = 0;
-        for (unsigned int i = 0; i < structure->element_data().size(); i++)
+void SolutionStore::loadRunTimeDetails()
+{
+    int timeStep = 0;
+
+    QString fn = QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_DETAILS);
+    if (QFile::exists(fn))
+    {
+        try
         {
-            XMLStructure::element_data data = structure->element_data().at(i);
-
-            // check field
-            if (!Agros2D::problem()->hasField(QString::fromStdString(data.field_id())))
-                throw AgrosException(QObject::tr("Field '%1' info mismatch.").arg(QString::fromStdString(data.field_id())));
-
-            FieldSolutionID solutionID(Agros2D::problem()->fieldInfo(QString::fromStdString(data.field_id())),
-                                       data.time_step(),
-                                       data.adaptivity_step(),
-                                       solutionTypeFromStringKey(QString::fromStdString(data.solution_type())));
-            // append multisolution
-            m_multiSolutions.append(solutionID);
-
-            // TODO: remove "problem time step structures"
-            // define transient time step
-            if (data.time_step() > time_step)
+            std::auto_ptr<XMLStructure::structure> structure_xsd = XMLStructure::structure_(compatibleFilename(fn).toStdString(), xml_schema::flags::dont_validate);
+            XMLStructure::structure *structure = structure_xsd.get();
+
+            for (unsigned int i = 0; i < structure->element_data().size(); i++)
             {
-                // new time step
-                time_step = data.time_step();
+                XMLStructure::element_data data = structure->element_data().at(i);
+
+                // check field
+                if (!Agros2D::problem()->hasField(QString::fromStdString(data.field_id())))
+                    throw AgrosException(QObject::tr("Field '%1' info mismatch.").arg(QString::fromStdString(data.field_id())));
+
+                FieldSolutionID solutionID(Agros2D::problem()->fieldInfo(QString::fromStdString(data.field_id())),
+                                           data.time_step(),
+                                           data.adaptivity_step(),
+                                           solutionTypeFromStringKey(QString::fromStdString(data.solution_type())));
+
+                QList<SolutionRunTimeDetails::FileName> fileNames;
+                for (int j = 0; j < data.files().file().size(); j++)
+                {
+                    XMLStructure::file file = data.files().file().at(j);
+
+                    fileNames.append(SolutionRunTimeDetails::FileName(QString::fromStdString(file.mesh_filename()),
+                                                                      QString::fromStdString(file.space_filename()),
+                                                                      QString::fromStdString(file.solution_filename())));
+                }
+
+                SolutionRunTimeDetails runTime(data.time_step_length().get(),
+                                               data.adaptivity_error().get(),
+                                               data.dofs().get());
+                runTime.setFileNames(fileNames);
 
-                Agros2D::problem()->defineActualTimeStepLength(data.time_step_length().get());
+                insertRunTimeDetails(solutionID, runTime, timeStep);
             }
+        }
+        catch (const xml_schema::exception& e)
+        {
+            std::cerr << e << std::endl;
+        }
+    }
+
+    // records written after the last compaction
+    replayRunTimeJournal(timeStep);
+}
+
+void SolutionStore::replayRunTimeJournal(int &timeStep)
+{
+    QFile file(QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_JOURNAL));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        QStringList record = in.readLine().split("\t");
+
+        // incomplete record (interrupted write)
+        if ((record.size() < 5) || ((record[0] == "A") && (record.size() < 13)))
+            continue;
+
+        // check field
+        if (!Agros2D::problem()->hasField(record[1]))
+            throw AgrosException(QObject::tr("Field '%1' info mismatch.").arg(record[1]));
 
+        FieldSolutionID solutionID(Agros2D::problem()->fieldInfo(record[1]),
+                                   record[2].toInt(),
+                                   record[3].toInt(),
+                                   solutionTypeFromStringKey(record[4]));
+
+        if (record[0] == "A")
+        {
             QList<SolutionRunTimeDetails::FileName> fileNames;
-            for (int j = 0; j < data.files().file().size(); j++)
+            foreach (QString files, record[9].split(";", QString::SkipEmptyParts))
             {
-                XMLStructure::file file = data.files().file().at(j);
-
-                fileNames.append(SolutionRunTimeDetails::FileName(QString::fromStdString(file.mesh_filename()),
-                                                                  QString::fromStdString(file.space_filename()),
-                                                                  QString::fromStdString(file.solution_filename())));
+                QStringList fileName = files.split("|");
+                if (fileName.size() == 3)
+                    fileNames.append(SolutionRunTimeDetails::FileName(fileName[0], fileName[1], fileName[2]));
             }
 
-            SolutionRunTimeDetails runTime(data.time_step_length().get(),
-                                           data.adaptivity_error().get(),
-                                           data.dofs().get());
+            SolutionRunTimeDetails runTime(record[5].toDouble(),
+                                           record[6].toDouble(),
+                                           record[7].toInt());
+            runTime.setJacobianCalculations(record[8].toInt());
             runTime.setFileNames(fileNames);
+            runTime.setNewtonResidual(doubleVectorFromString(record[10]));
+            runTime.setNonlinearDamping(doubleVectorFromString(record[11]));
+            runTime.setRelativeChangeOfSolutions(doubleVectorFromString(record[12]));
 
-            // append run time details
-            m_multiSolutionRunTimeDetails.insert(solutionID,
-                                                 runTime);
+            insertRunTimeDetails(solutionID, runTime, timeStep);
+        }
+        else if (record[0] == "R")
+        {
+            if (m_multiSolutionRunTimeDetails.contains(solutionID))
+                releaseMeshFileReferences(m_multiSolutionRunTimeDetails[solutionID]);
+            m_multiSolutions.removeOne(solutionID);
+            m_multiSolutionRunTimeDetails.remove(solutionID);
         }
     }
-    catch (const xml_schema::exception& e)
+}
+
+void SolutionStore::appendRunTimeJournal(const QString &record)
+{
+    if (!m_runTimeJournal.isOpen())
     {
-        std::cerr << e << std::endl;
+        m_runTimeJournal.setFileName(QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_JOURNAL));
+        if (!m_runTimeJournal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        {
+            Agros2D::log()->printError(QObject::tr("Solver"), QObject::tr("Access denied '%1'").arg(m_runTimeJournal.fileName()));
+            return;
+        }
+    }
+
+    m_runTimeJournal.write(QString("%1\n").arg(record).toUtf8());
+    m_runTimeJournal.flush();
+
+    // batched sync
+    if (++m_runTimeJournalUnsynced >= RUNTIME_JOURNAL_SYNC_INTERVAL)
+        syncRunTimeJournal();
+}
+
+void SolutionStore::syncRunTimeJournal()
+{
+    if (!m_runTimeJournal.isOpen())
+        return;
+
+    m_runTimeJournal.flush();
+#ifdef Q_OS_WIN
+    _commit(m_runTimeJournal.handle());
+#else
+    fsync(m_runTimeJournal.handle());
+#endif
+    m_runTimeJournalUnsynced = 0;
+}
+
+void SolutionStore::closeRunTimeJournal()
+{
+    if (m_runTimeJournal.isOpen())
+    {
+        syncRunTimeJournal();
+        m_runTimeJournal.close();
     }
 }
 
 void SolutionStore::saveRunTimeDetails()
 {
-    QString fn = QString("%1/runtime.xml").arg(cacheProblemDir());
+    QString fn = QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_DETAILS);
 
     try
     {
@@ -729,15 +1421,35 @@ void SolutionStore::saveRunTimeDetails()
     catch (const xml_schema::exception& e)
     {
         std::cerr << e << std::endl;
+        return;
     }
+
+    // all records are in runtime.xml now
+    closeRunTimeJournal();
+    QString fnJournal = QString("%1/%2").arg(cacheProblemDir()).arg(RUNTIME_JOURNAL);
+    if (QFile::exists(fnJournal))
+        QFile::remove(fnJournal);
+}
+
+SolutionStore::SolutionRunTimeDetails SolutionStore::multiSolutionRunTimeDetail(FieldSolutionID solutionID) const
+{
+    QMutexLocker locker(&m_cacheMutex);
+
+    assert(m_multiSolutionRunTimeDetails.contains(solutionID));
+
+    return m_multiSolutionRunTimeDetails[solutionID];
 }
 
 void SolutionStore::multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID, SolutionRunTimeDetails runTime)
 {
+    QMutexLocker locker(&m_cacheMutex);
+
     assert(m_multiSolutionRunTimeDetails.contains(solutionID));
+    releaseMeshFileReferences(m_multiSolutionRunTimeDetails[solutionID]);
     m_multiSolutionRunTimeDetails[solutionID] = runTime;
+    addMeshFileReferences(runTime);
 
-    // save structure to the file
-    saveRunTimeDetails();
+    // append run time details to the journal (replaces previous record)
+    appendRunTimeJournal(runTimeJournalRecord(solutionID, runTime));
 }
 
@@ -21,10 +21,79 @@
 #define SOLUTIONSTORE_H
 
 #include "solutiontypes.h"
+#include "solutioncontainer.h"
+
+class MeshHash;
+
+// background serialization of meshes, spaces and solutions
+class SolutionStoreWriter
+{
+public:
+    struct Task
+    {
+        enum Type
+        {
+            Task_Mesh,
+            Task_Space,
+            Task_Solution
+        };
+
+        Task() : type(Task_Mesh) {}
+
+        Type type;
+        QString fileName;
+
+        Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes;
+        Hermes::Hermes2D::SpaceSharedPtr<double> space;
+        Hermes::Hermes2D::MeshFunctionSharedPtr<double> solution;
+    };
+
+    SolutionStoreWriter(int numberOfThreads, int queueSize);
+    ~SolutionStoreWriter();
+
+    // blocks while the queue is full (back-pressure)
+    void enqueue(const Task &task);
+
+    // waits until all tasks are written
+    void flush();
+    // waits until the given files are written
+    void flush(const QStringList &fileNames);
+    inline bool isPending(const QString &fileName) { QMutexLocker locker(&m_mutex); return m_pending.contains(fileName); }
+
+private:
+    class WorkerThread : public QThread
+    {
+    public:
+        WorkerThread(SolutionStoreWriter *writer) : QThread(), m_writer(writer) {}
+
+    protected:
+        virtual void run() { m_writer->process(); }
+
+    private:
+        SolutionStoreWriter *m_writer;
+    };
+
+    QList<WorkerThread *> m_threads;
+    int m_queueSize;
+
+    QMutex m_mutex;
+    QWaitCondition m_queueNotEmpty;
+    QWaitCondition m_queueNotFull;
+    QWaitCondition m_taskFinished;
+
+    QList<Task> m_queue;
+    QSet<QString> m_pending;
+    int m_running;
+    bool m_stop;
+
+    void process();
+    void write(const Task &task);
+};
 
 class AGROS_LIBRARY_API SolutionStore
 {
 public:
+    SolutionStore();
     ~SolutionStore();
 
     class SolutionRunTimeDetails
@@ -88,6 +157,20 @@ public:
         QVector<double> m_nonlinearDamping;
     };
 
+    struct CacheStatistics
+    {
+        CacheStatistics() : hits(0), misses(0), evictions(0), entries(0), pinned(0), memorySize(0), memoryLimit(0) {}
+
+        long long hits;
+        long long misses;
+        long long evictions;
+        long long entries;
+        long long pinned;
+        // bytes
+        long long memorySize;
+        long long memoryLimit;
+    };
+
     bool contains(FieldSolutionID solutionID) const;
     MultiArray<double> multiArray(FieldSolutionID solutionID);
     MultiArray<double> multiArray(BlockSolutionID solutionID);
@@ -128,30 +211,95 @@ public:
     FieldSolutionID lastTimeAndAdaptiveSolution(const FieldInfo* fieldInfo, SolutionMode solutionType);
     BlockSolutionID lastTimeAndAdaptiveSolution(const Block *block, SolutionMode solutionType);
 
+    // reads runtime.xml and replays the run time journal
     void loadRunTimeDetails();
+    // writes runtime.xml and truncates the run time journal (compaction)
+    void saveRunTimeDetails();
 
-    SolutionRunTimeDetails multiSolutionRunTimeDetail(FieldSolutionID solutionID) const { assert(m_multiSolutionRunTimeDetails.contains(solutionID)); return m_multiSolutionRunTimeDetails[solutionID]; }
+    SolutionRunTimeDetails multiSolutionRunTimeDetail(FieldSolutionID solutionID) const;
     void multiSolutionRunTimeDetailReplace(FieldSolutionID solutionID, SolutionRunTimeDetails runTime);
 
     inline bool isEmpty() const { return m_multiSolutions.isEmpty(); }
     void clearAll();
 
+    // pinned solutions are never evicted from the cache (e.g. previous time levels used by BDF)
+    void pinSolution(const Block *block, FieldSolutionID solutionID);
+    void unpinSolutions(const Block *block);
+
+    CacheStatistics cacheStatistics() const;
+
+    // time series extraction, solution is read into a single slot outside the cache (cached solutions are not evicted)
+    // mesh and space of the previous slot are reused if their file names are unchanged
+    void streamSolution(FieldSolutionID solutionID);
+    void releaseStream();
+
+    // barrier, all queued meshes, spaces and solutions are written to the disk
+    void flush();
+
+    // meshes, spaces and solutions are extracted from the container on demand
+    bool openContainer(const QString &fileName);
+    // extracts remaining entries and closes the container
+    void detachContainer();
+
+    // point location, built once per mesh and shared by postprocessing and particle tracing
+    QSharedPointer<MeshHash> meshHash(Hermes::Hermes2D::MeshSharedPtr mesh);
+
     void printDebugCacheStatus();
 
 private:
     QList<FieldSolutionID> m_multiSolutions;
     QMap<FieldSolutionID, SolutionRunTimeDetails> m_multiSolutionRunTimeDetails;
     QMap<FieldSolutionID, MultiArray<double> > m_multiSolutionCache;
+    // least recently used first
     QList<FieldSolutionID> m_multiSolutionCacheIDOrder;
+    QMap<FieldSolutionID, qint64> m_multiSolutionCacheMemorySize;
+    QMap<const Block *, QList<FieldSolutionID> > m_multiSolutionCachePinned;
+    qint64 m_cacheMemorySize;
+    CacheStatistics m_cacheStatistics;
+    // store is accessed from parallel postprocessing (particle tracing) and from concurrently solved blocks
+    mutable QMutex m_cacheMutex;
+
+    SolutionStoreWriter *m_writer;
+    SolutionContainer m_container;
+
+    FieldSolutionID m_streamSolutionID;
+    MultiArray<double> m_streamMultiArray;
+
+    // reads mesh, space and solution files (mesh and space are reused from the cache or time series slot)
+    MultiArray<double> readMultiArray(FieldSolutionID solutionID);
+
+    void extractFromContainer(const QStringList &fileNames);
+
+    QMap<Hermes::Hermes2D::Mesh *, QSharedPointer<MeshHash> > m_meshHashes;
+    void removeUnusedMeshHashes();
 
     void addSolution(FieldSolutionID solutionID, MultiArray<double> multiArray, SolutionRunTimeDetails runTime);
     void removeSolution(FieldSolutionID solutionID, bool saveRunTime = true);
 
     void insertMultiSolutionToCache(FieldSolutionID solutionID, MultiArray<double> multiArray);
+    void removeMultiSolutionFromCache(FieldSolutionID solutionID);
+    void flushCache();
+    bool isPinned(FieldSolutionID solutionID) const;
 
     QString baseStoreFileName(FieldSolutionID solutionID) const;
-
-    void saveRunTimeDetails();
+    // content addressed mesh file (shared by solutions, spaces and time steps)
+    QString meshStoreFileName(Hermes::Hermes2D::MeshSharedPtr mesh) const;
+    // number of solutions referencing the mesh file, the file is removed with the last reference
+    QMap<QString, int> m_meshFileReferences;
+    void addMeshFileReferences(const SolutionRunTimeDetails &runTime);
+    // returns mesh files without reference
+    QStringList releaseMeshFileReferences(const SolutionRunTimeDetails &runTime);
+
+    // append-only journal, one record per add, replace or remove
+    QFile m_runTimeJournal;
+    int m_runTimeJournalUnsynced;
+
+    void appendRunTimeJournal(const QString &record);
+    void syncRunTimeJournal();
+    void closeRunTimeJournal();
+    void replayRunTimeJournal(int &timeStep);
+
+    void insertRunTimeDetails(FieldSolutionID solutionID, SolutionRunTimeDetails runTime, int &timeStep);
 };
 
 #endif // SOLUTIONSTORE_H
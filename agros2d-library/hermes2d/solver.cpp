@@ -39,8 +39,11 @@
 #include "plugin_interface.h"
 #include "logview.h"
 #include "bdf2.h"
+#include "solver_daemon.h"
 #include "plugin_interface.h"
 #include "weak_form.h"
+#include "coupling.h"
+#include "parser/lex.h"
 
 #include "pythonlab/pythonengine.h"
 
@@ -61,7 +64,7 @@ Hermes::Solvers::ExternalSolver<double>* getExternalSolver(CSCMatrix<double> *m,
 }
 
 AgrosExternalSolverExternal::AgrosExternalSolverExternal(CSCMatrix<double> *m, SimpleVector<double> *rhs)
-    : ExternalSolver<double>(m, rhs), initialGuess(NULL)
+    : ExternalSolver<double>(m, rhs), initialGuess(NULL), m_clientId(ExternalSolverDaemon::nextClientId())
 {
 }
 
@@ -74,6 +77,10 @@ void AgrosExternalSolverExternal::solve(double* initial_guess)
 {
     initialGuess = initial_guess;
 
+    if (solveDaemon())
+        return;
+
+    // exchange through files and a new process
     fileMatrix = QString("%1/solver_matrix").arg(cacheProblemDir());
     fileRHS = QString("%1/solver_rhs").arg(cacheProblemDir());
     fileInitial = QString("%1/solver_initial").arg(cacheProblemDir());
@@ -160,6 +167,41 @@ void AgrosExternalSolverExternal::solve(double* initial_guess)
     QFile::remove(tempProblemDir() + "/solver.err");
 }
 
+bool AgrosExternalSolverExternal::solveDaemon()
+{
+    if (!Agros2D::configComputer()->value(Config::Config_ExternalSolverDaemon).toBool())
+        return false;
+
+    ExternalSolverDaemon *daemon = ExternalSolverDaemon::daemon(solverName());
+    if (!daemon)
+        return false;
+
+    ExternalSolverBuffer::Reuse reuse = ExternalSolverBuffer::Reuse_None;
+    if (this->reuse_scheme == HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY)
+        reuse = ExternalSolverBuffer::Reuse_Matrix;
+    else if ((this->reuse_scheme == HERMES_REUSE_MATRIX_REORDERING) || (this->reuse_scheme == HERMES_REUSE_MATRIX_REORDERING_AND_SCALING))
+        reuse = ExternalSolverBuffer::Reuse_Pattern;
+
+    double *solution = new double[this->rhs->get_size()];
+
+    QString error;
+    if (!daemon->solve(m_clientId, this->m, this->rhs->v, solution, reuse, error))
+    {
+        Agros2D::log()->printWarning(tr("External solver"), error);
+        delete [] solution;
+        return false;
+    }
+
+    delete [] this->sln;
+    this->sln = solution;
+
+    if (!(Agros2D::problem()->isTransient() || Agros2D::problem()->isNonlinear()))
+        this->m->free();
+    this->rhs->free();
+
+    return true;
+}
+
 void AgrosExternalSolverExternal::processError(QProcess::ProcessError error)
 {
     Agros2D::log()->printError(tr("Solver"), tr("Could not start external solver"));
@@ -458,39 +500,273 @@ void ProblemSolver<Scalar>::clearActualSpaces()
     m_actualSpaces.clear();
 }
 
+// structure of spaces (active elements and their orders), equal structures give the same sparsity pattern
+template <typename Scalar>
+static QByteArray spacesStructure(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    for (unsigned int comp = 0; comp < spaces.size(); comp++)
+    {
+        int ndof = spaces.at(comp)->get_num_dofs();
+        hash.addData((const char *) &ndof, sizeof(int));
+
+        Element *e;
+        for_all_active_elements(e, spaces.at(comp)->get_mesh())
+        {
+            int data[2] = { e->id, spaces.at(comp)->get_element_order(e->id) };
+            hash.addData((const char *) data, sizeof(data));
+        }
+    }
+
+    return hash.result();
+}
+
+static void markerValuesHash(QCryptographicHash &hash, const Marker *marker, double time, const QStringList &matrixIds)
+{
+    QStringList ids = marker->values().keys();
+    ids.sort();
+
+    foreach (QString id, ids)
+    {
+        if (!matrixIds.contains(id))
+            continue;
+
+        QSharedPointer<Value> value = marker->value(id);
+        hash.addData(id.toUtf8());
+        hash.addData(value->toString().toUtf8());
+
+        if (value->isTimeDependent())
+        {
+            double number = value->numberAtTime(time);
+            hash.addData((const char *) &number, sizeof(double));
+        }
+    }
+}
+
+// variables of the matrix volume forms of the block (false if some expression could not be parsed)
+static bool matrixFormVariables(Block *block, QSet<QString> &variables)
+{
+    QList<FormInfo> forms;
+    foreach (FieldInfo *fieldInfo, block->fieldInfos())
+        forms.append(WeakFormAgros<double>::wfMatrixVolumeSeparated(fieldInfo->plugin()->module(), fieldInfo->analysisType(), fieldInfo->linearityType()));
+
+    foreach (CouplingInfo *couplingInfo, block->couplings())
+        if (couplingInfo->isHard())
+            forms.append(couplingInfo->wfMatrixVolumeSeparated(&couplingInfo->plugin()->coupling()->volume(),
+                                                               couplingInfo->sourceField()->analysisType(),
+                                                               couplingInfo->targetField()->analysisType(),
+                                                               couplingInfo->couplingType(),
+                                                               couplingInfo->linearityType()));
+
+    foreach (FormInfo form, forms)
+    {
+        foreach (QString expression, QStringList() << form.expr_planar << form.expr_axi << form.condition)
+        {
+            LexicalAnalyser lex;
+            try
+            {
+                lex.setExpression(expression);
+            }
+            catch (ParserException &e)
+            {
+                return false;
+            }
+
+            foreach (Token token, lex.tokens())
+                if (token.type() == ParserTokenType_VARIABLE)
+                    variables.insert(token.toString());
+        }
+    }
+
+    return true;
+}
+
+// inputs the matrix depends on (spaces, material and boundary values at the actual time, time step length)
+template <typename Scalar>
+static QByteArray matrixInputs(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces, const QByteArray &markerValuesInputs)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(spacesStructure(spaces));
+    hash.addData(markerValuesInputs);
+
+    double timeStepLength = Agros2D::problem()->actualTimeStepLength();
+    hash.addData((const char *) &timeStepLength, sizeof(double));
+
+    return hash.result();
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::updateMarkerValuesInputs()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // sources (e.g. time dependent volume heat) change the right hand side only
+    QSet<QString> variables;
+    bool allMaterialValues = !matrixFormVariables(m_block, variables);
+
+    double time = Agros2D::problem()->actualTime();
+    foreach (FieldInfo *fieldInfo, m_block->fieldInfos())
+    {
+        QStringList materialIds;
+        foreach (XMLModule::quantity quantity, fieldInfo->plugin()->module()->volume().quantity())
+            if (allMaterialValues || (quantity.shortname().present() && variables.contains(QString::fromStdString(quantity.shortname().get()))))
+                materialIds.append(QString::fromStdString(quantity.id()));
+
+        foreach (SceneMaterial *material, Agros2D::scene()->materials->filter(fieldInfo).items())
+            markerValuesHash(hash, material, time, materialIds);
+
+        // values of boundaries without matrix forms change the right hand side only (as in Problem::sweepInvalidation)
+        foreach (SceneBoundary *boundary, Agros2D::scene()->boundaries->filter(fieldInfo).items())
+        {
+            hash.addData(boundary->type().toUtf8());
+            if (!fieldInfo->boundaryType(boundary->type()).wfMatrixSurface().isEmpty())
+                markerValuesHash(hash, boundary, time, boundary->values().keys());
+        }
+    }
+
+    m_markerValuesInputs = hash.result();
+}
+
+template <typename Scalar>
+bool ProblemSolver<Scalar>::isMatrixUnchanged(bool unchangedDueToBDF, Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces)
+{
+    // matrix of nonlinear problems and of problems with weak couplings depends on the solution
+    if (m_block->matrixReuseType() != MatrixReuseType_Factorization
+            || m_block->linearityType() != LinearityType_Linear
+            || !m_block->sourceFieldInfosCoupling().isEmpty())
+    {
+        m_matrixInputs.clear();
+        return false;
+    }
+
+    QByteArray inputs = matrixInputs(spaces, m_markerValuesInputs);
+    bool unchanged = unchangedDueToBDF && (inputs == m_matrixInputs);
+    m_matrixInputs = inputs;
+
+    return unchanged;
+}
+
 template <typename Scalar>
 Scalar *ProblemSolver<Scalar>::solveOneProblem(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces,
                                                int adaptivityStep,
-                                               Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution)
+                                               Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution,
+                                               bool nonlinearInitialGuess)
 {
     LinearMatrixSolver<Scalar> *linearSolver = m_hermesSolverContainer->linearSolver();
 
-    if (m_block->isTransient())
-        linearSolver->set_reuse_scheme(HERMES_REUSE_MATRIX_REORDERING);
+    // factorization (and preconditioner of iterative solvers) is kept if the matrix is unchanged
+    MatrixReuseType matrixReuse = m_block->matrixReuseType();
+    if (matrixReuse == MatrixReuseType_None)
+        linearSolver->set_reuse_scheme(HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+    else if (m_block->isTransient())
+        linearSolver->set_reuse_scheme(m_matrixUnchanged ? HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY
+                                                         : HERMES_REUSE_MATRIX_REORDERING);
 
     m_hermesSolverContainer->setMatrixRhsOutput(m_solverCode, adaptivityStep);
 
-    if (LoopSolver<Scalar> *iterLinearSolver = dynamic_cast<LoopSolver<Scalar> *>(linearSolver))
+    LoopSolver<Scalar> *iterLinearSolver = dynamic_cast<LoopSolver<Scalar> *>(linearSolver);
+
+    // initial guess (direct solvers of linear problems do not need it)
+    Scalar *initialSolutionVector = NULL;
+    if (iterLinearSolver || (nonlinearInitialGuess && !previousSolution.empty() && m_block->linearityType() != LinearityType_Linear))
     {
-        // iterative solver
-        Scalar *initialSolutionVector = new Scalar[Hermes::Hermes2D::Space<Scalar>::get_num_dofs(spaces)];
+        initialSolutionVector = new Scalar[Hermes::Hermes2D::Space<Scalar>::get_num_dofs(spaces)];
         m_hermesSolverContainer->projectPreviousSolution(initialSolutionVector, spaces, previousSolution);
-        m_hermesSolverContainer->solve(initialSolutionVector);
+    }
+
+    m_hermesSolverContainer->solve(initialSolutionVector);
 
+    if (initialSolutionVector)
         delete [] initialSolutionVector;
 
+    if (iterLinearSolver)
+    {
+        // iterative solver
         Agros2D::log()->printDebug(QObject::tr("Solver"),
                                    QObject::tr("Iterative solver statistics: %1 iterations, residual %2")
                                    .arg(iterLinearSolver->get_num_iters())
                                    .arg(iterLinearSolver->get_residual_norm()));
     }
-    else
+
+    return m_hermesSolverContainer->slnVector();
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::clearTimeHistory()
+{
+    m_timeHistoryTimes.clear();
+    m_timeHistoryVectors.clear();
+    m_timeHistoryStructure.clear();
+}
+
+template <typename Scalar>
+void ProblemSolver<Scalar>::appendTimeHistory(const Scalar *solutionVector)
+{
+    // solutions on different spaces cannot be combined
+    QByteArray structure = spacesStructure(actualSpaces());
+    if (structure != m_timeHistoryStructure)
     {
-        // direct solver
-        m_hermesSolverContainer->solve(nullptr);
+        clearTimeHistory();
+        m_timeHistoryStructure = structure;
     }
 
-    return m_hermesSolverContainer->slnVector();
+    int ndof = Hermes::Hermes2D::Space<Scalar>::get_num_dofs(actualSpaces());
+    QVector<Scalar> vector(ndof);
+    for (int i = 0; i < ndof; i++)
+        vector[i] = solutionVector[i];
+
+    m_timeHistoryTimes.append(Agros2D::problem()->actualTime());
+    m_timeHistoryVectors.append(vector);
+
+    // actual level and order + 1 previous levels
+    while (m_timeHistoryVectors.size() > Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt() + 2)
+    {
+        m_timeHistoryTimes.removeFirst();
+        m_timeHistoryVectors.removeFirst();
+    }
+}
+
+template <typename Scalar>
+bool ProblemSolver<Scalar>::embeddedTimeError(int order, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions, double &error)
+{
+    if (m_timeHistoryVectors.size() < order + 2)
+        return false;
+
+    int last = m_timeHistoryVectors.size() - 1;
+    int first = last - order - 1;
+    double time = m_timeHistoryTimes.at(last);
+    int ndof = m_timeHistoryVectors.at(last).size();
+
+    // predictor (Lagrange extrapolation of previous levels to the actual time)
+    Scalar *predictorVector = new Scalar[ndof];
+    for (int k = 0; k < ndof; k++)
+        predictorVector[k] = 0.0;
+
+    for (int i = first; i < last; i++)
+    {
+        double weight = 1.0;
+        for (int j = first; j < last; j++)
+            if (j != i)
+                weight *= (time - m_timeHistoryTimes.at(j)) / (m_timeHistoryTimes.at(i) - m_timeHistoryTimes.at(j));
+
+        const QVector<Scalar> &vector = m_timeHistoryVectors.at(i);
+        for (int k = 0; k < ndof; k++)
+            predictorVector[k] += weight * vector.at(k);
+    }
+
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > predictor = createSolutions<Scalar>(spacesMeshes(actualSpaces()));
+    Solution<Scalar>::vector_to_solutions(predictorVector, actualSpaces(), predictor);
+    delete [] predictorVector;
+
+    DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, predictor.size());
+    errorCalculator.calculate_errors(solutions, predictor, false);
+
+    // local error of the corrector is the scaled corrector - predictor difference
+    double factor = (time - m_timeHistoryTimes.at(last - 1)) / (time - m_timeHistoryTimes.at(first));
+    error = factor * factor * errorCalculator.get_total_error_squared();
+
+    return true;
 }
 
 template <typename Scalar>
@@ -521,10 +797,8 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
     {
         int order = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
         bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(order, Agros2D::problem()->timeStepLengths());
-        m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
-
-        // update timedep values
-        Module::updateTimeFunctions(Agros2D::problem()->actualTime());
+        m_matrixUnchanged = isMatrixUnchanged(matrixUnchanged, actualSpaces());
+        m_hermesSolverContainer->matrixUnchangedDueToBDF(m_matrixUnchanged);
     }
 
     m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
@@ -535,6 +809,11 @@ void ProblemSolver<Scalar>::solveSimple(int timeStep, int adaptivityStep)
         Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep,
                                                  previousTSMultiSolutionArray.solutions());
 
+        if (m_block->isTransient()
+                && ((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) != TimeStepMethod_Fixed
+                && ((TimeErrorEstimator) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimator).toInt()) == TimeErrorEstimator_Embedded)
+            appendTimeHistory(solutionVector);
+
         // output
         Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(spacesMeshes(actualSpaces()));
         Solution<Scalar>::vector_to_solutions(solutionVector, actualSpaces(), solutions);
@@ -588,28 +867,37 @@ TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int ada
     }
 
     int previouslyUsedOrder = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
-    bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(previouslyUsedOrder - 1, Agros2D::problem()->timeStepLengths());
-    // using different order
-    assert(matrixUnchanged == false);
-    m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
-    m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
-    m_block->weakForm()->updateExtField();
 
-    // solutions obtained by time method of higher order in the original calculation
-    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > timeReferenceSolution;
-    if(timeStep > 0)
-        timeReferenceSolution = referenceCalculation.solutions();
-    Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep, timeReferenceSolution);
+    // embedded estimator does not need another solution, lower order solution is used until the history is long enough
+    double error = 0.0;
+    TimeErrorEstimator timeErrorEstimator = (TimeErrorEstimator) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimator).toInt();
+    if (!(timeErrorEstimator == TimeErrorEstimator_Embedded && embeddedTimeError(previouslyUsedOrder, referenceCalculation.solutions(), error)))
+    {
+        bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(previouslyUsedOrder - 1, Agros2D::problem()->timeStepLengths());
+        // using different order
+        assert(matrixUnchanged == false);
+        m_matrixUnchanged = false;
+        m_matrixInputs.clear();
+        m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
+        m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
+        m_block->weakForm()->updateExtField();
 
-    Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes = spacesMeshes(actualSpaces());
-    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(meshes);
-    Solution<Scalar>::vector_to_solutions(solutionVector, actualSpaces(), solutions);
+        // solutions obtained by time method of higher order in the original calculation
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > timeReferenceSolution;
+        if(timeStep > 0)
+            timeReferenceSolution = referenceCalculation.solutions();
+        Scalar *solutionVector = solveOneProblem(actualSpaces(), adaptivityStep, timeReferenceSolution);
 
-    // error calculation
-    DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, solutions.size());
-    // calculate error the total error estimate.
-    errorCalculator.calculate_errors(referenceCalculation.solutions(), solutions, false);
-    double error = errorCalculator.get_total_error_squared();
+        Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshes = spacesMeshes(actualSpaces());
+        Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions = createSolutions<Scalar>(meshes);
+        Solution<Scalar>::vector_to_solutions(solutionVector, actualSpaces(), solutions);
+
+        // error calculation
+        DefaultErrorCalculator<double, HERMES_H1_NORM> errorCalculator(RelativeErrorToGlobalNorm, solutions.size());
+        // calculate error the total error estimate.
+        errorCalculator.calculate_errors(referenceCalculation.solutions(), solutions, false);
+        error = errorCalculator.get_total_error_squared();
+    }
 
     // update
     double actualRatio = error / Agros2D::problem()->actualTimeStepLength();
@@ -659,8 +947,17 @@ TimeStepInfo ProblemSolver<Scalar>::estimateTimeStepLength(int timeStep, int ada
                                arg(nextTimeStepLength / Agros2D::problem()->actualTimeStepLength()*100.).
                                arg(m_averageErrorToLenghtRatio));
     if(refuseThisStep)
+    {
         Agros2D::log()->printMessage(m_solverID, "Transient step refused");
 
+        // refused level is solved again
+        if (!m_timeHistoryVectors.isEmpty() && m_timeHistoryTimes.last() == Agros2D::problem()->actualTime())
+        {
+            m_timeHistoryTimes.removeLast();
+            m_timeHistoryVectors.removeLast();
+        }
+    }
+
     return TimeStepInfo(nextTimeStepLength, refuseThisStep);
 }
 
@@ -794,20 +1091,18 @@ void ProblemSolver<Scalar>::solveReferenceAndProject(int timeStep, int adaptivit
         throw(AgrosSolverException(QObject::tr("DOF is zero")));
     }
 
-    // update timedep values
-    foreach (Field* field, m_block->fields())
-        Module::updateTimeFunctions(Agros2D::problem()->actualTime());
+    // timedep values are updated once per time step (Problem::solve)
     m_block->updateExactSolutionFunctions();
 
     // todo: delete? delam to pro referencni... (zkusit)
     Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces = actualSpaces();
     Hermes::Hermes2D::Space<Scalar>::update_essential_bc_values(spaces, Agros2D::problem()->actualTime());
 
+    bool matrixUnchanged = false;
     if (m_block->isTransient())
     {
         int order = min(timeStep, Agros2D::problem()->config()->value(ProblemConfig::TimeOrder).toInt());
-        bool matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(order, Agros2D::problem()->timeStepLengths());
-        m_hermesSolverContainer->matrixUnchangedDueToBDF(matrixUnchanged);
+        matrixUnchanged = m_block->weakForm()->bdf2Table()->setOrderAndPreviousSteps(order, Agros2D::problem()->timeStepLengths());
     }
 
     m_block->weakForm()->set_current_time(Agros2D::problem()->actualTime());
@@ -817,6 +1112,14 @@ void ProblemSolver<Scalar>::solveReferenceAndProject(int timeStep, int adaptivit
     Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spacesRef = deepMeshAndSpaceCopy(actualSpaces(), true);
     assert(actualSpaces().size() == spacesRef.size());
 
+    // matrix is assembled on the reference spaces
+    if (m_block->isTransient())
+    {
+        updateMarkerValuesInputs();
+        m_matrixUnchanged = isMatrixUnchanged(matrixUnchanged, spacesRef);
+        m_hermesSolverContainer->matrixUnchangedDueToBDF(m_matrixUnchanged);
+    }
+
     // todo: delete? je to vubec potreba?
     Hermes::Hermes2D::Space<Scalar>::update_essential_bc_values(spacesRef, Agros2D::problem()->actualTime());
 
@@ -824,8 +1127,20 @@ void ProblemSolver<Scalar>::solveReferenceAndProject(int timeStep, int adaptivit
 
     // in adaptivity, in each step we use different spaces. This should be done some other way
     m_hermesSolverContainer->setTableSpaces()->set_spaces(spacesRef);
-    Scalar *solutionVector = solveOneProblem(spacesRef, adaptivityStep,
-                                             Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >());
+
+    // warm start, previous reference solution is projected onto the new reference spaces
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousReferenceSolution;
+    if (m_block->adaptivityWarmStart())
+    {
+        if (adaptivityStep > 0)
+        {
+            BlockSolutionID previousReferenceID(m_block, timeStep, adaptivityStep - 1, SolutionMode_Reference);
+            if (Agros2D::solutionStore()->contains(previousReferenceID.fieldSolutionID(m_block->fields().at(0)->fieldInfo())))
+                previousReferenceSolution = Agros2D::solutionStore()->multiArray(previousReferenceID).solutions();
+        }
+    }
+
+    Scalar *solutionVector = solveOneProblem(spacesRef, adaptivityStep, previousReferenceSolution, true);
 
     // output reference solution
     Hermes::vector<Hermes::Hermes2D::MeshSharedPtr> meshesRef = spacesMeshes(spacesRef);
@@ -968,6 +1283,8 @@ void ProblemSolver<Scalar>::solveInitialTimeStep()
 {
     Agros2D::log()->printDebug(m_solverID, QObject::tr("Initial time step"));
 
+    clearTimeHistory();
+
     //Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces = deepMeshAndSpaceCopy(actualSpaces(), false);
     Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions;
 
@@ -84,10 +84,15 @@ public:
     void solve(double* initial_guess);
 
     virtual void setSolverCommand() = 0;
+    virtual QString solverName() const = 0;
 
 protected:
     QProcess *m_process;
 
+    // persistent solver process (factorization is kept between calls)
+    int m_clientId;
+    bool solveDaemon();
+
     QString command;
 
     QString fileMatrix;
@@ -108,6 +113,7 @@ public:
     AgrosExternalSolverMUMPS(CSCMatrix<double> *m, SimpleVector<double> *rhs);
 
     virtual void setSolverCommand();
+    virtual QString solverName() const { return "mumps"; }
 };
 
 class AgrosExternalSolverUMFPack : public AgrosExternalSolverExternal
@@ -116,6 +122,7 @@ public:
     AgrosExternalSolverUMFPack(CSCMatrix<double> *m, SimpleVector<double> *rhs);
 
     virtual void setSolverCommand();
+    virtual QString solverName() const { return "umfpack"; }
 };
 
 struct TimeStepInfo
@@ -164,7 +171,7 @@ template <typename Scalar>
 class ProblemSolver
 {
 public:
-    ProblemSolver() : m_hermesSolverContainer(NULL) {}
+    ProblemSolver() : m_hermesSolverContainer(NULL), m_matrixUnchanged(false) {}
     ~ProblemSolver();
 
     void init(Block* block);
@@ -175,7 +182,14 @@ public:
     // returns the value of the next time step lenght (for transient problems), using BDF2 approximation
     TimeStepInfo estimateTimeStepLength(int timeStep, int adaptivityStep);
 
+    // time dependent values are evaluated once per time step by the caller (Module::updateTimeFunctions),
+    // the caller then calls updateMarkerValuesInputs() on its own thread before solveSimple()
     void solveSimple(int timeStep, int adaptivityStep);
+    // material and boundary values at the actual time (Python engine is not reentrant)
+    void updateMarkerValuesInputs();
+
+    // assembled (and factorized) matrix is kept, only the right hand side is assembled (parametric sweep)
+    inline void setMatrixUnchanged(bool unchanged) { m_hermesSolverContainer->matrixUnchangedDueToBDF(unchanged); }
     void solveReferenceAndProject(int timeStep, int adaptivityStep);
     bool createAdaptedSpace(int timeStep, int adaptivityStep);
 
@@ -199,9 +213,30 @@ private:
     // to be used in advanced time step adaptivity
     double m_averageErrorToLenghtRatio;
 
+    // matrix inputs of the last time step (reuse of factorization), see matrixInputs
+    QByteArray m_matrixInputs;
+    // hash of material and boundary values of the matrix forms at the actual time step, see updateMarkerValuesInputs
+    QByteArray m_markerValuesInputs;
+    bool m_matrixUnchanged;
+    // true if the factorized matrix of the previous time step can be used (reuse policy, BDF coefficients and matrix inputs)
+    bool isMatrixUnchanged(bool unchangedDueToBDF, Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces);
+
+    // solution vectors of the last time levels (embedded time error estimator), valid for one spaces structure only
+    QList<double> m_timeHistoryTimes;
+    QList<QVector<Scalar> > m_timeHistoryVectors;
+    QByteArray m_timeHistoryStructure;
+
+    void appendTimeHistory(const Scalar *solutionVector);
+    void clearTimeHistory();
+    // difference between the solution and the predictor extrapolated from previous time levels, false if the history is too short
+    bool embeddedTimeError(int order, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > solutions, double &error);
+
     void initSelectors(Hermes::vector<QSharedPointer<Hermes::Hermes2D::RefinementSelectors::Selector<Scalar> > >& selectors);
 
-    Scalar *solveOneProblem(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces, int adaptivityStep, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution = Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >());
+    // previous solution is used as the initial guess of iterative linear solvers (and of nonlinear solvers if nonlinearInitialGuess is set)
+    Scalar *solveOneProblem(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces, int adaptivityStep,
+                            Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> > previousSolution = Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<Scalar> >(),
+                            bool nonlinearInitialGuess = false);
 
     void clearActualSpaces();
     void setActualSpaces(Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<Scalar> > spaces);
@@ -0,0 +1,231 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "solver_daemon.h"
+
+#include "util/global.h"
+#include "logview.h"
+
+// daemons are owned by their threads (socket and process are not shared between threads)
+static QThreadStorage<QMap<QString, QSharedPointer<ExternalSolverDaemon> > *> daemons;
+static QAtomicInt daemonCounter;
+static QAtomicInt clientCounter;
+static QAtomicInt solveCounter;
+static QAtomicInt reusedCounter;
+
+const int DAEMON_CONNECT_TIMEOUT = 10000;
+const int DAEMON_WRITE_TIMEOUT = 10000;
+// longest solve, hanging daemon is killed and the solver falls back to files
+const int DAEMON_SOLVE_TIMEOUT = 300000;
+
+ExternalSolverDaemon *ExternalSolverDaemon::daemon(const QString &solver)
+{
+    if (!daemons.hasLocalData())
+        daemons.setLocalData(new QMap<QString, QSharedPointer<ExternalSolverDaemon> >());
+
+    QMap<QString, QSharedPointer<ExternalSolverDaemon> > *map = daemons.localData();
+
+    // restart terminated daemon
+    if (map->contains(solver) && !map->value(solver)->isRunning())
+        map->remove(solver);
+
+    if (!map->contains(solver))
+    {
+        QSharedPointer<ExternalSolverDaemon> daemon(new ExternalSolverDaemon(solver));
+        if (!daemon->start())
+            return NULL;
+
+        map->insert(solver, daemon);
+    }
+
+    return map->value(solver).data();
+}
+
+int ExternalSolverDaemon::nextClientId()
+{
+    return clientCounter.fetchAndAddOrdered(1);
+}
+
+ExternalSolverDaemon::Statistics ExternalSolverDaemon::statistics()
+{
+    Statistics statistics;
+    statistics.solves = solveCounter.fetchAndAddOrdered(0);
+    statistics.reusedFactorizations = reusedCounter.fetchAndAddOrdered(0);
+
+    return statistics;
+}
+
+ExternalSolverDaemon::ExternalSolverDaemon(const QString &solver)
+    : m_solver(solver), m_process(NULL), m_socket(NULL), m_memory(NULL), m_generation(0)
+{
+    m_serverName = QString("agros2d_solver_%1_%2_%3").
+            arg(QCoreApplication::applicationPid()).
+            arg(solver).
+            arg(daemonCounter.fetchAndAddOrdered(1));
+}
+
+ExternalSolverDaemon::~ExternalSolverDaemon()
+{
+    if (m_socket)
+    {
+        if (m_socket->state() == QLocalSocket::ConnectedState)
+        {
+            m_socket->write("QUIT\n");
+            m_socket->waitForBytesWritten(1000);
+        }
+        delete m_socket;
+    }
+
+    if (m_process)
+    {
+        if (!m_process->waitForFinished(1000))
+            m_process->kill();
+        delete m_process;
+    }
+
+    delete m_memory;
+}
+
+bool ExternalSolverDaemon::start()
+{
+    m_process = new QProcess();
+    m_process->setStandardOutputFile(QString("%1/%2.out").arg(tempProblemDir()).arg(m_serverName));
+    m_process->setStandardErrorFile(QString("%1/%2.err").arg(tempProblemDir()).arg(m_serverName));
+    m_process->start(QString("%1/solver_external").arg(QCoreApplication::applicationDirPath()),
+                     QStringList() << "-o" << m_solver << "-d" << m_serverName);
+
+    if (!m_process->waitForStarted())
+    {
+        Agros2D::log()->printWarning(QObject::tr("Solver"), QObject::tr("Could not start external solver daemon"));
+        return false;
+    }
+
+    // server is listening shortly after the start
+    m_socket = new QLocalSocket();
+    QTime time;
+    time.start();
+    while (time.elapsed() < DAEMON_CONNECT_TIMEOUT)
+    {
+        m_socket->connectToServer(m_serverName);
+        if (m_socket->waitForConnected(100))
+            return true;
+
+        // sleep, daemon could have failed
+        if (m_process->waitForFinished(50))
+            break;
+    }
+
+    Agros2D::log()->printWarning(QObject::tr("Solver"), QObject::tr("Could not connect to external solver daemon"));
+    return false;
+}
+
+bool ExternalSolverDaemon::isRunning() const
+{
+    return m_process && (m_process->state() == QProcess::Running)
+            && m_socket && (m_socket->state() == QLocalSocket::ConnectedState);
+}
+
+void ExternalSolverDaemon::terminate()
+{
+    // daemon is restarted by the next request
+    if (m_socket)
+        m_socket->abort();
+
+    if (m_process)
+    {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+bool ExternalSolverDaemon::reserve(qint64 bytes)
+{
+    if (m_memory && m_memory->isAttached() && (m_memory->size() >= bytes))
+        return true;
+
+    // new segment (daemon attaches it by its key)
+    delete m_memory;
+    m_memory = new QSharedMemory(QString("%1_%2").arg(m_serverName).arg(m_generation++));
+
+    return m_memory->create(bytes + bytes / 4);
+}
+
+bool ExternalSolverDaemon::solve(int client, Hermes::Algebra::CSCMatrix<double> *matrix, const double *rhs, double *sln,
+                                 ExternalSolverBuffer::Reuse reuse, QString &error)
+{
+    int size = matrix->get_size();
+    int nnz = matrix->get_nnz();
+
+    if (!reserve(ExternalSolverBuffer::bytes(size, nnz)))
+    {
+        error = m_memory->errorString();
+        return false;
+    }
+
+    // one copy into the shared memory
+    ExternalSolverBuffer buffer(m_memory->data());
+    buffer.header()->size = size;
+    buffer.header()->nnz = nnz;
+    buffer.header()->reuse = reuse;
+    memcpy(buffer.Ap(), matrix->get_Ap(), (size + 1) * sizeof(int));
+    memcpy(buffer.Ai(), matrix->get_Ai(), nnz * sizeof(int));
+    memcpy(buffer.Ax(), matrix->get_Ax(), nnz * sizeof(double));
+    memcpy(buffer.rhs(), rhs, size * sizeof(double));
+
+    m_socket->write(QString("SOLVE %1 %2\n").arg(m_memory->key()).arg(client).toUtf8());
+    if (!m_socket->waitForBytesWritten(DAEMON_WRITE_TIMEOUT))
+    {
+        error = QObject::tr("Could not send request to external solver daemon: %1").arg(m_socket->errorString());
+        terminate();
+        return false;
+    }
+
+    QTime time;
+    time.start();
+    while (!m_socket->canReadLine())
+    {
+        int remaining = DAEMON_SOLVE_TIMEOUT - time.elapsed();
+        if ((remaining <= 0) || !m_socket->waitForReadyRead(remaining))
+        {
+            if (m_socket->state() == QLocalSocket::ConnectedState)
+                error = QObject::tr("External solver daemon did not respond in %1 s").arg(DAEMON_SOLVE_TIMEOUT / 1000);
+            else
+                error = QObject::tr("External solver daemon terminated");
+
+            terminate();
+            return false;
+        }
+    }
+
+    QStringList reply = QString::fromUtf8(m_socket->readLine()).trimmed().split(" ");
+    if (reply.first() != "OK")
+    {
+        error = reply.mid(1).join(" ");
+        return false;
+    }
+
+    memcpy(sln, buffer.sln(), size * sizeof(double));
+
+    solveCounter.fetchAndAddOrdered(1);
+    if ((reply.size() > 1) && (reply[1] == "REUSED"))
+        reusedCounter.fetchAndAddOrdered(1);
+
+    return true;
+}
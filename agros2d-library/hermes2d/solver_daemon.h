@@ -0,0 +1,120 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#ifndef SOLVER_DAEMON_H
+#define SOLVER_DAEMON_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+// persistent external solver (solver_external --daemon <server>)
+//
+// the process is started once per thread and solver, requests are sent over a local socket,
+// CSC arrays, right hand side and solution are passed in a shared memory segment
+//
+// client -> daemon (lines of UTF-8 text):
+//   SOLVE <shared memory key> <client id>
+//   QUIT
+// daemon -> client:
+//   OK [REUSED]
+//   ERROR <message>
+//
+// daemon keeps the matrix and factorization of each client, symbolic or numeric
+// factorization is reused according to the reuse flag in the header (REUSED if the numeric one was kept)
+
+// layout of the shared memory segment: header, Ap, Ai (int), Ax, rhs, sln (double)
+class ExternalSolverBuffer
+{
+public:
+    enum Reuse
+    {
+        Reuse_None = 0,
+        // sparsity pattern is unchanged, symbolic factorization is kept
+        Reuse_Pattern = 1,
+        // matrix is unchanged, numeric factorization is kept
+        Reuse_Matrix = 2
+    };
+
+    struct Header
+    {
+        qint32 size;
+        qint32 nnz;
+        qint32 reuse;
+        qint32 reserved;
+    };
+
+    ExternalSolverBuffer(void *data) : m_data((char *) data) {}
+
+    static inline qint64 bytes(int size, int nnz) { return axOffset(size, nnz) + (qint64) (nnz + 2 * size) * sizeof(double); }
+
+    inline Header *header() const { return (Header *) m_data; }
+    inline int *Ap() const { return (int *) (m_data + sizeof(Header)); }
+    inline int *Ai() const { return Ap() + header()->size + 1; }
+    inline double *Ax() const { return (double *) (m_data + axOffset(header()->size, header()->nnz)); }
+    inline double *rhs() const { return Ax() + header()->nnz; }
+    inline double *sln() const { return rhs() + header()->size; }
+
+private:
+    char *m_data;
+
+    // doubles are aligned to 8 bytes
+    static inline qint64 axOffset(int size, int nnz) { return ((sizeof(Header) + (qint64) (size + 1 + nnz) * sizeof(int) + 7) / 8) * 8; }
+};
+
+class ExternalSolverDaemon
+{
+public:
+    ~ExternalSolverDaemon();
+
+    // daemon of the current thread, started on first use (NULL if it could not be started)
+    static ExternalSolverDaemon *daemon(const QString &solver);
+
+    bool solve(int client, Hermes::Algebra::CSCMatrix<double> *matrix, const double *rhs, double *sln,
+               ExternalSolverBuffer::Reuse reuse, QString &error);
+
+    // unique id of the solver instance (daemon keeps its factorization)
+    static int nextClientId();
+
+    // successful solves of all daemons and those with a kept numeric factorization
+    struct Statistics
+    {
+        int solves;
+        int reusedFactorizations;
+    };
+
+    static Statistics statistics();
+
+private:
+    ExternalSolverDaemon(const QString &solver);
+
+    QString m_solver;
+    QString m_serverName;
+    QProcess *m_process;
+    QLocalSocket *m_socket;
+    QSharedMemory *m_memory;
+    int m_generation;
+
+    bool start();
+    void terminate();
+    bool isRunning() const;
+    bool reserve(qint64 bytes);
+};
+
+#endif // SOLVER_DAEMON_H
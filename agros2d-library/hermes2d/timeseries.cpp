@@ -0,0 +1,229 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "timeseries.h"
+
+#include "util/global.h"
+#include "field.h"
+#include "problem.h"
+#include "problem_config.h"
+#include "solutionstore.h"
+#include "plugin_interface.h"
+#include "scene.h"
+#include "scenenode.h"
+#include "scenelabel.h"
+#include "sceneedge.h"
+
+TimeSeries::TimeSeries(const FieldInfo *fieldInfo, SolutionMode solutionMode)
+    : m_fieldInfo(fieldInfo), m_solutionMode(solutionMode)
+{
+}
+
+void TimeSeries::extract()
+{
+    m_columnNames.clear();
+    m_columns.clear();
+
+    if (!Agros2D::problem()->isSolved())
+        return;
+
+    // stored time steps
+    QList<int> timeSteps;
+    for (int timeStep = 0; timeStep <= Agros2D::solutionStore()->lastTimeStep(m_fieldInfo, m_solutionMode); timeStep++)
+        if (Agros2D::solutionStore()->contains(FieldSolutionID(m_fieldInfo, timeStep, 0, m_solutionMode)))
+            timeSteps.append(timeStep);
+
+    foreach (int timeStep, timeSteps)
+    {
+        int adaptivityStep = Agros2D::solutionStore()->lastAdaptiveStep(m_fieldInfo, m_solutionMode, timeStep);
+
+        // mesh and space of the previous step are reused
+        Agros2D::solutionStore()->streamSolution(FieldSolutionID(m_fieldInfo, timeStep, adaptivityStep, m_solutionMode));
+
+        append("t", Agros2D::problem()->timeStepToTotalTime(timeStep));
+        extractPoints(timeStep, adaptivityStep);
+        extractIntegrals(timeStep, adaptivityStep);
+
+        // integrals skipped in this step (e.g. invalid markers)
+        int rows = times().size();
+        foreach (QString name, m_columnNames)
+            while (m_columns[name].size() < rows)
+                m_columns[name].append(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    Agros2D::solutionStore()->releaseStream();
+}
+
+void TimeSeries::append(const QString &name, double value)
+{
+    // new column is padded to the current time step
+    if (!m_columns.contains(name))
+    {
+        m_columnNames.append(name);
+        if (name != "t")
+            m_columns[name].fill(std::numeric_limits<double>::quiet_NaN(), times().size() - 1);
+    }
+
+    m_columns[name].append(value);
+}
+
+void TimeSeries::extractPoints(int timeStep, int adaptivityStep)
+{
+    if (m_points.isEmpty())
+        return;
+
+    LocalValueBatch *batch = m_fieldInfo->plugin()->localValueBatch(m_fieldInfo, timeStep, adaptivityStep, m_solutionMode, m_points);
+    QMap<QString, LocalPointValues> values = batch->values();
+    QVector<bool> found = batch->isFound();
+    delete batch;
+
+    QString labelX = Agros2D::problem()->config()->labelX().toLower();
+    QString labelY = Agros2D::problem()->config()->labelY().toLower();
+
+    for (int i = 0; i < m_points.size(); i++)
+    {
+        foreach (Module::LocalVariable variable, m_fieldInfo->localPointVariables())
+        {
+            LocalPointValues value = values.value(variable.id());
+            bool valid = found[i] && !value.scalar.isEmpty();
+
+            if (variable.isScalar())
+            {
+                append(pointColumnName(i, variable.shortname()), valid ? value.scalar[i] : std::numeric_limits<double>::quiet_NaN());
+            }
+            else
+            {
+                double x = valid ? value.vectorX[i] : std::numeric_limits<double>::quiet_NaN();
+                double y = valid ? value.vectorY[i] : std::numeric_limits<double>::quiet_NaN();
+
+                append(pointColumnName(i, variable.shortname()), sqrt(x*x + y*y));
+                append(pointColumnName(i, variable.shortname() + labelX), x);
+                append(pointColumnName(i, variable.shortname() + labelY), y);
+            }
+        }
+    }
+}
+
+void TimeSeries::extractIntegrals(int timeStep, int adaptivityStep)
+{
+    if (m_volumeIntegrals.isEmpty() && m_surfaceIntegrals.isEmpty())
+        return;
+
+    // selection of the user is restored after the integrals
+    QList<SceneBasic *> selection;
+    foreach (SceneNode *node, Agros2D::scene()->nodes->items())
+        if (node->isSelected())
+            selection.append(node);
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+        if (edge->isSelected())
+            selection.append(edge);
+    foreach (SceneLabel *label, Agros2D::scene()->labels->items())
+        if (label->isSelected())
+            selection.append(label);
+
+    // integrals are evaluated over selected labels and edges
+    for (int i = 0; i < m_volumeIntegrals.size(); i++)
+    {
+        Agros2D::scene()->selectNone();
+        foreach (int index, m_volumeIntegrals[i])
+            Agros2D::scene()->labels->at(index)->setSelected(true);
+
+        IntegralValue *integral = m_fieldInfo->plugin()->volumeIntegral(m_fieldInfo, timeStep, adaptivityStep, m_solutionMode);
+        QMapIterator<QString, double> it(integral->values());
+        while (it.hasNext())
+        {
+            it.next();
+            append(volumeIntegralColumnName(i, m_fieldInfo->volumeIntegral(it.key()).shortname()), it.value());
+        }
+        delete integral;
+    }
+
+    for (int i = 0; i < m_surfaceIntegrals.size(); i++)
+    {
+        Agros2D::scene()->selectNone();
+        foreach (int index, m_surfaceIntegrals[i])
+            Agros2D::scene()->edges->at(index)->setSelected(true);
+
+        IntegralValue *integral = m_fieldInfo->plugin()->surfaceIntegral(m_fieldInfo, timeStep, adaptivityStep, m_solutionMode);
+        QMapIterator<QString, double> it(integral->values());
+        while (it.hasNext())
+        {
+            it.next();
+            append(surfaceIntegralColumnName(i, m_fieldInfo->surfaceIntegral(it.key()).shortname()), it.value());
+        }
+        delete integral;
+    }
+
+    Agros2D::scene()->selectNone();
+    foreach (SceneBasic *item, selection)
+        item->setSelected(true);
+}
+
+bool TimeSeries::exportCSV(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    // columns are padded in extract()
+    foreach (QString name, m_columnNames)
+        assert(m_columns[name].size() == times().size());
+
+    QTextStream out(&file);
+
+    // headers
+    foreach (QString name, m_columnNames)
+        out << name << ";";
+    out << "\n";
+
+    // values
+    for (int i = 0; i < times().size(); i++)
+    {
+        foreach (QString name, m_columnNames)
+            out << QString::number(m_columns[name].at(i), 'g', 16) << ";";
+        out << "\n";
+    }
+
+    file.close();
+
+    return true;
+}
+
+bool TimeSeries::exportBinary(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    out << (quint32) m_columnNames.size() << (quint32) times().size();
+    foreach (QString name, m_columnNames)
+        out << name;
+    foreach (QString name, m_columnNames)
+        foreach (double value, m_columns[name])
+            out << value;
+
+    file.close();
+
+    return true;
+}
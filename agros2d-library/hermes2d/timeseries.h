@@ -0,0 +1,77 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include "util.h"
+#include "util/point.h"
+#include "util/global.h"
+
+#include "solutiontypes.h"
+
+class FieldInfo;
+
+// history of local values and integrals, stored time steps are walked once in order
+// (all probes and integrals are evaluated per step, each solution is read at most once)
+class AGROS_LIBRARY_API TimeSeries
+{
+public:
+    TimeSeries(const FieldInfo *fieldInfo, SolutionMode solutionMode = SolutionMode_Normal);
+
+    // probes
+    inline void addPoint(const Point &point) { m_points.append(point); }
+    inline void addVolumeIntegral(const QList<int> &labels) { m_volumeIntegrals.append(labels); }
+    inline void addSurfaceIntegral(const QList<int> &edges) { m_surfaceIntegrals.append(edges); }
+
+    void extract();
+
+    // columnar output: "t", "p<i>_<variable>" (points), "v<i>_<variable>" (volume integrals) and "s<i>_<variable>" (surface integrals)
+    // values in points outside the domain are NaN
+    inline QStringList columnNames() const { return m_columnNames; }
+    inline QVector<double> column(const QString &name) const { return m_columns.value(name); }
+    inline QVector<double> times() const { return m_columns.value("t"); }
+
+    static QString pointColumnName(int point, const QString &variable) { return QString("p%1_%2").arg(point).arg(variable); }
+    static QString volumeIntegralColumnName(int integral, const QString &variable) { return QString("v%1_%2").arg(integral).arg(variable); }
+    static QString surfaceIntegralColumnName(int integral, const QString &variable) { return QString("s%1_%2").arg(integral).arg(variable); }
+
+    bool exportCSV(const QString &fileName) const;
+    // little endian QDataStream: number of columns and rows (quint32), names (QString) and columns (double)
+    bool exportBinary(const QString &fileName) const;
+
+private:
+    const FieldInfo *m_fieldInfo;
+    SolutionMode m_solutionMode;
+
+    QVector<Point> m_points;
+    QList<QList<int> > m_volumeIntegrals;
+    QList<QList<int> > m_surfaceIntegrals;
+
+    QStringList m_columnNames;
+    QMap<QString, QVector<double> > m_columns;
+
+    void append(const QString &name, double value);
+
+    void extractPoints(int timeStep, int adaptivityStep);
+    void extractIntegrals(int timeStep, int adaptivityStep);
+};
+
+#endif // TIMESERIES_H
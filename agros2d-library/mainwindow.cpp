@@ -54,6 +54,7 @@
 #include "chartdialog.h"
 #include "examplesdialog.h"
 #include "hermes2d/solver.h"
+#include "hermes2d/solutionstore.h"
 
 #include "util/form_script.h"
 
@@ -130,8 +131,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     connect(currentPythonEngineAgros(), SIGNAL(executedScript()), this, SLOT(doExecutedScript()));
 
     // post hermes
-    connect(problemWidget, SIGNAL(changed()), postHermes, SLOT(refresh()));
-    connect(postprocessorWidget, SIGNAL(apply()), postHermes, SLOT(refresh()));
+    connect(problemWidget, SIGNAL(changed()), postHermes, SLOT(refreshAsync()));
+    connect(postprocessorWidget, SIGNAL(apply()), postHermes, SLOT(refreshAsync()));
     currentPythonEngineAgros()->setPostHermes(postHermes);
 
     connect(Agros2D::problem(), SIGNAL(meshed()), this, SLOT(setControls()));
@@ -1012,6 +1013,9 @@ void MainWindow::doDocumentDeleteSolution()
 
     if (QFile::exists(Agros2D::problem()->config()->fileName()))
     {
+        // solution file could be opened
+        Agros2D::solutionStore()->detachContainer();
+
         if (!QFile(solutionFN).remove())
             Agros2D::log()->printError(tr("Solution"), tr("Access denied '%1'").arg(solutionFN));
 
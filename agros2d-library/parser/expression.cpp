@@ -0,0 +1,505 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "expression.h"
+
+#include "lex.h"
+
+// math functions (Python math module and builtins)
+static double expressionSin(double x) { return sin(x); }
+static double expressionCos(double x) { return cos(x); }
+static double expressionTan(double x) { return tan(x); }
+static double expressionAsin(double x) { return asin(x); }
+static double expressionAcos(double x) { return acos(x); }
+static double expressionAtan(double x) { return atan(x); }
+static double expressionSinh(double x) { return sinh(x); }
+static double expressionCosh(double x) { return cosh(x); }
+static double expressionTanh(double x) { return tanh(x); }
+static double expressionExp(double x) { return exp(x); }
+static double expressionLog(double x) { return log(x); }
+static double expressionLog10(double x) { return log10(x); }
+static double expressionSqrt(double x) { return sqrt(x); }
+static double expressionFabs(double x) { return fabs(x); }
+static double expressionFloor(double x) { return floor(x); }
+static double expressionCeil(double x) { return ceil(x); }
+static double expressionDegrees(double x) { return x * 180.0 / M_PI; }
+static double expressionRadians(double x) { return x * M_PI / 180.0; }
+static double expressionFloat(double x) { return x; }
+
+static double expressionAtan2(double y, double x) { return atan2(y, x); }
+static double expressionPow(double x, double y) { return pow(x, y); }
+static double expressionHypot(double x, double y) { return sqrt(x*x + y*y); }
+static double expressionFmod(double x, double y) { return fmod(x, y); }
+static double expressionLogBase(double x, double base) { return log(x) / log(base); }
+static double expressionMin(double x, double y) { return (y < x) ? y : x; }
+static double expressionMax(double x, double y) { return (y > x) ? y : x; }
+
+CompiledExpression::CompiledExpression()
+    : m_isValid(false), m_stackSize(0), m_position(0), m_depth(0)
+{
+}
+
+bool CompiledExpression::compile(const QString &expression, const QStringList &variables)
+{
+    m_expression = expression;
+    m_variables = variables;
+    m_isValid = false;
+    m_program.clear();
+    m_stackSize = 0;
+
+    m_tokens.clear();
+    m_tokenTypes.clear();
+    m_position = 0;
+    m_depth = 0;
+
+    LexicalAnalyser lex;
+    try
+    {
+        lex.setExpression(expression);
+    }
+    catch (ParserException e)
+    {
+        return false;
+    }
+
+    foreach (Token token, lex.tokens())
+    {
+        QString text = token.toString();
+
+        // lexer joins sign with the following number ("(x)-1"), sign is handled by the parser
+        if (token.type() == ParserTokenType_NUMBER && (text.startsWith("-") || text.startsWith("+")))
+        {
+            m_tokens.append(text.left(1));
+            m_tokenTypes.append(ParserTokenType_OPERATOR);
+            text = text.mid(1);
+        }
+
+        m_tokens.append(text);
+        m_tokenTypes.append(token.type());
+    }
+
+    if (m_tokens.isEmpty())
+        return false;
+
+    bool isInteger = false;
+    if (!parseComparison(isInteger) || !atEnd())
+    {
+        m_program.clear();
+        return false;
+    }
+
+    assert(m_depth == 1);
+    m_isValid = true;
+
+    m_tokens.clear();
+    m_tokenTypes.clear();
+
+    return true;
+}
+
+double CompiledExpression::evaluate(const double *values) const
+{
+    assert(m_isValid);
+    return run(m_program.constData(), m_program.size(), m_stackSize, values);
+}
+
+double CompiledExpression::run(const Instruction *program, int size, int stackSize, const double *values)
+{
+    QVarLengthArray<double, 32> buffer(stackSize);
+    double *stack = buffer.data();
+    int top = -1;
+
+    for (int i = 0; i < size; i++)
+    {
+        const Instruction &instruction = program[i];
+
+        switch (instruction.code)
+        {
+        case OpCode_Constant:
+            stack[++top] = instruction.value;
+            break;
+        case OpCode_Variable:
+            stack[++top] = values[instruction.index];
+            break;
+        case OpCode_Negate:
+            stack[top] = - stack[top];
+            break;
+        case OpCode_Add:
+            top--; stack[top] = stack[top] + stack[top + 1];
+            break;
+        case OpCode_Subtract:
+            top--; stack[top] = stack[top] - stack[top + 1];
+            break;
+        case OpCode_Multiply:
+            top--; stack[top] = stack[top] * stack[top + 1];
+            break;
+        case OpCode_Divide:
+            top--; stack[top] = stack[top] / stack[top + 1];
+            break;
+        case OpCode_FloorDivide:
+            top--; stack[top] = floor(stack[top] / stack[top + 1]);
+            break;
+        case OpCode_Power:
+            top--; stack[top] = pow(stack[top], stack[top + 1]);
+            break;
+        case OpCode_Equal:
+            top--; stack[top] = (stack[top] == stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_NotEqual:
+            top--; stack[top] = (stack[top] != stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Less:
+            top--; stack[top] = (stack[top] < stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_LessEqual:
+            top--; stack[top] = (stack[top] <= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Greater:
+            top--; stack[top] = (stack[top] > stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_GreaterEqual:
+            top--; stack[top] = (stack[top] >= stack[top + 1]) ? 1.0 : 0.0;
+            break;
+        case OpCode_Function1:
+            stack[top] = instruction.function1(stack[top]);
+            break;
+        case OpCode_Function2:
+            top--; stack[top] = instruction.function2(stack[top], stack[top + 1]);
+            break;
+        default:
+            assert(0);
+        }
+    }
+
+    return stack[top];
+}
+
+void CompiledExpression::append(const Instruction &instruction, int operands)
+{
+    m_program.append(instruction);
+
+    // stack depth
+    if (instruction.code == OpCode_Constant || instruction.code == OpCode_Variable)
+        m_depth++;
+    else
+        m_depth -= operands - 1;
+    m_stackSize = qMax(m_stackSize, m_depth);
+
+    // constant folding
+    if (operands == 0 || m_program.size() < operands + 1)
+        return;
+
+    for (int i = m_program.size() - operands - 1; i < m_program.size() - 1; i++)
+        if (m_program[i].code != OpCode_Constant)
+            return;
+
+    int start = m_program.size() - operands - 1;
+    double value = run(m_program.constData() + start, operands + 1, operands, NULL);
+
+    m_program.resize(start);
+    m_program.append(Instruction(OpCode_Constant, value));
+}
+
+bool CompiledExpression::accept(const QString &op)
+{
+    if (!atEnd() && m_tokenTypes[m_position] == ParserTokenType_OPERATOR && m_tokens[m_position] == op)
+    {
+        m_position++;
+        return true;
+    }
+
+    return false;
+}
+
+bool CompiledExpression::parseComparison(bool &isInteger)
+{
+    if (!parseSum(isInteger))
+        return false;
+
+    OpCode code;
+    if (accept("=="))
+        code = OpCode_Equal;
+    else if (accept("!="))
+        code = OpCode_NotEqual;
+    else if (accept("<="))
+        code = OpCode_LessEqual;
+    else if (accept(">="))
+        code = OpCode_GreaterEqual;
+    else if (accept("<"))
+        code = OpCode_Less;
+    else if (accept(">"))
+        code = OpCode_Greater;
+    else
+        return true;
+
+    bool isIntegerRight = false;
+    if (!parseSum(isIntegerRight))
+        return false;
+
+    append(Instruction(code), 2);
+
+    // bool is int in Python, chained comparisons are not supported
+    isInteger = true;
+    return atEnd() || m_tokens[m_position] == ")" || m_tokens[m_position] == ",";
+}
+
+bool CompiledExpression::parseSum(bool &isInteger)
+{
+    if (!parseTerm(isInteger))
+        return false;
+
+    while (true)
+    {
+        OpCode code;
+        if (accept("+"))
+            code = OpCode_Add;
+        else if (accept("-"))
+            code = OpCode_Subtract;
+        else
+            return true;
+
+        bool isIntegerRight = false;
+        if (!parseTerm(isIntegerRight))
+            return false;
+
+        append(Instruction(code), 2);
+        isInteger = isInteger && isIntegerRight;
+    }
+}
+
+bool CompiledExpression::parseTerm(bool &isInteger)
+{
+    if (!parseUnary(isInteger))
+        return false;
+
+    while (true)
+    {
+        bool isDivision = false;
+        if (accept("/"))
+            isDivision = true;
+        else if (!accept("*"))
+            return true;
+
+        bool isIntegerRight = false;
+        if (!parseUnary(isIntegerRight))
+            return false;
+
+        // integer division (Python 2)
+        if (isDivision)
+            append(Instruction((isInteger && isIntegerRight) ? OpCode_FloorDivide : OpCode_Divide), 2);
+        else
+            append(Instruction(OpCode_Multiply), 2);
+
+        isInteger = isInteger && isIntegerRight;
+    }
+}
+
+bool CompiledExpression::parseUnary(bool &isInteger)
+{
+    if (accept("-"))
+    {
+        if (!parseUnary(isInteger))
+            return false;
+
+        append(Instruction(OpCode_Negate), 1);
+        return true;
+    }
+
+    if (accept("+"))
+        return parseUnary(isInteger);
+
+    return parsePower(isInteger);
+}
+
+bool CompiledExpression::parsePower(bool &isInteger)
+{
+    if (!parsePrimary(isInteger))
+        return false;
+
+    if (!accept("**"))
+        return true;
+
+    // right associative, binds tighter than unary operator on the left
+    bool isIntegerRight = false;
+    if (!parseUnary(isIntegerRight))
+        return false;
+
+    // integer operands are constants (folded), negative exponent gives float
+    isInteger = isInteger && isIntegerRight
+            && m_program.last().code == OpCode_Constant
+            && m_program.last().value >= 0.0;
+
+    append(Instruction(OpCode_Power), 2);
+
+    return true;
+}
+
+bool CompiledExpression::parsePrimary(bool &isInteger)
+{
+    if (atEnd())
+        return false;
+
+    QString text = m_tokens[m_position];
+    int type = m_tokenTypes[m_position];
+    m_position++;
+
+    if (type == ParserTokenType_NUMBER)
+    {
+        bool ok = false;
+        double value = text.toDouble(&ok);
+        if (!ok)
+            return false;
+
+        isInteger = !text.contains(".") && !text.contains("e", Qt::CaseInsensitive);
+
+        // octal literal (Python 2)
+        if (isInteger && text.length() > 1 && text.startsWith("0"))
+            return false;
+
+        append(Instruction(OpCode_Constant, value), 0);
+        return true;
+    }
+
+    if (type == ParserTokenType_VARIABLE)
+    {
+        isInteger = false;
+
+        int index = m_variables.indexOf(text);
+        if (index != -1)
+        {
+            append(Instruction(OpCode_Variable, 0.0, index), 0);
+            return true;
+        }
+
+        // user variable (pi and e can be redefined too), evaluated by Python
+        return false;
+    }
+
+    if (type == ParserTokenType_FUNCTION)
+        return parseFunction(text, isInteger);
+
+    if (type == ParserTokenType_OPERATOR && text == "(")
+    {
+        if (!parseComparison(isInteger))
+            return false;
+
+        return accept(")");
+    }
+
+    return false;
+}
+
+bool CompiledExpression::parseFunction(const QString &name, bool &isInteger)
+{
+    if (!accept("("))
+        return false;
+
+    // arguments
+    int count = 0;
+    bool isIntegerArguments = true;
+    if (!accept(")"))
+    {
+        do
+        {
+            bool isIntegerArgument = false;
+            if (!parseComparison(isIntegerArgument))
+                return false;
+
+            isIntegerArguments = isIntegerArguments && isIntegerArgument;
+            count++;
+
+            // min and max take any number of arguments
+            if (count > 1 && (name == "min" || name == "max"))
+            {
+                Instruction instruction(OpCode_Function2);
+                instruction.function2 = (name == "min") ? expressionMin : expressionMax;
+                append(instruction, 2);
+            }
+        }
+        while (accept(","));
+
+        if (!accept(")"))
+            return false;
+    }
+
+    isInteger = false;
+
+    if (name == "min" || name == "max")
+    {
+        isInteger = isIntegerArguments;
+        return (count > 1);
+    }
+
+    if (count == 1)
+    {
+        Function1 function = NULL;
+        if (name == "sin") function = expressionSin;
+        else if (name == "cos") function = expressionCos;
+        else if (name == "tan") function = expressionTan;
+        else if (name == "asin") function = expressionAsin;
+        else if (name == "acos") function = expressionAcos;
+        else if (name == "atan") function = expressionAtan;
+        else if (name == "sinh") function = expressionSinh;
+        else if (name == "cosh") function = expressionCosh;
+        else if (name == "tanh") function = expressionTanh;
+        else if (name == "exp") function = expressionExp;
+        else if (name == "log") function = expressionLog;
+        else if (name == "log10") function = expressionLog10;
+        else if (name == "sqrt") function = expressionSqrt;
+        else if (name == "fabs") function = expressionFabs;
+        else if (name == "floor") function = expressionFloor;
+        else if (name == "ceil") function = expressionCeil;
+        else if (name == "degrees") function = expressionDegrees;
+        else if (name == "radians") function = expressionRadians;
+        else if (name == "float") function = expressionFloat;
+        else if (name == "abs")
+        {
+            function = expressionFabs;
+            isInteger = isIntegerArguments;
+        }
+        else
+            return false;
+
+        Instruction instruction(OpCode_Function1);
+        instruction.function1 = function;
+        append(instruction, 1);
+
+        return true;
+    }
+
+    if (count == 2)
+    {
+        Function2 function = NULL;
+        if (name == "atan2") function = expressionAtan2;
+        else if (name == "pow") function = expressionPow;
+        else if (name == "hypot") function = expressionHypot;
+        else if (name == "fmod") function = expressionFmod;
+        else if (name == "log") function = expressionLogBase;
+        else
+            return false;
+
+        Instruction instruction(OpCode_Function2);
+        instruction.function2 = function;
+        append(instruction, 2);
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,109 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include "util.h"
+
+// native evaluator of the math subset of Python expressions (literals, + - * / **,
+// comparisons, math functions and bound variables), other expressions are not compiled
+// and have to be evaluated by Python engine
+class AGROS_LIBRARY_API CompiledExpression
+{
+public:
+    CompiledExpression();
+
+    // compile expression, variables are bound in the given order
+    bool compile(const QString &expression, const QStringList &variables);
+
+    inline bool isValid() const { return m_isValid; }
+    inline QString expression() const { return m_expression; }
+    inline QStringList variables() const { return m_variables; }
+
+    // values of bound variables in the order given to compile
+    double evaluate(const double *values) const;
+
+private:
+    enum OpCode
+    {
+        OpCode_Constant,
+        OpCode_Variable,
+        OpCode_Negate,
+        OpCode_Add,
+        OpCode_Subtract,
+        OpCode_Multiply,
+        OpCode_Divide,
+        OpCode_FloorDivide,
+        OpCode_Power,
+        OpCode_Equal,
+        OpCode_NotEqual,
+        OpCode_Less,
+        OpCode_LessEqual,
+        OpCode_Greater,
+        OpCode_GreaterEqual,
+        OpCode_Function1,
+        OpCode_Function2
+    };
+
+    typedef double (*Function1)(double);
+    typedef double (*Function2)(double, double);
+
+    struct Instruction
+    {
+        Instruction(OpCode code = OpCode_Constant, double value = 0.0, int index = 0)
+            : code(code), value(value), index(index), function1(NULL), function2(NULL) {}
+
+        OpCode code;
+        double value;
+        int index;
+        Function1 function1;
+        Function2 function2;
+    };
+
+    QString m_expression;
+    QStringList m_variables;
+    bool m_isValid;
+
+    QVector<Instruction> m_program;
+    int m_stackSize;
+
+    // compiler state
+    QStringList m_tokens;
+    QList<int> m_tokenTypes;
+    int m_position;
+    int m_depth;
+
+    bool parseComparison(bool &isInteger);
+    bool parseSum(bool &isInteger);
+    bool parseTerm(bool &isInteger);
+    bool parseUnary(bool &isInteger);
+    bool parsePower(bool &isInteger);
+    bool parsePrimary(bool &isInteger);
+    bool parseFunction(const QString &name, bool &isInteger);
+
+    bool accept(const QString &op);
+    inline bool atEnd() const { return m_position >= m_tokens.count(); }
+
+    void append(const Instruction &instruction, int operands);
+
+    static double run(const Instruction *program, int size, int stackSize, const double *values);
+};
+
+#endif // EXPRESSION_H
@@ -1,250 +1,199 @@
 #include "mesh_hash.h"
 #include "hermes2d.h"
 
-MeshHashElement::MeshHashElement(Point p1, Point p2, int depth) : m_p1(p1), m_p2(p2), m_depth(depth)
-{
-    for(int i = 0; i < 2; i++)
-        for(int j = 0; j < 2; j++)
-            m_sons[i][j] = NULL;
-    m_active = true;
-}
-
-MeshHashElement::~MeshHashElement()
-{
-    for(int i = 0; i < 2; i++)
-        for(int j = 0; j < 2; j++)
-            if(m_sons[i][j])
-                delete m_sons[i][j];
-
-}
-
-bool MeshHashElement::belongs(Hermes::Hermes2D::Element *element)
-{
-    Point p1, p2;
-    MeshHash::elementBoundingBox(element, p1, p2);
-    return ((p1.x <= m_p2.x) && (p2.x >= m_p1.x) && (p1.y <= m_p2.y) && (p2.y >= m_p1.y));
-}
-
-void MeshHashElement::insert(Hermes::Hermes2D::Element *element)
+MeshHash::MeshHash(const Hermes::Hermes2D::MeshSharedPtr mesh)
+    : m_mesh(mesh), m_meshSeq(mesh->get_seq())
 {
-    if(m_active)
+    // find bounding box of the whole mesh
+    bool first = true;
+    Hermes::Hermes2D::Element *element;
+    for_all_active_elements(element, mesh)
     {
-        if(! m_elements.contains(element))
-            m_elements.push_back(element);
+        Point p1, p2;
+        elementBoundingBox(element, p1, p2);
 
-        if((m_elements.size() > MAX_ELEMENTS) && (m_depth < MAX_DEPTH))
+        if (first)
         {
-            m_active = false;
-            double xx[3] = {m_p1.x, (m_p1.x + m_p2.x) / 2., m_p2.x};
-            double yy[3] = {m_p1.y, (m_p1.y + m_p2.y) / 2., m_p2.y};
-            for(int i = 0; i < 2; i++)
-            {
-                double x0 = xx[i];
-                double x1 = xx[i+1];
-                for(int j = 0; j < 2; j++)
-                {
-                    double y0 = yy[j];
-                    double y1 = yy[j+1];
-
-                    assert(m_sons[i][j] == NULL);
-                    m_sons[i][j] = new MeshHashElement(Point(x0,y0), Point(x1,y1), m_depth + 1);
-
-                    for(int elem = 0; elem < m_elements.size(); elem++)
-                    {
-                        if(m_sons[i][j]->belongs(m_elements[elem]))
-                            m_sons[i][j]->insert(m_elements[elem]);
-                    }
-                }
-            }
-
-            m_elements.clear();
+            m_p1 = p1;
+            m_p2 = p2;
+            first = false;
         }
-    }
-    else
-    {
-        for(int i = 0; i < 2; i++)
+        else
         {
-            for(int j = 0; j < 2; j++)
-            {
-                assert(m_sons[i][j]);
-                if(m_sons[i][j]->belongs(element))
-                    m_sons[i][j]->insert(element);
-            }
+            m_p1.x = qMin(m_p1.x, p1.x);
+            m_p1.y = qMin(m_p1.y, p1.y);
+            m_p2.x = qMax(m_p2.x, p2.x);
+            m_p2.y = qMax(m_p2.y, p2.y);
         }
     }
 
-}
+    // grid size (approx. ELEMENTS_PER_CELL elements in one cell, cells are nearly square)
+    int numberOfElements = mesh->get_num_active_elements();
+    double width = qMax(m_p2.x - m_p1.x, EPS_ZERO);
+    double height = qMax(m_p2.y - m_p1.y, EPS_ZERO);
+    double cells = qMax(1.0, (double) numberOfElements / ELEMENTS_PER_CELL);
 
-Hermes::Hermes2D::Element* MeshHashElement::getElement(double x, double y)
-{
-    if(m_active)
-    {
-        double x_ref, y_ref;
-        foreach(Hermes::Hermes2D::Element* element, m_elements)
-        {
-            if(Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(element, x, y, &x_ref, &y_ref))
-                return element;
-        }
-        return NULL;
-    }
-    else
+    m_gridSizeX = qBound(1, (int) ceil(sqrt(cells * width / height)), MAX_GRID_SIZE);
+    m_gridSizeY = qBound(1, (int) ceil(cells / m_gridSizeX), MAX_GRID_SIZE);
+    m_intervalX = width / m_gridSizeX;
+    m_intervalY = height / m_gridSizeY;
+
+    m_cells.resize(m_gridSizeX * m_gridSizeY);
+
+    // assign elements
+    for_all_active_elements(element, mesh)
     {
-        Hermes::Hermes2D::Element* element;
-        for(int i = 0; i < 2; i++)
-        {
-            for(int j = 0; j < 2; j++)
-            {
-                element = m_sons[i][j]->getElement(x,y);
-                if(element)
-                    return element;
-            }
-        }
-        return NULL;
+        Point p1, p2;
+        elementBoundingBox(element, p1, p2);
+
+        int xMin = cellX(p1.x);
+        int xMax = cellX(p2.x);
+        int yMin = cellY(p1.y);
+        int yMax = cellY(p2.y);
+
+        for (int j = yMin; j <= yMax; j++)
+            for (int i = xMin; i <= xMax; i++)
+                m_cells[j * m_gridSizeX + i].append(element);
     }
 }
 
+MeshHash::~MeshHash()
+{
+    m_cells.clear();
+}
+
 void MeshHash::elementBoundingBox(Hermes::Hermes2D::Element *element, Point &p1, Point &p2)
 {
     p1.x = p2.x = element->vn[0]->x;
     p1.y = p2.y = element->vn[0]->y;
 
-    for(int i = 1; i < element->get_nvert(); i++)
+    for (int i = 1; i < element->get_nvert(); i++)
     {
         double xx = element->vn[i]->x;
         double yy = element->vn[i]->y;
-        if(xx > p2.x)
+        if (xx > p2.x)
             p2.x = xx;
-        if(xx < p1.x)
+        if (xx < p1.x)
             p1.x = xx;
-        if(yy > p2.y)
+        if (yy > p2.y)
             p2.y = yy;
-        if(yy < p1.y)
+        if (yy < p1.y)
             p1.y = yy;
     }
 
-    if(element->is_curved())
+    if (element->is_curved())
     {
-        // todo: should be improved
-        Point diameter = p2 - p1;
-        p2 = p2 + diameter;
-        p1 = p1 - diameter;
+        // arc over chord c with angle alpha <= 90 deg bulges at most c / 2 * tan(alpha / 4)
+        double chord = 0.0;
+        for (int i = 0; i < element->get_nvert(); i++)
+        {
+            Hermes::Hermes2D::Node *start = element->vn[i];
+            Hermes::Hermes2D::Node *end = element->vn[element->next_vert(i)];
+            chord = qMax(chord, sqrt((end->x - start->x) * (end->x - start->x) + (end->y - start->y) * (end->y - start->y)));
+        }
+
+        double bulge = chord / 2.0 * tan(M_PI / 8.0) * (1.0 + EPS_ZERO);
+        p1 = p1 - Point(bulge, bulge);
+        p2 = p2 + Point(bulge, bulge);
     }
 }
 
+Hermes::Hermes2D::Element* MeshHash::getElement(double x, double y) const
+{
+    return locate(x, y).element;
+}
 
-
-MeshHash::MeshHash(const Hermes::Hermes2D::MeshSharedPtr mesh)
+MeshHash::Location MeshHash::locate(double x, double y, Hermes::Hermes2D::Element *hint) const
 {
-    // find bounding box of the whole mesh
-    Point mesh_p1, mesh_p2;
-    bool first = true;
-    Hermes::Hermes2D::Node* n;
-    for_all_vertex_nodes(n, mesh)
+    double xReference, yReference;
+
+    if (hint)
     {
-        if(first)
-        {
-            mesh_p1.x = mesh_p2.x = n->x;
-            mesh_p1.y = mesh_p2.y = n->y;
-            first = false;
-        }
-        else
+        if (Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(hint, x, y, &xReference, &yReference))
+            return Location(hint, xReference, yReference);
+
+        // coherent queries usually move to the adjacent element
+        for (int i = 0; i < hint->get_nvert(); i++)
         {
-            if(n->x > mesh_p2.x)
-                mesh_p2.x = n->x;
-            if(n->x < mesh_p1.x)
-                mesh_p1.x = n->x;
-            if(n->y > mesh_p2.y)
-                mesh_p2.y = n->y;
-            if(n->y < mesh_p1.y)
-                mesh_p1.y = n->y;
+            Hermes::Hermes2D::Element *neighbor = hint->get_neighbor(i);
+            if (neighbor && neighbor->active && Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(neighbor, x, y, &xReference, &yReference))
+                return Location(neighbor, xReference, yReference);
         }
     }
 
-    // create grid
-    double interval_len_x = (mesh_p2.x - mesh_p1.x) / GRID_SIZE;
-    double interval_len_y = (mesh_p2.y - mesh_p1.y) / GRID_SIZE;
-
-    intervals_x[0] = mesh_p1.x;
-    intervals_y[0] = mesh_p1.y;
+    // this means that x or y is outside mesh, but it can hapen
+    if ((x < m_p1.x) || (x > m_p2.x) || (y < m_p1.y) || (y > m_p2.y))
+        return Location();
 
-    for(int i = 1; i < GRID_SIZE; i++)
+    foreach (Hermes::Hermes2D::Element *element, m_cells[cellY(y) * m_gridSizeX + cellX(x)])
     {
-        intervals_x[i] = intervals_x[i-1] + interval_len_x;
-        intervals_y[i] = intervals_y[i-1] + interval_len_y;
+        if (element != hint && Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(element, x, y, &xReference, &yReference))
+            return Location(element, xReference, yReference);
     }
 
-    intervals_x[GRID_SIZE] = mesh_p2.x;
-    intervals_y[GRID_SIZE] = mesh_p2.y;
+    return Location();
+}
 
-    for(int i = 0; i < GRID_SIZE; i++)
-    {
-        for(int j = 0; j < GRID_SIZE; j++)
-        {
-            m_grid[i][j] = new MeshHashElement(Point(intervals_x[i], intervals_y[j]), Point(intervals_x[i+1], intervals_y[j+1]));
-        }
-    }
+QVector<MeshHash::Location> MeshHash::locate(const QVector<Point> &points) const
+{
+    QVector<Location> locations(points.size());
 
-    // assign elements
-    Hermes::Hermes2D::Element *element;
-    Point p1, p2;
-    int x_min, x_max, y_min, y_max;
-    for_all_active_elements(element, mesh)
+    Hermes::Hermes2D::Element *hint = NULL;
+    foreach (int i, spatialOrder(points))
     {
-        elementBoundingBox(element, p1, p2);
-        x_min = 0;
-        while(intervals_x[x_min + 1] < p1.x)
-            x_min++;
-
-        x_max = GRID_SIZE - 1;
-        while(intervals_x[x_max] > p2.x)
-            x_max--;
-
-        y_min = 0;
-        while(intervals_y[y_min + 1] < p1.y)
-            y_min++;
+        locations[i] = locate(points[i].x, points[i].y, hint);
+        if (locations[i].element)
+            hint = locations[i].element;
+    }
 
-        y_max = GRID_SIZE - 1;
-        while(intervals_y[y_max] > p2.y)
-            y_max--;
+    return locations;
+}
 
-        assert((x_max >= x_min) && (y_max >= y_min));
+// spreads lower 16 bits of value to even bits
+static inline quint32 mortonSpread(quint32 value)
+{
+    value &= 0x0000ffff;
+    value = (value | (value << 8)) & 0x00ff00ff;
+    value = (value | (value << 4)) & 0x0f0f0f0f;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
 
-        for(int i = x_min; i <= x_max; i++)
-        {
-            for(int j = y_min; j <= y_max; j++)
-            {
-                assert(m_grid[i][j]->belongs(element));
-                m_grid[i][j]->insert(element);
-            }
-        }
-    }
+    return value;
 }
 
-MeshHash::~MeshHash()
+QVector<int> MeshHash::spatialOrder(const QVector<Point> &points)
 {
-    for(int i = 0; i < GRID_SIZE; i++)
+    QVector<int> order(points.size());
+    if (points.isEmpty())
+        return order;
+
+    // bounding box of points
+    Point p1 = points.first();
+    Point p2 = points.first();
+    foreach (Point point, points)
     {
-        for(int j = 0; j < GRID_SIZE; j++)
-        {
-            delete m_grid[i][j];
-        }
+        p1.x = qMin(p1.x, point.x);
+        p1.y = qMin(p1.y, point.y);
+        p2.x = qMax(p2.x, point.x);
+        p2.y = qMax(p2.y, point.y);
     }
 
-}
+    double scaleX = 65535.0 / qMax(p2.x - p1.x, EPS_ZERO);
+    double scaleY = 65535.0 / qMax(p2.y - p1.y, EPS_ZERO);
 
-Hermes::Hermes2D::Element* MeshHash::getElement(double x, double y)
-{
-    int i = 0;
-    while((i < GRID_SIZE) && (intervals_x[i+1] < x))
-        i++;
+    // (key, index) pairs, stable for equal keys
+    QVector<QPair<quint32, int> > keys(points.size());
+    for (int i = 0; i < points.size(); i++)
+    {
+        quint32 i1 = (quint32) ((points[i].x - p1.x) * scaleX);
+        quint32 i2 = (quint32) ((points[i].y - p1.y) * scaleY);
 
-    int j = 0;
-    while((j < GRID_SIZE) && (intervals_y[j+1] < y))
-        j++;
+        keys[i] = QPair<quint32, int>(mortonSpread(i1) | (mortonSpread(i2) << 1), i);
+    }
+    qSort(keys);
 
-    // this means that x or y is outside mesh, but it can hapen
-    if((i >= GRID_SIZE) || (j >= GRID_SIZE))
-        return NULL;
-    else
-        return m_grid[i][j]->getElement(x,y);
+    for (int i = 0; i < keys.size(); i++)
+        order[i] = keys[i].second;
+
+    return order;
 }
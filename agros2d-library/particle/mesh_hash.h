@@ -2,58 +2,64 @@
 #define MESHHASH_H
 
 #include "util.h"
+#include "util/point.h"
 #include "util/global.h"
 
-namespace Hermes
-{
-namespace Hermes2D
-{
-class Element;
-}
-}
+#include "hermes2d.h"
 
-class MeshHashElement
+// point location in the mesh (uniform grid sized by the number of elements)
+class AGROS_LIBRARY_API MeshHash
 {
 public:
-    MeshHashElement(Point p1, Point p2, int depth = 0);
-    ~MeshHashElement();
-    inline bool belongs(Point p) { return (p.x >= m_p1.x) && (p.x <= m_p2.x) && (p.y <= m_p1.y) && (p.y >= m_p2.y); }
-    bool belongs(Hermes::Hermes2D::Element* element);
-    void insert(Hermes::Hermes2D::Element* element);
-
-    Hermes::Hermes2D::Element* getElement(double x, double y);
-
-private:
-    Point m_p1, m_p2;
-    QList<Hermes::Hermes2D::Element*> m_elements;
-    MeshHashElement* m_sons[2][2];
-    int m_depth;
-
-    static const int MAX_ELEMENTS = 50;
-    static const int MAX_DEPTH = 10;
-    bool m_active;
-};
+    struct Location
+    {
+        Location(Hermes::Hermes2D::Element *element = NULL, double xReference = 0.0, double yReference = 0.0)
+            : element(element), xReference(xReference), yReference(yReference) {}
 
-#define GRID_SIZE  30
+        Hermes::Hermes2D::Element *element;
+        double xReference;
+        double yReference;
+    };
 
-class MeshHash
-{
-public:
     MeshHash(const Hermes::Hermes2D::MeshSharedPtr mesh);
     ~MeshHash();
 
-    // smallest box interval_x X interval_y in which element is contained. If element is curvilinear, has to be made larger
-    // if we knew more about the shape of curvilinear element, this increase could be smaller
+    // smallest box in which element is contained, curved edges are arcs up to 90 deg
     static void elementBoundingBox(Hermes::Hermes2D::Element* element, Point& p1, Point& p2);
 
-    Hermes::Hermes2D::Element* getElement(double x, double y);
+    inline Hermes::Hermes2D::MeshSharedPtr mesh() const { return m_mesh; }
+    inline int meshSeq() const { return m_meshSeq; }
+
+    Hermes::Hermes2D::Element* getElement(double x, double y) const;
+
+    // hint (e.g. last found element) and its neighbours are tested first
+    Location locate(double x, double y, Hermes::Hermes2D::Element *hint = NULL) const;
+    // batched query, points are walked in spatial order and each point uses the previous element as a hint
+    // (locations are returned in the original order)
+    QVector<Location> locate(const QVector<Point> &points) const;
+
+    // order of points along the Z-order (Morton) curve of their bounding box
+    static QVector<int> spatialOrder(const QVector<Point> &points);
 
 private:
-    MeshHashElement* m_grid[GRID_SIZE][GRID_SIZE];
+    Hermes::Hermes2D::MeshSharedPtr m_mesh;
+    int m_meshSeq;
 
-    double intervals_x[GRID_SIZE + 1];
-    double intervals_y[GRID_SIZE + 1];
-};
+    Point m_p1;
+    Point m_p2;
+    int m_gridSizeX;
+    int m_gridSizeY;
+    double m_intervalX;
+    double m_intervalY;
 
+    // elements of cell (i, j) are stored in m_cells[j * m_gridSizeX + i]
+    QVector<QVector<Hermes::Hermes2D::Element *> > m_cells;
+
+    static const int ELEMENTS_PER_CELL = 4;
+    static const int MAX_GRID_SIZE = 1024;
+
+    inline int cellX(double x) const { return qBound(0, (int) floor((x - m_p1.x) / m_intervalX), m_gridSizeX - 1); }
+    inline int cellY(double y) const { return qBound(0, (int) floor((y - m_p1.y) / m_intervalY), m_gridSizeY - 1); }
+};
 
 #endif // MESHHASH_H
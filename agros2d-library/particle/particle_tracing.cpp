@@ -40,6 +40,104 @@
 #include "hermes2d/solutionstore.h"
 #include "hermes2d/problem_config.h"
 
+
+// initial capacity of trajectory buffers
+const int PARTICLE_TRAJECTORY_RESERVE = 4096;
+
+ParticleTracingSettings::ParticleTracingSettings()
+{
+    ProblemSetting *setting = Agros2D::problem()->setting();
+
+    coordinateType = Agros2D::problem()->config()->coordinateType();
+    butcherTableType = (Hermes::ButcherTableType) setting->value(ProblemSetting::View_ParticleButcherTableType).toInt();
+
+    maximumNumberOfSteps = setting->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt();
+    maximumStep = setting->value(ProblemSetting::View_ParticleMaximumStep).toDouble();
+    maximumRelativeError = setting->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble();
+
+    includeRelativisticCorrection = setting->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool();
+    p2pElectricForce = setting->value(ProblemSetting::View_ParticleP2PElectricForce).toBool();
+    p2pMagneticForce = setting->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool();
+    p2pOpeningAngle = setting->value(ProblemSetting::View_ParticleP2POpeningAngle).toDouble();
+
+    customForce = Point3(setting->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
+                         setting->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
+                         setting->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
+    dragDensity = setting->value(ProblemSetting::View_ParticleDragDensity).toDouble();
+    dragCoefficient = setting->value(ProblemSetting::View_ParticleDragCoefficient).toDouble();
+    dragReferenceArea = setting->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+
+    coefficientOfRestitution = setting->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+    reflectOnDifferentMaterial = setting->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool();
+    reflectOnBoundary = setting->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool();
+
+    numberOfThreads = qMax(1, Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt());
+}
+
+void ParticleTrajectory::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_vx.clear();
+    m_vy.clear();
+    m_vz.clear();
+    m_time.clear();
+}
+
+void ParticleTrajectory::reserve(int size)
+{
+    m_x.reserve(size);
+    m_y.reserve(size);
+    m_z.reserve(size);
+    m_vx.reserve(size);
+    m_vy.reserve(size);
+    m_vz.reserve(size);
+    m_time.reserve(size);
+}
+
+void ParticleTrajectory::append(const Point3 &position, const Point3 &velocity, double time)
+{
+    m_x.append(position.x);
+    m_y.append(position.y);
+    m_z.append(position.z);
+    m_vx.append(velocity.x);
+    m_vy.append(velocity.y);
+    m_vz.append(velocity.z);
+    m_time.append(time);
+}
+
+int ParticleTrajectory::timeToLevel(double time, int levels) const
+{
+    assert(levels > 0 && levels <= m_time.size());
+
+    if (levels == 1)
+        return 0;
+    else if (time >= m_time[levels - 1])
+        return levels - 1;
+
+    // times are nondecreasing, first interval [t_i, t_i+1] containing time
+    QVector<double>::const_iterator it = std::lower_bound(m_time.constBegin() + 1, m_time.constBegin() + levels, time);
+    return it - m_time.constBegin() - 1;
+}
+
+// particle to particle forces are evaluated in cartesian coordinates
+static inline Point3 cartesianPosition(CoordinateType coordinateType, const Point3 &position)
+{
+    if (coordinateType == CoordinateType_Planar)
+        return position;
+    else
+        return Point3(position.x * cos(position.z), position.y, position.x * sin(position.z));
+}
+
+static inline Point3 cartesianVelocity(CoordinateType coordinateType, const Point3 &position, const Point3 &velocity)
+{
+    if (coordinateType == CoordinateType_Planar)
+        return velocity;
+    else
+        return Point3(velocity.x * cos(position.z), velocity.y, velocity.x * sin(position.z));
+}
+
 ParticleTracing::ParticleTracing(QObject *parent)
     : QObject(parent)
 {
@@ -56,8 +154,13 @@ ParticleTracing::ParticleTracing(QObject *parent)
         FieldSolutionID fsid(fieldInfo, timeStep, adaptivityStep, solutionMode);
         Hermes::Hermes2D::MeshFunctionSharedPtr<double> sln = Agros2D::solutionStore()->multiArray(fsid).solutions().at(0);
 
-        m_solutionIDs[fieldInfo] = FieldSolutionID(fieldInfo, timeStep, adaptivityStep, solutionMode);
-        m_meshes[fieldInfo] = sln->get_mesh();
+        m_fieldInfos.append(fieldInfo);
+        m_solutionIDs.append(fsid);
+        m_meshHashes.append(Agros2D::solutionStore()->meshHash(sln->get_mesh()));
+
+        // time functions are evaluated by the Python engine, which is not reentrant
+        if (fieldInfo->analysisType() == AnalysisType_Transient)
+            m_settings.numberOfThreads = 1;
     }
 }
 
@@ -67,68 +170,101 @@ ParticleTracing::~ParticleTracing()
 
 void ParticleTracing::clear()
 {
-    // clear lists
-    for (int i = 0; m_positionsList.size(); i++)
-        m_positionsList[i].clear();
-    m_positionsList.clear();
-    for (int i = 0; m_velocitiesList.size(); i++)
-        m_velocitiesList[i].clear();
-    m_velocitiesList.clear();
-    for (int i = 0; m_timesList.size(); i++)
-        m_timesList[i].clear();
-    m_timesList.clear();
+    // clear buffers
+    m_trajectories.clear();
+    m_states.clear();
+    m_levels.clear();
+    m_tree.clear();
 
     m_velocityMin =  numeric_limits<double>::max();
     m_velocityMax = -numeric_limits<double>::max();
 }
 
+QList<QList<Point3> > ParticleTracing::positions() const
+{
+    QList<QList<Point3> > list;
+    foreach (ParticleTrajectory trajectory, m_trajectories)
+    {
+        QList<Point3> positions;
+        for (int i = 0; i < trajectory.size(); i++)
+            positions.append(trajectory.position(i));
+
+        list.append(positions);
+    }
+
+    return list;
+}
+
+QList<QList<Point3> > ParticleTracing::velocities() const
+{
+    QList<QList<Point3> > list;
+    foreach (ParticleTrajectory trajectory, m_trajectories)
+    {
+        QList<Point3> velocities;
+        for (int i = 0; i < trajectory.size(); i++)
+            velocities.append(trajectory.velocity(i));
+
+        list.append(velocities);
+    }
+
+    return list;
+}
+
+QList<QList<double> > ParticleTracing::times() const
+{
+    QList<QList<double> > list;
+    foreach (ParticleTrajectory trajectory, m_trajectories)
+    {
+        QList<double> times;
+        for (int i = 0; i < trajectory.size(); i++)
+            times.append(trajectory.time(i));
+
+        list.append(times);
+    }
+
+    return list;
+}
+
 // input position, velocity: planar x, y, z, axi r, z, phi
 // ouput x, y, z
 Point3 ParticleTracing::force(int particleIndex,
                               Point3 position,
                               Point3 velocity)
 {
+    ParticleState &state = m_states[particleIndex];
+
     Point3 totalFieldForce;
-    foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+    for (int i = 0; i < m_fieldInfos.size(); i++)
     {
-        if (!fieldInfo->plugin()->hasForce(fieldInfo))
-            continue;
+        FieldInfo *fieldInfo = m_fieldInfos[i];
 
         Point3 fieldForce;
 
-        bool elementIsValid = false;
-        Hermes::Hermes2D::Element *activeElement = NULL;
+        // active element for current field (last element is tested first)
+        Hermes::Hermes2D::Element *activeElement = m_meshHashes[i]->locate(position.x, position.y, state.activeElements[i]).element;
 
-        // active element for current field
-        if (m_activeElement.contains(fieldInfo))
-            activeElement = m_activeElement[fieldInfo];
-
-        if (activeElement)
+        if (activeElement != state.activeElements[i])
         {
-            double x_reference;
-            double y_reference;
-            elementIsValid = Hermes::Hermes2D::RefMap::is_element_on_physical_coordinates(activeElement,
-                                                                                          position.x, position.y, &x_reference, &y_reference);
-        }
+            // find material
+            SceneMaterial *material = NULL;
+            if (activeElement)
+            {
+                SceneLabel *label = Agros2D::scene()->labels->at(atoi(fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(activeElement->marker).marker.c_str()));
+                material = label->marker(fieldInfo);
 
-        if (!elementIsValid)
-        {
-            m_activeElement[fieldInfo] = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(true, m_meshes[fieldInfo],
-                                                                                                   position.x, position.y);
+                assert(!material->isNone());
+            }
+
+            state.activeElements[i] = activeElement;
+            state.activeMaterials[i] = material;
         }
 
         if (activeElement)
         {
-            // find material
-            SceneLabel *label = Agros2D::scene()->labels->at(atoi(fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(activeElement->marker).marker.c_str()));
-            SceneMaterial* material = label->marker(fieldInfo);
-
-            assert(!material->isNone());
-
             try
             {
-                fieldForce = fieldInfo->plugin()->force(fieldInfo, m_solutionIDs[fieldInfo].timeStep, m_solutionIDs[fieldInfo].adaptivityStep, m_solutionIDs[fieldInfo].solutionMode,
-                                                        activeElement, material, position, velocity)
+                fieldForce = fieldInfo->plugin()->force(fieldInfo, m_solutionIDs[i].timeStep, m_solutionIDs[i].adaptivityStep, m_solutionIDs[i].solutionMode,
+                                                        activeElement, state.activeMaterials[i], position, velocity)
                         * m_particleChargesList[particleIndex];
             }
             catch (AgrosException e)
@@ -143,20 +279,31 @@ Point3 ParticleTracing::force(int particleIndex,
     // particle to particle force
     Point3 forceP2PElectric;
     Point3 forceP2PMagnetic;
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PElectricForce).toBool() ||
-            Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool())
+    if ((m_settings.p2pElectricForce || m_settings.p2pMagneticForce) && m_settings.p2pOpeningAngle > 0.0)
+    {
+        // Barnes-Hut approximation
+        m_tree.evaluate(particleIndex,
+                        cartesianPosition(m_settings.coordinateType, position),
+                        cartesianVelocity(m_settings.coordinateType, position, velocity),
+                        m_settings.p2pElectricForce, m_settings.p2pMagneticForce,
+                        forceP2PElectric, forceP2PMagnetic);
+
+        forceP2PElectric = forceP2PElectric * m_particleChargesList[particleIndex];
+        forceP2PMagnetic = forceP2PMagnetic * m_particleChargesList[particleIndex];
+    }
+    else if (m_settings.p2pElectricForce || m_settings.p2pMagneticForce)
     {
-        for (int i = 0; i < m_positionsList.size(); i++)
+        for (int i = 0; i < m_trajectories.size(); i++)
         {
             if (particleIndex == i)
                 continue;
 
-            int timeLevel = timeToLevel(i, m_timesList[particleIndex].last());
-            Point3 particlePosition = m_positionsList[i].at(timeLevel);
-            Point3 particleVelocity = m_velocitiesList[i].at(timeLevel);
+            int timeLevel = m_trajectories[i].timeToLevel(m_trajectories[particleIndex].lastTime(), m_levels[i]);
+            Point3 particlePosition = m_trajectories[i].position(timeLevel);
+            Point3 particleVelocity = m_trajectories[i].velocity(timeLevel);
 
             double distance = 0.0;
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+            if (m_settings.coordinateType == CoordinateType_Planar)
                 distance = Point3(position.x - particlePosition.x,
                                   position.y - particlePosition.y,
                                   position.z - particlePosition.z).magnitude();
@@ -167,9 +314,9 @@ Point3 ParticleTracing::force(int particleIndex,
 
             if (distance > 0)
             {
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PElectricForce).toBool())
+                if (m_settings.p2pElectricForce)
                 {
-                    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+                    if (m_settings.coordinateType == CoordinateType_Planar)
                         forceP2PElectric = forceP2PElectric + Point3(
                                     (position.x - particlePosition.x) / distance,
                                     (position.y - particlePosition.y) / distance,
@@ -182,31 +329,15 @@ Point3 ParticleTracing::force(int particleIndex,
                                     (position.x * sin(position.z) - particlePosition.x * sin(particlePosition.z)) / distance)
                                 * (m_particleChargesList[particleIndex] * m_particleChargesList[i] / (4 * M_PI * EPS0 * distance * distance));
                 }
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleP2PMagneticForce).toBool())
+                if (m_settings.p2pMagneticForce)
                 {
-                    Point3 r0, v0;
-                    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                    {
-                        r0 = Point3((position.x - particlePosition.x) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.z - particlePosition.z) / distance);
-                        v0 = Point3(velocity.x - particleVelocity.x,
-                                    velocity.y - particleVelocity.y,
-                                    velocity.z - particleVelocity.z);
-                    }
-                    else
-                    {
-                        r0 = Point3((position.x * cos(position.z) - particlePosition.x * cos(particlePosition.z)) / distance,
-                                    (position.y - particlePosition.y) / distance,
-                                    (position.x * sin(position.z) - particlePosition.x * sin(particlePosition.z)) / distance);
-                        // TODO: fix velocity
-                        assert(0);
-                        v0 = Point3(velocity.x * cos(position.z) - particleVelocity.x * cos(particlePosition.z),
-                                    velocity.y - particleVelocity.y,
-                                    velocity.x * sin(position.z) - particleVelocity.x * sin(particlePosition.z));
-                    }
-
-                    forceP2PMagnetic = forceP2PMagnetic + (v0 % v0 % r0)
+                    Point3 r0 = (cartesianPosition(m_settings.coordinateType, position)
+                                 - cartesianPosition(m_settings.coordinateType, particlePosition)) / distance;
+                    Point3 v1 = cartesianVelocity(m_settings.coordinateType, position, velocity);
+                    Point3 v2 = cartesianVelocity(m_settings.coordinateType, particlePosition, particleVelocity);
+
+                    // v x B, B of the moving source charge (Biot-Savart)
+                    forceP2PMagnetic = forceP2PMagnetic + (v1 % (v2 % r0))
                             * (m_particleChargesList[particleIndex] * m_particleChargesList[i] * MU0 / (4 * M_PI * distance * distance));
 
                 }
@@ -215,20 +346,18 @@ Point3 ParticleTracing::force(int particleIndex,
     }
 
     // custom force
-    Point3 forceCustom = Point3(Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceX).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceY).toDouble(),
-                                Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCustomForceZ).toDouble());
+    Point3 forceCustom = m_settings.customForce;
 
     // Drag force
-    Point3 velocityReal = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
+    Point3 velocityReal = (m_settings.coordinateType == CoordinateType_Planar) ?
                 velocity : Point3(velocity.x, velocity.y, position.x * velocity.z);
     Point3 forceDrag;
     if (velocityReal.magnitude() > 0.0)
         forceDrag = velocityReal.normalizePoint() *
-                - 0.5 * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragDensity).toDouble()
+                - 0.5 * m_settings.dragDensity
                 * velocityReal.magnitude() * velocityReal.magnitude()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragCoefficient).toDouble()
-                * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleDragReferenceArea).toDouble();
+                * m_settings.dragCoefficient
+                * m_settings.dragReferenceArea;
 
     // Total force
     Point3 totalForce = totalFieldForce + forceDrag + forceCustom + forceP2PElectric + forceP2PMagnetic;
@@ -245,9 +374,9 @@ bool ParticleTracing::newtonEquations(int particleIndex,
 {
     // relativistic correction
     double mass = m_particleMassesList[particleIndex];
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool())
+    if (m_settings.includeRelativisticCorrection)
     {
-        Point3 velocityReal = (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
+        Point3 velocityReal = (m_settings.coordinateType == CoordinateType_Planar) ?
                     velocity : Point3(velocity.x, velocity.y, position.x * velocity.z);
 
         mass = mass / (sqrt(1.0 - (velocityReal.magnitude() * velocityReal.magnitude()) / (SPEEDOFLIGHT * SPEEDOFLIGHT)));
@@ -256,7 +385,7 @@ bool ParticleTracing::newtonEquations(int particleIndex,
     // Total acceleration
     Point3 totalAccel = force(particleIndex, position, velocity) / mass;
 
-    if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
+    if (m_settings.coordinateType == CoordinateType_Planar)
     {
         // position
         *newposition = velocity * step;
@@ -278,375 +407,487 @@ bool ParticleTracing::newtonEquations(int particleIndex,
     return true;
 }
 
-int ParticleTracing::timeToLevel(int particleIndex, double time)
+bool ParticleTracing::isStopped(int particleIndex)
 {
-    if (m_timesList[particleIndex].size() == 1)
-        return 0;
-    else if (time >= m_timesList[particleIndex].last())
-        return m_timesList[particleIndex].size() - 1;
-    else
-        for (int i = 0; i < m_timesList[particleIndex].size() - 1; i++)
-            if ((m_timesList[particleIndex].at(i) <= time) && (time <= m_timesList[particleIndex].at(i+1)))
-                return i;
+    ParticleState &state = m_states[particleIndex];
+
+    // stop on number of steps
+    if (state.numberOfSteps > m_settings.maximumNumberOfSteps - 1)
+        state.stopComputation = true;
+
+    // stop on time steps
+    if (state.timeStep < EPS_ZERO / 100.0)
+        state.stopComputation = true;
 
-    assert(0);
+    return state.stopComputation;
 }
 
-void ParticleTracing::computeTrajectoryParticles(const QList<Point3> initialPositions, const QList<Point3> initialVelocities,
-                                                 const QList<double> particleCharges, const QList<double> particleMasses)
+void ParticleTracing::computeStep(int particleIndex)
 {
-    assert(initialPositions.size() == initialVelocities.size());
-    assert(initialPositions.size() == particleCharges.size());
-    assert(initialPositions.size() == particleMasses.size());
-    assert(initialPositions.size() == Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleNumberOfParticles).toInt());
+    ParticleState &state = m_states[particleIndex];
+    const ParticleTrajectory &trajectory = m_trajectories[particleIndex];
 
-    m_particleChargesList = particleCharges;
-    m_particleMassesList = particleMasses;
+    Hermes::ButcherTable butcher(m_settings.butcherTableType);
 
-    Hermes::ButcherTable butcher((Hermes::ButcherTableType) Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleButcherTableType).toInt());
+    // increase number of steps
+    state.numberOfSteps++;
 
-    clear();
+    // initial position and velocity
+    Point3 position = trajectory.lastPosition();
+    Point3 velocity = trajectory.lastVelocity();
+    if (m_settings.coordinateType == CoordinateType_Axisymmetric)
+        velocity.z = velocity.z / position.x; // v_phi = omega * r
+    double currentTimeStep = state.timeStep;
 
-    int numberOfParticles = Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleNumberOfParticles).toInt();
+    // Runge-Kutta steps
+    Point3 newPositionH;
+    Point3 newVelocityH;
 
-    QTime timePart;
-    timePart.start();
+    // Butcher tableu
+    QVector<Point3> kp(butcher.get_size());
+    QVector<Point3> kv(butcher.get_size());
 
-    RectPoint bound = Agros2D::scene()->boundingBox();
+    int maxStepsRKF = 0;
+    while (!state.stopComputation && maxStepsRKF < 100)
+    {
+        bool butcherOK = true;
 
-    double maxStep = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumStep).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumStep).toDouble() :
-              min(bound.width(), bound.height()) / 80.0;
-    double relErrorMax = (Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() > 0.0)
-            ? Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumRelativeError).toDouble() : 1e-6;
-    double relErrorMin = 1e-3;
+        for (int k = 0; k < butcher.get_size(); k++)
+        {
+            Point3 pos = position;
+            Point3 vel = velocity;
 
-    // given velocity
-    QList<bool> stopComputation;
-    QList<int> numberOfSteps;
-    QList<double> timeStep;
+            for (int l = 0; l < butcher.get_size(); l++)
+            {
+                if (l < k)
+                {
+                    pos = pos + kp[l] * butcher.get_A(k, l);
+                    vel = vel + kv[l] * butcher.get_A(k, l);
+                }
+            }
 
-    // initial positions
+            if (m_settings.includeRelativisticCorrection
+                    && ((m_settings.coordinateType == CoordinateType_Planar
+                         ? vel.magnitude() : Point3(vel.x, vel.y, pos.x * vel.z).magnitude()) > SPEEDOFLIGHT))
+            {
+                // decrease time step
+                butcherOK = false;
+                break;
+            }
+
+            newtonEquations(particleIndex, currentTimeStep, pos, vel, &kp[k], &kv[k]);
+        }
+
+        if (butcherOK)
+        {
+            // low order
+            Point3 newPositionL = position;
+            Point3 newVelocityL = velocity;
+            for (int k = 0; k < butcher.get_size() - 1; k++)
+            {
+                newPositionL = newPositionL + kp[k] * butcher.get_B2(k);
+                newVelocityL = newVelocityL + kv[k] * butcher.get_B2(k);
+            }
+
+            // high order
+            newPositionH = position;
+            newVelocityH = velocity;
+            for (int k = 0; k < butcher.get_size(); k++)
+            {
+                newPositionH = newPositionH + kp[k] * butcher.get_B(k);
+                newVelocityH = newVelocityH + kv[k] * butcher.get_B(k);
+            }
+
+            // optimal step estimation
+            double absErrorPos = fabs(newPositionH.magnitude() - newPositionL.magnitude());
+            double relErrorPos = fabs(absErrorPos / newPositionH.magnitude());
+            double absErrorVel = fabs(newVelocityH.magnitude() - newVelocityL.magnitude());
+            double relErrorVel = fabs(absErrorVel / newVelocityH.magnitude());
+            double currentStepLength = ((m_settings.coordinateType == CoordinateType_Planar) ?
+                                            (position - newPositionH).magnitude() :
+                                            (Point3(position.x * cos(position.z), position.x * sin(position.z), position.y)
+                                             - Point3(newPositionH.x * cos(newPositionH.z), newPositionH.x * sin(newPositionH.z), newPositionH.y)).magnitude());
+            double currentStepVelocity = ((m_settings.coordinateType == CoordinateType_Planar) ?
+                                              (velocity - newVelocityH).magnitude() :
+                                              (Point3(velocity.x, velocity.y, position.x * velocity.z) - Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z)).magnitude());
+
+            // nearly zero step
+            if (currentStepLength < EPS_ZERO && currentStepVelocity < EPS_ZERO)
+            {
+                qDebug() << QString("Particle %1: time step is too short - refused.").arg(particleIndex);
+                currentTimeStep *= 3.0;
+                continue;
+            }
+
+            // minimum step
+            if ((currentStepLength > m_maxStep) || (relErrorVel > m_relErrorMax && relErrorPos > m_relErrorMax))
+            {
+                // decrease step
+                qDebug() << QString("Particle %1: time step is too long or relative error was exceeded - refused.").arg(particleIndex);
+                currentTimeStep /= 2.0;
+                continue;
+            }
+            // relative tolerance
+            else if ((relErrorVel < m_relErrorMin && relErrorPos < m_relErrorMin))
+            {
+                // increase next step
+                qDebug() << QString("Particle %1: time step increased.").arg(particleIndex);
+                double optStep = 0.8 * currentTimeStep * pow((m_relErrorMin / relErrorPos), 0.25);
+                if (relErrorPos > 0 && optStep > currentTimeStep)
+                    state.timeStep = optStep;
+                else
+                    state.timeStep = 1.2 * currentTimeStep;
+                break;
+            }
+            else
+            {
+                // store current time step
+                state.timeStep = currentTimeStep;
+                break;
+            }
+        }
+        else
+        {
+            if (currentTimeStep < EPS_ZERO / 100.0)
+            {
+                // store current time step
+                state.timeStep = currentTimeStep;
+                // stop computation
+                break;
+            }
+            else
+            {
+                // decrease step
+                qDebug() << QString("Particle %1: the speed of light was exceeded - refused.").arg(particleIndex);
+                currentTimeStep /= 2.0;
+                continue;
+            }
+        }
+    }
+
+    // check crossing
+    QMap<SceneEdge *, Point> intersections;
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+    {
+        QList<Point> incts = intersection(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y),
+                                          Point(), 0.0, 0.0,
+                                          edge->nodeStart()->point(), edge->nodeEnd()->point(),
+                                          edge->center(), edge->radius(), edge->angle());
+
+        if (incts.length() > 0)
+            foreach (Point p, incts)
+                intersections.insert(edge, p);
+    }
+
+    // find the closest intersection
+    Point intersect;
+    SceneEdge *crossingEdge = NULL;
+    double distance = numeric_limits<double>::max();
+    for (QMap<SceneEdge *, Point>::const_iterator it = intersections.begin(); it != intersections.end(); ++it)
+        if ((it.value() - Point(position.x, position.y)).magnitude() < distance)
+        {
+            distance = (it.value() - Point(position.x, position.y)).magnitude();
+
+            crossingEdge = it.key();
+            intersect = it.value();
+        }
+
+    if (crossingEdge && distance > EPS_ZERO)
+    {
+        bool impact = false;
+        foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
+        {
+            if ((m_settings.coefficientOfRestitution < EPS_ZERO) || // no reflection
+                    (crossingEdge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !m_settings.reflectOnDifferentMaterial) || // inner edge
+                    (crossingEdge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
+                     && !m_settings.reflectOnBoundary)) // boundary
+                impact = true;
+        }
+
+        // current step ration
+        if (impact)
+        {
+            newPositionH.x = intersect.x;
+            newPositionH.y = intersect.y;
+
+            state.stopComputation = true;
+        }
+        else
+        {
+            // input vector moved to the origin
+            Point vectin = Point(newPositionH.x, newPositionH.y) - intersect;
+
+            // tangent vector
+            Point tangent;
+            if (crossingEdge->isStraight())
+                tangent = (crossingEdge->nodeStart()->point() - crossingEdge->nodeEnd()->point()).normalizePoint();
+            else
+                tangent = Point((intersect.y - crossingEdge->center().y), -(intersect.x - crossingEdge->center().x)).normalizePoint();
+
+            Point idealReflectedPosition(intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y),
+                                         intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y));
+
+            double ratio = (Point(position.x, position.y) - intersect).magnitude()
+                    / (Point(newPositionH.x, newPositionH.y) - Point(position.x, position.y)).magnitude();
+
+            // output vector
+            Point vectout = (idealReflectedPosition - intersect).normalizePoint();
+
+            // stop computation (impact distance is very very small)
+            if ((fabs(distance / 100.0 * vectout.x) < EPS_ZERO) && (fabs(distance / 100.0 * vectout.y) < EPS_ZERO))
+                state.stopComputation = true;
+
+            // output point
+            newPositionH.x = intersect.x + distance / 100.0 * vectout.x;
+            newPositionH.y = intersect.y + distance / 100.0 * vectout.y;
+
+            // velocity in the direction of output vector
+            Point3 oldv = newVelocityH;
+            newVelocityH.x = vectout.x * Point(oldv.x, oldv.y).magnitude() * m_settings.coefficientOfRestitution;
+            newVelocityH.y = vectout.y * Point(oldv.x, oldv.y).magnitude() * m_settings.coefficientOfRestitution;
+
+            // set new timestep
+            currentTimeStep = currentTimeStep * ratio;
+            state.timeStep = currentTimeStep;
+        }
+    }
+
+    // new values
+    state.newPosition = newPositionH;
+    state.newTimeStep = currentTimeStep;
+
+    // velocities in planar and axisymmetric arrangement
+    if (m_settings.coordinateType == CoordinateType_Planar)
+        state.newVelocity = newVelocityH;
+    else
+        state.newVelocity = Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z); // v_phi = omega * r
+}
+
+void ParticleTracing::commitStep(int particleIndex)
+{
+    const ParticleState &state = m_states[particleIndex];
+    if (!state.error.isEmpty())
+        return;
+
+    ParticleTrajectory &trajectory = m_trajectories[particleIndex];
+    trajectory.append(state.newPosition, state.newVelocity, trajectory.lastTime() + state.newTimeStep);
+}
+
+void ParticleTracing::computeIndependentParticles()
+{
+    int numberOfParticles = m_trajectories.size();
+
+    // particles do not interact, each one is traced by a single thread from start to end
+#pragma omp parallel for schedule(dynamic, 1) num_threads(m_settings.numberOfThreads)
     for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
     {
-        // position and velocity cache
-        m_positionsList.append(QList<Point3>());
-        m_velocitiesList.append(QList<Point3>());
-        m_timesList.append(QList<double>());
+        ParticleState &state = m_states[particleIndex];
 
-        m_positionsList[particleIndex].append(initialPositions[particleIndex]);
-        m_velocitiesList[particleIndex].append(initialVelocities[particleIndex]);
-        m_timesList[particleIndex].append(0);
+        try
+        {
+            while (!isStopped(particleIndex))
+            {
+                computeStep(particleIndex);
+                commitStep(particleIndex);
+            }
+        }
+        catch (AgrosException &e)
+        {
+            state.error = e.toString();
+            state.stopComputation = true;
+        }
+        catch (std::exception &e)
+        {
+            state.error = QString::fromStdString(e.what());
+            state.stopComputation = true;
+        }
+    }
+}
 
-        stopComputation.append(false);
-        numberOfSteps.append(0);
+void ParticleTracing::buildTree(const QVector<int> &running)
+{
+    if (running.isEmpty())
+        return;
+
+    // synchronized time (all running particles reached it)
+    double syncTime = numeric_limits<double>::max();
+    foreach (int particleIndex, running)
+        syncTime = qMin(syncTime, m_trajectories[particleIndex].lastTime());
+
+    int numberOfParticles = m_trajectories.size();
+    QVector<Point3> positions(numberOfParticles);
+    QVector<Point3> velocities(numberOfParticles);
+    QVector<double> charges(numberOfParticles);
+    for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+    {
+        const ParticleTrajectory &trajectory = m_trajectories[particleIndex];
+
+        // linear interpolation between time levels
+        int level = trajectory.timeToLevel(syncTime, m_levels[particleIndex]);
+        Point3 position = trajectory.position(level);
+        Point3 velocity = trajectory.velocity(level);
+        if (level < m_levels[particleIndex] - 1 && trajectory.time(level + 1) > trajectory.time(level))
+        {
+            double ratio = (syncTime - trajectory.time(level)) / (trajectory.time(level + 1) - trajectory.time(level));
+            position = position + (trajectory.position(level + 1) - position) * ratio;
+            velocity = velocity + (trajectory.velocity(level + 1) - velocity) * ratio;
+        }
 
-        // timeStep.append(initialVelocities[particleIndex].magnitude() > 0
-        //                 ? qMax(bound.width(), bound.height()) / initialVelocities[particleIndex].magnitude() / 10 : 1e-11);
-        timeStep.append(1e-11);
+        positions[particleIndex] = cartesianPosition(m_settings.coordinateType, position);
+        velocities[particleIndex] = cartesianVelocity(m_settings.coordinateType, position, velocity);
+        charges[particleIndex] = m_particleChargesList[particleIndex];
     }
 
+    m_tree.setOpeningAngle(m_settings.p2pOpeningAngle);
+    m_tree.build(positions, velocities, charges);
+}
+
+void ParticleTracing::computeInteractingParticles()
+{
+    int numberOfParticles = m_trajectories.size();
+
     bool globalStopComputation = false;
     while (!globalStopComputation)
     {
         double syncTime = 0.0;
         int syncParticle = -1;
         for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            if (m_timesList[particleIndex].last() > syncTime)
+            if (m_trajectories[particleIndex].lastTime() > syncTime)
             {
-                syncTime = m_timesList[particleIndex].last();
+                syncTime = m_trajectories[particleIndex].lastTime();
                 syncParticle = particleIndex;
             }
 
         double timeStp = 0.0;
         if (syncParticle == -1)
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            if (timeStep[particleIndex] > timeStp)
-            {
-                timeStp = timeStep[particleIndex];
-                syncParticle = particleIndex;
-            }
+            for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+                if (m_states[particleIndex].timeStep > timeStp)
+                {
+                    timeStp = m_states[particleIndex].timeStep;
+                    syncParticle = particleIndex;
+                }
 
+        // particles advanced in this round
+        QVector<int> running;
         for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
         {
-            // stop on number of steps
-            if (numberOfSteps[particleIndex] > Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleMaximumNumberOfSteps).toInt() - 1)
-                stopComputation[particleIndex] = true;
-
-            // stop on time steps
-            if (timeStep[particleIndex] < EPS_ZERO / 100.0)
-                stopComputation[particleIndex] = true;
-
-            if (stopComputation[particleIndex])
+            if (isStopped(particleIndex))
                 continue;
 
             // sync
-            if (!stopComputation[particleIndex] && particleIndex == syncParticle)
+            if (particleIndex == syncParticle)
             {
                 bool otherParticlesIsRunning = false;
                 for (int particleIndexOther = 0; particleIndexOther < numberOfParticles; particleIndexOther++)
-                    if (particleIndex != particleIndexOther && !stopComputation[particleIndexOther])
+                    if (particleIndex != particleIndexOther && !m_states[particleIndexOther].stopComputation)
                         otherParticlesIsRunning = true;
 
                 if (otherParticlesIsRunning)
                     continue;
             }
 
-            // increase number of steps
-            numberOfSteps[particleIndex]++;
+            running.append(particleIndex);
+        }
 
-            // initial position and velocity
-            Point3 position = m_positionsList[particleIndex].last();
-            Point3 velocity = m_velocitiesList[particleIndex].last();
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Axisymmetric)
-                velocity.z = velocity.z / position.x; // v_phi = omega * r
-            double currentTimeStep = timeStep[particleIndex];
-            // qDebug() << currentTimeStep;
+        // all particles see the trajectories from the beginning of the round (independent on thread count)
+        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+            m_levels[particleIndex] = m_trajectories[particleIndex].size();
 
-            // Runge-Kutta steps
-            Point3 newPositionH;
-            Point3 newVelocityH;
+        if (m_settings.p2pOpeningAngle > 0.0)
+            buildTree(running);
 
-            // Butcher tableu
-            QVector<Point3> kp(butcher.get_size());
-            QVector<Point3> kv(butcher.get_size());
+        int numberOfRunning = running.size();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(m_settings.numberOfThreads)
+        for (int i = 0; i < numberOfRunning; i++)
+        {
+            ParticleState &state = m_states[running[i]];
 
-            int maxStepsRKF = 0;
-            while (!stopComputation[particleIndex] && maxStepsRKF < 100)
+            try
             {
-                bool butcherOK = true;
-
-                for (int k = 0; k < butcher.get_size(); k++)
-                {
-                    Point3 pos = position;
-                    Point3 vel = velocity;
-
-                    for (int l = 0; l < butcher.get_size(); l++)
-                    {
-                        if (l < k)
-                        {
-                            pos = pos + kp[l] * butcher.get_A(k, l);
-                            vel = vel + kv[l] * butcher.get_A(k, l);
-                        }
-                    }
-
-                    if ((Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleIncludeRelativisticCorrection).toBool())
-                            && ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar
-                                 ? vel.magnitude() : Point3(vel.x, vel.y, pos.x * vel.z).magnitude()) > SPEEDOFLIGHT))
-                    {
-                        // decrease time step
-                        butcherOK = false;
-                        break;
-                    }
-
-                    newtonEquations(particleIndex, currentTimeStep, pos, vel, &kp[k], &kv[k]);
-                }
-
-                if (butcherOK)
-                {
-                    // low order
-                    Point3 newPositionL = position;
-                    Point3 newVelocityL = velocity;
-                    for (int k = 0; k < butcher.get_size() - 1; k++)
-                    {
-                        newPositionL = newPositionL + kp[k] * butcher.get_B2(k);
-                        newVelocityL = newVelocityL + kv[k] * butcher.get_B2(k);
-                    }
-
-                    // high order
-                    newPositionH = position;
-                    newVelocityH = velocity;
-                    for (int k = 0; k < butcher.get_size(); k++)
-                    {
-                        newPositionH = newPositionH + kp[k] * butcher.get_B(k);
-                        newVelocityH = newVelocityH + kv[k] * butcher.get_B(k);
-                    }
-
-                    // optimal step estimation
-                    double absErrorPos = fabs(newPositionH.magnitude() - newPositionL.magnitude());
-                    double relErrorPos = fabs(absErrorPos / newPositionH.magnitude());
-                    double absErrorVel = fabs(newVelocityH.magnitude() - newVelocityL.magnitude());
-                    double relErrorVel = fabs(absErrorVel / newVelocityH.magnitude());
-                    double currentStepLength = ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
-                                                    (position - newPositionH).magnitude() :
-                                                    (Point3(position.x * cos(position.z), position.x * sin(position.z), position.y)
-                                                     - Point3(newPositionH.x * cos(newPositionH.z), newPositionH.x * sin(newPositionH.z), newPositionH.y)).magnitude());
-                    double currentStepVelocity = ((Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar) ?
-                                                      (velocity - newVelocityH).magnitude() :
-                                                      (Point3(velocity.x, velocity.y, position.x * velocity.z) - Point3(newVelocityH.x, newVelocityH.y, newPositionH.x * newVelocityH.z)).magnitude());
-
-                    // nearly zero step
-                    // qDebug() << "currentTimeStep" << currentTimeStep << "currentStepLength" << currentStepLength << "currentStepVelocity" << currentStepVelocity << "absErrorPos" << absErrorPos << "relErrorPos" << relErrorPos << "absErrorVel" << absErrorVel << "relErrorVel" << relErrorVel;
-                    if (currentStepLength < EPS_ZERO && currentStepVelocity < EPS_ZERO)
-                    {
-                        qDebug() << QString("Particle %1: time step is too short - refused.").arg(particleIndex);
-                        currentTimeStep *= 3.0;
-                        continue;
-                    }
-
-                    // minimum step
-                    if ((currentStepLength > maxStep) || (relErrorVel > relErrorMax && relErrorPos > relErrorMax))
-                    {
-                        // decrease step
-                        qDebug() << QString("Particle %1: time step is too long or relative error was exceeded - refused.").arg(particleIndex);
-                        currentTimeStep /= 2.0;
-                        continue;
-                    }
-                    // relative tolerance
-                    else if ((relErrorVel < relErrorMin && relErrorPos < relErrorMin))
-                    {
-                        // increase next step
-                        qDebug() << QString("Particle %1: time step increased.").arg(particleIndex);
-                        double optStep = 0.8 * currentTimeStep * pow((relErrorMin / relErrorPos), 0.25);
-                        if (relErrorPos > 0 && optStep > currentTimeStep)
-                            timeStep[particleIndex] = optStep;
-                        else
-                            timeStep[particleIndex] = 1.2 * currentTimeStep;
-                        break;
-                    }
-                    else
-                    {
-                        // store current time step
-                        timeStep[particleIndex] = currentTimeStep;
-                        break;
-                    }
-                }
-                else
-                {
-                    if (currentTimeStep < EPS_ZERO / 100.0)
-                    {
-                        // store current time step
-                        timeStep[particleIndex] = currentTimeStep;
-                        // stop computation
-                        break;
-                    }
-                    else
-                    {
-                        // decrease step
-                        qDebug() << QString("Particle %1: the speed of light was exceeded - refused.").arg(particleIndex);
-                        currentTimeStep /= 2.0;
-                        continue;
-                    }
-                }
+                computeStep(running[i]);
             }
-
-            // check crossing
-            QMap<SceneEdge *, Point> intersections;
-            foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+            catch (AgrosException &e)
             {
-                QList<Point> incts = intersection(Point(position.x, position.y), Point(newPositionH.x, newPositionH.y),
-                                                  Point(), 0.0, 0.0,
-                                                  edge->nodeStart()->point(), edge->nodeEnd()->point(),
-                                                  edge->center(), edge->radius(), edge->angle());
-
-                if (incts.length() > 0)
-                    foreach (Point p, incts)
-                        intersections.insert(edge, p);
+                state.error = e.toString();
+                state.stopComputation = true;
             }
-
-            // find the closest intersection
-            Point intersect;
-            SceneEdge *crossingEdge = NULL;
-            double distance = numeric_limits<double>::max();
-            for (QMap<SceneEdge *, Point>::const_iterator it = intersections.begin(); it != intersections.end(); ++it)
-                if ((it.value() - Point(position.x, position.y)).magnitude() < distance)
-                {
-                    distance = (it.value() - Point(position.x, position.y)).magnitude();
-
-                    crossingEdge = it.key();
-                    intersect = it.value();
-                }
-
-            if (crossingEdge && distance > EPS_ZERO)
+            catch (std::exception &e)
             {
-                bool impact = false;
-                foreach (FieldInfo* fieldInfo, Agros2D::problem()->fieldInfos())
-                {
-                    if ((Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble() < EPS_ZERO) || // no reflection
-                            (crossingEdge->marker(fieldInfo) == Agros2D::scene()->boundaries->getNone(fieldInfo)
-                             && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnDifferentMaterial).toBool()) || // inner edge
-                            (crossingEdge->marker(fieldInfo) != Agros2D::scene()->boundaries->getNone(fieldInfo)
-                             && !Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleReflectOnBoundary).toBool())) // boundary
-                        impact = true;
-                }
-
-                // current step ration
-                if (impact)
-                {
-                    newPositionH.x = intersect.x;
-                    newPositionH.y = intersect.y;
-
-                    // qDebug() << particleIndex << "impact";
-                    stopComputation[particleIndex] = true;
-                }
-                else
-                {
-                    // input vector moved to the origin
-                    Point vectin = Point(newPositionH.x, newPositionH.y) - intersect;
+                state.error = QString::fromStdString(e.what());
+                state.stopComputation = true;
+            }
+        }
 
-                    // tangent vector
-                    Point tangent;
-                    if (crossingEdge->isStraight())
-                        tangent = (crossingEdge->nodeStart()->point() - crossingEdge->nodeEnd()->point()).normalizePoint();
-                    else
-                        tangent = Point((intersect.y - crossingEdge->center().y), -(intersect.x - crossingEdge->center().x)).normalizePoint();
+        // add to the trajectories in fixed order
+        foreach (int particleIndex, running)
+            commitStep(particleIndex);
 
-                    Point idealReflectedPosition(intersect.x + (((tangent.x * tangent.x) - (tangent.y * tangent.y)) * vectin.x + 2.0*tangent.x*tangent.y * vectin.y),
-                                                 intersect.y + (2.0*tangent.x*tangent.y * vectin.x + ((tangent.y * tangent.y) - (tangent.x * tangent.x)) * vectin.y));
+        // global stop
+        bool stop = true;
+        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+            stop = stop && m_states[particleIndex].stopComputation;
+        globalStopComputation = stop;
+    }
+}
 
-                    double ratio = (Point(position.x, position.y) - intersect).magnitude()
-                            / (Point(newPositionH.x, newPositionH.y) - Point(position.x, position.y)).magnitude();
+void ParticleTracing::computeTrajectoryParticles(const QList<Point3> initialPositions, const QList<Point3> initialVelocities,
+                                                 const QList<double> particleCharges, const QList<double> particleMasses)
+{
+    assert(initialPositions.size() == initialVelocities.size());
+    assert(initialPositions.size() == particleCharges.size());
+    assert(initialPositions.size() == particleMasses.size());
+    assert(initialPositions.size() == Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleNumberOfParticles).toInt());
 
-                    // output vector
-                    Point vectout = (idealReflectedPosition - intersect).normalizePoint();
+    m_particleChargesList = particleCharges;
+    m_particleMassesList = particleMasses;
 
-                    // stop computation (impact distance is very very small)
-                    if ((fabs(distance / 100.0 * vectout.x) < EPS_ZERO) && (fabs(distance / 100.0 * vectout.y) < EPS_ZERO))
-                        stopComputation[particleIndex] = true;
+    clear();
 
-                    // output point
-                    newPositionH.x = intersect.x + distance / 100.0 * vectout.x;
-                    newPositionH.y = intersect.y + distance / 100.0 * vectout.y;
+    int numberOfParticles = initialPositions.size();
 
-                    // velocity in the direction of output vector
-                    Point3 oldv = newVelocityH;
-                    newVelocityH.x = vectout.x * Point(oldv.x, oldv.y).magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
-                    newVelocityH.y = vectout.y * Point(oldv.x, oldv.y).magnitude() * Agros2D::problem()->setting()->value(ProblemSetting::View_ParticleCoefficientOfRestitution).toDouble();
+    QTime timePart;
+    timePart.start();
 
-                    // set new timestep
-                    currentTimeStep = currentTimeStep * ratio;
-                    timeStep[particleIndex] = currentTimeStep;
-                }
-            }
+    RectPoint bound = Agros2D::scene()->boundingBox();
 
-            // new values
-            velocity = newVelocityH;
-            position = newPositionH;
+    m_maxStep = (m_settings.maximumStep > 0.0) ? m_settings.maximumStep : min(bound.width(), bound.height()) / 80.0;
+    m_relErrorMax = (m_settings.maximumRelativeError > 0.0) ? m_settings.maximumRelativeError : 1e-6;
+    m_relErrorMin = 1e-3;
 
-            // add to the lists
-            m_timesList[particleIndex].append(m_timesList[particleIndex].last() + currentTimeStep);
-            m_positionsList[particleIndex].append(position);
+    // initial positions
+    m_trajectories.resize(numberOfParticles);
+    m_states.resize(numberOfParticles);
+    m_levels.resize(numberOfParticles);
+    for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+    {
+        // position and velocity buffers
+        m_trajectories[particleIndex].reserve(qMin(m_settings.maximumNumberOfSteps + 1, PARTICLE_TRAJECTORY_RESERVE));
+        m_trajectories[particleIndex].append(initialPositions[particleIndex], initialVelocities[particleIndex], 0.0);
+
+        // timeStep = initialVelocities[particleIndex].magnitude() > 0
+        //            ? qMax(bound.width(), bound.height()) / initialVelocities[particleIndex].magnitude() / 10 : 1e-11;
+        m_states[particleIndex].timeStep = 1e-11;
+        m_states[particleIndex].activeElements.fill(NULL, m_fieldInfos.size());
+        m_states[particleIndex].activeMaterials.fill(NULL, m_fieldInfos.size());
+    }
 
-            // velocities in planar and axisymmetric arrangement
-            if (Agros2D::problem()->config()->coordinateType() == CoordinateType_Planar)
-                m_velocitiesList[particleIndex].append(velocity);
-            else
-                m_velocitiesList[particleIndex].append(Point3(velocity.x, velocity.y, position.x * velocity.z)); // v_phi = omega * r
-        }
+    if (m_settings.p2pElectricForce || m_settings.p2pMagneticForce)
+        computeInteractingParticles();
+    else
+        computeIndependentParticles();
 
-        // global stop
-        bool stop = true;
-        for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
-            stop = stop && stopComputation[particleIndex];
-        globalStopComputation = stop;
-    }
+    // report the first failure
+    for (int particleIndex = 0; particleIndex < numberOfParticles; particleIndex++)
+        if (!m_states[particleIndex].error.isEmpty())
+            throw AgrosException(m_states[particleIndex].error);
 
     // velocity min and max value
-    for (int i = 0; i < m_velocitiesList.length(); i++)
+    foreach (ParticleTrajectory trajectory, m_trajectories)
     {
-        for (int j = 0; j < m_velocitiesList[i].length(); j++)
+        for (int i = 0; i < trajectory.size(); i++)
         {
-            double velocity = m_velocitiesList[i][j].magnitude();
+            double velocity = trajectory.velocity(i).magnitude();
 
             if (velocity < m_velocityMin) m_velocityMin = velocity;
             if (velocity > m_velocityMax) m_velocityMax = velocity;
@@ -28,9 +28,73 @@
 
 #include "hermes2d/solutiontypes.h"
 
+#include "particle_tree.h"
+#include "mesh_hash.h"
+
 class FieldInfo;
 class SceneMaterial;
 
+// settings snapshot (problem settings are read once, not in the integration loop)
+struct ParticleTracingSettings
+{
+    ParticleTracingSettings();
+
+    CoordinateType coordinateType;
+    Hermes::ButcherTableType butcherTableType;
+
+    int maximumNumberOfSteps;
+    double maximumStep;
+    double maximumRelativeError;
+
+    bool includeRelativisticCorrection;
+    bool p2pElectricForce;
+    bool p2pMagneticForce;
+    // Barnes-Hut opening angle (0 - direct summation)
+    double p2pOpeningAngle;
+
+    Point3 customForce;
+    double dragDensity;
+    double dragCoefficient;
+    double dragReferenceArea;
+
+    double coefficientOfRestitution;
+    bool reflectOnDifferentMaterial;
+    bool reflectOnBoundary;
+
+    int numberOfThreads;
+};
+
+// trajectory of one particle (structure of arrays)
+class ParticleTrajectory
+{
+public:
+    void clear();
+    void reserve(int size);
+    void append(const Point3 &position, const Point3 &velocity, double time);
+
+    inline int size() const { return m_time.size(); }
+
+    inline Point3 position(int i) const { return Point3(m_x[i], m_y[i], m_z[i]); }
+    inline Point3 velocity(int i) const { return Point3(m_vx[i], m_vy[i], m_vz[i]); }
+    inline double time(int i) const { return m_time[i]; }
+
+    inline Point3 lastPosition() const { return position(size() - 1); }
+    inline Point3 lastVelocity() const { return velocity(size() - 1); }
+    inline double lastTime() const { return m_time.last(); }
+
+    // level of given time, only first "levels" items are used
+    int timeToLevel(double time, int levels) const;
+
+private:
+    QVector<double> m_x;
+    QVector<double> m_y;
+    QVector<double> m_z;
+    QVector<double> m_vx;
+    QVector<double> m_vy;
+    QVector<double> m_vz;
+    QVector<double> m_time;
+};
+
 class ParticleTracing : public QObject
 {
     Q_OBJECT
@@ -44,30 +108,62 @@ public:
     void computeTrajectoryParticles(const QList<Point3> initialPositions, const QList<Point3> initialVelocities,
                                     const QList<double> particleCharges, const QList<double> particleMasses);
 
-    inline QList<QList<Point3> > positions() const { return m_positionsList; }
-    inline QList<QList<Point3> > velocities() const { return m_velocitiesList; }
-    inline QList<QList<double> > times() const { return m_timesList; }
+    QList<QList<Point3> > positions() const;
+    QList<QList<Point3> > velocities() const;
+    QList<QList<double> > times() const;
 
     inline double velocityMin() const { return m_velocityMin; }
     inline double velocityMax() const { return m_velocityMax; }
 
 private:
+    // state of one particle, each particle is advanced by one thread at a time
+    struct ParticleState
+    {
+        ParticleState() : timeStep(0.0), numberOfSteps(0), stopComputation(false) {}
+
+        double timeStep;
+        int numberOfSteps;
+        bool stopComputation;
+
+        // element location cache (one item per force field)
+        QVector<Hermes::Hermes2D::Element *> activeElements;
+        QVector<SceneMaterial *> activeMaterials;
+
+        // result of the last step
+        Point3 newPosition;
+        Point3 newVelocity;
+        double newTimeStep;
+
+        QString error;
+    };
+
+    ParticleTracingSettings m_settings;
+
+    // force fields
+    QList<FieldInfo *> m_fieldInfos;
+    QList<FieldSolutionID> m_solutionIDs;
+    QList<QSharedPointer<MeshHash> > m_meshHashes;
+
     // input
     QList<double> m_particleChargesList;
     QList<double> m_particleMassesList;
 
+    double m_maxStep;
+    double m_relErrorMax;
+    double m_relErrorMin;
+
     // output
-    QList<QList<Point3> > m_positionsList;
-    QList<QList<Point3> > m_velocitiesList;
-    QList<QList<double> > m_timesList;
+    QVector<ParticleTrajectory> m_trajectories;
+    QVector<ParticleState> m_states;
+
+    // number of trajectory items visible to particle to particle forces
+    QVector<int> m_levels;
+    // particles at the synchronized time of the round
+    ParticleTree m_tree;
 
     double m_velocityMin;
     double m_velocityMax;
 
-    QMap<FieldInfo *, FieldSolutionID> m_solutionIDs;
-    QMap<FieldInfo *, Hermes::Hermes2D::MeshSharedPtr> m_meshes;
-    QMap<FieldInfo *, Hermes::Hermes2D::Element *> m_activeElement;
-
     Point3 force(int particleIndex, Point3 position, Point3 velocity);
 
     bool newtonEquations(int particleIndex,
@@ -77,7 +173,14 @@ private:
                          Point3 *newposition,
                          Point3 *newvelocity);
 
-    int timeToLevel(int particleIndex, double time);
+    bool isStopped(int particleIndex);
+    void computeStep(int particleIndex);
+    void commitStep(int particleIndex);
+
+    void buildTree(const QVector<int> &running);
+
+    void computeIndependentParticles();
+    void computeInteractingParticles();
 };
 
 
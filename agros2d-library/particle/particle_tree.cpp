@@ -0,0 +1,243 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "particle_tree.h"
+
+ParticleTree::Node::Node(const Point3 &center, double halfSize)
+    : center(center), halfSize(halfSize), charge(0.0), weight(0.0)
+{
+    for (int i = 0; i < 8; i++)
+        children[i] = -1;
+}
+
+ParticleTree::ParticleTree(double openingAngle) : m_openingAngle(openingAngle)
+{
+}
+
+void ParticleTree::clear()
+{
+    m_nodes.clear();
+    m_positions.clear();
+    m_velocities.clear();
+    m_charges.clear();
+}
+
+void ParticleTree::build(const QVector<Point3> &positions, const QVector<Point3> &velocities, const QVector<double> &charges)
+{
+    assert(positions.size() == velocities.size());
+    assert(positions.size() == charges.size());
+
+    clear();
+
+    m_positions = positions;
+    m_velocities = velocities;
+    m_charges = charges;
+
+    if (m_positions.isEmpty())
+        return;
+
+    // bounding cube
+    Point3 lower = m_positions.first();
+    Point3 upper = m_positions.first();
+    foreach (Point3 point, m_positions)
+    {
+        lower = Point3(qMin(lower.x, point.x), qMin(lower.y, point.y), qMin(lower.z, point.z));
+        upper = Point3(qMax(upper.x, point.x), qMax(upper.y, point.y), qMax(upper.z, point.z));
+    }
+
+    double halfSize = qMax(upper.x - lower.x, qMax(upper.y - lower.y, upper.z - lower.z)) / 2.0;
+    halfSize = (halfSize > 0.0) ? halfSize * (1.0 + 1e-6) : 1.0;
+
+    m_nodes.reserve(2 * m_positions.size() / LEAF_SIZE + 1);
+    m_nodes.append(Node((lower + upper) / 2.0, halfSize));
+
+    // particles are inserted in fixed order (tree does not depend on the number of threads)
+    for (int i = 0; i < m_positions.size(); i++)
+        insert(i);
+
+    aggregate(0);
+}
+
+int ParticleTree::octant(const Node &node, const Point3 &point) const
+{
+    return ((point.x >= node.center.x) ? 1 : 0)
+            + ((point.y >= node.center.y) ? 2 : 0)
+            + ((point.z >= node.center.z) ? 4 : 0);
+}
+
+void ParticleTree::insert(int particleIndex)
+{
+    int nodeIndex = 0;
+    int depth = 0;
+
+    while (true)
+    {
+        if (m_nodes[nodeIndex].isLeaf())
+        {
+            if (m_nodes[nodeIndex].particles.size() < LEAF_SIZE || depth >= MAX_DEPTH)
+            {
+                m_nodes[nodeIndex].particles.append(particleIndex);
+                return;
+            }
+
+            split(nodeIndex);
+        }
+
+        nodeIndex = m_nodes[nodeIndex].children[octant(m_nodes[nodeIndex], m_positions[particleIndex])];
+        depth++;
+    }
+}
+
+void ParticleTree::split(int nodeIndex)
+{
+    Point3 center = m_nodes[nodeIndex].center;
+    double halfSize = m_nodes[nodeIndex].halfSize / 2.0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        Point3 childCenter(center.x + ((i & 1) ? halfSize : -halfSize),
+                           center.y + ((i & 2) ? halfSize : -halfSize),
+                           center.z + ((i & 4) ? halfSize : -halfSize));
+
+        // append could reallocate nodes
+        m_nodes.append(Node(childCenter, halfSize));
+        m_nodes[nodeIndex].children[i] = m_nodes.size() - 1;
+    }
+
+    // move particles to the children
+    foreach (int particleIndex, m_nodes[nodeIndex].particles)
+    {
+        int child = m_nodes[nodeIndex].children[octant(m_nodes[nodeIndex], m_positions[particleIndex])];
+        m_nodes[child].particles.append(particleIndex);
+    }
+    m_nodes[nodeIndex].particles.clear();
+}
+
+void ParticleTree::aggregate(int nodeIndex)
+{
+    double charge = 0.0;
+    double weight = 0.0;
+    Point3 chargeCenter;
+    Point3 velocity;
+
+    if (m_nodes[nodeIndex].isLeaf())
+    {
+        foreach (int particleIndex, m_nodes[nodeIndex].particles)
+        {
+            double w = fabs(m_charges[particleIndex]);
+
+            charge += m_charges[particleIndex];
+            weight += w;
+            chargeCenter = chargeCenter + m_positions[particleIndex] * w;
+            velocity = velocity + m_velocities[particleIndex] * w;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            int child = m_nodes[nodeIndex].children[i];
+            aggregate(child);
+
+            const Node &node = m_nodes[child];
+            charge += node.charge;
+            weight += node.weight;
+            chargeCenter = chargeCenter + node.chargeCenter * node.weight;
+            velocity = velocity + node.velocity * node.weight;
+        }
+    }
+
+    Node &node = m_nodes[nodeIndex];
+    node.charge = charge;
+    node.weight = weight;
+    if (weight > 0.0)
+    {
+        node.chargeCenter = chargeCenter / weight;
+        node.velocity = velocity / weight;
+    }
+    else
+    {
+        node.chargeCenter = node.center;
+    }
+}
+
+void ParticleTree::addPair(const Point3 &position, const Point3 &velocity,
+                           const Point3 &sourcePosition, const Point3 &sourceVelocity, double sourceCharge,
+                           bool electric, bool magnetic,
+                           Point3 &forceElectric, Point3 &forceMagnetic) const
+{
+    double distance = (position - sourcePosition).magnitude();
+    if (distance > 0)
+    {
+        Point3 r0 = (position - sourcePosition) / distance;
+
+        if (electric)
+            forceElectric = forceElectric + r0 * (sourceCharge / (4 * M_PI * EPS0 * distance * distance));
+
+        // v x B, B of the moving source charge (Biot-Savart)
+        if (magnetic)
+            forceMagnetic = forceMagnetic + (velocity % (sourceVelocity % r0)) * (sourceCharge * MU0 / (4 * M_PI * distance * distance));
+    }
+}
+
+void ParticleTree::evaluate(int particleIndex, const Point3 &position, const Point3 &velocity,
+                            bool electric, bool magnetic,
+                            Point3 &forceElectric, Point3 &forceMagnetic) const
+{
+    forceElectric = Point3();
+    forceMagnetic = Point3();
+
+    if (m_nodes.isEmpty())
+        return;
+
+    const Point3 &particlePosition = m_positions[particleIndex];
+
+    QVector<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node &node = m_nodes[stack.last()];
+        stack.removeLast();
+
+        if (node.weight == 0.0)
+            continue;
+
+        if (node.isLeaf())
+        {
+            foreach (int sourceIndex, node.particles)
+                if (sourceIndex != particleIndex)
+                    addPair(position, velocity,
+                            m_positions[sourceIndex], m_velocities[sourceIndex], m_charges[sourceIndex],
+                            electric, magnetic, forceElectric, forceMagnetic);
+        }
+        else if (!node.contains(particlePosition)
+                 && 2.0 * node.halfSize < m_openingAngle * (position - node.chargeCenter).magnitude())
+        {
+            // far node
+            addPair(position, velocity,
+                    node.chargeCenter, node.velocity, node.charge,
+                    electric, magnetic, forceElectric, forceMagnetic);
+        }
+        else
+        {
+            for (int i = 7; i >= 0; i--)
+                stack.append(node.children[i]);
+        }
+    }
+}
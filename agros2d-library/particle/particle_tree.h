@@ -0,0 +1,90 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef PARTICLETREE_H
+#define PARTICLETREE_H
+
+#include "util.h"
+#include "util/point.h"
+
+// Barnes-Hut octree for particle to particle forces
+// (cartesian coordinates, far nodes are replaced by their total charge)
+class ParticleTree
+{
+public:
+    ParticleTree(double openingAngle = 0.5);
+
+    void clear();
+    void build(const QVector<Point3> &positions, const QVector<Point3> &velocities, const QVector<double> &charges);
+
+    inline double openingAngle() const { return m_openingAngle; }
+    inline void setOpeningAngle(double openingAngle) { m_openingAngle = openingAngle; }
+
+    // forces per unit charge of the particle, particle itself is excluded
+    void evaluate(int particleIndex, const Point3 &position, const Point3 &velocity,
+                  bool electric, bool magnetic,
+                  Point3 &forceElectric, Point3 &forceMagnetic) const;
+
+private:
+    struct Node
+    {
+        Node(const Point3 &center = Point3(), double halfSize = 0.0);
+
+        Point3 center;
+        double halfSize;
+
+        // charge and charge weighted position and velocity
+        double charge;
+        double weight;
+        Point3 chargeCenter;
+        Point3 velocity;
+
+        int children[8];
+        QVector<int> particles;
+
+        inline bool isLeaf() const { return children[0] == -1; }
+        inline bool contains(const Point3 &point) const
+        {
+            return (fabs(point.x - center.x) <= halfSize) && (fabs(point.y - center.y) <= halfSize) && (fabs(point.z - center.z) <= halfSize);
+        }
+    };
+
+    static const int LEAF_SIZE = 8;
+    static const int MAX_DEPTH = 24;
+
+    double m_openingAngle;
+
+    QVector<Node> m_nodes;
+    QVector<Point3> m_positions;
+    QVector<Point3> m_velocities;
+    QVector<double> m_charges;
+
+    void insert(int particleIndex);
+    void split(int nodeIndex);
+    void aggregate(int nodeIndex);
+
+    int octant(const Node &node, const Point3 &point) const;
+
+    void addPair(const Point3 &position, const Point3 &velocity,
+                 const Point3 &sourcePosition, const Point3 &sourceVelocity, double sourceCharge,
+                 bool electric, bool magnetic,
+                 Point3 &forceElectric, Point3 &forceMagnetic) const;
+};
+
+#endif // PARTICLETREE_H
@@ -365,6 +365,7 @@ QWidget *FieldWidget::createAdaptivityWidget()
     cmbAdaptivityErrorCalculator = new QComboBox();
     chkAdaptivityUseAniso = new QCheckBox(tr("Use anisotropic refinements"));
     chkAdaptivityFinerReference = new QCheckBox(tr("Use hp reference solution for h and p adaptivity"));
+    chkAdaptivityWarmStart = new QCheckBox(tr("Use previous reference solution as initial guess"));
     txtAdaptivityOrderIncrease = new QSpinBox(this);
     txtAdaptivityOrderIncrease->setMinimum(1);
     txtAdaptivityOrderIncrease->setMaximum(10);
@@ -402,6 +403,7 @@ QWidget *FieldWidget::createAdaptivityWidget()
     layoutAdaptivityReferenceSolution->addWidget(chkAdaptivitySpaceRefinement, 0, 2);
     layoutAdaptivityReferenceSolution->addWidget(chkAdaptivityUseAniso, 1, 2);
     layoutAdaptivityReferenceSolution->addWidget(chkAdaptivityFinerReference, 2, 2);
+    layoutAdaptivityReferenceSolution->addWidget(chkAdaptivityWarmStart, 3, 2);
     layoutAdaptivityReferenceSolution->setRowStretch(50, 1);
 
     QGroupBox *grpReferenceSolution = new QGroupBox(tr("Reference solution"), this);
@@ -455,6 +457,17 @@ QWidget *FieldWidget::createTransientAnalysisWidget()
 
 QWidget *FieldWidget::createLinearSolverWidget()
 {
+    cmbLinearSolverReuse = new QComboBox();
+
+    QGridLayout *reuseLayout = new QGridLayout();
+    reuseLayout->setColumnMinimumWidth(0, columnMinimumWidth());
+    reuseLayout->setColumnStretch(1, 1);
+    reuseLayout->addWidget(new QLabel(tr("Reuse of matrix:")), 0, 0);
+    reuseLayout->addWidget(cmbLinearSolverReuse, 0, 1);
+
+    QGroupBox *reuseGroup = new QGroupBox(tr("Matrix reuse"));
+    reuseGroup->setLayout(reuseLayout);
+
     cmbIterLinearSolverMethod = new QComboBox();
     cmbIterLinearSolverPreconditioner = new QComboBox();
     txtIterLinearSolverToleranceAbsolute = new LineEditDouble(1e-15);
@@ -477,6 +490,7 @@ QWidget *FieldWidget::createLinearSolverWidget()
     iterSolverGroup->setLayout(iterSolverLayout);
 
     QVBoxLayout *layoutLinearSolver = new QVBoxLayout();
+    layoutLinearSolver->addWidget(reuseGroup);
     layoutLinearSolver->addWidget(iterSolverGroup);
     layoutLinearSolver->addStretch();
 
@@ -534,6 +548,10 @@ void FieldWidget::fillComboBox()
     foreach(Module::ErrorCalculator calc, m_fieldInfo->errorCalculators())
         cmbAdaptivityErrorCalculator->addItem(calc.name(), calc.id());
 
+    cmbLinearSolverReuse->clear();
+    foreach (QString type, matrixReuseTypeStringKeys())
+        cmbLinearSolverReuse->addItem(matrixReuseTypeString(matrixReuseTypeFromStringKey(type)), matrixReuseTypeFromStringKey(type));
+
     cmbIterLinearSolverMethod->clear();
     foreach (QString method, iterLinearSolverMethodStringKeys())
         cmbIterLinearSolverMethod->addItem(iterLinearSolverMethodString(iterLinearSolverMethodFromStringKey(method)), iterLinearSolverMethodFromStringKey(method));
@@ -559,6 +577,7 @@ void FieldWidget::load()
     cmbAdaptivityErrorCalculator->setCurrentIndex(cmbAdaptivityErrorCalculator->findData(m_fieldInfo->value(FieldInfo::AdaptivityErrorCalculator).toString()));
     chkAdaptivityUseAniso->setChecked(m_fieldInfo->value(FieldInfo::AdaptivityUseAniso).toBool());
     chkAdaptivityFinerReference->setChecked(m_fieldInfo->value(FieldInfo::AdaptivityFinerReference).toBool());
+    chkAdaptivityWarmStart->setChecked(m_fieldInfo->value(FieldInfo::AdaptivityWarmStart).toBool());
     txtAdaptivityOrderIncrease->setValue(m_fieldInfo->value(FieldInfo::AdaptivityOrderIncrease).toInt());
     chkAdaptivitySpaceRefinement->setChecked(m_fieldInfo->value(FieldInfo::AdaptivitySpaceRefinement).toBool());
     txtAdaptivityBackSteps->setValue(m_fieldInfo->value(FieldInfo::AdaptivityTransientBackSteps).toInt());
@@ -588,6 +607,7 @@ void FieldWidget::load()
     txtPicardAndersonBeta->setValue(m_fieldInfo->value(FieldInfo::PicardAndersonBeta).toDouble());
     txtPicardAndersonNumberOfLastVectors->setValue(m_fieldInfo->value(FieldInfo::PicardAndersonNumberOfLastVectors).toInt());
     // linear solver
+    cmbLinearSolverReuse->setCurrentIndex(cmbLinearSolverReuse->findData(m_fieldInfo->value(FieldInfo::LinearSolverReuse).toInt()));
     cmbIterLinearSolverMethod->setCurrentIndex((Hermes::Solvers::IterSolverType) cmbIterLinearSolverMethod->findData(m_fieldInfo->value(FieldInfo::LinearSolverIterMethod).toInt()));
     cmbIterLinearSolverPreconditioner->setCurrentIndex((Hermes::Solvers::PreconditionerType) cmbIterLinearSolverPreconditioner->findData(m_fieldInfo->value(FieldInfo::LinearSolverIterPreconditioner).toInt()));
     txtIterLinearSolverToleranceAbsolute->setValue(m_fieldInfo->value(FieldInfo::LinearSolverIterToleranceAbsolute).toDouble());
@@ -609,6 +629,7 @@ bool FieldWidget::save()
     m_fieldInfo->setValue(FieldInfo::AdaptivityErrorCalculator, cmbAdaptivityErrorCalculator->itemData(cmbAdaptivityErrorCalculator->currentIndex()).toString());
     m_fieldInfo->setValue(FieldInfo::AdaptivityUseAniso, chkAdaptivityUseAniso->isChecked());
     m_fieldInfo->setValue(FieldInfo::AdaptivityFinerReference, chkAdaptivityFinerReference->isChecked());
+    m_fieldInfo->setValue(FieldInfo::AdaptivityWarmStart, chkAdaptivityWarmStart->isChecked());
     m_fieldInfo->setValue(FieldInfo::AdaptivityOrderIncrease, txtAdaptivityOrderIncrease->value());
     m_fieldInfo->setValue(FieldInfo::AdaptivitySpaceRefinement, chkAdaptivitySpaceRefinement->isChecked());
     m_fieldInfo->setValue(FieldInfo::AdaptivityTransientBackSteps, txtAdaptivityBackSteps->value());
@@ -636,6 +657,7 @@ bool FieldWidget::save()
     m_fieldInfo->setValue(FieldInfo::PicardAndersonBeta, txtPicardAndersonBeta->value());
     m_fieldInfo->setValue(FieldInfo::PicardAndersonNumberOfLastVectors, txtPicardAndersonNumberOfLastVectors->value());
     // linear solver
+    m_fieldInfo->setValue(FieldInfo::LinearSolverReuse, cmbLinearSolverReuse->itemData(cmbLinearSolverReuse->currentIndex()).toInt());
     m_fieldInfo->setValue(FieldInfo::LinearSolverIterMethod, cmbIterLinearSolverMethod->itemData(cmbIterLinearSolverMethod->currentIndex()).toInt());
     m_fieldInfo->setValue(FieldInfo::LinearSolverIterPreconditioner, cmbIterLinearSolverPreconditioner->itemData(cmbIterLinearSolverPreconditioner->currentIndex()).toInt());
     m_fieldInfo->setValue(FieldInfo::LinearSolverIterToleranceAbsolute, txtIterLinearSolverToleranceAbsolute->value());
@@ -708,6 +730,7 @@ void FieldWidget::doAdaptivityChanged(int index)
     chkAdaptivitySpaceRefinement->setEnabled((AdaptivityType) cmbAdaptivityType->itemData(index).toInt() != AdaptivityType_None);
     txtAdaptivityOrderIncrease->setEnabled((AdaptivityType) cmbAdaptivityType->itemData(index).toInt() != AdaptivityType_None);
     chkAdaptivityFinerReference->setEnabled((AdaptivityType) cmbAdaptivityType->itemData(index).toInt() != AdaptivityType_None);
+    chkAdaptivityWarmStart->setEnabled((AdaptivityType) cmbAdaptivityType->itemData(index).toInt() != AdaptivityType_None);
 
     AnalysisType analysisType = (AnalysisType) cmbAnalysisType->itemData(cmbAnalysisType->currentIndex()).toInt();
     txtAdaptivityBackSteps->setEnabled(Agros2D::problem()->isTransient() && analysisType != AnalysisType_Transient && (AdaptivityType) cmbAdaptivityType->itemData(index).toInt() != AdaptivityType_None);
@@ -1176,6 +1199,7 @@ void ProblemWidget::createControls()
     lblTransientTimeTotal = new QLabel("Total time");
     txtTransientTolerance = new LineEditDouble(0.1);
     txtTransientTolerance->setBottom(0.0);
+    cmbTransientErrorEstimator = new QComboBox();
     chkTransientInitialStepSize = new QCheckBox(this);
     txtTransientInitialStepSize = new LineEditDouble(0.01);
     txtTransientInitialStepSize->setBottom(0);
@@ -1195,15 +1219,17 @@ void ProblemWidget::createControls()
     layoutTransientAnalysis->addWidget(txtTransientOrder, 1, 2);
     layoutTransientAnalysis->addWidget(new QLabel(tr("Tolerance:")), 2, 0, 1, 2);
     layoutTransientAnalysis->addWidget(txtTransientTolerance, 2, 2);
-    layoutTransientAnalysis->addWidget(lblTransientTimeTotal, 3, 0, 1, 2);
-    layoutTransientAnalysis->addWidget(txtTransientTimeTotal, 3, 2);
-    layoutTransientAnalysis->addWidget(lblTransientSteps, 4, 0, 1, 2);
-    layoutTransientAnalysis->addWidget(txtTransientSteps, 4, 2);
-    layoutTransientAnalysis->addWidget(new QLabel(tr("Initial time step:")), 5, 0);
-    layoutTransientAnalysis->addWidget(chkTransientInitialStepSize, 5, 1, 1, 1, Qt::AlignRight);
-    layoutTransientAnalysis->addWidget(txtTransientInitialStepSize, 5, 2);
-    layoutTransientAnalysis->addWidget(new QLabel(tr("Constant time step:")), 6, 0, 1, 2);
-    layoutTransientAnalysis->addWidget(lblTransientTimeStep, 6, 2);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Error estimator:")), 3, 0, 1, 2);
+    layoutTransientAnalysis->addWidget(cmbTransientErrorEstimator, 3, 2);
+    layoutTransientAnalysis->addWidget(lblTransientTimeTotal, 4, 0, 1, 2);
+    layoutTransientAnalysis->addWidget(txtTransientTimeTotal, 4, 2);
+    layoutTransientAnalysis->addWidget(lblTransientSteps, 5, 0, 1, 2);
+    layoutTransientAnalysis->addWidget(txtTransientSteps, 5, 2);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Initial time step:")), 6, 0);
+    layoutTransientAnalysis->addWidget(chkTransientInitialStepSize, 6, 1, 1, 1, Qt::AlignRight);
+    layoutTransientAnalysis->addWidget(txtTransientInitialStepSize, 6, 2);
+    layoutTransientAnalysis->addWidget(new QLabel(tr("Constant time step:")), 7, 0, 1, 2);
+    layoutTransientAnalysis->addWidget(lblTransientTimeStep, 7, 2);
 
     grpTransientAnalysis = new QGroupBox(tr("Transient analysis"));
     grpTransientAnalysis->setLayout(layoutTransientAnalysis);
@@ -1302,6 +1328,9 @@ void ProblemWidget::fillComboBox()
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_Fixed), TimeStepMethod_Fixed);
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_BDFTolerance), TimeStepMethod_BDFTolerance);
     cmbTransientMethod->addItem(timeStepMethodString(TimeStepMethod_BDFNumSteps), TimeStepMethod_BDFNumSteps);
+
+    cmbTransientErrorEstimator->addItem(timeErrorEstimatorString(TimeErrorEstimator_LowerOrder), TimeErrorEstimator_LowerOrder);
+    cmbTransientErrorEstimator->addItem(timeErrorEstimatorString(TimeErrorEstimator_Embedded), TimeErrorEstimator_Embedded);
 }
 
 void ProblemWidget::updateControls()
@@ -1313,6 +1342,7 @@ void ProblemWidget::updateControls()
     txtFrequency->disconnect();
 
     cmbTransientMethod->disconnect();
+    cmbTransientErrorEstimator->disconnect();
     txtTransientOrder->disconnect();
     txtTransientTimeTotal->disconnect();
     txtTransientTolerance->disconnect();
@@ -1346,6 +1376,9 @@ void ProblemWidget::updateControls()
     cmbTransientMethod->setCurrentIndex(cmbTransientMethod->findData((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()));
     if (cmbTransientMethod->currentIndex() == -1)
         cmbTransientMethod->setCurrentIndex(0);
+    cmbTransientErrorEstimator->setCurrentIndex(cmbTransientErrorEstimator->findData((TimeErrorEstimator) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimator).toInt()));
+    if (cmbTransientErrorEstimator->currentIndex() == -1)
+        cmbTransientErrorEstimator->setCurrentIndex(0);
 
     lblTransientTimeTotal->setText(QString("Total time (%1)").arg(Agros2D::problem()->timeUnit()));
 
@@ -1369,6 +1402,7 @@ void ProblemWidget::updateControls()
 
     // transient
     connect(cmbTransientMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(changedWithClear()));
+    connect(cmbTransientErrorEstimator, SIGNAL(currentIndexChanged(int)), this, SLOT(changedWithClear()));
     connect(txtTransientSteps, SIGNAL(valueChanged(int)), this, SLOT(changedWithClear()));
     connect(txtTransientTimeTotal, SIGNAL(textChanged(QString)), this, SLOT(changedWithClear()));
     connect(txtTransientOrder, SIGNAL(valueChanged(int)), this, SLOT(changedWithClear()));
@@ -1397,6 +1431,7 @@ void ProblemWidget::changedWithClear()
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethod, (TimeStepMethod) cmbTransientMethod->itemData(cmbTransientMethod->currentIndex()).toInt());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeOrder, txtTransientOrder->value());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodTolerance, txtTransientTolerance->value());
+    Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodErrorEstimator, (TimeErrorEstimator) cmbTransientErrorEstimator->itemData(cmbTransientErrorEstimator->currentIndex()).toInt());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeConstantTimeSteps, txtTransientSteps->value());
     Agros2D::problem()->config()->setValue(ProblemConfig::TimeTotal, txtTransientTimeTotal->value());
     txtTransientInitialStepSize->setEnabled(chkTransientInitialStepSize->isChecked());
@@ -1428,6 +1463,7 @@ void ProblemWidget::transientChanged()
         chkTransientInitialStepSize->setEnabled(false);
         txtTransientInitialStepSize->setEnabled(false);
         txtTransientTolerance->setEnabled(false);
+        cmbTransientErrorEstimator->setEnabled(false);
         txtTransientSteps->setEnabled(true);
 
     }
@@ -1435,12 +1471,14 @@ void ProblemWidget::transientChanged()
     {
         chkTransientInitialStepSize->setEnabled(true);
         txtTransientTolerance->setEnabled(true);
+        cmbTransientErrorEstimator->setEnabled(true);
         txtTransientSteps->setEnabled(false);
     }
     else if (((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) == TimeStepMethod_BDFNumSteps)
     {
         chkTransientInitialStepSize->setEnabled(true);
         txtTransientTolerance->setEnabled(false);
+        cmbTransientErrorEstimator->setEnabled(true);
         txtTransientSteps->setEnabled(true);
     }
 
@@ -115,6 +115,7 @@ private:
     QComboBox *cmbAdaptivityStoppingCriterionType;
     QCheckBox *chkAdaptivityUseAniso;
     QCheckBox *chkAdaptivityFinerReference;
+    QCheckBox *chkAdaptivityWarmStart;
     QSpinBox *txtAdaptivityOrderIncrease;
     QCheckBox *chkAdaptivitySpaceRefinement;
     QSpinBox *txtAdaptivityBackSteps;
@@ -152,6 +153,7 @@ private:
     LineEditDouble *txtTransientTimeSkip;
 
     // linear solver
+    QComboBox *cmbLinearSolverReuse;
     QComboBox *cmbIterLinearSolverMethod;
     QComboBox *cmbIterLinearSolverPreconditioner;
     LineEditDouble *txtIterLinearSolverToleranceAbsolute;
@@ -257,6 +259,7 @@ private:
     QLabel *lblTransientTimeTotal;
     QSpinBox *txtTransientOrder;
     QComboBox *cmbTransientMethod;
+    QComboBox *cmbTransientErrorEstimator;
     QLabel *lblTransientTimeStep;
 
     // couplings
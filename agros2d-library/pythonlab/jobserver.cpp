@@ -0,0 +1,412 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "jobserver.h"
+
+// largest accepted frame (problem or script)
+const quint32 MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+JobServer::JobServer(int port, int numberOfWorkers)
+    : m_numberOfWorkers(numberOfWorkers > 0 ? numberOfWorkers : QThread::idealThreadCount()), m_lastJobID(0)
+{
+    // local clients only, failure is checked by isListening()
+    if (!listen(QHostAddress::LocalHost, port))
+    {
+        Hermes::Mixins::Loggable::Static::error(tr("Error: Unable to start the job server: %1.").arg(errorString()).toLatin1());
+        return;
+    }
+
+    Hermes::Mixins::Loggable::Static::warn(tr("The job server is running on IP: %1, port: %2, workers: %3").
+                                           arg(QHostAddress(QHostAddress::LocalHost).toString()).
+                                           arg(serverPort()).
+                                           arg(m_numberOfWorkers).toLatin1());
+
+    connect(this, SIGNAL(newConnection()), this, SLOT(connected()));
+}
+
+JobServer::~JobServer()
+{
+    foreach (Job job, m_running)
+    {
+        job.process->disconnect();
+        job.process->kill();
+        job.process->waitForFinished();
+        delete job.process;
+
+        removeDirectory(jobDir(job.id));
+    }
+
+    foreach (Job job, m_queue)
+        removeDirectory(jobDir(job.id));
+
+    foreach (Job job, m_finished)
+        removeDirectory(jobDir(job.id));
+}
+
+void JobServer::connected()
+{
+    while (hasPendingConnections())
+    {
+        QTcpSocket *client = nextPendingConnection();
+        m_frameSizes[client] = 0;
+
+        connect(client, SIGNAL(readyRead()), this, SLOT(readFrames()));
+        connect(client, SIGNAL(disconnected()), this, SLOT(disconnected()));
+    }
+}
+
+void JobServer::readFrames()
+{
+    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+    assert(client);
+
+    QDataStream in(client);
+    while (true)
+    {
+        if (m_frameSizes[client] == 0)
+        {
+            if (client->bytesAvailable() < (qint64) sizeof(quint32))
+                return;
+
+            quint32 size;
+            in >> size;
+
+            // refuse the frame before allocating it
+            if (size > MAX_FRAME_SIZE)
+            {
+                writeFrame(client, "ERROR", tr("Frame size %1 exceeds the limit of %2 bytes.").arg(size).arg(MAX_FRAME_SIZE));
+                disconnect(client, SIGNAL(readyRead()), this, SLOT(readFrames()));
+                client->disconnectFromHost();
+                return;
+            }
+
+            m_frameSizes[client] = size;
+
+            // empty frame
+            if (size == 0)
+                continue;
+        }
+
+        if (client->bytesAvailable() < m_frameSizes[client])
+            return;
+
+        QByteArray frame = client->read(m_frameSizes[client]);
+        m_frameSizes[client] = 0;
+
+        processFrame(client, QString::fromUtf8(frame));
+    }
+}
+
+void JobServer::disconnected()
+{
+    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+    assert(client);
+
+    // jobs of the client are not needed anymore
+    for (int i = m_queue.count() - 1; i >= 0; i--)
+    {
+        if (m_queue[i].client == client)
+        {
+            removeDirectory(jobDir(m_queue[i].id));
+            m_queue.removeAt(i);
+        }
+    }
+
+    for (int i = m_running.count() - 1; i >= 0; i--)
+    {
+        if (m_running[i].client == client)
+        {
+            m_running[i].client = NULL;
+            m_running[i].process->kill();
+        }
+    }
+
+    for (int i = m_finished.count() - 1; i >= 0; i--)
+    {
+        if (m_finished[i].client == client)
+        {
+            removeDirectory(jobDir(m_finished[i].id));
+            m_finished.removeAt(i);
+        }
+    }
+
+    m_frameSizes.remove(client);
+    client->deleteLater();
+}
+
+void JobServer::processFrame(QTcpSocket *client, const QString &frame)
+{
+    int newLine = frame.indexOf("\n");
+    QString header = (newLine == -1) ? frame : frame.left(newLine);
+    QString body = (newLine == -1) ? "" : frame.mid(newLine + 1);
+
+    QStringList items = header.split(" ", QString::SkipEmptyParts);
+    if (items.isEmpty())
+    {
+        writeFrame(client, "ERROR", tr("Empty command."));
+        return;
+    }
+
+    if (items.at(0) == "SUBMIT" && items.count() == 2)
+    {
+        submit(client, items.at(1), body);
+    }
+    else if ((items.at(0) == "CANCEL" || items.at(0) == "FETCH" || items.at(0) == "DELETE") && items.count() == 2)
+    {
+        bool ok = false;
+        int id = items.at(1).toInt(&ok);
+        if (!ok)
+            writeFrame(client, "ERROR", tr("Invalid job id '%1'.").arg(items.at(1)));
+        else if (items.at(0) == "CANCEL")
+            cancel(client, id);
+        else if (items.at(0) == "FETCH")
+            fetch(client, id);
+        else
+            remove(client, id);
+    }
+    else
+    {
+        writeFrame(client, "ERROR", tr("Unknown command '%1'.").arg(header));
+    }
+}
+
+void JobServer::submit(QTcpSocket *client, const QString &type, const QString &content)
+{
+    Job job;
+    job.id = ++m_lastJobID;
+    job.client = client;
+    job.process = NULL;
+
+    QString suffix;
+    if (type == "script")
+    {
+        job.type = JobType_Script;
+        suffix = "py";
+    }
+    else if (type == "problem")
+    {
+        job.type = JobType_Problem;
+        suffix = "a2d";
+    }
+    else
+    {
+        writeFrame(client, "ERROR", tr("Unknown job type '%1'.").arg(type));
+        return;
+    }
+
+    // each job has its own directory (solution of the problem is written next to it)
+    QDir().mkpath(jobDir(job.id));
+    job.fileName = QString("%1/job.%2").arg(jobDir(job.id)).arg(suffix);
+    writeStringContent(job.fileName, content);
+
+    m_queue.append(job);
+    writeFrame(client, QString("ACCEPTED %1 %2").arg(job.id).arg(m_queue.count() - 1));
+
+    startJobs();
+}
+
+void JobServer::cancel(QTcpSocket *client, int id)
+{
+    for (int i = 0; i < m_queue.count(); i++)
+    {
+        if (m_queue[i].id == id && m_queue[i].client == client)
+        {
+            removeDirectory(jobDir(id));
+            m_queue.removeAt(i);
+            writeFrame(client, QString("CANCELLED %1").arg(id));
+            return;
+        }
+    }
+
+    for (int i = 0; i < m_running.count(); i++)
+    {
+        if (m_running[i].id == id && m_running[i].client == client)
+        {
+            // killed worker does not report FINISHED
+            m_running[i].client = NULL;
+            m_running[i].process->kill();
+            writeFrame(client, QString("CANCELLED %1").arg(id));
+            return;
+        }
+    }
+
+    writeFrame(client, QString("ERROR %1").arg(id), tr("Job %1 not found.").arg(id));
+}
+
+void JobServer::fetch(QTcpSocket *client, int id)
+{
+    int index = finishedIndex(client, id);
+    if (index == -1)
+    {
+        writeFrame(client, QString("ERROR %1").arg(id), tr("Finished job %1 not found.").arg(id));
+        return;
+    }
+
+    // all files written by the worker (solution, mesh, results of the script)
+    QDir dir(jobDir(id));
+    QStringList files = dir.entryList(QDir::Files, QDir::Name);
+    foreach (QString file, files)
+    {
+        QFile result(dir.absoluteFilePath(file));
+        if (!result.open(QIODevice::ReadOnly))
+        {
+            writeFrame(client, QString("ERROR %1").arg(id), tr("Could not read result '%1'.").arg(file));
+            return;
+        }
+
+        writeFrame(client, QString("RESULT %1 %2").arg(id).arg(file), QString::fromLatin1(result.readAll().toBase64()));
+    }
+
+    writeFrame(client, QString("FETCHED %1 %2").arg(id).arg(files.count()));
+}
+
+void JobServer::remove(QTcpSocket *client, int id)
+{
+    int index = finishedIndex(client, id);
+    if (index == -1)
+    {
+        writeFrame(client, QString("ERROR %1").arg(id), tr("Finished job %1 not found.").arg(id));
+        return;
+    }
+
+    removeDirectory(jobDir(id));
+    m_finished.removeAt(index);
+    writeFrame(client, QString("DELETED %1").arg(id));
+}
+
+void JobServer::startJobs()
+{
+    while (m_running.count() < m_numberOfWorkers && !m_queue.isEmpty())
+    {
+        Job job = m_queue.takeFirst();
+
+        job.process = new QProcess();
+        job.process->setWorkingDirectory(jobDir(job.id));
+        job.process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(job.process, SIGNAL(readyReadStandardOutput()), this, SLOT(workerOutput()));
+        connect(job.process, SIGNAL(finished(int)), this, SLOT(workerFinished(int)));
+        connect(job.process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(workerError(QProcess::ProcessError)));
+
+        m_running.append(job);
+        writeFrame(job.client, QString("STARTED %1").arg(job.id));
+
+        QStringList args;
+        args << "-l" << ((job.type == JobType_Script) ? "-s" : "-p") << job.fileName;
+        job.process->start(QString("%1/agros2d_solver").arg(QCoreApplication::applicationDirPath()), args);
+    }
+}
+
+void JobServer::finishJob(int index, bool keepResults)
+{
+    Job job = m_running.takeAt(index);
+
+    job.process->disconnect();
+    job.process->deleteLater();
+    job.process = NULL;
+
+    // results wait for FETCH or DELETE, cancelled jobs are not reported
+    if (keepResults && job.client)
+        m_finished.append(job);
+    else
+        removeDirectory(jobDir(job.id));
+
+    startJobs();
+}
+
+void JobServer::workerOutput()
+{
+    int index = runningIndex(qobject_cast<QProcess *>(sender()));
+    if (index == -1)
+        return;
+
+    QString output = QString::fromUtf8(m_running[index].process->readAllStandardOutput());
+    if (m_running[index].client)
+        writeFrame(m_running[index].client, QString("OUTPUT %1").arg(m_running[index].id), output);
+}
+
+void JobServer::workerFinished(int exitCode)
+{
+    int index = runningIndex(qobject_cast<QProcess *>(sender()));
+    if (index == -1)
+        return;
+
+    Job job = m_running[index];
+    if (job.client)
+    {
+        QString output = QString::fromUtf8(job.process->readAllStandardOutput());
+        if (!output.isEmpty())
+            writeFrame(job.client, QString("OUTPUT %1").arg(job.id), output);
+
+        writeFrame(job.client, QString("FINISHED %1 %2").arg(job.id).arg(exitCode));
+    }
+
+    finishJob(index, true);
+}
+
+void JobServer::workerError(QProcess::ProcessError error)
+{
+    // crashed and killed workers are reported by finished()
+    if (error != QProcess::FailedToStart)
+        return;
+
+    int index = runningIndex(qobject_cast<QProcess *>(sender()));
+    if (index == -1)
+        return;
+
+    Job job = m_running[index];
+    if (job.client)
+        writeFrame(job.client, QString("ERROR %1").arg(job.id), tr("Could not start solver: %1").arg(job.process->errorString()));
+
+    finishJob(index, false);
+}
+
+int JobServer::runningIndex(QProcess *process) const
+{
+    for (int i = 0; i < m_running.count(); i++)
+        if (m_running[i].process == process)
+            return i;
+
+    return -1;
+}
+
+int JobServer::finishedIndex(QTcpSocket *client, int id) const
+{
+    for (int i = 0; i < m_finished.count(); i++)
+        if (m_finished[i].id == id && m_finished[i].client == client)
+            return i;
+
+    return -1;
+}
+
+QString JobServer::jobDir(int id) const
+{
+    return QString("%1/jobs/%2").arg(tempProblemDir()).arg(id);
+}
+
+void JobServer::writeFrame(QTcpSocket *client, const QString &header, const QString &body)
+{
+    QByteArray frame = header.toUtf8();
+    if (!body.isEmpty())
+        frame += "\n" + body.toUtf8();
+
+    QDataStream out(client);
+    out << (quint32) frame.size();
+    client->write(frame);
+}
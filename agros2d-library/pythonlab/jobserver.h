@@ -0,0 +1,107 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+#include "../util/util.h"
+
+// local job server, problems and scripts are solved in a pool of agros2d_solver processes
+//
+// protocol (both directions): frames of quint32 length (big endian) followed by UTF-8 text,
+// the first line of the text is the header, the rest is the body
+//
+// client -> server:
+//   SUBMIT script|problem   body: content of the script (.py) or problem (.a2d)
+//   CANCEL <id>
+//   FETCH <id>              results of the finished job
+//   DELETE <id>             removes results of the finished job
+// server -> client:
+//   ACCEPTED <id> <position in queue>
+//   STARTED <id>
+//   OUTPUT <id>             body: standard output of the worker
+//   FINISHED <id> <exit code>
+//   CANCELLED <id>
+//   RESULT <id> <file>      body: content of the file (base64)
+//   FETCHED <id> <number of files>
+//   DELETED <id>
+//   ERROR [<id>]            body: message
+//
+// results of the finished job are kept until the client deletes them or disconnects,
+// frames longer than MAX_FRAME_SIZE are refused and the client is disconnected
+class AGROS_LIBRARY_API JobServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    JobServer(int port, int numberOfWorkers);
+    ~JobServer();
+
+private slots:
+    void connected();
+    void readFrames();
+    void disconnected();
+
+    void workerOutput();
+    void workerFinished(int exitCode);
+    void workerError(QProcess::ProcessError error);
+
+private:
+    enum JobType
+    {
+        JobType_Script,
+        JobType_Problem
+    };
+
+    struct Job
+    {
+        int id;
+        JobType type;
+        QString fileName;
+        QTcpSocket *client;
+        QProcess *process;
+    };
+
+    int m_numberOfWorkers;
+    int m_lastJobID;
+
+    QList<Job> m_queue;
+    QList<Job> m_running;
+    QList<Job> m_finished;
+
+    // size of the incomplete frame for each client
+    QMap<QTcpSocket *, quint32> m_frameSizes;
+
+    void processFrame(QTcpSocket *client, const QString &frame);
+    void submit(QTcpSocket *client, const QString &type, const QString &content);
+    void cancel(QTcpSocket *client, int id);
+    void fetch(QTcpSocket *client, int id);
+    void remove(QTcpSocket *client, int id);
+
+    void startJobs();
+    void finishJob(int index, bool keepResults);
+
+    int runningIndex(QProcess *process) const;
+    int finishedIndex(QTcpSocket *client, int id) const;
+    QString jobDir(int id) const;
+
+    void writeFrame(QTcpSocket *client, const QString &header, const QString &body = "");
+};
+
+#endif // JOBSERVER_H
@@ -22,6 +22,7 @@
 #include "hermes2d/plugin_interface.h"
 #include "hermes2d/problem_config.h"
 #include "hermes2d/solutionstore.h"
+#include "hermes2d/timeseries.h"
 #include "sceneview_post2d.h"
 
 PyField::PyField(std::string fieldId)
@@ -161,6 +162,14 @@ void PyField::setLinearSolverPreconditioner(const std::string &linearSolverPreco
         throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(iterLinearSolverPreconditionerTypeStringKeys())).toStdString());
 }
 
+void PyField::setLinearSolverReuse(const std::string &linearSolverReuse)
+{
+    if (matrixReuseTypeStringKeys().contains(QString::fromStdString(linearSolverReuse)))
+        m_fieldInfo->setValue(FieldInfo::LinearSolverReuse, (MatrixReuseType) matrixReuseTypeFromStringKey(QString::fromStdString(linearSolverReuse)));
+    else
+        throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(matrixReuseTypeStringKeys())).toStdString());
+}
+
 void PyField::setAdaptivityStoppingCriterion(const std::string &adaptivityStoppingCriterion)
 {
     if (adaptivityStoppingCriterionTypeStringKeys().contains(QString::fromStdString(adaptivityStoppingCriterion)))
@@ -247,15 +256,21 @@ void PyField::modifyBoundary(const std::string &name, const std::string &type,
     if (sceneBoundary == NULL)
         throw invalid_argument(QObject::tr("Boundary condition '%1' doesn't exists.").arg(QString::fromStdString(name)).toStdString());
 
-    // browse boundary types
-    foreach (Module::BoundaryType boundaryType, sceneBoundary->fieldInfo()->boundaryTypes())
+    // browse boundary types (empty type keeps the actual one)
+    if (!type.empty())
     {
-        if (QString::fromStdString(type) == boundaryType.id())
+        bool assigned = false;
+        foreach (Module::BoundaryType boundaryType, sceneBoundary->fieldInfo()->boundaryTypes())
         {
-            sceneBoundary->setType(QString::fromStdString(type));
-            break;
+            if (QString::fromStdString(type) == boundaryType.id())
+            {
+                sceneBoundary->setType(QString::fromStdString(type));
+                assigned = true;
+                break;
+            }
         }
-        else
+
+        if (!assigned)
             throw invalid_argument(QObject::tr("Wrong boundary type '%1'.").arg(QString::fromStdString(type)).toStdString());
     }
 
@@ -548,6 +563,156 @@ void PyField::localValues(double x, double y, int timeStep, int adaptivityStep,
     results = values;
 }
 
+void PyField::localValuesBatch(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                               const std::string &solutionType, map<std::string, vector<double> > &results) const
+{
+    if (x.size() != y.size())
+        throw invalid_argument(QObject::tr("Arrays of coordinates have different length.").toStdString());
+
+    map<std::string, vector<double> > values;
+
+    if (Agros2D::problem()->isSolved())
+    {
+        QVector<Point> points(x.size());
+        for (int i = 0; i < points.size(); i++)
+            points[i] = Point(x[i], y[i]);
+
+        SolutionMode solutionMode = getSolutionMode(QString::fromStdString(solutionType));
+
+        // set time and adaptivity step if -1 (default parameter - last steps), check steps
+        timeStep = getTimeStep(timeStep, solutionMode);
+        adaptivityStep = getAdaptivityStep(adaptivityStep, timeStep, solutionMode);
+
+        LocalValueBatch *batch = m_fieldInfo->plugin()->localValueBatch(m_fieldInfo, timeStep, adaptivityStep, solutionMode, points);
+        QVector<bool> found = batch->isFound();
+
+        std::string labelX = Agros2D::problem()->config()->labelX().toLower().toStdString();
+        std::string labelY = Agros2D::problem()->config()->labelY().toLower().toStdString();
+
+        QMapIterator<QString, LocalPointValues> it(batch->values());
+        while (it.hasNext())
+        {
+            it.next();
+
+            Module::LocalVariable variable = m_fieldInfo->localVariable(it.key());
+            std::string name = variable.shortname().toStdString();
+
+            // points outside the domain are NaN
+            if (variable.isScalar())
+            {
+                vector<double> &scalar = values[name];
+                scalar.resize(points.size());
+                for (int i = 0; i < points.size(); i++)
+                    scalar[i] = found[i] ? it.value().scalar[i] : std::numeric_limits<double>::quiet_NaN();
+            }
+            else
+            {
+                vector<double> &magnitude = values[name];
+                vector<double> &vectorX = values[name + labelX];
+                vector<double> &vectorY = values[name + labelY];
+                magnitude.resize(points.size());
+                vectorX.resize(points.size());
+                vectorY.resize(points.size());
+                for (int i = 0; i < points.size(); i++)
+                {
+                    if (found[i])
+                    {
+                        vectorX[i] = it.value().vectorX[i];
+                        vectorY[i] = it.value().vectorY[i];
+                        magnitude[i] = sqrt(vectorX[i] * vectorX[i] + vectorY[i] * vectorY[i]);
+                    }
+                    else
+                    {
+                        vectorX[i] = vectorY[i] = magnitude[i] = std::numeric_limits<double>::quiet_NaN();
+                    }
+                }
+            }
+        }
+        delete batch;
+    }
+    else
+    {
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+    }
+
+    results = values;
+}
+
+void PyField::timeSeries(const vector<double> &x, const vector<double> &y,
+                         const vector<vector<int> > &volumeLabels, const vector<vector<int> > &surfaceEdges,
+                         const std::string &solutionType, const std::string &fileName,
+                         map<std::string, vector<double> > &results) const
+{
+    if (x.size() != y.size())
+        throw invalid_argument(QObject::tr("Arrays of coordinates have different length.").toStdString());
+
+    if (!Agros2D::problem()->isSolved())
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+
+    TimeSeries timeSeries(m_fieldInfo, getSolutionMode(QString::fromStdString(solutionType)));
+
+    for (int i = 0; i < x.size(); i++)
+        timeSeries.addPoint(Point(x[i], y[i]));
+
+    for (vector<vector<int> >::const_iterator integral = volumeLabels.begin(); integral != volumeLabels.end(); ++integral)
+    {
+        QList<int> labels;
+        for (int i = 0; i < Agros2D::scene()->labels->length(); i++)
+        {
+            // all labels if empty
+            if (!integral->empty() && (std::find(integral->begin(), integral->end(), i) == integral->end()))
+                continue;
+
+            if (Agros2D::scene()->labels->at(i)->marker(m_fieldInfo) != Agros2D::scene()->materials->getNone(m_fieldInfo))
+                labels.append(i);
+            else if (!integral->empty())
+                throw out_of_range(QObject::tr("Label with index '%1' is 'none'.").arg(i).toStdString());
+        }
+
+        for (vector<int>::const_iterator it = integral->begin(); it != integral->end(); ++it)
+            if ((*it < 0) || (*it >= Agros2D::scene()->labels->length()))
+                throw out_of_range(QObject::tr("Label index must be between 0 and '%1'.").arg(Agros2D::scene()->labels->length()-1).toStdString());
+
+        timeSeries.addVolumeIntegral(labels);
+    }
+
+    for (vector<vector<int> >::const_iterator integral = surfaceEdges.begin(); integral != surfaceEdges.end(); ++integral)
+    {
+        QList<int> edges;
+        for (vector<int>::const_iterator it = integral->begin(); it != integral->end(); ++it)
+        {
+            if ((*it < 0) || (*it >= Agros2D::scene()->edges->length()))
+                throw out_of_range(QObject::tr("Edge index must be between 0 and '%1'.").arg(Agros2D::scene()->edges->length()-1).toStdString());
+
+            edges.append(*it);
+        }
+
+        // all edges if empty
+        if (edges.isEmpty())
+            for (int i = 0; i < Agros2D::scene()->edges->length(); i++)
+                edges.append(i);
+
+        timeSeries.addSurfaceIntegral(edges);
+    }
+
+    timeSeries.extract();
+
+    // export (csv or binary according to suffix)
+    if (!fileName.empty())
+    {
+        QString fn = QString::fromStdString(fileName);
+        bool ok = (QFileInfo(fn).suffix().toLower() == "csv") ? timeSeries.exportCSV(fn) : timeSeries.exportBinary(fn);
+        if (!ok)
+            throw invalid_argument(QObject::tr("File '%1' cannot be written.").arg(fn).toStdString());
+    }
+
+    map<std::string, vector<double> > values;
+    foreach (QString name, timeSeries.columnNames())
+        values[name.toStdString()] = timeSeries.column(name).toStdVector();
+
+    results = values;
+}
+
 void PyField::surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                                const std::string &solutionType, map<std::string, double> &results) const
 {
@@ -87,6 +87,11 @@ class PyField
         }
         void setLinearSolverPreconditioner(const std::string &linearSolverPreconditioner);
 
+        inline std::string getLinearSolverReuse() const {
+            return matrixReuseTypeToStringKey((MatrixReuseType) m_fieldInfo->value(FieldInfo::LinearSolverReuse).toInt()).toStdString();
+        }
+        void setLinearSolverReuse(const std::string &linearSolverReuse);
+
         // number of refinements
         inline int getNumberOfRefinements() const { return m_fieldInfo->value(FieldInfo::SpaceNumberOfRefinements).toInt(); }
         void setNumberOfRefinements(int numberOfRefinements);
@@ -136,6 +141,12 @@ class PyField
         // local values, integrals
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          const std::string &solutionType, map<std::string, double> &results) const;
+        void localValuesBatch(const vector<double> &x, const vector<double> &y, int timeStep, int adaptivityStep,
+                              const std::string &solutionType, map<std::string, vector<double> > &results) const;
+        void timeSeries(const vector<double> &x, const vector<double> &y,
+                        const vector<vector<int> > &volumeLabels, const vector<vector<int> > &surfaceEdges,
+                        const std::string &solutionType, const std::string &fileName,
+                        map<std::string, vector<double> > &results) const;
         void surfaceIntegrals(const vector<int> &edges, int timeStep, int adaptivityStep,
                               const std::string &solutionType, map<std::string, double> &results) const;
         void volumeIntegrals(const vector<int> &labels, int timeStep, int adaptivityStep,
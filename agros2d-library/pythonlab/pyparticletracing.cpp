@@ -190,8 +190,8 @@ void PyParticleTracing::setInitialVelocity(const vector<double> &velocity)
 
 void PyParticleTracing::setNumberOfParticles(int particles)
 {
-    if (particles < 1 || particles > 200)
-        throw out_of_range(QObject::tr("Number of particles is out of range (1 - 200).").toStdString());
+    if (particles < 1 || particles > 10000)
+        throw out_of_range(QObject::tr("Number of particles is out of range (1 - 10000).").toStdString());
 
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleNumberOfParticles, particles);
 }
@@ -241,6 +241,14 @@ void PyParticleTracing::setDragForceCoefficient(double coeff)
     Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleDragCoefficient, coeff);
 }
 
+void PyParticleTracing::setInteractionOpeningAngle(double angle)
+{
+    if (angle < 0.0)
+        throw out_of_range(QObject::tr("Opening angle cannot be negative.").toStdString());
+
+    Agros2D::problem()->setting()->setValue(ProblemSetting::View_ParticleP2POpeningAngle, angle);
+}
+
 void PyParticleTracing::setCustomForce(const vector<double> &force)
 {
     if (force.empty())
@@ -22,6 +22,7 @@
 #include "sceneview_geometry.h"
 #include "sceneview_post2d.h"
 #include "hermes2d/coupling.h"
+#include "hermes2d/field.h"
 
 PyProblem::PyProblem(bool clearProblem)
 {
@@ -100,6 +101,22 @@ void PyProblem::setTimeMethodTolerance(double timeMethodTolerance)
         throw out_of_range(QObject::tr("The time method tolerance must be positive.").toStdString());
 }
 
+void PyProblem::setTimeMethodErrorEstimator(const std::string &timeErrorEstimator)
+{
+    if (timeErrorEstimatorStringKeys().contains(QString::fromStdString(timeErrorEstimator)))
+        Agros2D::problem()->config()->setValue(ProblemConfig::TimeMethodErrorEstimator, (TimeErrorEstimator) timeErrorEstimatorFromStringKey(QString::fromStdString(timeErrorEstimator)));
+    else
+        throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(timeErrorEstimatorStringKeys())).toStdString());
+}
+
+void PyProblem::setIntegralOrder(const std::string &integralOrder)
+{
+    if (integralOrderTypeStringKeys().contains(QString::fromStdString(integralOrder)))
+        Agros2D::problem()->setting()->setValue(ProblemSetting::Problem_IntegralOrder, (IntegralOrderType) integralOrderTypeFromStringKey(QString::fromStdString(integralOrder)));
+    else
+        throw invalid_argument(QObject::tr("Invalid argument. Valid keys: %1").arg(stringListToString(integralOrderTypeStringKeys())).toStdString());
+}
+
 void PyProblem::setTimeInitialTimeStep(double timeInitialTimeStep)
 {
     if (timeInitialTimeStep > 0.0)
@@ -189,6 +206,15 @@ void PyProblem::solve()
         throw logic_error(QObject::tr("Problem is not solved.").toStdString());
 }
 
+void PyProblem::solveSweepPoint()
+{
+    // scene is not invalidated, mesh and matrices are reused if possible
+    Agros2D::problem()->solveSweepPoint();
+
+    if (!Agros2D::problem()->isSolved())
+        throw logic_error(QObject::tr("Problem is not solved.").toStdString());
+}
+
 double PyProblem::timeElapsed() const
 {
     if (!Agros2D::problem()->isSolved())
@@ -199,6 +225,18 @@ double PyProblem::timeElapsed() const
     return time;
 }
 
+bool PyProblem::isSettingSnapshotValid() const
+{
+    if (!Agros2D::problem()->config()->isSnapshotValid() || !Agros2D::problem()->setting()->isSnapshotValid())
+        return false;
+
+    foreach (FieldInfo *fieldInfo, Agros2D::problem()->fieldInfos())
+        if (!fieldInfo->isSnapshotValid())
+            return false;
+
+    return true;
+}
+
 void PyProblem::timeStepsLength(vector<double> &steps) const
 {
     if (!Agros2D::problem()->isTransient())
@@ -59,6 +59,10 @@ class PyProblem
         inline double getTimeMethodTolerance() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeMethodTolerance).toDouble(); }
         void setTimeMethodTolerance(double timeMethodTolerance);
 
+        // time method error estimator
+        inline std::string getTimeMethodErrorEstimator() const { return timeErrorEstimatorToStringKey((TimeErrorEstimator) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimator).toInt()).toStdString(); }
+        void setTimeMethodErrorEstimator(const std::string &timeErrorEstimator);
+
         // initial time step
         inline double getTimeInitialTimeStep() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeInitialStepSize).toDouble(); }
         void setTimeInitialTimeStep(double timeInitialTimeStep);
@@ -71,6 +75,10 @@ class PyProblem
         inline int getNumConstantTimeSteps() const { return Agros2D::problem()->config()->value(ProblemConfig::TimeConstantTimeSteps).toInt(); }
         void setNumConstantTimeSteps(int timeSteps);
 
+        // quadrature order of integrals
+        inline std::string getIntegralOrder() const { return integralOrderTypeToStringKey((IntegralOrderType) Agros2D::problem()->setting()->value(ProblemSetting::Problem_IntegralOrder).toInt()).toStdString(); }
+        void setIntegralOrder(const std::string &integralOrder);
+
         // coupling
         std::string getCouplingType(const std::string &sourceField, const std::string &targetField) const;
         void setCouplingType(const std::string &sourceField, const std::string &targetField, const std::string &type);
@@ -79,12 +87,19 @@ class PyProblem
         void mesh();
         void solve();        
 
+        // parametric sweep
+        void solveSweepPoint();
+        inline std::string sweepSolverExecutable() const { return QString("%1/agros2d_solver").arg(QCoreApplication::applicationDirPath()).toStdString(); }
+
         // time elapsed
         double timeElapsed() const;
 
         // time steps
         void timeStepsLength(vector<double> &steps) const;
 
+        // typed settings (problem, fields) are equal to values
+        bool isSettingSnapshotValid() const;
+
         // solution vector
 
 
@@ -22,6 +22,8 @@
 #include "logview.h"
 #include "hermes2d/plugin_interface.h"
 #include "hermes2d/module.h"
+#include "hermes2d/solutionstore.h"
+#include "hermes2d/solver_daemon.h"
 #ifdef _MSC_VER
 # ifdef _DEBUG
 #  undef _DEBUG
@@ -296,6 +298,11 @@ QString createPythonFromModel()
             str += QString("problem.time_steps = %1\n").
                     arg(Agros2D::problem()->config()->value(ProblemConfig::TimeConstantTimeSteps).toInt());
         }
+        if (((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) != TimeStepMethod_Fixed)
+        {
+            str += QString("problem.time_method_error_estimator = \"%1\"\n").
+                    arg(timeErrorEstimatorToStringKey((TimeErrorEstimator) Agros2D::problem()->config()->value(ProblemConfig::TimeMethodErrorEstimator).toInt()));
+        }
         if (((TimeStepMethod) Agros2D::problem()->config()->value(ProblemConfig::TimeMethod).toInt()) != TimeStepMethod_Fixed &&
                 (Agros2D::problem()->config()->value(ProblemConfig::TimeInitialStepSize).toDouble() > 0.0))
             str += QString("problem.time_initial_time_step = %1\n").
@@ -318,6 +325,9 @@ QString createPythonFromModel()
         str += QString("%1.matrix_solver = \"%2\"\n").
                 arg(fieldInfo->fieldId()).
                 arg(matrixSolverTypeToStringKey(fieldInfo->matrixSolver()));
+        str += QString("%1.matrix_solver_parameters['reuse'] = \"%2\"\n").
+                arg(fieldInfo->fieldId()).
+                arg(matrixReuseTypeToStringKey((MatrixReuseType) fieldInfo->value(FieldInfo::LinearSolverReuse).toInt()));
 
         if ((fieldInfo->matrixSolver() == Hermes::SOLVER_PARALUTION_ITERATIVE) || (fieldInfo->matrixSolver() == Hermes::SOLVER_PARALUTION_AMG))
         {
@@ -395,6 +405,10 @@ QString createPythonFromModel()
                     arg(fieldInfo->fieldId()).
                     arg((fieldInfo->value(FieldInfo::AdaptivityFinerReference).toBool()) ? "True" : "False");
 
+            str += QString("%1.adaptivity_parameters['warm_start'] = %2\n").
+                    arg(fieldInfo->fieldId()).
+                    arg((fieldInfo->value(FieldInfo::AdaptivityWarmStart).toBool()) ? "True" : "False");
+
             str += QString("%1.adaptivity_parameters['space_refinement'] = %2\n").
                     arg(fieldInfo->fieldId()).
                     arg((fieldInfo->value(FieldInfo::AdaptivitySpaceRefinement).toBool()) ? "True" : "False");
@@ -772,6 +786,27 @@ void memoryUsage(std::vector<int> &time, std::vector<int> &usage)
     usage = Agros2D::memoryMonitor()->memoryUsage().toVector().toStdVector();
 }
 
+void solutionCacheStatistics(std::map<std::string, long long> &statistics)
+{
+    SolutionStore::CacheStatistics cacheStatistics = Agros2D::solutionStore()->cacheStatistics();
+
+    statistics["hits"] = cacheStatistics.hits;
+    statistics["misses"] = cacheStatistics.misses;
+    statistics["evictions"] = cacheStatistics.evictions;
+    statistics["entries"] = cacheStatistics.entries;
+    statistics["pinned"] = cacheStatistics.pinned;
+    statistics["memory_size"] = cacheStatistics.memorySize;
+    statistics["memory_limit"] = cacheStatistics.memoryLimit;
+}
+
+void externalSolverDaemonStatistics(std::map<std::string, long long> &statistics)
+{
+    ExternalSolverDaemon::Statistics daemonStatistics = ExternalSolverDaemon::statistics();
+
+    statistics["solves"] = daemonStatistics.solves;
+    statistics["reused_factorizations"] = daemonStatistics.reusedFactorizations;
+}
+
 // ************************************************************************************
 
 void PyOptions::setNumberOfThreads(int threads)
@@ -782,12 +817,20 @@ void PyOptions::setNumberOfThreads(int threads)
     Agros2D::configComputer()->setValue(Config::Config_NumberOfThreads, threads);
 }
 
-void PyOptions::setCacheSize(int size)
+void PyOptions::setNumberOfConcurrentBlocks(int blocks)
+{
+    if (blocks < 1 || blocks > omp_get_max_threads())
+        throw out_of_range(QObject::tr("Number of concurrent blocks is out of range (1 - %1).").arg(omp_get_max_threads()).toStdString());
+
+    Agros2D::configComputer()->setValue(Config::Config_NumberOfConcurrentBlocks, blocks);
+}
+
+void PyOptions::setCacheMemorySize(int size)
 {
-    if (size < 2 || size > 50)
-        throw out_of_range(QObject::tr("Cache size is out of range (2 - 50).").toStdString());
+    if (size < 32 || size > 262144)
+        throw out_of_range(QObject::tr("Cache size is out of range (32 - 262144 MB).").toStdString());
 
-    Agros2D::configComputer()->setValue(Config::Config_CacheSize, size);
+    Agros2D::configComputer()->setValue(Config::Config_CacheMemorySize, size);
 }
 
 void PyOptions::setDumpFormat(std::string format)
@@ -126,6 +126,8 @@ inline std::string getScriptFromModel() { return createPythonFromModel().toStdSt
 
 int appTime();
 void memoryUsage(std::vector<int> &time, std::vector<int> &usage);
+void solutionCacheStatistics(std::map<std::string, long long> &statistics);
+void externalSolverDaemonStatistics(std::map<std::string, long long> &statistics);
 
 struct PyOptions
 {
@@ -133,9 +135,17 @@ struct PyOptions
     inline int getNumberOfThreads() const { return Agros2D::configComputer()->value(Config::Config_NumberOfThreads).toInt(); }
     void setNumberOfThreads(int threads);
 
-    // cache size
-    inline int getCacheSize() const { return Agros2D::configComputer()->value(Config::Config_CacheSize).toInt(); }
-    void setCacheSize(int size);
+    // number of independent blocks solved concurrently
+    inline int getNumberOfConcurrentBlocks() const { return Agros2D::configComputer()->value(Config::Config_NumberOfConcurrentBlocks).toInt(); }
+    void setNumberOfConcurrentBlocks(int blocks);
+
+    // persistent external solver
+    inline bool getExternalSolverDaemon() const { return Agros2D::configComputer()->value(Config::Config_ExternalSolverDaemon).toBool(); }
+    inline void setExternalSolverDaemon(bool daemon) { Agros2D::configComputer()->setValue(Config::Config_ExternalSolverDaemon, daemon); }
+
+    // cache size (MB)
+    inline int getCacheMemorySize() const { return Agros2D::configComputer()->value(Config::Config_CacheMemorySize).toInt(); }
+    void setCacheMemorySize(int size);
 
     // save matrix and rhs
     inline bool getSaveMatrixRHS() const { return Agros2D::configComputer()->value(Config::Config_LinearSystemSave).toBool(); }
@@ -343,12 +343,23 @@ void PyViewPost2D::activate()
     }
 }
 
-void PyViewPost2D::refresh()
+void PyViewPost2D::refresh(bool asynchronous)
 {
     checkExistingSolution();
 
     if (!silentMode())
-        currentPythonEngineAgros()->postHermes()->refresh();
+    {
+        if (asynchronous)
+            currentPythonEngineAgros()->postHermes()->refreshAsync();
+        else
+            currentPythonEngineAgros()->postHermes()->refresh();
+    }
+}
+
+void PyViewPost2D::wait()
+{
+    if (!silentMode())
+        currentPythonEngineAgros()->postHermes()->waitForProcessing();
 }
 
 void PyViewPost2D::setContourVariable(const std::string &var)
@@ -197,7 +197,9 @@ struct PyViewPost : PyViewMeshAndPost
 struct PyViewPost2D : PyViewPost
 {
     void activate();
-    void refresh();
+    // views are processed in the post-processing thread if asynchronous is set
+    void refresh(bool asynchronous = false);
+    void wait();
 
     // scalar view
     void setScalarViewShow(bool show) { setProblemSetting(ProblemSetting::View_ShowScalarView, show); }
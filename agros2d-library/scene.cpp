@@ -2507,7 +2507,16 @@ void Scene::readSolutionFromFile(const QString &fileName)
     {
         Agros2D::log()->printMessage(tr("Problem"), tr("Loading solution from disk"));
 
-        JlCompress::extractDir(solutionFile, cacheProblemDir());
+        if (SolutionContainer::isContainer(solutionFile))
+        {
+            if (!Agros2D::solutionStore()->openContainer(solutionFile))
+            {
+                Agros2D::problem()->clearSolution();
+                throw AgrosException(tr("Solution file '%1' is corrupted").arg(solutionFile));
+            }
+        }
+        else
+            JlCompress::extractDir(solutionFile, cacheProblemDir());
 
         // read mesh file
         if (QFile::exists(QString("%1/initial.msh").arg(cacheProblemDir())))
@@ -2547,18 +2556,24 @@ void Scene::writeSolutionToFile(const QString &fileName)
 {
     Agros2D::log()->printMessage(tr("Problem"), tr("Saving solution to disk"));
 
+    // wait for the background writer and compact run time journal
+    Agros2D::solutionStore()->flush();
+    Agros2D::solutionStore()->detachContainer();
+    if (!Agros2D::solutionStore()->isEmpty())
+        Agros2D::solutionStore()->saveRunTimeDetails();
+
     QFileInfo fileInfo(fileName);
     QString solutionFN = QString("%1/%2.sol").arg(fileInfo.absolutePath()).arg(fileInfo.baseName());
-    if (QFile(solutionFN).open(QIODevice::WriteOnly))
-        JlCompress::compressDir(solutionFN, cacheProblemDir());
-    else
+    if (!SolutionContainer::write(solutionFN, cacheProblemDir()))
         Agros2D::log()->printError(tr("Solver"), tr("Access denied '%1'").arg(solutionFN));
 }
 
 void Scene::checkNodeConnect(SceneNode *node)
 {
     bool isConnected = false;
-    foreach (SceneNode *nodeCheck, this->nodes->items())
+
+    RectPoint rect(node->point() - Point(EPS_ZERO, EPS_ZERO), node->point() + Point(EPS_ZERO, EPS_ZERO));
+    foreach (SceneNode *nodeCheck, this->nodes->itemsInRect(rect))
     {
         if ((nodeCheck->distance(node->point()) < EPS_ZERO) && (nodeCheck != node))
         {
@@ -2598,13 +2613,26 @@ void Scene::checkNodeConnect(SceneNode *node)
 
 void Scene::checkTwoNodesSameCoordinates()
 {
-    for(int nodeIdx1 = 0; nodeIdx1 < nodes->length(); nodeIdx1++)
+    QList<SceneNode *> items = nodes->items();
+
+    QHash<SceneNode *, int> indices;
+    for (int nodeIdx = 0; nodeIdx < items.count(); nodeIdx++)
+        indices.insert(items[nodeIdx], nodeIdx);
+
+    for (int nodeIdx1 = 0; nodeIdx1 < items.count(); nodeIdx1++)
     {
-        SceneNode* node1 = nodes->at(nodeIdx1);
-        for(int nodeIdx2 = 0; nodeIdx2 < nodeIdx1; nodeIdx2++)
+        SceneNode* node1 = items[nodeIdx1];
+        Point point = node1->point();
+
+        // tolerance of Point::operator==
+        double tolerance = POINT_ABS_ZERO + 2.0 * POINT_REL_ZERO * qMax(fabs(point.x), fabs(point.y));
+        RectPoint rect(Point(point.x - tolerance, point.y - tolerance),
+                       Point(point.x + tolerance, point.y + tolerance));
+
+        foreach (SceneNode *node2, nodes->itemsInRect(rect))
         {
-            SceneNode* node2 = nodes->at(nodeIdx2);
-            if(node1->point() == node2->point())
+            int nodeIdx2 = indices.value(node2);
+            if ((nodeIdx2 < nodeIdx1) && (node1->point() == node2->point()))
                 throw AgrosGeometryException(QObject::tr("Point %1 and %2 has the same coordinates.").arg(nodeIdx1).arg(nodeIdx2));
         }
     }
@@ -2665,9 +2693,18 @@ void Scene::findLyingEdgeNodes()
 {
     m_lyingEdgeNodes.clear();
 
+    nodes->optimizeIndex();
+
+    // tolerance of SceneEdge::isLyingOnNode()
+    double tolerance = sqrt(EPS_ZERO);
+
     foreach (SceneEdge *edge, edges->items())
     {
-        foreach (SceneNode *node, nodes->items())
+        RectPoint rect = edge->boundingBox();
+        rect.start = rect.start - Point(tolerance, tolerance);
+        rect.end = rect.end + Point(tolerance, tolerance);
+
+        foreach (SceneNode *node, nodes->itemsInRect(rect))
         {
             if (edge->isLyingOnNode(node))
             {
@@ -2682,14 +2719,12 @@ void Scene::findNumberOfConnectedNodeEdges()
     m_numberOfConnectedNodeEdges.clear();
 
     foreach (SceneNode *node, nodes->items())
+        m_numberOfConnectedNodeEdges.insert(node, 0);
+
+    foreach (SceneEdge *edge, edges->items())
     {
-        int connections = 0;
-        foreach (SceneEdge *edge, edges->items())
-        {
-            if (edge->nodeStart() == node || edge->nodeEnd() == node)
-                connections++;
-        }
-        m_numberOfConnectedNodeEdges.insert(node, connections);
+        m_numberOfConnectedNodeEdges[edge->nodeStart()]++;
+        m_numberOfConnectedNodeEdges[edge->nodeEnd()]++;
     }
 }
 
@@ -2697,13 +2732,31 @@ void Scene::findCrossings()
 {
     m_crossings.clear();
 
-    for (int i = 0; i < edges->count(); i++)
+    edges->optimizeIndex();
+
+    QList<SceneEdge *> items = edges->items();
+
+    QHash<SceneEdge *, int> indices;
+    for (int i = 0; i < items.count(); i++)
+        indices.insert(items[i], i);
+
+    // edges with crossing
+    QVector<bool> isCrossed(items.count(), false);
+
+    for (int i = 0; i < items.count(); i++)
     {
-        SceneEdge *edge = edges->at(i);
+        SceneEdge *edge = items[i];
+
+        RectPoint rect = edge->boundingBox();
+        rect.start = rect.start - Point(sqrt(EPS_ZERO), sqrt(EPS_ZERO));
+        rect.end = rect.end + Point(sqrt(EPS_ZERO), sqrt(EPS_ZERO));
 
-        for (int j = i + 1; j < edges->count(); j++)
+        // only edges with intersecting bounding boxes can cross
+        foreach (SceneEdge *edgeCheck, edges->itemsInRect(rect))
         {
-            SceneEdge *edgeCheck = edges->at(j);
+            int j = indices.value(edgeCheck);
+            if (j <= i)
+                continue;
 
             QList<Point> intersects;
 
@@ -2722,11 +2775,13 @@ void Scene::findCrossings()
 
             if (intersects.count() > 0)
             {
-                if (!m_crossings.contains(edgeCheck))
-                    m_crossings.append(edgeCheck);
-                if (!m_crossings.contains((edge)))
-                    m_crossings.append(edge);
+                isCrossed[i] = true;
+                isCrossed[j] = true;
             }
         }
     }
+
+    for (int i = 0; i < items.count(); i++)
+        if (isCrossed[i])
+            m_crossings.append(items[i]);
 }
@@ -78,7 +78,7 @@ public:
     inline int length() { return m_data.length(); }
     inline int count() {return length(); }
     inline int isEmpty() { return m_data.isEmpty(); }
-    void clear();
+    virtual void clear();
 
     /// selects or unselects all items
     void setSelected(bool value = true);
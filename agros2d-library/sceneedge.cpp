@@ -142,8 +142,12 @@ double SceneEdge::distance(const Point &point) const
 
 bool SceneEdge::isCrossed() const
 {
+    RectPoint rect = boundingBox();
+    rect.start = rect.start - Point(sqrt(EPS_ZERO), sqrt(EPS_ZERO));
+    rect.end = rect.end + Point(sqrt(EPS_ZERO), sqrt(EPS_ZERO));
+
     // TODO: copy of crossedEdges() !!!!
-    foreach (SceneEdge *edgeCheck, Agros2D::scene()->edges->items())
+    foreach (SceneEdge *edgeCheck, Agros2D::scene()->edges->itemsInRect(rect))
     {
         if (edgeCheck != this)
         {
@@ -240,6 +244,48 @@ void SceneEdge::computeCenterAndRadius()
     m_radiusCache = (m_centerCache - m_nodeStart->point()).magnitude();
 
     m_vectorCache = m_nodeEnd->point() - m_nodeStart->point();
+
+    // spatial index
+    Agros2D::scene()->edges->updateItem(this);
+}
+
+RectPoint SceneEdge::boundingBox() const
+{
+    Point start = m_nodeStart->point();
+    Point end = m_nodeEnd->point();
+
+    Point min(qMin(start.x, end.x), qMin(start.y, end.y));
+    Point max(qMax(start.x, end.x), qMax(start.y, end.y));
+
+    if (!isStraight())
+    {
+        // extremes of the circle lying on the arc (counterclockwise from start node)
+        double sweep = deg2rad(fabs(angle()));
+        double startAngle = atan2(start.y - m_centerCache.y, start.x - m_centerCache.x);
+        double endAngle = atan2(end.y - m_centerCache.y, end.x - m_centerCache.x);
+
+        for (int i = 0; i < 4; i++)
+        {
+            double extreme = i * M_PI / 2.0;
+
+            double deltaStart = fmod(extreme - startAngle + 4.0*M_PI, 2.0*M_PI);
+            double deltaEnd = fmod(extreme - endAngle + 4.0*M_PI, 2.0*M_PI);
+
+            // negative angle - direction is not known, both arcs are included
+            if ((deltaStart <= sweep) || (angle() < 0.0 && deltaEnd <= sweep))
+            {
+                Point point(m_centerCache.x + m_radiusCache * cos(extreme),
+                            m_centerCache.y + m_radiusCache * sin(extreme));
+
+                min.x = qMin(min.x, point.x);
+                max.x = qMax(max.x, point.x);
+                min.y = qMin(min.y, point.y);
+                max.y = qMax(max.y, point.y);
+            }
+        }
+    }
+
+    return RectPoint(min, max);
 }
 
 SceneEdge *SceneEdge::findClosestEdge(const Point &point)
@@ -279,9 +325,39 @@ void SceneEdge::addMarkersFromStrings(QMap<QString, QString> markers)
 
 //************************************************************************************************
 
+// rectangle around point with tolerance of Point::operator==
+static RectPoint pointRect(const Point &point)
+{
+    double tolerance = POINT_ABS_ZERO + 2.0 * POINT_REL_ZERO * qMax(fabs(point.x), fabs(point.y));
+
+    return RectPoint(Point(point.x - tolerance, point.y - tolerance),
+                     Point(point.x + tolerance, point.y + tolerance));
+}
+
+bool SceneEdgeContainer::add(SceneEdge *item)
+{
+    m_index.insert(item);
+
+    return MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::add(item);
+}
+
+bool SceneEdgeContainer::remove(SceneEdge *item)
+{
+    m_index.remove(item);
+
+    return MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::remove(item);
+}
+
+void SceneEdgeContainer::clear()
+{
+    m_index.clear();
+
+    MarkedSceneBasicContainer<SceneBoundary, SceneEdge>::clear();
+}
+
 void SceneEdgeContainer::removeConnectedToNode(SceneNode *node)
 {
-    foreach (SceneEdge *edge, m_data)
+    foreach (SceneEdge *edge, m_index.items(node->boundingBox()))
     {
         if ((edge->nodeStart() == node) || (edge->nodeEnd() == node))
         {
@@ -298,7 +374,8 @@ void SceneEdgeContainer::removeConnectedToNode(SceneNode *node)
 
 SceneEdge* SceneEdgeContainer::get(SceneEdge* edge) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    // candidates share the start node
+    foreach (SceneEdge *edgeCheck, m_index.items(edge->nodeStart()->boundingBox()))
     {
         if (((((edgeCheck->nodeStart() == edge->nodeStart()) && (edgeCheck->nodeEnd() == edge->nodeEnd())) &&
               (fabs(edgeCheck->angle() - edge->angle()) < EPS_ZERO)) ||
@@ -314,7 +391,7 @@ SceneEdge* SceneEdgeContainer::get(SceneEdge* edge) const
 
 SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEnd, double angle, int segments, bool isCurvilinear) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    foreach (SceneEdge *edgeCheck, m_index.items(pointRect(pointStart)))
     {
         if (((edgeCheck->nodeStart()->point() == pointStart) && (edgeCheck->nodeEnd()->point() == pointEnd))
                 && ((edgeCheck->angle() - angle) < EPS_ZERO) && (edgeCheck->segments() == segments) && (edgeCheck->isCurvilinear() == isCurvilinear))
@@ -326,7 +403,7 @@ SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEn
 
 SceneEdge* SceneEdgeContainer::get(const Point &pointStart, const Point &pointEnd) const
 {
-    foreach (SceneEdge *edgeCheck, m_data)
+    foreach (SceneEdge *edgeCheck, m_index.items(pointRect(pointStart)))
     {
         if (((edgeCheck->nodeStart()->point() == pointStart) && (edgeCheck->nodeEnd()->point() == pointEnd)))
             return edgeCheck;
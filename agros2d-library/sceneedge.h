@@ -23,6 +23,7 @@
 #include "util.h"
 #include "scenebasic.h"
 #include "scenemarkerdialog.h"
+#include "scenespatialindex.h"
 
 class SceneEdgeCommandAdd;
 class SceneEdgeCommandRemove;
@@ -47,13 +48,14 @@ public:
     bool hasLyingNode() const;
     bool isOutsideArea() const;
     bool isError() const;
-    bool isCrossed() const; // very slow, use carefully
+    bool isCrossed() const;
 
     inline Point center() const { return m_centerCache; }
     inline double radius() const { return m_radiusCache; }
     inline Point vector() const { return m_vectorCache; }
     double distance(const Point &point) const;    
     double length() const;
+    RectPoint boundingBox() const;
     bool isStraight() const { return (fabs(angle()) < EPS_ZERO); }
 
     // needed by mesh generator
@@ -94,6 +96,16 @@ Q_DECLARE_METATYPE(SceneEdge *)
 class SceneEdgeContainer : public MarkedSceneBasicContainer<SceneBoundary, SceneEdge>
 {
 public:
+    virtual bool add(SceneEdge *item);
+    virtual bool remove(SceneEdge *item);
+    virtual void clear();
+
+    /// edges with bounding box intersecting rectangle (spatial index)
+    QList<SceneEdge *> itemsInRect(const RectPoint &rect) const { return m_index.items(rect); }
+    /// geometry of edge has been changed
+    void updateItem(SceneEdge *item) { m_index.update(item); }
+    void optimizeIndex() { m_index.optimize(); }
+
     void removeConnectedToNode(SceneNode* node);
 
     /// if container contains the same edge, returns it. Otherwise returns NULL
@@ -108,6 +120,9 @@ public:
     /// returns bounding box, assumes container not empty
     RectPoint boundingBox() const;
     static RectPoint boundingBox(QList<SceneEdge *> edges);
+
+private:
+    SceneSpatialIndex<SceneEdge> m_index;
 };
 
 // *************************************************************************************************************************************
@@ -40,10 +40,14 @@ SceneNode::SceneNode(const PointValue &pointValue) : SceneBasic(), m_point(point
 
 void SceneNode::setPointValue(const PointValue &point)
 {
+    // connected edges are indexed at the original position
+    QList<SceneEdge *> edges = connectedEdges();
+
     m_point = point;
+    Agros2D::scene()->nodes->updateItem(this);
 
     // refresh cache
-    foreach (SceneEdge *edge, connectedEdges())
+    foreach (SceneEdge *edge, edges)
         edge->computeCenterAndRadius();
 }
 
@@ -86,20 +90,17 @@ SceneNode *SceneNode::findClosestNode(const Point &point)
 
 SceneNode* SceneNodeContainer::get(SceneNode *node) const
 {
-    foreach (SceneNode *nodeCheck, m_data)
-    {
-        if (nodeCheck->point() == node->point())
-        {
-            return nodeCheck;
-        }
-    }
-
-    return NULL;
+    return get(node->point());
 }
 
 SceneNode* SceneNodeContainer::get(const Point &point) const
 {
-    foreach (SceneNode *nodeCheck, m_data)
+    // tolerance of Point::operator==
+    double tolerance = POINT_ABS_ZERO + 2.0 * POINT_REL_ZERO * qMax(fabs(point.x), fabs(point.y));
+    RectPoint rect(Point(point.x - tolerance, point.y - tolerance),
+                   Point(point.x + tolerance, point.y + tolerance));
+
+    foreach (SceneNode *nodeCheck, m_index.items(rect))
     {
         if (nodeCheck->point() == point)
             return nodeCheck;
@@ -108,14 +109,30 @@ SceneNode* SceneNodeContainer::get(const Point &point) const
     return NULL;
 }
 
+bool SceneNodeContainer::add(SceneNode *item)
+{
+    m_index.insert(item);
+
+    return SceneBasicContainer<SceneNode>::add(item);
+}
+
 bool SceneNodeContainer::remove(SceneNode *item)
 {
     // remove all edges connected to this node
     Agros2D::scene()->edges->removeConnectedToNode(item);
 
+    m_index.remove(item);
+
     return SceneBasicContainer<SceneNode>::remove(item);
 }
 
+void SceneNodeContainer::clear()
+{
+    m_index.clear();
+
+    SceneBasicContainer<SceneNode>::clear();
+}
+
 RectPoint SceneNodeContainer::boundingBox() const
 {
     Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
@@ -138,7 +155,7 @@ SceneNodeContainer SceneNodeContainer::selected()
     foreach (SceneNode* item, this->m_data)
     {
         if (item->isSelected())
-            list.m_data.push_back(item);
+            list.add(item);
     }
 
     return list;
@@ -150,7 +167,7 @@ SceneNodeContainer SceneNodeContainer::highlighted()
     foreach (SceneNode* item, this->m_data)
     {
         if (item->isHighlighted())
-            list.m_data.push_back(item);
+            list.add(item);
     }
 
     return list;
@@ -473,29 +490,20 @@ void SceneNodeCommandRemoveMulti::redo()
 
 bool SceneNode::isConnected() const
 {
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-        if (edge->nodeStart() == this || edge->nodeEnd() == this)
-            return true;
-
-    return false;
+    return !connectedEdges().isEmpty();
 }
 
 bool SceneNode::isEndNode() const
 {
-    int connections = 0;
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
-        if (edge->nodeStart() == this || edge->nodeEnd() == this)
-            connections++;
-
-    return (connections == 1);
+    return (connectedEdges().count() == 1);
 }
 
 QList<SceneEdge *> SceneNode::connectedEdges() const
 {
     QList<SceneEdge *> edges;
-    edges.reserve(Agros2D::scene()->edges->count());
 
-    foreach (SceneEdge *edge, Agros2D::scene()->edges->items())
+    // bounding box of edge contains its nodes
+    foreach (SceneEdge *edge, Agros2D::scene()->edges->itemsInRect(boundingBox()))
         if (edge->nodeStart() == this || edge->nodeEnd() == this)
             edges.append(edge);
 
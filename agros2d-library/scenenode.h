@@ -23,6 +23,7 @@
 #include "util.h"
 #include "value.h"
 #include "scenebasic.h"
+#include "scenespatialindex.h"
 
 class SceneNodeCommandRemove;
 class QDomElement;
@@ -36,6 +37,7 @@ public:
     inline Point point() const { return m_point.point(); }
     inline PointValue pointValue() const { return m_point; }
     void setPointValue(const PointValue &point);
+    inline RectPoint boundingBox() const { return RectPoint(point(), point()); }
 
     // geometry editor
     bool isConnected() const;
@@ -71,7 +73,15 @@ public:
 
     SceneNode* findClosest(const Point& point) const;
 
+    virtual bool add(SceneNode *item);
     virtual bool remove(SceneNode *item);
+    virtual void clear();
+
+    /// nodes inside rectangle (spatial index)
+    QList<SceneNode *> itemsInRect(const RectPoint &rect) const { return m_index.items(rect); }
+    /// node has been moved
+    void updateItem(SceneNode *item) { m_index.update(item); }
+    void optimizeIndex() { m_index.optimize(); }
 
     /// returns bounding box, assumes container not empty
     RectPoint boundingBox() const;
@@ -79,6 +89,9 @@ public:
     //TODO should be in SceneBasicContainer, but I would have to cast the result....
     SceneNodeContainer selected();
     SceneNodeContainer highlighted();
+
+private:
+    SceneSpatialIndex<SceneNode> m_index;
 };
 
 
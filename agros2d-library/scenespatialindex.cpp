@@ -0,0 +1,266 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "scenespatialindex.h"
+
+#include "scenenode.h"
+#include "sceneedge.h"
+
+// average number of items in one cell
+const int SPATIAL_INDEX_ITEMS_PER_CELL = 2;
+// items covering more cells are not stored in the grid
+const int SPATIAL_INDEX_MAX_CELLS_PER_ITEM = 64;
+const int SPATIAL_INDEX_MAX_CELL_INDEX = 1 << 30;
+
+static inline bool rectIntersects(const RectPoint &a, const RectPoint &b)
+{
+    return (a.start.x <= b.end.x) && (b.start.x <= a.end.x) &&
+            (a.start.y <= b.end.y) && (b.start.y <= a.end.y);
+}
+
+template <typename BasicType>
+SceneSpatialIndex<BasicType>::SceneSpatialIndex()
+    : m_cellSize(0.0), m_builtCount(0), m_serial(0), m_references(0)
+{
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::clear()
+{
+    m_cells.clear();
+    m_entries.clear();
+    m_large.clear();
+
+    m_cellSize = 0.0;
+    m_builtCount = 0;
+    m_serial = 0;
+    m_references = 0;
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::insert(BasicType *item)
+{
+    assert(!m_entries.contains(item));
+
+    Entry entry;
+    entry.serial = m_serial++;
+    entry.box = item->boundingBox();
+    entry.isLarge = false;
+
+    m_entries.insert(item, entry);
+
+    // cell size is derived from the geometry, grid is rebuilt when the number of items doubles
+    if (m_cellSize == 0.0 || m_entries.count() > 2 * m_builtCount)
+        rebuild();
+    else
+        addToCells(item, m_entries[item]);
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::remove(BasicType *item)
+{
+    typename QHash<BasicType *, Entry>::iterator it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    removeFromCells(item, it.value());
+    m_entries.erase(it);
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::update(BasicType *item)
+{
+    typename QHash<BasicType *, Entry>::iterator it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    removeFromCells(item, it.value());
+    it.value().box = item->boundingBox();
+    addToCells(item, it.value());
+}
+
+template <typename BasicType>
+QList<BasicType *> SceneSpatialIndex<BasicType>::items(const RectPoint &rect) const
+{
+    // ordered by serial number
+    QMap<qint64, BasicType *> found;
+
+    if (m_entries.isEmpty())
+        return found.values();
+
+    int x0 = cellIndex(rect.start.x);
+    int x1 = cellIndex(rect.end.x);
+    int y0 = cellIndex(rect.start.y);
+    int y1 = cellIndex(rect.end.y);
+
+    if ((double(x1 - x0 + 1) * double(y1 - y0 + 1)) > m_cells.count())
+    {
+        // large rectangle - check all items
+        for (typename QHash<BasicType *, Entry>::const_iterator it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+            if (rectIntersects(it.value().box, rect))
+                found.insert(it.value().serial, it.key());
+    }
+    else
+    {
+        for (int i = x0; i <= x1; i++)
+        {
+            for (int j = y0; j <= y1; j++)
+            {
+                typename QHash<qint64, QList<BasicType *> >::const_iterator cell = m_cells.find(cellKey(i, j));
+                if (cell == m_cells.constEnd())
+                    continue;
+
+                foreach (BasicType *item, cell.value())
+                {
+                    const Entry &entry = m_entries[item];
+                    if (rectIntersects(entry.box, rect))
+                        found.insert(entry.serial, item);
+                }
+            }
+        }
+
+        foreach (BasicType *item, m_large)
+        {
+            const Entry &entry = m_entries[item];
+            if (rectIntersects(entry.box, rect))
+                found.insert(entry.serial, item);
+        }
+    }
+
+    return found.values();
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::optimize()
+{
+    if (m_entries.isEmpty())
+        return;
+
+    // too many large items or overfilled cells
+    if ((m_large.count() > 16 + m_entries.count() / 8) ||
+            (m_references > 16 * SPATIAL_INDEX_ITEMS_PER_CELL * m_cells.count()) ||
+            (m_references > 8 * m_entries.count()))
+        rebuild();
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::rebuild()
+{
+    m_cells.clear();
+    m_large.clear();
+    m_references = 0;
+    m_builtCount = m_entries.count();
+
+    // bounding box and mean size of items
+    Point min( numeric_limits<double>::max(),  numeric_limits<double>::max());
+    Point max(-numeric_limits<double>::max(), -numeric_limits<double>::max());
+    double size = 0.0;
+
+    foreach (const Entry &entry, m_entries)
+    {
+        min.x = qMin(min.x, entry.box.start.x);
+        min.y = qMin(min.y, entry.box.start.y);
+        max.x = qMax(max.x, entry.box.end.x);
+        max.y = qMax(max.y, entry.box.end.y);
+
+        size += qMax(entry.box.width(), entry.box.height());
+    }
+    size /= m_entries.count();
+
+    double width = max.x - min.x;
+    double height = max.y - min.y;
+
+    m_cellSize = qMax(sqrt(width * height * SPATIAL_INDEX_ITEMS_PER_CELL / m_entries.count()), size);
+    if (m_cellSize < EPS_ZERO * qMax(width, height))
+        m_cellSize = qMax(width, height) / m_entries.count();
+    if (m_cellSize < EPS_ZERO)
+        m_cellSize = 1.0;
+
+    for (typename QHash<BasicType *, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        addToCells(it.key(), it.value());
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::addToCells(BasicType *item, Entry &entry)
+{
+    entry.x0 = cellIndex(entry.box.start.x);
+    entry.x1 = cellIndex(entry.box.end.x);
+    entry.y0 = cellIndex(entry.box.start.y);
+    entry.y1 = cellIndex(entry.box.end.y);
+
+    int cells = (entry.x1 - entry.x0 + 1) * (entry.y1 - entry.y0 + 1);
+    entry.isLarge = ((entry.x1 - entry.x0 + 1) > SPATIAL_INDEX_MAX_CELLS_PER_ITEM) ||
+            ((entry.y1 - entry.y0 + 1) > SPATIAL_INDEX_MAX_CELLS_PER_ITEM) ||
+            (cells > SPATIAL_INDEX_MAX_CELLS_PER_ITEM);
+
+    if (entry.isLarge)
+    {
+        m_large.insert(item);
+        return;
+    }
+
+    for (int i = entry.x0; i <= entry.x1; i++)
+        for (int j = entry.y0; j <= entry.y1; j++)
+            m_cells[cellKey(i, j)].append(item);
+
+    m_references += cells;
+}
+
+template <typename BasicType>
+void SceneSpatialIndex<BasicType>::removeFromCells(BasicType *item, const Entry &entry)
+{
+    if (entry.isLarge)
+    {
+        m_large.remove(item);
+        return;
+    }
+
+    for (int i = entry.x0; i <= entry.x1; i++)
+    {
+        for (int j = entry.y0; j <= entry.y1; j++)
+        {
+            typename QHash<qint64, QList<BasicType *> >::iterator cell = m_cells.find(cellKey(i, j));
+            assert(cell != m_cells.end());
+
+            cell.value().removeOne(item);
+            if (cell.value().isEmpty())
+                m_cells.erase(cell);
+        }
+    }
+
+    m_references -= (entry.x1 - entry.x0 + 1) * (entry.y1 - entry.y0 + 1);
+}
+
+template <typename BasicType>
+int SceneSpatialIndex<BasicType>::cellIndex(double coordinate) const
+{
+    if (m_cellSize == 0.0)
+        return 0;
+
+    double index = floor(coordinate / m_cellSize);
+    if (index > SPATIAL_INDEX_MAX_CELL_INDEX)
+        return SPATIAL_INDEX_MAX_CELL_INDEX;
+    if (index < -SPATIAL_INDEX_MAX_CELL_INDEX)
+        return -SPATIAL_INDEX_MAX_CELL_INDEX;
+
+    return int(index);
+}
+
+template class SceneSpatialIndex<SceneNode>;
+template class SceneSpatialIndex<SceneEdge>;
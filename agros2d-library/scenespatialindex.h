@@ -0,0 +1,79 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SCENESPATIALINDEX_H
+#define SCENESPATIALINDEX_H
+
+#include "util.h"
+
+class SceneNode;
+class SceneEdge;
+
+// hashed uniform grid over bounding boxes of scene items (item->boundingBox())
+// items covering too many cells are kept in a separate list
+template <typename BasicType>
+class SceneSpatialIndex
+{
+public:
+    SceneSpatialIndex();
+
+    void clear();
+    void insert(BasicType *item);
+    void remove(BasicType *item);
+    // geometry of item has been changed
+    void update(BasicType *item);
+
+    inline bool contains(BasicType *item) const { return m_entries.contains(item); }
+    inline int count() const { return m_entries.count(); }
+
+    // items with bounding box intersecting rectangle (in order of insertion)
+    QList<BasicType *> items(const RectPoint &rect) const;
+
+    // rebuild grid if the cell size does not fit the geometry (after transformations)
+    void optimize();
+
+private:
+    struct Entry
+    {
+        qint64 serial;
+        RectPoint box;
+
+        // cell range
+        int x0, y0, x1, y1;
+        bool isLarge;
+    };
+
+    double m_cellSize;
+    int m_builtCount;
+    qint64 m_serial;
+    int m_references;
+
+    QHash<qint64, QList<BasicType *> > m_cells;
+    QHash<BasicType *, Entry> m_entries;
+    QSet<BasicType *> m_large;
+
+    void rebuild();
+    void addToCells(BasicType *item, Entry &entry);
+    void removeFromCells(BasicType *item, const Entry &entry);
+
+    int cellIndex(double coordinate) const;
+    inline qint64 cellKey(int i, int j) const { return (qint64(i) << 32) | quint32(j); }
+};
+
+#endif // SCENESPATIALINDEX_H
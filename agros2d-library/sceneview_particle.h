@@ -81,6 +81,7 @@ private:
     LineEditDouble *txtParticleDragReferenceArea;
     QCheckBox *chkParticleP2PElectricForce;
     QCheckBox *chkParticleP2PMagneticForce;
+    LineEditDouble *txtParticleP2POpeningAngle;
 
     void createControls();
 
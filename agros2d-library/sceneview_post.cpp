@@ -52,18 +52,433 @@
 
 #include "pythonlab/pythonengine.h"
 
+// quality of the linearized views (refinement level of the fixed linearizer criterion)
+const int POST_QUALITY_COARSE = 0;
+const int POST_QUALITY_FULL = 1;
+
+// snapshot of the active solution and view settings, the worker thread does not touch the problem
+struct PostProcessingRequest
+{
+    PostProcessingRequest() : generation(0), coarsePass(false), fieldInfo(NULL),
+        showOrder(false), orderComponent(0),
+        showContour(false), contourComp(PhysicFieldVariableComp_Undefined), deformContour(false),
+        showScalar(false), scalarComp(PhysicFieldVariableComp_Undefined), deformScalar(false),
+        showVector(false), deformVector(false) {}
+
+    int generation;
+    bool coarsePass;
+
+    FieldInfo *fieldInfo;
+    FieldSolutionID fsid;
+
+    // copies of the solutions, the solutions in the store can be evaluated by the gui meanwhile
+    Hermes::vector<Hermes::Hermes2D::SpaceSharedPtr<double> > spaces;
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > solutions;
+    RectPoint boundingBox;
+
+    // filters of the copied solutions, see filterKey
+    // created on the gui thread (filters read the problem config and the material tables)
+    QMap<QString, Hermes::Hermes2D::MeshFunctionSharedPtr<double> > filters;
+
+    bool showOrder;
+    int orderComponent;
+
+    bool showContour;
+    QString contourVariable;
+    PhysicFieldVariableComp contourComp;
+    bool deformContour;
+
+    bool showScalar;
+    QString scalarVariable;
+    PhysicFieldVariableComp scalarComp;
+    bool deformScalar;
+
+    bool showVector;
+    QString vectorVariable;
+    bool deformVector;
+};
+
+static QString filterKey(const QString &variable, PhysicFieldVariableComp comp)
+{
+    return QString("%1/%2").arg(variable).arg(comp);
+}
+
+static QString viewKey(const PostProcessingRequest &request, const QString &view, const QString &variable, int comp, bool deform, int quality)
+{
+    return QString("%1/%2/%3/%4/%5/%6/%7/%8/%9").
+            arg(request.fieldInfo->fieldId()).
+            arg(request.fsid.timeStep).
+            arg(request.fsid.adaptivityStep).
+            arg(request.fsid.solutionMode).
+            arg(view).
+            arg(variable).
+            arg(comp).
+            arg(deform).
+            arg(quality);
+}
+
+class PostProcessingThread : public QThread
+{
+public:
+    PostProcessingThread(PostHermes *postHermes, const PostProcessingRequest &request)
+        : QThread(), m_postHermes(postHermes), m_request(request), m_deformationScale(0.0) {}
+
+    inline const PostProcessingRequest &request() const { return m_request; }
+    // errors are reported by the gui when the thread is finished (log is not thread safe)
+    inline QStringList errors() const { return m_errors; }
+
+    // coarse pass (if requested) and full pass, linearized views are stored in the cache
+    // the gui is notified after each pass if notify is set
+    void process(bool notify);
+
+protected:
+    virtual void run() { process(true); }
+
+private:
+    PostHermes *m_postHermes;
+    PostProcessingRequest m_request;
+    double m_deformationScale;
+    QStringList m_errors;
+
+    inline bool isCanceled() { return m_postHermes->isCanceled(m_request.generation); }
+
+    Hermes::Hermes2D::MeshFunctionSharedPtr<double> filter(const QString &variable, PhysicFieldVariableComp comp);
+    double deformationScale();
+
+    void processOrder();
+    void processLinearizer(const QString &variable, PhysicFieldVariableComp comp, bool deform, int quality);
+    void processVectorizer(const QString &variable, bool deform, int quality);
+};
+
+void PostProcessingThread::process(bool notify)
+{
+    if (m_request.deformContour || m_request.deformScalar || m_request.deformVector)
+        m_deformationScale = deformationScale();
+
+    processOrder();
+
+    QList<int> qualities;
+    if (m_request.coarsePass)
+        qualities.append(POST_QUALITY_COARSE);
+    qualities.append(POST_QUALITY_FULL);
+
+    // running pass of Hermes cannot be interrupted, cancellation is checked between views
+    foreach (int quality, qualities)
+    {
+        if (isCanceled())
+            return;
+        if (m_request.showContour)
+            processLinearizer(m_request.contourVariable, m_request.contourComp, m_request.deformContour, quality);
+
+        if (isCanceled())
+            return;
+        if (m_request.showScalar)
+            processLinearizer(m_request.scalarVariable, m_request.scalarComp, m_request.deformScalar, quality);
+
+        if (isCanceled())
+            return;
+        if (m_request.showVector)
+            processVectorizer(m_request.vectorVariable, m_request.deformVector, quality);
+
+        if (notify)
+            QMetaObject::invokeMethod(m_postHermes, "processPass", Qt::QueuedConnection,
+                                      Q_ARG(int, m_request.generation), Q_ARG(int, quality));
+    }
+}
+
+Hermes::Hermes2D::MeshFunctionSharedPtr<double> PostProcessingThread::filter(const QString &variable, PhysicFieldVariableComp comp)
+{
+    assert(m_request.filters.contains(filterKey(variable, comp)));
+    return m_request.filters.value(filterKey(variable, comp));
+}
+
+double PostProcessingThread::deformationScale()
+{
+    double scale = 0.0;
+
+    Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(m_request.solutions.at(0),
+                                                                                                                                                           m_request.solutions.at(1)));
+    if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
+        scale = qMax(m_request.boundingBox.width(), m_request.boundingBox.height()) / filter->get_approx_max_value() / 15.0;
+    delete filter;
+
+    return scale;
+}
+
+void PostProcessingThread::processOrder()
+{
+    if (!m_request.showOrder)
+        return;
+
+    QString key = viewKey(m_request, "order", "", m_request.orderComponent, false, POST_QUALITY_FULL);
+    if (m_postHermes->viewCache()->contains(key))
+        return;
+
+    QSharedPointer<Hermes::Hermes2D::Views::Orderizer> orderView(new Hermes::Hermes2D::Views::Orderizer());
+
+    try
+    {
+        orderView->process_space(m_request.spaces.at(m_request.orderComponent));
+
+        PostViewData data;
+        data.orderizer = orderView;
+        m_postHermes->viewCache()->insert(key, data);
+    }
+    catch (Hermes::Exceptions::Exception& e)
+    {
+        m_errors.append(QObject::tr("Orderizer processing failed: %1").arg(e.info().c_str()));
+    }
+}
+
+void PostProcessingThread::processLinearizer(const QString &variable, PhysicFieldVariableComp comp, bool deform, int quality)
+{
+    // contour and scalar view of the same variable share the linearizer
+    QString key = viewKey(m_request, "linearizer", variable, comp, deform, quality);
+    if (m_postHermes->viewCache()->contains(key))
+        return;
+
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linView(new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL));
+
+    // deformed shape
+    if (deform && m_deformationScale != 0.0)
+        linView->set_displacement(m_request.solutions.at(0), m_request.solutions.at(1), m_deformationScale);
+    else
+        linView->set_displacement(NULL, NULL);
+
+    try
+    {
+        linView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(quality));
+        linView->process_solution(filter(variable, comp), Hermes::Hermes2D::H2D_FN_VAL_0);
+
+        PostViewData data;
+        data.linearizer = linView;
+        m_postHermes->viewCache()->insert(key, data);
+    }
+    catch (Hermes::Exceptions::Exception &e)
+    {
+        m_errors.append(QObject::tr("Linearizer (%1) processing failed: %2").arg(variable).arg(e.info().c_str()));
+    }
+}
+
+void PostProcessingThread::processVectorizer(const QString &variable, bool deform, int quality)
+{
+    QString key = viewKey(m_request, "vectorizer", variable, PhysicFieldVariableComp_Undefined, deform, quality);
+    if (m_postHermes->viewCache()->contains(key))
+        return;
+
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vecView(new Hermes::Hermes2D::Views::Vectorizer(Hermes::Hermes2D::OpenGL));
+
+    // deformed shape
+    if (deform && m_deformationScale != 0.0)
+        vecView->set_displacement(m_request.solutions.at(0), m_request.solutions.at(1), m_deformationScale);
+    else
+        vecView->set_displacement(NULL, NULL);
+
+    Hermes::Hermes2D::MeshFunctionSharedPtr<double> slns[2] = { filter(variable, PhysicFieldVariableComp_X),
+                                                                 filter(variable, PhysicFieldVariableComp_Y) };
+    int items[2] = { Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0 };
+
+    try
+    {
+        vecView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(quality));
+        vecView->process_solution(slns, items);
+
+        PostViewData data;
+        data.vectorizer = vecView;
+        m_postHermes->viewCache()->insert(key, data);
+    }
+    catch (Hermes::Exceptions::Exception &e)
+    {
+        m_errors.append(QObject::tr("Vectorizer processing failed: %1").arg(e.info().c_str()));
+    }
+}
+
+// ************************************************************************************************
+
+bool PostViewCache::contains(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_data.contains(key);
+}
+
+PostViewData PostViewCache::value(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_data.contains(key))
+        return PostViewData();
+
+    // most recently used key is the last one
+    m_keys.removeOne(key);
+    m_keys.append(key);
+
+    return m_data[key];
+}
+
+void PostViewCache::insert(const QString &key, const PostViewData &data)
+{
+    QMutexLocker locker(&m_mutex);
+    m_keys.removeOne(key);
+    m_keys.append(key);
+    m_data[key] = data;
+
+    // views in use are kept alive by their shared pointers
+    while (m_keys.size() > m_size)
+        m_data.remove(m_keys.takeFirst());
+}
+
+void PostViewCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_data.clear();
+    m_keys.clear();
+}
+
+// ************************************************************************************************
+
+PostScalarFieldArray::PostScalarFieldArray()
+    : m_offset(0.0), m_count(0),
+      m_vertexBuffer(QGLBuffer::VertexBuffer), m_normalBuffer(QGLBuffer::VertexBuffer)
+{
+}
+
+void PostScalarFieldArray::clear()
+{
+    m_linearizer.clear();
+    m_offset = 0.0;
+    m_count = 0;
+
+    m_vertices.clear();
+    m_normals.clear();
+
+    if (m_vertexBuffer.isCreated())
+        m_vertexBuffer.destroy();
+    if (m_normalBuffer.isCreated())
+        m_normalBuffer.destroy();
+}
+
+void PostScalarFieldArray::create(QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer, bool normals)
+{
+    clear();
+
+    m_linearizer = linearizer;
+    if (m_linearizer.isNull())
+        return;
+
+    m_offset = m_linearizer->get_min_value();
+
+    for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
+         it = m_linearizer->triangles_begin(); !it.end; ++it)
+    {
+        Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
+
+        for (int j = 0; j < 3; j++)
+        {
+            m_vertices.append(triangle[j][0]);
+            m_vertices.append(triangle[j][1]);
+            m_vertices.append(triangle[j][2] - m_offset);
+        }
+
+        if (normals)
+        {
+            double ax = triangle[1][0] - triangle[0][0];
+            double ay = triangle[1][1] - triangle[0][1];
+            double az = triangle[1][2] - triangle[0][2];
+
+            double bx = triangle[2][0] - triangle[0][0];
+            double by = triangle[2][1] - triangle[0][1];
+            double bz = triangle[2][2] - triangle[0][2];
+
+            // surface is flipped (z = - value) by the modelview matrix, normals are normalized by OpenGL
+            for (int j = 0; j < 3; j++)
+            {
+                m_normals.append(- (ay * bz - az * by));
+                m_normals.append(- (az * bx - ax * bz));
+                m_normals.append(- (ax * by - ay * bx));
+            }
+        }
+
+        m_count += 3;
+    }
+
+    // client side arrays are kept if buffer objects are not supported (Mesa software rendering supports both)
+    if (m_vertexBuffer.create())
+    {
+        m_vertexBuffer.setUsagePattern(QGLBuffer::StaticDraw);
+        m_vertexBuffer.bind();
+        m_vertexBuffer.allocate(m_vertices.constData(), m_vertices.size() * sizeof(GLfloat));
+        m_vertexBuffer.release();
+        m_vertices.clear();
+
+        if (normals && m_normalBuffer.create())
+        {
+            m_normalBuffer.setUsagePattern(QGLBuffer::StaticDraw);
+            m_normalBuffer.bind();
+            m_normalBuffer.allocate(m_normals.constData(), m_normals.size() * sizeof(GLfloat));
+            m_normalBuffer.release();
+            m_normals.clear();
+        }
+    }
+}
+
+void PostScalarFieldArray::paint(bool elevation)
+{
+    if (m_count == 0)
+        return;
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    if (m_vertexBuffer.isCreated())
+    {
+        m_vertexBuffer.bind();
+        glVertexPointer(elevation ? 3 : 2, GL_FLOAT, 3 * sizeof(GLfloat), 0);
+        glTexCoordPointer(1, GL_FLOAT, 3 * sizeof(GLfloat), reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
+        m_vertexBuffer.release();
+    }
+    else
+    {
+        glVertexPointer(elevation ? 3 : 2, GL_FLOAT, 3 * sizeof(GLfloat), m_vertices.constData());
+        glTexCoordPointer(1, GL_FLOAT, 3 * sizeof(GLfloat), m_vertices.constData() + 2);
+    }
+
+    bool normals = elevation && (m_normalBuffer.isCreated() || !m_normals.isEmpty());
+    if (normals)
+    {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        if (m_normalBuffer.isCreated())
+        {
+            m_normalBuffer.bind();
+            glNormalPointer(GL_FLOAT, 0, 0);
+            m_normalBuffer.release();
+        }
+        else
+        {
+            glNormalPointer(GL_FLOAT, 0, m_normals.constData());
+        }
+    }
+
+    glDrawArrays(GL_TRIANGLES, 0, m_count);
+
+    if (normals)
+        glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// ************************************************************************************************
+
 PostHermes::PostHermes() :
     m_activeViewField(NULL),
     m_activeTimeStep(NOT_FOUND_SO_FAR),
     m_activeAdaptivityStep(NOT_FOUND_SO_FAR),
     m_activeSolutionMode(SolutionMode_Undefined),
     m_isProcessed(false),
+    m_thread(NULL),
+    m_pendingRefresh(false),
+    m_generation(0),
+    m_viewCache(8),
     m_linInitialMeshView(NULL),
-    m_linSolutionMeshView(NULL),
-    m_orderView(NULL),
-    m_linContourView(NULL),
-    m_linScalarView(NULL),
-    m_vecVectorView(NULL)
+    m_linSolutionMeshView(NULL)
 {
     connect(Agros2D::scene(), SIGNAL(cleared()), this, SLOT(clear()));
     connect(Agros2D::problem(), SIGNAL(clearedSolution()), this, SLOT(clearView()));
@@ -75,7 +490,17 @@ PostHermes::PostHermes() :
 
 PostHermes::~PostHermes()
 {
-    clear();
+    nextGeneration();
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+    }
+
+    if (m_linInitialMeshView)
+        delete m_linInitialMeshView;
+    if (m_linSolutionMeshView)
+        delete m_linSolutionMeshView;
 }
 
 void PostHermes::processInitialMesh()
@@ -134,315 +559,199 @@ void PostHermes::processSolutionMesh()
     }
 }
 
-void PostHermes::processOrder()
+bool PostHermes::isCanceled(int generation)
 {
-    // init linearizer for order view
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowOrderView).toBool()))
-    {
-        Agros2D::log()->printMessage(tr("Mesh View"), tr("Polynomial order"));
+    QMutexLocker locker(&m_generationMutex);
+    return (generation != m_generation);
+}
 
-        int comp = Agros2D::problem()->setting()->value(ProblemSetting::View_OrderComponent).toInt() - 1;
+int PostHermes::nextGeneration()
+{
+    QMutexLocker locker(&m_generationMutex);
+    return ++m_generation;
+}
 
-        if (m_orderView)
-            delete m_orderView;
-        m_orderView = new Hermes::Hermes2D::Views::Orderizer();
+void PostHermes::cancelProcessing()
+{
+    nextGeneration();
+    m_pendingRefresh = false;
 
-        try
-        {
-            m_orderView->process_space(activeMultiSolutionArray().spaces().at(comp));
-        }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_orderView;
-            m_orderView = NULL;
+    if (m_thread)
+    {
+        // running pass cannot be interrupted, its result is not used
+        m_thread->wait();
+        delete m_thread;
+        m_thread = NULL;
 
-            Agros2D::log()->printError("Order View", QObject::tr("Orderizer processing failed: %1").arg(e.info().c_str()));
-        }
+        Agros2D::problem()->setIsPostprocessingRunning(false);
     }
 }
 
-void PostHermes::processRangeContour()
+void PostHermes::clearView()
 {
-    if (Agros2D::problem()->isSolved() && m_activeViewField && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowContourView).toBool()))
-    {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
-
-        Agros2D::log()->printMessage(tr("Post View"), tr("Contour view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()));
+    cancelProcessing();
 
-        QString variableName = Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString();
-        Module::LocalVariable variable = m_activeViewField->localVariable(variableName);
+    m_isProcessed = false;
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnContourView;
-        if (variable.isScalar())
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Scalar);
-        else
-            slnContourView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ContourVariable).toString()),
-                                              PhysicFieldVariableComp_Magnitude);
+    if (m_linInitialMeshView)
+    {
+        delete m_linInitialMeshView;
+        m_linInitialMeshView = NULL;
+    }
+    if (m_linSolutionMeshView)
+    {
+        delete m_linSolutionMeshView;
+        m_linSolutionMeshView = NULL;
+    }
 
-        // new linearizer
-        if (m_linContourView)
-            delete m_linContourView;
-        m_linContourView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+    m_orderView.clear();
+    m_linContourView.clear();
+    m_linScalarView.clear();
+    m_vecVectorView.clear();
 
+    m_viewCache.clear();
+}
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformContour).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
+void PostHermes::refresh()
+{
+    cancelProcessing();
 
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+    Agros2D::problem()->setIsPostprocessingRunning();
 
-                m_linContourView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                  activeMultiSolutionArray().solutions().at(1),
-                                                  dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_linContourView->set_displacement(NULL, NULL);
-        }
+    processMeshed();
 
-        // process solution.
-        try
-        {
-            m_linContourView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            // m_linContourView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_linContourView->process_solution(slnContourView, Hermes::Hermes2D::H2D_FN_VAL_0);
-        }
-        catch (Hermes::Exceptions::Exception& e)
-        {
-            delete m_linContourView;
-            m_linContourView = NULL;
+    PostProcessingRequest request;
+    if (createRequest(request, false))
+    {
+        PostProcessingThread worker(this, request);
+        worker.process(false);
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (contour view) processing failed: %1").arg(e.info().c_str()));
-        }
+        foreach (QString error, worker.errors())
+            Agros2D::log()->printError(tr("Post View"), error);
     }
+    setViews(request, POST_QUALITY_FULL);
+
+    m_isProcessed = true;
+    emit processed();
+    Agros2D::problem()->setIsPostprocessingRunning(false);
 }
 
-void PostHermes::processRangeScalar()
+void PostHermes::refreshAsync()
 {
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField)
-            && ((Agros2D::problem()->setting()->value(ProblemSetting::View_ShowScalarView).toBool())
-                || (((SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D)))
-    {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewScalarVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
+    nextGeneration();
 
-        Agros2D::log()->printMessage(tr("Post View"), tr("Scalar view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()));
+    Agros2D::problem()->setIsPostprocessingRunning();
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnScalarView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariable).toString()),
-                                                                                         (PhysicFieldVariableComp) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarVariableComp).toInt());
+    // the latest request is started when the running thread finishes
+    if (m_thread && m_thread->isRunning())
+    {
+        m_pendingRefresh = true;
+        return;
+    }
 
-        // new linearizer
-        if (m_linScalarView)
-            delete m_linScalarView;
-        m_linScalarView = new Hermes::Hermes2D::Views::Linearizer(Hermes::Hermes2D::OpenGL);
+    startThread();
+}
 
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformScalar).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
+void PostHermes::startThread()
+{
+    m_pendingRefresh = false;
 
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = NULL;
+    }
 
-                m_linScalarView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                  activeMultiSolutionArray().solutions().at(1),
-                                                  dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_linScalarView->set_displacement(NULL, NULL);
-        }
+    // mesh views are not expensive
+    processMeshed();
 
-        // process solution
-        try
-        {
-            /*
-            QTime time;
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH)" << time.elapsed();
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_HIGH));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_HIGH)" << time.elapsed();
-
-            time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(2));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            qDebug() << "LinearizerCriterionFixed(2)" << time.elapsed();
-            */
-            // time.start();
-            m_linScalarView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            m_linScalarView->process_solution(slnScalarView, Hermes::Hermes2D::H2D_FN_VAL_0);
-            // qDebug() << "LinearizerCriterionFixed(1)" << time.elapsed();
-
-            if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
-            {
-                Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView->get_min_value());
-                Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView->get_max_value());
-            }
-        }
-        catch (Hermes::Exceptions::Exception &e)
-        {
-            delete m_linScalarView;
-            m_linScalarView = NULL;
+    PostProcessingRequest request;
+    if (createRequest(request, true))
+    {
+        m_thread = new PostProcessingThread(this, request);
+        connect(m_thread, SIGNAL(finished()), this, SLOT(processFinished()));
+        m_thread->start();
+    }
+    else
+    {
+        setViews(request, POST_QUALITY_FULL);
 
-            Agros2D::log()->printError("Mesh View", QObject::tr("Linearizer (scalar view) processing failed: %1").arg(e.info().c_str()));
-        }
+        m_isProcessed = true;
+        emit processed();
+        Agros2D::problem()->setIsPostprocessingRunning(false);
     }
 }
 
-void PostHermes::processRangeVector()
+void PostHermes::processPass(int generation, int quality)
 {
-    if ((Agros2D::problem()->isSolved()) && (m_activeViewField) && (Agros2D::problem()->setting()->value(ProblemSetting::View_ShowVectorView).toBool()))
-    {
-        bool contains = false;
-        foreach (Module::LocalVariable variable, m_activeViewField->viewVectorVariables())
-        {
-            if (variable.id() == Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString())
-            {
-                contains = true;
-                break;
-            }
-        }
+    // pass of a canceled request
+    if (isCanceled(generation) || !m_thread)
+        return;
 
-        Agros2D::log()->printMessage(tr("Post View"), tr("Vector view (%1)").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()));
+    setViews(m_thread->request(), quality);
 
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorXView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_X);
-
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slnVectorYView = viewScalarFilter(m_activeViewField->localVariable(Agros2D::problem()->setting()->value(ProblemSetting::View_VectorVariable).toString()),
-                                                                                          PhysicFieldVariableComp_Y);
-
-        // new vectorizer
-        if (m_vecVectorView)
-            delete m_vecVectorView;
-        m_vecVectorView = new Hermes::Hermes2D::Views::Vectorizer(Hermes::Hermes2D::OpenGL);
-
-        // deformed shape
-        if (m_activeViewField->hasDeformableShape() && Agros2D::problem()->setting()->value(ProblemSetting::View_DeformVector).toBool())
-        {
-            Hermes::Hermes2D::MagFilter<double> *filter = new Hermes::Hermes2D::MagFilter<double>(Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> >(activeMultiSolutionArray().solutions().at(0),
-                                                                                                                                                                   activeMultiSolutionArray().solutions().at(1)));
-            if (fabs(filter->get_approx_max_value() - filter->get_approx_min_value()) > EPS_ZERO)
-            {
-                RectPoint rect = Agros2D::scene()->boundingBox();
-                double dmult = qMax(rect.width(), rect.height()) / filter->get_approx_max_value() / 15.0;
+    m_isProcessed = true;
+    emit processed();
+}
 
-                m_vecVectorView->set_displacement(activeMultiSolutionArray().solutions().at(0),
-                                                 activeMultiSolutionArray().solutions().at(1),
-                                                 dmult);
-            }
-            delete filter;
-        }
-        else
-        {
-            m_vecVectorView->set_displacement(NULL, NULL);
-        }
+void PostHermes::processFinished()
+{
+    // thread already deleted by cancelProcessing
+    if (sender() != m_thread)
+        return;
 
-        // process solution
-        Hermes::Hermes2D::MeshFunctionSharedPtr<double> slns[2] = { slnVectorXView, slnVectorYView };
-        int items[2] = { Hermes::Hermes2D::H2D_FN_VAL_0, Hermes::Hermes2D::H2D_FN_VAL_0 };
+    if (!isCanceled(m_thread->request().generation))
+        foreach (QString error, m_thread->errors())
+            Agros2D::log()->printError(tr("Post View"), error);
 
-        try
-        {
-            // m_vecVectorView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionAdaptive(Hermes::Hermes2D::Views::HERMES_EPS_VERYHIGH));
-            m_vecVectorView->set_criterion(Hermes::Hermes2D::Views::LinearizerCriterionFixed(1));
-            m_vecVectorView->process_solution(slns, items);
-        }
-        catch (Hermes::Exceptions::Exception &e)
-        {
-            delete m_vecVectorView;
-            m_vecVectorView = NULL;
-
-            Agros2D::log()->printError("Mesh View", QObject::tr("Vectorizer processing failed: %1").arg(e.info().c_str()));
-        }
-    }
+    if (m_pendingRefresh)
+        startThread();
+    else
+        Agros2D::problem()->setIsPostprocessingRunning(false);
 }
 
-void PostHermes::clearView()
+void PostHermes::waitForProcessing()
 {
-    m_isProcessed = false;
-
-    if (m_linInitialMeshView)
-    {
-        delete m_linInitialMeshView;
-        m_linInitialMeshView = NULL;
-    }
-    if (m_linSolutionMeshView)
+    while (m_thread)
     {
-        delete m_linSolutionMeshView;
-        m_linSolutionMeshView = NULL;
-    }
-    if (m_orderView)
-    {
-        delete m_orderView;
-        m_orderView = NULL;
-    }
+        m_thread->wait();
 
-    if (m_linContourView)
-    {
-        delete m_linContourView;
-        m_linContourView = NULL;
-    }
-    if (m_linScalarView)
-    {
-        delete m_linScalarView;
-        m_linScalarView = NULL;
-    }
+        // queued passes, finished() starts the pending request
+        QCoreApplication::processEvents();
 
-    if (m_vecVectorView)
-    {
-        delete m_vecVectorView;
-        m_vecVectorView = NULL;
+        if (m_thread && !m_thread->isRunning() && !m_pendingRefresh)
+            break;
     }
 }
 
-void PostHermes::refresh()
+void PostHermes::setViews(const PostProcessingRequest &request, int quality)
 {
-    Agros2D::problem()->setIsPostprocessingRunning();
-    clearView();
+    if (request.showOrder)
+        m_orderView = m_viewCache.value(viewKey(request, "order", "", request.orderComponent, false, POST_QUALITY_FULL)).orderizer;
+    else
+        m_orderView.clear();
 
-    if (Agros2D::problem()->isMeshed())
-        processMeshed();
+    if (request.showContour)
+        m_linContourView = m_viewCache.value(viewKey(request, "linearizer", request.contourVariable, request.contourComp, request.deformContour, quality)).linearizer;
+    else
+        m_linContourView.clear();
 
-    if (Agros2D::problem()->isSolved())
-        processSolved();
+    if (request.showScalar)
+        m_linScalarView = m_viewCache.value(viewKey(request, "linearizer", request.scalarVariable, request.scalarComp, request.deformScalar, quality)).linearizer;
+    else
+        m_linScalarView.clear();
 
-    m_isProcessed = true;
-    emit processed();
-    Agros2D::problem()->setIsPostprocessingRunning(false);
+    if (m_linScalarView && Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+    {
+        Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMin, m_linScalarView->get_min_value());
+        Agros2D::problem()->setting()->setValue(ProblemSetting::View_ScalarRangeMax, m_linScalarView->get_max_value());
+    }
+
+    if (request.showVector)
+        m_vecVectorView = m_viewCache.value(viewKey(request, "vectorizer", request.vectorVariable, PhysicFieldVariableComp_Undefined, request.deformVector, quality)).vectorizer;
+    else
+        m_vecVectorView.clear();
 }
 
 void PostHermes::clear()
@@ -496,35 +805,121 @@ void PostHermes::problemSolved()
 
 void PostHermes::processMeshed()
 {
-    processInitialMesh();
+    if (m_linInitialMeshView)
+    {
+        delete m_linInitialMeshView;
+        m_linInitialMeshView = NULL;
+    }
+    if (m_linSolutionMeshView)
+    {
+        delete m_linSolutionMeshView;
+        m_linSolutionMeshView = NULL;
+    }
+
+    if (Agros2D::problem()->isMeshed())
+        processInitialMesh();
 }
 
-void PostHermes::processSolved()
+bool PostHermes::createRequest(PostProcessingRequest &request, bool coarsePass)
 {
+    if (!Agros2D::problem()->isSolved() || !m_activeViewField)
+        return false;
+
     // update time functions
     if (Agros2D::problem()->isTransient())
         Module::updateTimeFunctions(Agros2D::problem()->timeStepToTotalTime(activeTimeStep()));
 
     FieldSolutionID fsid(activeViewField(), activeTimeStep(), activeAdaptivityStep(), activeAdaptivitySolutionType());
-    if (Agros2D::solutionStore()->contains(fsid))
+    if (!Agros2D::solutionStore()->contains(fsid))
+        return false;
+
+    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+    if (ma.spaces().empty())
+        return false;
+    if (ma.solutions().empty())
+        return false;
+
+    // add icon to progress
+    Agros2D::log()->addIcon(icon("scene-post2d"),
+                            tr("Postprocessor"));
+
+    processSolutionMesh();
+
+    ProblemSetting *setting = Agros2D::problem()->setting();
+
+    request.generation = m_generation;
+    request.coarsePass = coarsePass;
+    request.fieldInfo = m_activeViewField;
+    request.fsid = fsid;
+    request.spaces = ma.spaces();
+    foreach (Hermes::Hermes2D::MeshFunctionSharedPtr<double> solution, ma.solutions())
+        request.solutions.push_back(Hermes::Hermes2D::MeshFunctionSharedPtr<double>(solution->clone()));
+    request.boundingBox = Agros2D::scene()->boundingBox();
+
+    Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > slns;
+    for (int k = 0; k < m_activeViewField->numberOfSolutions(); k++)
+        slns.push_back(request.solutions.at(k));
+
+    // order view
+    request.showOrder = setting->value(ProblemSetting::View_ShowOrderView).toBool();
+    request.orderComponent = setting->value(ProblemSetting::View_OrderComponent).toInt() - 1;
+    if (request.showOrder)
+        Agros2D::log()->printMessage(tr("Mesh View"), tr("Polynomial order"));
+
+    // contour view
+    request.showContour = setting->value(ProblemSetting::View_ShowContourView).toBool();
+    if (request.showContour)
     {
-        MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
-        if (ma.spaces().empty())
-            return;
-        if (ma.solutions().empty())
-            return;
+        request.contourVariable = setting->value(ProblemSetting::View_ContourVariable).toString();
+        request.contourComp = m_activeViewField->localVariable(request.contourVariable).isScalar() ? PhysicFieldVariableComp_Scalar : PhysicFieldVariableComp_Magnitude;
+        request.deformContour = m_activeViewField->hasDeformableShape() && setting->value(ProblemSetting::View_DeformContour).toBool();
+        createFilter(request, slns, request.contourVariable, request.contourComp);
 
-        // add icon to progress
-        Agros2D::log()->addIcon(icon("scene-post2d"),
-                                tr("Postprocessor"));
+        Agros2D::log()->printMessage(tr("Post View"), tr("Contour view (%1)").arg(request.contourVariable));
+    }
 
-        processSolutionMesh();
-        processOrder();
+    // scalar view
+    request.showScalar = setting->value(ProblemSetting::View_ShowScalarView).toBool()
+            || (((SceneViewPost3DMode) setting->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D);
+    if (request.showScalar)
+    {
+        request.scalarVariable = setting->value(ProblemSetting::View_ScalarVariable).toString();
+        request.scalarComp = (PhysicFieldVariableComp) setting->value(ProblemSetting::View_ScalarVariableComp).toInt();
+        request.deformScalar = m_activeViewField->hasDeformableShape() && setting->value(ProblemSetting::View_DeformScalar).toBool();
+        createFilter(request, slns, request.scalarVariable, request.scalarComp);
 
-        processRangeContour();
-        processRangeScalar();
-        processRangeVector();
+        Agros2D::log()->printMessage(tr("Post View"), tr("Scalar view (%1)").arg(request.scalarVariable));
     }
+
+    // vector view
+    request.showVector = setting->value(ProblemSetting::View_ShowVectorView).toBool();
+    if (request.showVector)
+    {
+        request.vectorVariable = setting->value(ProblemSetting::View_VectorVariable).toString();
+        request.deformVector = m_activeViewField->hasDeformableShape() && setting->value(ProblemSetting::View_DeformVector).toBool();
+        createFilter(request, slns, request.vectorVariable, PhysicFieldVariableComp_X);
+        createFilter(request, slns, request.vectorVariable, PhysicFieldVariableComp_Y);
+
+        Agros2D::log()->printMessage(tr("Post View"), tr("Vector view (%1)").arg(request.vectorVariable));
+    }
+
+    return true;
+}
+
+void PostHermes::createFilter(PostProcessingRequest &request, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > slns,
+                              const QString &variable, PhysicFieldVariableComp comp)
+{
+    QString key = filterKey(variable, comp);
+    if (request.filters.contains(key))
+        return;
+
+    request.filters[key] = m_activeViewField->plugin()->filter(m_activeViewField,
+                                                               request.fsid.timeStep,
+                                                               request.fsid.adaptivityStep,
+                                                               request.fsid.solutionMode,
+                                                               slns,
+                                                               variable,
+                                                               comp);
 }
 
 Hermes::Hermes2D::MeshFunctionSharedPtr<double> PostHermes::viewScalarFilter(Module::LocalVariable physicFieldVariable,
@@ -626,7 +1021,8 @@ MultiArray<double> PostHermes::activeMultiSolutionArray()
 SceneViewPostInterface::SceneViewPostInterface(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon(parent),
       m_postHermes(postHermes),
-      m_textureScalar(0)
+      m_textureScalar(0),
+      m_paletteValid(false)
 {
 }
 
@@ -639,8 +1035,8 @@ void SceneViewPostInterface::initializeGL()
 
 const QVector3D SceneViewPostInterface::paletteColor2(const int pos) const
 {
-    int n = (int) (pos / (PALETTEENTRIES / Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteSteps).toInt()))
-            * (PALETTEENTRIES / Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteSteps).toInt());
+    int n = (int) (pos / (PALETTEENTRIES / Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_PaletteSteps)))
+            * (PALETTEENTRIES / Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_PaletteSteps));
 
     if (n < 0)
         n = 0;
@@ -648,7 +1044,7 @@ const QVector3D SceneViewPostInterface::paletteColor2(const int pos) const
         n = PALETTEENTRIES - 1;
 
     const double *colors = NULL;
-    switch ((PaletteType) Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteType).toInt())
+    switch ((PaletteType) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_PaletteType))
     {
     case Palette_Agros:
         colors = paletteDataAgros2D[n];
@@ -660,7 +1056,7 @@ const QVector3D SceneViewPostInterface::paletteColor2(const int pos) const
 
 const double* SceneViewPostInterface::paletteColor(double x) const
 {
-    switch ((PaletteType) Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteType).toInt())
+    switch ((PaletteType) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_PaletteType))
     {
     case Palette_Paruly:
     {
@@ -713,14 +1109,14 @@ const double* SceneViewPostInterface::paletteColor(double x) const
     }
         break;
     default:
-        qWarning() << QString("Undefined: %1.").arg(((PaletteType) Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteType).toInt()));
+        qWarning() << QString("Undefined: %1.").arg(((PaletteType) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_PaletteType)));
         return NULL;
     }
 }
 
 const double* SceneViewPostInterface::paletteColorOrder(int n) const
 {
-    switch ((PaletteOrderType) Agros2D::problem()->setting()->value(ProblemSetting::View_OrderPaletteOrderType).toInt())
+    switch ((PaletteOrderType) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_OrderPaletteOrderType))
     {
     case PaletteOrder_Hermes:
         return paletteOrderHermes[n];
@@ -735,26 +1131,34 @@ const double* SceneViewPostInterface::paletteColorOrder(int n) const
     case PaletteOrder_BWDesc:
         return paletteOrderBWDesc[n];
     default:
-        qWarning() << QString("Undefined: %1.").arg(Agros2D::problem()->setting()->value(ProblemSetting::View_OrderPaletteOrderType).toInt());
+        qWarning() << QString("Undefined: %1.").arg(Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_OrderPaletteOrderType));
         return NULL;
     }
 }
 
 void SceneViewPostInterface::paletteCreate()
 {
-    int paletteSteps = Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteFilter).toBool()
-            ? 100 : Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteSteps).toInt();
-
-    unsigned char palette[256][3];
-    for (int i = 0; i < paletteSteps; i++)
+    bool paletteFilter = Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteFilter).toBool();
+    int paletteSteps = Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteSteps).toInt();
+    bool rangeLog = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool();
+    double rangeBase = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt();
+
+    // texture covers the whole range, log scale and steps are part of the texture (not of the geometry)
+    unsigned char palette[256][4];
+    for (int i = 0; i < 256; i++)
     {
-        const double* color = paletteColor((double) i / paletteSteps);
+        double x = paletteFilter ? i / 255.0 : (i + 0.5) / 256.0;
+        if (rangeLog)
+            x = log10(1.0 + (rangeBase - 1.0) * x) / log10(rangeBase);
+        if (!paletteFilter)
+            x = qMin(floor(x * paletteSteps), paletteSteps - 1.0) / paletteSteps;
+
+        const double* color = paletteColor(x);
         palette[i][0] = (unsigned char) (color[0] * 255);
         palette[i][1] = (unsigned char) (color[1] * 255);
         palette[i][2] = (unsigned char) (color[2] * 255);
+        palette[i][3] = 255;
     }
-    for (int i = paletteSteps; i < 256; i++)
-        memcpy(palette[i], palette[paletteSteps-1], 3);
 
     makeCurrent();
     if (glIsTexture(m_textureScalar))
@@ -769,7 +1173,7 @@ void SceneViewPostInterface::paletteCreate()
 #else
     glTexParameteri(GL_TEXTURE_1D, GL_GENERATE_MIPMAP, GL_TRUE);
 #endif
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteFilter).toBool())
+    if (paletteFilter)
     {
 #ifdef Q_WS_WIN
         glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -787,20 +1191,54 @@ void SceneViewPostInterface::paletteCreate()
 #endif
         glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     }
-    glTexImage1D(GL_TEXTURE_1D, 0, 3, 256, 0, GL_RGB, GL_UNSIGNED_BYTE, palette);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, palette);
+#if defined(GL_CLAMP_TO_BORDER)
+    // values out of the user range are transparent (removed by the alpha test)
+    if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+    {
+        float border[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        glTexParameterfv(GL_TEXTURE_1D, GL_TEXTURE_BORDER_COLOR, border);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    }
+    else
+#endif
+    {
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    }
 
     // adjust palette
-    if (Agros2D::problem()->setting()->value(ProblemSetting::View_PaletteFilter).toBool())
+    if (paletteFilter)
     {
-        m_texScale = (double) (paletteSteps-1) / 256.0;
+        m_texScale = 255.0 / 256.0;
         m_texShift = 0.5 / 256.0;
     }
     else
     {
-        m_texScale = (double) paletteSteps / 256.0;
+        m_texScale = 1.0;
         m_texShift = 0.0;
     }
+
+    m_paletteValid = true;
+}
+
+void SceneViewPostInterface::loadScalarFieldTextureMatrix()
+{
+    double rangeMin = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble();
+    double rangeMax = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble();
+
+    // range
+    double irange = 1.0 / (rangeMax - rangeMin);
+    // special case: constant solution
+    if (fabs(rangeMax - rangeMin) < EPS_ZERO)
+        irange = 1.0;
+
+    // texture coordinate is the value relative to the offset of the array
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslated(m_texShift, 0.0, 0.0);
+    glScaled(m_texScale * irange, 0.0, 0.0);
+    glTranslated(m_scalarFieldArray.offset() - rangeMin, 0.0, 0.0);
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void SceneViewPostInterface::paintScalarFieldColorBar(double min, double max)
@@ -884,12 +1322,8 @@ void SceneViewPostInterface::paintScalarFieldColorBar(double min, double max)
     // labels
     for (int i = 1; i < numTicks+1; i++)
     {
-        double value = 0.0;
-        if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool())
-            value = min + (double) (i-1) / (numTicks-1) * (max - min);
-        else
-            value = min + (double) pow((double) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt(),
-                                       ((i-1) / (numTicks-1)))/Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt() * (max - min);
+        // log scale is part of the palette texture, ticks are linear
+        double value = min + (double) (i-1) / (numTicks-1) * (max - min);
 
         if (fabs(value) < EPS_ZERO) value = 0.0;
         double tickY = (scaleSize.y - 60.0) / (numTicks - 1.0);
@@ -29,6 +29,67 @@ template <typename Scalar> class MultiArray;
 class ParticleTracing;
 class FieldInfo;
 
+class PostProcessingThread;
+struct PostProcessingRequest;
+
+// linearized data of one view (only one of the pointers is set)
+struct PostViewData
+{
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer;
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> vectorizer;
+    QSharedPointer<Hermes::Hermes2D::Views::Orderizer> orderizer;
+};
+
+// cache of linearized views, key is made of the solution, variable, component and quality
+// shared by the gui and the post-processing thread, the least recently used item is removed first
+class PostViewCache
+{
+public:
+    PostViewCache(int size = 16) : m_size(size) {}
+
+    bool contains(const QString &key);
+    PostViewData value(const QString &key);
+    void insert(const QString &key, const PostViewData &data);
+    void clear();
+
+private:
+    QMutex m_mutex;
+    int m_size;
+
+    QMap<QString, PostViewData> m_data;
+    QStringList m_keys;
+};
+
+// linearized scalar view stored once in a vertex buffer (client side arrays if buffer objects are not supported)
+// range, log scale and palette are applied by the texture, so the geometry is not rebuilt when they are changed
+class PostScalarFieldArray
+{
+public:
+    PostScalarFieldArray();
+
+    void clear();
+    void create(QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer, bool normals);
+    inline bool isCreated(QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linearizer) const { return !m_linearizer.isNull() && m_linearizer == linearizer; }
+
+    // values are stored relative to the offset (minimum of the linearizer)
+    inline double offset() const { return m_offset; }
+
+    // value is passed as the texture coordinate (and as the z coordinate for the elevated surface)
+    void paint(bool elevation);
+
+private:
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linearizer;
+    double m_offset;
+    int m_count;
+
+    // x, y, value
+    QVector<GLfloat> m_vertices;
+    QVector<GLfloat> m_normals;
+
+    QGLBuffer m_vertexBuffer;
+    QGLBuffer m_normalBuffer;
+};
+
 class PostHermes : public QObject
 {
     Q_OBJECT
@@ -42,16 +103,17 @@ public:
     inline Hermes::Hermes2D::Views::Linearizer *linSolutionMeshView() { return m_linSolutionMeshView; }
 
     // order view
-    Hermes::Hermes2D::Views::Orderizer *ordView() { return m_orderView; }
+    Hermes::Hermes2D::Views::Orderizer *ordView() { return m_orderView.data(); }
 
     // contour
-    inline Hermes::Hermes2D::Views::Linearizer *linContourView() { return m_linContourView; }
+    inline Hermes::Hermes2D::Views::Linearizer *linContourView() { return m_linContourView.data(); }
 
     // scalar view
-    inline Hermes::Hermes2D::Views::Linearizer *linScalarView() { return m_linScalarView; }
+    inline Hermes::Hermes2D::Views::Linearizer *linScalarView() { return m_linScalarView.data(); }
+    inline QSharedPointer<Hermes::Hermes2D::Views::Linearizer> linScalarViewShared() { return m_linScalarView; }
 
     // vector view
-    inline Hermes::Hermes2D::Views::Vectorizer *vecVectorView() { return m_vecVectorView; }
+    inline Hermes::Hermes2D::Views::Vectorizer *vecVectorView() { return m_vecVectorView.data(); }
 
     Hermes::Hermes2D::MeshFunctionSharedPtr<double> viewScalarFilter(Module::LocalVariable physicFieldVariable,
                                                                      PhysicFieldVariableComp physicFieldVariableComp);
@@ -73,17 +135,36 @@ public:
 
     inline bool isProcessed() const { return m_isProcessed; }
 
+    // true if the request was superseded by a newer one
+    bool isCanceled(int generation);
+    inline PostViewCache *viewCache() { return &m_viewCache; }
+
 signals:
     void processed();
 
 public slots:
+    // views are processed when the function returns (scripts, dialogs)
     void refresh();
+    // views are processed in a worker thread, coarse views are shown first
+    // a running request is canceled by the next one
+    void refreshAsync();
+    // returns when the running and pending requests are processed (scripts)
+    void waitForProcessing();
     void clear();
     void clearView();
 
 private:
     bool m_isProcessed;
 
+    // post-processing thread, newer request is started when the running one finishes
+    PostProcessingThread *m_thread;
+    bool m_pendingRefresh;
+
+    QMutex m_generationMutex;
+    int m_generation;
+
+    PostViewCache m_viewCache;
+
     // initial mesh
     Hermes::Hermes2D::Views::Linearizer *m_linInitialMeshView;
 
@@ -91,16 +172,16 @@ private:
     Hermes::Hermes2D::Views::Linearizer *m_linSolutionMeshView;
 
     // order view
-    Hermes::Hermes2D::Views::Orderizer *m_orderView;
+    QSharedPointer<Hermes::Hermes2D::Views::Orderizer> m_orderView;
 
     // contour
-    Hermes::Hermes2D::Views::Linearizer *m_linContourView;
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linContourView;
 
     // scalar view
-    Hermes::Hermes2D::Views::Linearizer *m_linScalarView; // linealizer for scalar view
+    QSharedPointer<Hermes::Hermes2D::Views::Linearizer> m_linScalarView; // linealizer for scalar view
 
     // vector view
-    Hermes::Hermes2D::Views::Vectorizer *m_vecVectorView; // vectorizer for vector view
+    QSharedPointer<Hermes::Hermes2D::Views::Vectorizer> m_vecVectorView; // vectorizer for vector view
 
     // view
     FieldInfo *m_activeViewField;
@@ -108,17 +189,24 @@ private:
     int m_activeAdaptivityStep;
     SolutionMode m_activeSolutionMode;
 
+    int nextGeneration();
+    void cancelProcessing();
+    // snapshot of the active solution and view settings, false if there is nothing to process
+    bool createRequest(PostProcessingRequest &request, bool coarsePass);
+    void createFilter(PostProcessingRequest &request, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > slns,
+                      const QString &variable, PhysicFieldVariableComp comp);
+    // views of the request are taken from the cache
+    void setViews(const PostProcessingRequest &request, int quality);
+    void startThread();
+
 private slots:
     void processMeshed();
-    void processSolved();
 
     void processInitialMesh();
     void processSolutionMesh();
-    void processOrder();
 
-    void processRangeContour();
-    void processRangeScalar();
-    void processRangeVector();
+    void processPass(int generation, int quality);
+    void processFinished();
 
     virtual void clearGLLists() {}
 
@@ -140,6 +228,10 @@ protected:
     double m_texShift;
 
     GLuint m_textureScalar;
+    bool m_paletteValid;
+
+    // scalar field, geometry is created only for a new linearizer
+    PostScalarFieldArray m_scalarFieldArray;
 
     PostHermes *m_postHermes;
 
@@ -152,6 +244,8 @@ protected:
     const double *paletteColor(double x) const;
     const double *paletteColorOrder(int n) const;
     void paletteCreate();
+    // maps values of the scalar field array to the palette texture
+    void loadScalarFieldTextureMatrix();
 
 protected slots:
     virtual void clearGLLists() {}
@@ -44,6 +44,7 @@
 #include "hermes2d/problem_config.h"
 #include "hermes2d/plugin_interface.h"
 #include "hermes2d/solutionstore.h"
+#include "particle/mesh_hash.h"
 
 #include "pythonlab/pythonengine_agros.h"
 
@@ -51,7 +52,6 @@ SceneViewPost2D::SceneViewPost2D(PostHermes *postHermes, QWidget *parent)
     : SceneViewCommon2D(postHermes, parent),
       m_listContours(-1),
       m_listVectors(-1),
-      m_listScalarField(-1),
       m_selectedPoint(Point())
 {
     createActionsPost2D();
@@ -171,7 +171,7 @@ void SceneViewPost2D::mousePressEvent(QMouseEvent *event)
         // select volume integral area
         if (actPostprocessorModeVolumeIntegral->isChecked())
         {
-            Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, postHermes()->activeViewField()->initialMesh(), p.x, p.y);
+            Hermes::Hermes2D::Element *e = Agros2D::solutionStore()->meshHash(postHermes()->activeViewField()->initialMesh())->getElement(p.x, p.y);
             if (e)
             {
                 SceneLabel *label = Agros2D::scene()->labels->at(atoi(postHermes()->activeViewField()->initialMesh()->get_element_markers_conversion().
@@ -307,148 +307,42 @@ void SceneViewPost2D::paintGeometry()
 void SceneViewPost2D::paintScalarField()
 {
     if (!Agros2D::problem()->isSolved()) return;
+    if (!m_postHermes->linScalarView()) return;
 
     loadProjection2d(true);
 
-    if (m_listScalarField == -1)
-    {
-        if (!m_postHermes->linScalarView()) return;
+    // geometry is uploaded only for a new linearizer, range and palette changes update the texture
+    if (!m_scalarFieldArray.isCreated(m_postHermes->linScalarViewShared()))
+        m_scalarFieldArray.create(m_postHermes->linScalarViewShared(), false);
 
+    if (!m_paletteValid)
         paletteCreate();
 
-        m_listScalarField = glGenLists(1);
-        glNewList(m_listScalarField, GL_COMPILE);
-
-        // range
-        double irange = 1.0 / (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble());
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) < EPS_ZERO)
-            irange = 1.0;
-
-        // set texture for coloring
-        glEnable(GL_TEXTURE_1D);
-        glBindTexture(GL_TEXTURE_1D, m_textureScalar);
-        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
-
-        // set texture transformation matrix
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glTranslated(m_texShift, 0.0, 0.0);
-        glScaled(m_texScale, 0.0, 0.0);
-
-        glBegin(GL_TRIANGLES);
-        for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
-             it = m_postHermes->linScalarView()->triangles_begin(); !it.end; ++it)
-        {
-            Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
-
-            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
-            {
-                double avgValue = (triangle[0][2] + triangle[1][2] + triangle[2][2]) / 3.0;
-                if (avgValue < Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() || avgValue > Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble())
-                    continue;
-            }
-
-            for (int j = 0; j < 3; j++)
-            {
-                if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeLog).toBool())
-                    glTexCoord1d(log10((double) (1 + (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt() - 1))
-                                       * (triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange) / log10((double) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeBase).toInt()));
-                else
-                    glTexCoord1d((triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange);
-
-                glVertex2d(triangle[j][0], triangle[j][1]);
-            }
-        }
-        glEnd();
-
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glDisable(GL_TEXTURE_1D);
-
-        // switch-off texture transform
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
-
-        glEndList();
-
-        glCallList(m_listScalarField);
-
-        /*
-        // range
-        double irange = PALETTEENTRIES / (Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin);
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->configView()->scalarRangeMax - Agros2D::problem()->configView()->scalarRangeMin) < EPS_ZERO)
-            irange = PALETTEENTRIES / 2;
-
-        double3* linVert = m_postHermes->linScalarView()->get_vertices();
-        int3* linTris = m_postHermes->linScalarView()->get_triangles();
-        Point point[3];
-        double value[3];
-
-        for (int i = 0; i < m_postHermes->linScalarView()->get_num_triangles(); i++)
-        {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
-            }
-
-            if (!Agros2D::problem()->configView()->scalarRangeAuto)
-            {
-                double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < Agros2D::problem()->configView()->scalarRangeMin || avgValue > Agros2D::problem()->configView()->scalarRangeMax)
-                    continue;
-            }
-
-            for (int j = 0; j < 3; j++)
-            {
-                m_arrayScalarField.push_back(QVector2D(point[j].x, point[j].y));
+    // set texture for coloring
+    glEnable(GL_TEXTURE_1D);
+    glBindTexture(GL_TEXTURE_1D, m_textureScalar);
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
 
-                const double* color = paletteColor2((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange);
+    // set texture transformation matrix
+    loadScalarFieldTextureMatrix();
 
-                m_arrayScalarFieldColors.push_back(QVector3D(color[0], color[1], color[2]));
-                // qDebug() << ((value[j] - Agros2D::problem()->configView()->scalarRangeMin) * irange) << m_arrayScalarFieldColors.at(m_arrayScalarFieldColors.count() - 1);
-
-            }
-        }
-        */
-    }
-    else
+    // values out of the user range
+    if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
     {
-        glCallList(m_listScalarField);
-
-        /*
-        glLineWidth(1.0);
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-        glBegin(GL_TRIANGLES);
-        for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
-             it = m_postHermes->linScalarView()->triangles_begin(); !it.end; ++it)
-        {
-            Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
-
-            for (int j = 0; j < 3; j++)
-                glVertex2d(triangle[j][0], triangle[j][1]);
-        }
-        glEnd();
-        */
-
-        /*
-        glEnableClientState(GL_COLOR_ARRAY);
-        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnable(GL_ALPHA_TEST);
+        glAlphaFunc(GL_GREATER, 0.5);
+    }
 
-        glColorPointer(3, GL_FLOAT, 0, m_arrayScalarFieldColors.constData());
-        glVertexPointer(2, GL_FLOAT, 0, m_arrayScalarField.constData());
+    m_scalarFieldArray.paint(false);
 
-        glDrawArrays(GL_TRIANGLES, 0, m_arrayScalarField.size());
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_TEXTURE_1D);
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
-        */
-    }
+    // switch-off texture transform
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void SceneViewPost2D::paintContours()
@@ -993,7 +887,7 @@ void SceneViewPost2D::paintVectors()
                         double value = sqrt(dx*dx + dy*dy);
                         double angle = atan2(dy, dx);
 
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorProportional).toBool()) && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
+                        if ((Agros2D::problem()->setting()->snapshot().toBool(ProblemSetting::View_VectorProportional)) && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
                         {
                             if ((value / vectorRangeMax) < 1e-6)
                             {
@@ -1002,20 +896,20 @@ void SceneViewPost2D::paintVectors()
                             }
                             else
                             {
-                                dx = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                                dy = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
+                                dx = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->snapshot().toDouble(ProblemSetting::View_VectorScale) * gs * cos(angle);
+                                dy = ((value - vectorRangeMin) * irange) * Agros2D::problem()->setting()->snapshot().toDouble(ProblemSetting::View_VectorScale) * gs * sin(angle);
                             }
                         }
                         else
                         {
-                            dx = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * cos(angle);
-                            dy = Agros2D::problem()->setting()->value(ProblemSetting::View_VectorScale).toDouble() * gs * sin(angle);
+                            dx = Agros2D::problem()->setting()->snapshot().toDouble(ProblemSetting::View_VectorScale) * gs * cos(angle);
+                            dy = Agros2D::problem()->setting()->snapshot().toDouble(ProblemSetting::View_VectorScale) * gs * sin(angle);
                         }
 
                         double dm = sqrt(dx*dx + dy*dy);
 
                         // color
-                        if ((Agros2D::problem()->setting()->value(ProblemSetting::View_VectorColor).toBool())
+                        if ((Agros2D::problem()->setting()->snapshot().toBool(ProblemSetting::View_VectorColor))
                                 && (fabs(vectorRangeMin - vectorRangeMax) > EPS_ZERO))
                         {
                             double color = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
@@ -1028,12 +922,12 @@ void SceneViewPost2D::paintVectors()
 
                         // tail
                         Point shiftCenter(0.0, 0.0);
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Head)
+                        if ((VectorCenter) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_VectorCenter) == VectorCenter_Head)
                             shiftCenter = Point(- 2.0*dm * cos(angle), - 2.0*dm * sin(angle)); // head
-                        if ((VectorCenter) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorCenter).toInt() == VectorCenter_Center)
+                        if ((VectorCenter) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_VectorCenter) == VectorCenter_Center)
                             shiftCenter = Point(- dm * cos(angle), - dm * sin(angle)); // center
 
-                        if ((VectorType) Agros2D::problem()->setting()->value(ProblemSetting::View_VectorType).toInt() == VectorType_Arrow)
+                        if ((VectorType) Agros2D::problem()->setting()->snapshot().toInt(ProblemSetting::View_VectorType) == VectorType_Arrow)
                         {
                             // arrow and shaft
                             // head for an arrow
@@ -1183,11 +1077,12 @@ void SceneViewPost2D::clearGLLists()
 {
     if (m_listContours != -1) glDeleteLists(m_listContours, 1);
     if (m_listVectors != -1) glDeleteLists(m_listVectors, 1);
-    if (m_listScalarField != -1) glDeleteLists(m_listScalarField, 1);
 
     m_listContours = -1;
     m_listVectors = -1;
-    m_listScalarField = -1;
+
+    // geometry of the scalar field is kept
+    m_paletteValid = false;
 }
 
 void SceneViewPost2D::refresh()
@@ -1217,6 +1112,9 @@ void SceneViewPost2D::clear()
 
     setControls();
 
+    makeCurrent();
+    m_scalarFieldArray.clear();
+
     SceneViewCommon2D::clear();
     if (Agros2D::problem()->isSolved())
         SceneViewCommon::refresh();
@@ -86,10 +86,6 @@ private:
     // gl lists
     int m_listContours;
     int m_listVectors;
-    int m_listScalarField;
-
-    // QVector<QVector2D> m_arrayScalarField;
-    // QVector<QVector3D> m_arrayScalarFieldColors;
 
     void createActionsPost2D();
 
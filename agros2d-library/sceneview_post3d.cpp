@@ -162,101 +162,88 @@ void SceneViewPost3D::resizeGL(int w, int h)
 void SceneViewPost3D::paintScalarField3D()
 {
     if (!Agros2D::problem()->isSolved()) return;
+    if (!m_postHermes->linScalarView()) return;
 
     loadProjection3d(true, ((SceneViewPost3DMode) Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DMode).toInt()) == SceneViewPost3DMode_ScalarView3D);
 
-    if (m_listScalarField3D == -1)
-    {
-        if (!m_postHermes->linScalarView()) return;
+    // geometry is uploaded only for a new linearizer, range and palette changes update the texture and matrices
+    if (!m_scalarFieldArray.isCreated(m_postHermes->linScalarViewShared()))
+        m_scalarFieldArray.create(m_postHermes->linScalarViewShared(), true);
 
+    if (!m_paletteValid)
         paletteCreate();
 
-        m_listScalarField3D = glGenLists(1);
-        glNewList(m_listScalarField3D, GL_COMPILE);
+    glPushMatrix();
 
-        glPushMatrix();
-
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
 
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
 
-        glPopMatrix();
+    glPopMatrix();
 
-        glEnable(GL_DEPTH_TEST);
+    glEnable(GL_DEPTH_TEST);
 
-        // range
-        double irange = 1.0 / (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble());
-        // special case: constant solution
-        if (fabs(Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble()) < EPS_ZERO)
-        {
-            irange = 1.0;
-        }
+    double rangeMin = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble();
+    double rangeMax = Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble();
 
-        RectPoint rect = Agros2D::scene()->boundingBox();
+    // range
+    double irange = 1.0 / (rangeMax - rangeMin);
+    // special case: constant solution
+    if (fabs(rangeMin - rangeMax) < EPS_ZERO)
+    {
+        irange = 1.0;
+    }
 
-        double max = qMax(rect.width(), rect.height());
+    RectPoint rect = Agros2D::scene()->boundingBox();
 
-        glPushMatrix();
-        glScaled(1.0, 1.0, max / Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DHeight).toDouble() * fabs(irange));
+    double max = qMax(rect.width(), rect.height());
 
-        // scalar view
-        initLighting();
-        // init normal
-        double *normal = new double[3];
+    glPushMatrix();
+    glScaled(1.0, 1.0, max / Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DHeight).toDouble() * fabs(irange));
 
-        // set texture for coloring
-        if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
-            glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-        else
-            glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
-        glEnable(GL_TEXTURE_1D);
-        glBindTexture(GL_TEXTURE_1D, m_textureScalar);
+    // scalar view
+    initLighting();
 
-        // set texture transformation matrix
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glTranslated(m_texShift, 0.0, 0.0);
-        glScaled(m_texScale, 0.0, 0.0);
+    // set texture for coloring
+    if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    else
+        glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glEnable(GL_TEXTURE_1D);
+    glBindTexture(GL_TEXTURE_1D, m_textureScalar);
 
-        glBegin(GL_TRIANGLES);
-        for (Hermes::Hermes2D::Views::Linearizer::Iterator<Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t>
-             it = m_postHermes->linScalarView()->triangles_begin(); !it.end; ++it)
-        {
-            Hermes::Hermes2D::Views::ScalarLinearizerDataDimensions<LINEARIZER_DATA_TYPE>::triangle_t& triangle = it.get();
+    // set texture transformation matrix
+    loadScalarFieldTextureMatrix();
 
-            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
-            {
-                double avgValue = (triangle[0][2] + triangle[1][2] + triangle[2][2]) / 3.0;
-                if (avgValue < Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble() || avgValue > Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble())
-                    continue;
-            }
+    // values out of the user range
+    if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+    {
+        glEnable(GL_ALPHA_TEST);
+        glAlphaFunc(GL_GREATER, 0.5);
+    }
 
-            double delta = 0.0;
+    // z = - (value - min), values of the array are relative to the offset
+    glPushMatrix();
+    glScaled(1.0, 1.0, -1.0);
+    glTranslated(0.0, 0.0, m_scalarFieldArray.offset() - rangeMin);
+    glEnable(GL_NORMALIZE);
 
-            if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DLighting).toBool())
-            {
-                computeNormal(triangle[0][0], triangle[0][1], - delta - (triangle[0][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
-                        triangle[1][0], triangle[1][1], - delta - (triangle[1][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
-                        triangle[2][0], triangle[2][1], - delta - (triangle[2][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()),
-                        normal);
+    m_scalarFieldArray.paint(true);
 
-                glNormal3d(normal[0], normal[1], normal[2]);
-            }
-            for (int j = 0; j < 3; j++)
-            {
-                glTexCoord1d((triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * irange);
-                glVertex3d(triangle[j][0], triangle[j][1], - delta - (triangle[j][2] - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()));
-            }
-        }
-        glEnd();
+    glDisable(GL_NORMALIZE);
+    glPopMatrix();
 
-        // remove normal
-        delete [] normal;
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_TEXTURE_1D);
+    glDisable(GL_LIGHTING);
 
-        glDisable(GL_TEXTURE_1D);
-        glDisable(GL_LIGHTING);
+    // mesh, bounding box and geometry
+    if (m_listScalarField3D == -1)
+    {
+        m_listScalarField3D = glGenLists(1);
+        glNewList(m_listScalarField3D, GL_COMPILE);
 
         // draw blended mesh
         glEnable(GL_BLEND);
@@ -285,7 +272,7 @@ void SceneViewPost3D::paintScalarField3D()
         if (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarView3DBoundingBox).toBool())
         {
             double borderXY = max * 0.05;
-            double borderZ = (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) * 0.05;
+            double borderZ = (rangeMax - rangeMin) * 0.05;
 
             glBegin(GL_LINES);
             glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, borderZ);
@@ -297,23 +284,23 @@ void SceneViewPost3D::paintScalarField3D()
             glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, borderZ);
             glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, borderZ);
 
-            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
-            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
 
             glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, borderZ);
-            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
             glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.start.y - borderXY, - (rangeMax - rangeMin) - borderZ);
             glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, borderZ);
-            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
+            glVertex3d(rect.end.x + borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
             glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, borderZ);
-            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMax).toDouble() - Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeMin).toDouble()) - borderZ);
+            glVertex3d(rect.start.x - borderXY, rect.end.y + borderXY, - (rangeMax - rangeMin) - borderZ);
             glEnd();
         }
 
@@ -343,23 +330,19 @@ void SceneViewPost3D::paintScalarField3D()
             glLineWidth(1.0);
         }
 
-        glDisable(GL_DEPTH_TEST);
+        glEndList();
+    }
 
-        // switch-off texture transform
-        glMatrixMode(GL_TEXTURE);
-        glLoadIdentity();
-        glMatrixMode(GL_MODELVIEW);
+    glCallList(m_listScalarField3D);
 
-        glPopMatrix();
+    glDisable(GL_DEPTH_TEST);
 
-        glEndList();
+    // switch-off texture transform
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
 
-        glCallList(m_listScalarField3D);
-    }
-    else
-    {
-        glCallList(m_listScalarField3D);
-    }
+    glPopMatrix();
 }
 
 void SceneViewPost3D::paintScalarField3DSolid()
@@ -435,6 +418,13 @@ void SceneViewPost3D::paintScalarField3DSolid()
             glLoadIdentity();
             glTranslated(m_texShift, 0.0, 0.0);
             glScaled(m_texScale, 0.0, 0.0);
+
+            // values out of the user range
+            if (!Agros2D::problem()->setting()->value(ProblemSetting::View_ScalarRangeAuto).toBool())
+            {
+                glEnable(GL_ALPHA_TEST);
+                glAlphaFunc(GL_GREATER, 0.5);
+            }
         }
         else
         {
@@ -658,6 +648,7 @@ void SceneViewPost3D::paintScalarField3DSolid()
 
         if (!isModel)
         {
+            glDisable(GL_ALPHA_TEST);
             glDisable(GL_TEXTURE_1D);
 
             // switch-off texture transform
@@ -822,6 +813,9 @@ void SceneViewPost3D::clearGLLists()
     m_listScalarField3D = -1;
     m_listScalarField3DSolid = -1;
     m_listModel = -1;
+
+    // geometry of the scalar field is kept
+    m_paletteValid = false;
 }
 
 void SceneViewPost3D::refresh()
@@ -845,6 +839,9 @@ void SceneViewPost3D::setControls()
 
 void SceneViewPost3D::clear()
 {
+    makeCurrent();
+    m_scalarFieldArray.clear();
+
     SceneViewCommon3D::clear();
     if (Agros2D::problem()->isSolved())
         doZoomBestFit();
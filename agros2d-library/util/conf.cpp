@@ -78,6 +78,8 @@ void Config::load()
     // number of threads
     if (m_setting[Config_NumberOfThreads].toInt() > omp_get_max_threads())
         m_setting[Config_NumberOfThreads] = omp_get_max_threads();
+    if (m_setting[Config_NumberOfConcurrentBlocks].toInt() < 1)
+        m_setting[Config_NumberOfConcurrentBlocks] = 1;
     Hermes::HermesCommonApi.set_integral_param_value(Hermes::numThreads, m_setting[Config_NumberOfThreads].toInt());
 }
 
@@ -100,8 +102,10 @@ void Config::setStringKeys()
     m_settingKey[Config_ShowResults] = "Config_ShowResults";
     m_settingKey[Config_LinearSystemFormat] = "Config_LinearSystemFormat";
     m_settingKey[Config_LinearSystemSave] = "Config_LinearSystemSave";
-    m_settingKey[Config_CacheSize] = "Config_CacheSize";
+    m_settingKey[Config_CacheMemorySize] = "Config_CacheMemorySize";
     m_settingKey[Config_NumberOfThreads] = "Config_NumberOfThreads";
+    m_settingKey[Config_NumberOfConcurrentBlocks] = "Config_NumberOfConcurrentBlocks";
+    m_settingKey[Config_ExternalSolverDaemon] = "Config_ExternalSolverDaemon";
     m_settingKey[Config_ShowGrid] = "Config_ShowGrid";
     m_settingKey[Config_ShowRulers] = "Config_ShowRulers";
     m_settingKey[Config_ShowAxes] = "Config_ShowAxes";
@@ -121,8 +125,12 @@ void Config::setDefaultValues()
     m_settingDefault[Config_ShowResults] = false;
     m_settingDefault[Config_LinearSystemFormat] = EXPORT_FORMAT_MATLAB_MATIO;
     m_settingDefault[Config_LinearSystemSave] = false;
-    m_settingDefault[Config_CacheSize] = 10;
+    m_settingDefault[Config_CacheMemorySize] = 1024;
     m_settingDefault[Config_NumberOfThreads] = omp_get_max_threads();
+    // independent weakly coupled blocks solved at once (threads are split between them)
+    m_settingDefault[Config_NumberOfConcurrentBlocks] = 1;
+    // external solver is kept running between solves (otherwise a new process per solve)
+    m_settingDefault[Config_ExternalSolverDaemon] = true;
     m_settingDefault[Config_ShowGrid] = true;
     m_settingDefault[Config_ShowRulers] = true;
     m_settingDefault[Config_ShowAxes] = true;
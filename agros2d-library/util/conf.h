@@ -40,8 +40,10 @@ public:
         Config_ShowResults,
         Config_LinearSystemFormat,
         Config_LinearSystemSave,
-        Config_CacheSize,
+        Config_CacheMemorySize,
         Config_NumberOfThreads,
+        Config_NumberOfConcurrentBlocks,
+        Config_ExternalSolverDaemon,
         Config_RulersFontFamily,
         Config_RulersFontPointSize,
         Config_PostFontFamily,
@@ -35,6 +35,7 @@ static QMap<AdaptivityType, QString> adaptivityTypeList;
 static QMap<AdaptivityStoppingCriterionType, QString> adaptivityStoppingCriterionTypeList;
 static QMap<Hermes::Hermes2D::NormType, QString> adaptivityNormTypeList;
 static QMap<TimeStepMethod, QString> timeStepMethodList;
+static QMap<TimeErrorEstimator, QString> timeErrorEstimatorList;
 static QMap<SolutionMode, QString> solutionTypeList;
 static QMap<AnalysisType, QString> analysisTypeList;
 static QMap<CouplingType, QString> couplingTypeList;
@@ -42,6 +43,7 @@ static QMap<LinearityType, QString> linearityTypeList;
 static QMap<DampingType, QString> dampingTypeList;
 static QMap<MeshType, QString> meshTypeList;
 static QMap<Hermes::MatrixSolverType, QString> matrixSolverTypeList;
+static QMap<MatrixReuseType, QString> matrixReuseTypeList;
 static QMap<Hermes::Algebra::MatrixExportFormat, QString> dumpFormatList;
 static QMap<Hermes::Hermes2D::SpaceType, QString> spaceTypeList;
 static QMap<PaletteType, QString> paletteTypeList;
@@ -51,6 +53,7 @@ static QMap<VectorCenter, QString> vectorCenterList;
 static QMap<DataTableType, QString> dataTableTypeList;
 static QMap<SpecialFunctionType, QString> specialFunctionTypeList;
 static QMap<Hermes::ButcherTableType, QString> butcherTableTypeList;
+static QMap<IntegralOrderType, QString> integralOrderTypeList;
 static QMap<Hermes::Solvers::IterSolverType, QString> iterLinearSolverMethodList;
 static QMap<Hermes::Solvers::PreconditionerType, QString> iterLinearSolverPreconditionerTypeList;
 
@@ -98,6 +101,10 @@ QStringList timeStepMethodStringKeys() { return timeStepMethodList.values(); }
 QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod) { return timeStepMethodList[timeStepMethod]; }
 TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod) { return timeStepMethodList.key(timeStepMethod); }
 
+QStringList timeErrorEstimatorStringKeys() { return timeErrorEstimatorList.values(); }
+QString timeErrorEstimatorToStringKey(TimeErrorEstimator timeErrorEstimator) { return timeErrorEstimatorList[timeErrorEstimator]; }
+TimeErrorEstimator timeErrorEstimatorFromStringKey(const QString &timeErrorEstimator) { return timeErrorEstimatorList.key(timeErrorEstimator); }
+
 QStringList solutionTypeStringKeys() { return solutionTypeList.values(); }
 QString solutionTypeToStringKey(SolutionMode solutionType) { return solutionTypeList[solutionType]; }
 SolutionMode solutionTypeFromStringKey(const QString &solutionType) { return solutionTypeList.key(solutionType); }
@@ -114,6 +121,10 @@ QStringList matrixSolverTypeStringKeys() { return matrixSolverTypeList.values();
 QString matrixSolverTypeToStringKey(Hermes::MatrixSolverType matrixSolverType) { return matrixSolverTypeList[matrixSolverType]; }
 Hermes::MatrixSolverType matrixSolverTypeFromStringKey(const QString &matrixSolverType) { return matrixSolverTypeList.key(matrixSolverType); }
 
+QStringList matrixReuseTypeStringKeys() { return matrixReuseTypeList.values(); }
+QString matrixReuseTypeToStringKey(MatrixReuseType matrixReuseType) { return matrixReuseTypeList[matrixReuseType]; }
+MatrixReuseType matrixReuseTypeFromStringKey(const QString &matrixReuseType) { return matrixReuseTypeList.key(matrixReuseType); }
+
 QStringList dumpFormatStringKeys() { return dumpFormatList.values(); }
 QString dumpFormatToStringKey(Hermes::Algebra::MatrixExportFormat format) { return dumpFormatList[format]; }
 Hermes::Algebra::MatrixExportFormat dumpFormatFromStringKey(const QString &format) { return dumpFormatList.key(format); }
@@ -154,6 +165,10 @@ QStringList butcherTableTypeStringKeys() { return butcherTableTypeList.values();
 QString butcherTableTypeToStringKey(Hermes::ButcherTableType tableType) { return butcherTableTypeList[tableType]; }
 Hermes::ButcherTableType butcherTableTypeFromStringKey(const QString &tableType) { return butcherTableTypeList.key(tableType); }
 
+QStringList integralOrderTypeStringKeys() { return integralOrderTypeList.values(); }
+QString integralOrderTypeToStringKey(IntegralOrderType integralOrderType) { return integralOrderTypeList[integralOrderType]; }
+IntegralOrderType integralOrderTypeFromStringKey(const QString &integralOrderType) { return integralOrderTypeList.key(integralOrderType); }
+
 QStringList iterLinearSolverMethodStringKeys() { return iterLinearSolverMethodList.values(); }
 QString iterLinearSolverMethodToStringKey(Hermes::Solvers::IterSolverType type) { return iterLinearSolverMethodList[type]; }
 Hermes::Solvers::IterSolverType iterLinearSolverMethodFromStringKey(const QString &type) { return iterLinearSolverMethodList.key(type); }
@@ -206,6 +221,10 @@ void initLists()
     //    timeStepMethodList.insert(TimeStepMethod_FixedBDF2B, "fixed_bdf2b");
     //    timeStepMethodList.insert(TimeStepMethod_FixedCombine, "fixed_combine");
 
+    // TimeErrorEstimator
+    timeErrorEstimatorList.insert(TimeErrorEstimator_LowerOrder, "lower_order");
+    timeErrorEstimatorList.insert(TimeErrorEstimator_Embedded, "embedded");
+
     // PHYSICFIELDVARIABLECOMP
     physicFieldVariableCompList.insert(PhysicFieldVariableComp_Scalar, "scalar");
     physicFieldVariableCompList.insert(PhysicFieldVariableComp_Magnitude, "magnitude");
@@ -261,6 +280,11 @@ void initLists()
 #endif
     matrixSolverTypeList.insert(Hermes::SOLVER_EXTERNAL, "external");
 
+    // matrix reuse
+    matrixReuseTypeList.insert(MatrixReuseType_None, "disabled");
+    matrixReuseTypeList.insert(MatrixReuseType_Structure, "structure");
+    matrixReuseTypeList.insert(MatrixReuseType_Factorization, "factorization");
+
     // dump format
     dumpFormatList.insert(Hermes::Algebra::EXPORT_FORMAT_PLAIN_ASCII, "plain_ascii");
     dumpFormatList.insert(Hermes::Algebra::EXPORT_FORMAT_MATLAB_MATIO, "matlab_mat");
@@ -325,6 +349,11 @@ void initLists()
     butcherTableTypeList.insert(Hermes::Explicit_CASH_KARP_6_45_embedded, "cash-karp");
     butcherTableTypeList.insert(Hermes::Explicit_DORMAND_PRINCE_7_45_embedded, "dormand-prince");
 
+    // IntegralOrderType
+    integralOrderTypeList.insert(IntegralOrder_Fixed, "fixed");
+    integralOrderTypeList.insert(IntegralOrder_Automatic, "automatic");
+    integralOrderTypeList.insert(IntegralOrder_Adaptive, "adaptive");
+
     // Iterative solver
     iterLinearSolverMethodList.insert(Hermes::Solvers::CG, "cg");
     iterLinearSolverMethodList.insert(Hermes::Solvers::GMRES, "gmres");
@@ -484,6 +513,20 @@ QString timeStepMethodString(TimeStepMethod timeStepMethod)
     }
 }
 
+QString timeErrorEstimatorString(TimeErrorEstimator timeErrorEstimator)
+{
+    switch (timeErrorEstimator)
+    {
+    case TimeErrorEstimator_LowerOrder:
+        return QObject::tr("Lower order solution");
+    case TimeErrorEstimator_Embedded:
+        return QObject::tr("Embedded (predictor-corrector)");
+    default:
+        std::cerr << "Time error estimator '" + QString::number(timeErrorEstimator).toStdString() + "' is not implemented. timeErrorEstimatorString(TimeErrorEstimator timeErrorEstimator)" << endl;
+        throw;
+    }
+}
+
 QString weakFormString(WeakFormKind weakForm)
 {
     switch (weakForm)
@@ -625,6 +668,22 @@ QString matrixSolverTypeString(Hermes::MatrixSolverType matrixSolverType)
     }
 }
 
+QString matrixReuseTypeString(MatrixReuseType matrixReuseType)
+{
+    switch (matrixReuseType)
+    {
+    case MatrixReuseType_None:
+        return QObject::tr("Disabled");
+    case MatrixReuseType_Structure:
+        return QObject::tr("Matrix structure");
+    case MatrixReuseType_Factorization:
+        return QObject::tr("Factorization");
+    default:
+        std::cerr << "Matrix reuse type '" + QString::number(matrixReuseType).toStdString() + "' is not implemented. matrixReuseTypeString(MatrixReuseType matrixReuseType)" << endl;
+        throw;
+    }
+}
+
 QString dumpFormatString(Hermes::Algebra::MatrixExportFormat format)
 {
     switch (format)
@@ -728,6 +787,22 @@ QString butcherTableTypeString(Hermes::ButcherTableType tableType)
     }
 }
 
+QString integralOrderTypeString(IntegralOrderType integralOrderType)
+{
+    switch (integralOrderType)
+    {
+    case IntegralOrder_Fixed:
+        return QObject::tr("Fixed");
+    case IntegralOrder_Automatic:
+        return QObject::tr("Automatic");
+    case IntegralOrder_Adaptive:
+        return QObject::tr("Adaptive");
+    default:
+        std::cerr << "Integral order type '" + QString::number(integralOrderType).toStdString() + "' is not implemented. integralOrderTypeString(IntegralOrderType integralOrderType)" << endl;
+        throw;
+    }
+}
+
 QString iterLinearSolverMethodString(Hermes::Solvers::IterSolverType type)
 {
     switch (type)
@@ -66,6 +66,21 @@ enum TimeStepMethod
     TimeStepMethod_BDFNumSteps = 2
 };
 
+enum TimeErrorEstimator
+{
+    TimeErrorEstimator_Undefined = -1,
+    TimeErrorEstimator_LowerOrder = 0,
+    TimeErrorEstimator_Embedded = 1
+};
+
+enum MatrixReuseType
+{
+    MatrixReuseType_Undefined = -1,
+    MatrixReuseType_None = 0,
+    MatrixReuseType_Structure = 1,
+    MatrixReuseType_Factorization = 2
+};
+
 enum LinearityType
 {
     LinearityType_Undefined = -1,
@@ -230,6 +245,13 @@ enum SpecialFunctionType
     SpecialFunctionType_Function1D = 1
 };
 
+enum IntegralOrderType
+{
+    IntegralOrder_Fixed = 0,
+    IntegralOrder_Automatic = 1,
+    IntegralOrder_Adaptive = 2
+};
+
 // keys
 AGROS_LIBRARY_API void initLists();
 
@@ -302,6 +324,12 @@ AGROS_LIBRARY_API QStringList timeStepMethodStringKeys();
 AGROS_LIBRARY_API QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod);
 AGROS_LIBRARY_API TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod);
 
+// time error estimator
+AGROS_LIBRARY_API QString timeErrorEstimatorString(TimeErrorEstimator timeErrorEstimator);
+AGROS_LIBRARY_API QStringList timeErrorEstimatorStringKeys();
+AGROS_LIBRARY_API QString timeErrorEstimatorToStringKey(TimeErrorEstimator timeErrorEstimator);
+AGROS_LIBRARY_API TimeErrorEstimator timeErrorEstimatorFromStringKey(const QString &timeErrorEstimator);
+
 // solution mode
 AGROS_LIBRARY_API QString solutionTypeString(SolutionMode solutionMode);
 AGROS_LIBRARY_API QStringList solutionTypeStringKeys();
@@ -315,6 +343,12 @@ AGROS_LIBRARY_API QStringList matrixSolverTypeStringKeys();
 AGROS_LIBRARY_API QString matrixSolverTypeToStringKey(Hermes::MatrixSolverType matrixSolverType);
 AGROS_LIBRARY_API Hermes::MatrixSolverType matrixSolverTypeFromStringKey(const QString &matrixSolverType);
 
+// matrix reuse type
+AGROS_LIBRARY_API QString matrixReuseTypeString(MatrixReuseType matrixReuseType);
+AGROS_LIBRARY_API QStringList matrixReuseTypeStringKeys();
+AGROS_LIBRARY_API QString matrixReuseTypeToStringKey(MatrixReuseType matrixReuseType);
+AGROS_LIBRARY_API MatrixReuseType matrixReuseTypeFromStringKey(const QString &matrixReuseType);
+
 // matrix dump format
 AGROS_LIBRARY_API QString dumpFormatString(Hermes::Algebra::MatrixExportFormat format);
 AGROS_LIBRARY_API QStringList dumpFormatStringKeys();
@@ -384,6 +418,12 @@ AGROS_LIBRARY_API QStringList butcherTableTypeStringKeys();
 AGROS_LIBRARY_API QString butcherTableTypeToStringKey(Hermes::ButcherTableType tableType);
 AGROS_LIBRARY_API Hermes::ButcherTableType butcherTableTypeFromStringKey(const QString &tableType);
 
+// quadrature order of integrals
+AGROS_LIBRARY_API QString integralOrderTypeString(IntegralOrderType integralOrderType);
+AGROS_LIBRARY_API QStringList integralOrderTypeStringKeys();
+AGROS_LIBRARY_API QString integralOrderTypeToStringKey(IntegralOrderType integralOrderType);
+AGROS_LIBRARY_API IntegralOrderType integralOrderTypeFromStringKey(const QString &integralOrderType);
+
 // iterative solver - method
 AGROS_LIBRARY_API QString iterLinearSolverMethodString(Hermes::Solvers::IterSolverType type);
 AGROS_LIBRARY_API QStringList iterLinearSolverMethodStringKeys();
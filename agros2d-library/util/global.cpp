@@ -28,6 +28,7 @@
 
 #include "pythonlab/pythonengine_agros.h"
 #include "pythonlab/remotecontrol.h"
+#include "pythonlab/jobserver.h"
 
 #include "hermes2d/module.h"
 
@@ -38,7 +39,7 @@
 
 #include "util/system_utils.h"
 
-AgrosApplication::AgrosApplication(int& argc, char ** argv) : QApplication(argc, argv), m_scriptEngineRemote(NULL)
+AgrosApplication::AgrosApplication(int& argc, char ** argv) : QApplication(argc, argv), m_scriptEngineRemote(NULL), m_jobServer(NULL)
 {
     setlocale (LC_NUMERIC, "C");
 
@@ -71,6 +72,8 @@ AgrosApplication::~AgrosApplication()
 {
     if (m_scriptEngineRemote)
         delete m_scriptEngineRemote;
+    if (m_jobServer)
+        delete m_jobServer;
 }
 
 // reimplemented from QApplication so we can throw exceptions in slots
@@ -225,3 +228,10 @@ void AgrosApplication::runRemoteServer()
 {
     m_scriptEngineRemote = new ScriptEngineRemote();
 }
+
+bool AgrosApplication::runJobServer(int port, int numberOfWorkers)
+{
+    m_jobServer = new JobServer(port, numberOfWorkers);
+
+    return m_jobServer->isListening();
+}
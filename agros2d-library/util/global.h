@@ -30,6 +30,7 @@ class Log;
 class Scene;
 class PluginInterface;
 class ScriptEngineRemote;
+class JobServer;
 class MemoryMonitor;
 
 class AGROS_LIBRARY_API AgrosApplication : public QApplication
@@ -41,9 +42,11 @@ public:
     virtual bool notify(QObject *receiver, QEvent *event);
 
     void runRemoteServer();
+    bool runJobServer(int port, int numberOfWorkers);
 
 private:
     ScriptEngineRemote *m_scriptEngineRemote;
+    JobServer *m_jobServer;
 };
 
 class AGROS_LIBRARY_API Agros2D
@@ -0,0 +1,106 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef UTIL_SETTING_SNAPSHOT_H
+#define UTIL_SETTING_SNAPSHOT_H
+
+#include "util.h"
+
+// typed copy of a settings map (numbers and booleans), indexed by the setting type
+// every key is stored only under the type of its default value, values are converted from QVariant
+// once when a setting is changed, reading is an array access without map lookup and QVariant conversion,
+// so it can be used in loops
+template <typename Type>
+class SettingSnapshot
+{
+public:
+    SettingSnapshot() {}
+    SettingSnapshot(const QMap<Type, QVariant> &settingDefault, const QMap<Type, QVariant> &setting)
+    {
+        // keys are sorted, the last one is the greatest
+        m_entries.resize(settingDefault.isEmpty() ? 0 : settingDefault.lastKey() + 1);
+
+        // types of keys without default (or with strings) stay invalid
+        for (typename QMap<Type, QVariant>::const_iterator it = settingDefault.constBegin(); it != settingDefault.constEnd(); ++it)
+        {
+            QVariant::Type type = it.value().type();
+            if (type == QVariant::Double || type == QVariant::Int || type == QVariant::Bool)
+                m_entries[it.key()].type = type;
+        }
+
+        for (typename QMap<Type, QVariant>::const_iterator it = setting.constBegin(); it != setting.constEnd(); ++it)
+            setValue(it.key(), it.value());
+    }
+
+    // updates one entry only
+    inline void setValue(Type type, const QVariant &value)
+    {
+        if (type >= m_entries.size())
+            return;
+
+        Entry &entry = m_entries[type];
+        if (entry.type == QVariant::Double)
+            entry.number = value.toDouble();
+        else if (entry.type == QVariant::Int)
+            entry.integer = value.toInt();
+        else if (entry.type == QVariant::Bool)
+            entry.boolean = value.toBool();
+    }
+
+    inline double toDouble(Type type) const { assert(type < m_entries.size() && m_entries[type].type == QVariant::Double); return m_entries[type].number; }
+    inline int toInt(Type type) const { assert(type < m_entries.size() && m_entries[type].type == QVariant::Int); return m_entries[type].integer; }
+    inline bool toBool(Type type) const { assert(type < m_entries.size() && m_entries[type].type == QVariant::Bool); return m_entries[type].boolean; }
+
+    // compares stored entries with the settings map (typed keys only)
+    bool isEqual(const QMap<Type, QVariant> &setting) const
+    {
+        for (int i = 0; i < m_entries.size(); i++)
+        {
+            const Entry &entry = m_entries[i];
+            if (entry.type == QVariant::Invalid)
+                continue;
+
+            QVariant value = setting.value((Type) i);
+            if ((entry.type == QVariant::Double && entry.number != value.toDouble()) ||
+                    (entry.type == QVariant::Int && entry.integer != value.toInt()) ||
+                    (entry.type == QVariant::Bool && entry.boolean != value.toBool()))
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    struct Entry
+    {
+        Entry() : type(QVariant::Invalid), number(0.0) {}
+
+        QVariant::Type type;
+        union
+        {
+            double number;
+            int integer;
+            bool boolean;
+        };
+    };
+
+    QVector<Entry> m_entries;
+};
+
+#endif // UTIL_SETTING_SNAPSHOT_H
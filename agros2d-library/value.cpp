@@ -24,16 +24,17 @@
 #include "pythonlab/pythonengine_agros.h"
 #include "hermes2d/problem_config.h"
 #include "parser/lex.h"
+#include "parser/expression.h"
 
 Value::Value(double value)
-    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
+    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependentPlanar(false), m_isCoordinateDependentAxisymmetric(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     m_text = QString::number(value);
     m_number = value;      
 }
 
 Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
-    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
+    : m_isEvaluated(true), m_isTimeDependent(false), m_isCoordinateDependentPlanar(false), m_isCoordinateDependentAxisymmetric(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     assert(x.size() == y.size());
 
@@ -46,14 +47,14 @@ Value::Value(double value, std::vector<double> x, std::vector<double> y, DataTab
 }
 
 Value::Value(const QString &value)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependentPlanar(false), m_isCoordinateDependentAxisymmetric(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     parseFromString(value.isEmpty() ? "0" : value);
     evaluateAndSave();
 }
 
 Value::Value(const QString &value, std::vector<double> x, std::vector<double> y, DataTableType type, bool splineFirstDerivatives, bool extrapolateConstant)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependentPlanar(false), m_isCoordinateDependentAxisymmetric(false), m_time(0.0), m_point(Point()), m_table(DataTable()), m_problem(Agros2D::problem())
 {
     assert(x.size() == y.size());
 
@@ -66,7 +67,7 @@ Value::Value(const QString &value, std::vector<double> x, std::vector<double> y,
 }
 
 Value::Value(const QString &value, const DataTable &table)
-    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependent(false), m_time(0.0), m_point(Point()), m_table(table), m_problem(Agros2D::problem())
+    : m_isEvaluated(false), m_isTimeDependent(false), m_isCoordinateDependentPlanar(false), m_isCoordinateDependentAxisymmetric(false), m_time(0.0), m_point(Point()), m_table(table), m_problem(Agros2D::problem())
 {
     parseFromString(value.isEmpty() ? "0" : value);
 }
@@ -86,7 +87,10 @@ Value& Value::operator =(const Value &origin)
     m_time = origin.m_time;
     m_point = origin.m_point;
     m_isTimeDependent = origin.m_isTimeDependent;
-    m_isCoordinateDependent = origin.m_isCoordinateDependent;
+    m_isCoordinateDependentPlanar = origin.m_isCoordinateDependentPlanar;
+    m_isCoordinateDependentAxisymmetric = origin.m_isCoordinateDependentAxisymmetric;
+    m_expressionPlanar = origin.m_expressionPlanar;
+    m_expressionAxisymmetric = origin.m_expressionAxisymmetric;
     m_table = origin.m_table;
 
     evaluateAndSave();
@@ -213,7 +217,8 @@ void Value::setText(const QString &str)
     m_text = str;
 
     m_isTimeDependent = false;
-    m_isCoordinateDependent = false;
+    m_isCoordinateDependentPlanar = false;
+    m_isCoordinateDependentAxisymmetric = false;
 
     LexicalAnalyser lex;
 
@@ -234,19 +239,23 @@ void Value::setText(const QString &str)
         {
             if (token.toString() == "time")
                 m_isTimeDependent = true;
-            if (m_problem->config()->coordinateType() == CoordinateType_Planar)
-            {
-                if (token.toString() == "x" || token.toString() == "y")
-                    m_isCoordinateDependent = true;
-            }
-            else
-            {
-                if (token.toString() == "r" || token.toString() == "z")
-                    m_isCoordinateDependent = true;
-            }
+            if (token.toString() == "x" || token.toString() == "y")
+                m_isCoordinateDependentPlanar = true;
+            if (token.toString() == "r" || token.toString() == "z")
+                m_isCoordinateDependentAxisymmetric = true;
         }
     }
 
+    // compile expression for both coordinate types (variables are bound in order time, x, y),
+    // the coordinate type can be changed after the value is set
+    m_expressionPlanar = QSharedPointer<CompiledExpression>(new CompiledExpression());
+    if (!m_expressionPlanar->compile(m_text, QStringList() << "time" << "x" << "y"))
+        m_expressionPlanar.clear();
+
+    m_expressionAxisymmetric = QSharedPointer<CompiledExpression>(new CompiledExpression());
+    if (!m_expressionAxisymmetric->compile(m_text, QStringList() << "time" << "r" << "z"))
+        m_expressionAxisymmetric.clear();
+
     evaluateAndSave();
 }
 
@@ -285,6 +294,14 @@ void Value::parseFromString(const QString &str)
     }
 }
 
+bool Value::isCoordinateDependent() const
+{
+    if (m_problem->config()->coordinateType() == CoordinateType_Planar)
+        return m_isCoordinateDependentPlanar;
+    else
+        return m_isCoordinateDependentAxisymmetric;
+}
+
 bool Value::evaluate(double time, const Point &point, double& result) const
 {
     return evaluateExpression(m_text, time, point, result);
@@ -317,12 +334,29 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
         return true;
     }
 
+    // compiled expression
+    QSharedPointer<CompiledExpression> compiledExpression = (m_problem->config()->coordinateType() == CoordinateType_Planar)
+            ? m_expressionPlanar : m_expressionAxisymmetric;
+    if (!compiledExpression.isNull() && compiledExpression->expression() == expression)
+    {
+        double values[3] = { time, point.x, point.y };
+        double result = compiledExpression->evaluate(values);
+
+        // errors (division by zero, domain) are reported by Python
+        if (qIsFinite(result))
+        {
+            evaluationResult = (fabs(result) < EPS_ZERO) ? 0.0 : result;
+            return true;
+        }
+    }
+
     bool signalBlocked = currentPythonEngineAgros()->signalsBlocked();
     currentPythonEngineAgros()->blockSignals(true);
 
     QString command;
 
-    if (m_isCoordinateDependent && !m_isTimeDependent)
+    bool isCoordinateDependent = this->isCoordinateDependent();
+    if (isCoordinateDependent && !m_isTimeDependent)
     {
         if (m_problem->config()->coordinateType() == CoordinateType_Planar)
             command = QString("x = %1; y = %2").arg(point.x).arg(point.y);
@@ -330,12 +364,12 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
             command = QString("r = %1; z = %2").arg(point.x).arg(point.y);
     }
 
-    if (m_isTimeDependent && !m_isCoordinateDependent)
+    if (m_isTimeDependent && !isCoordinateDependent)
     {
         command = QString("time = %1").arg(time);
     }
 
-    if (m_isCoordinateDependent && m_isTimeDependent)
+    if (isCoordinateDependent && m_isTimeDependent)
     {
         if (m_problem->config()->coordinateType() == CoordinateType_Planar)
             command = QString("time = %1; x = %2; y = %3").arg(time).arg(point.x).arg(point.y);
@@ -351,7 +385,7 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
     {
         QString commandDel;
 
-        if (m_isCoordinateDependent && !m_isTimeDependent)
+        if (isCoordinateDependent && !m_isTimeDependent)
         {
             if (m_problem->config()->coordinateType() == CoordinateType_Planar)
                 commandDel = QString("del x; del y");
@@ -359,12 +393,12 @@ bool Value::evaluateExpression(const QString &expression, double time, const Poi
                 commandDel = QString("del r; del z");
         }
 
-        if (m_isTimeDependent && !m_isCoordinateDependent)
+        if (m_isTimeDependent && !isCoordinateDependent)
         {
             commandDel = QString("del time");
         }
 
-        if (m_isCoordinateDependent && m_isTimeDependent)
+        if (isCoordinateDependent && m_isTimeDependent)
         {
             if (m_problem->config()->coordinateType() == CoordinateType_Planar)
                 commandDel = QString("del time; del x; del y");
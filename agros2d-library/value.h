@@ -29,6 +29,7 @@
 class DataTable;
 class FieldInfo;
 class Problem;
+class CompiledExpression;
 
 class AGROS_LIBRARY_API Value
 {
@@ -56,7 +57,7 @@ public:
 
     bool isNumber();
     inline bool isTimeDependent() const { return m_isTimeDependent; }
-    inline bool isCoordinateDependent() const { return m_isCoordinateDependent; }
+    bool isCoordinateDependent() const;
 
     bool evaluateAtPoint(const Point &point);
     bool evaluateAtTime(double time);
@@ -91,7 +92,12 @@ private:
     double m_time;
     Point m_point;
     bool m_isTimeDependent;
-    bool m_isCoordinateDependent;
+    // x, y (planar) and r, z (axisymmetric) are bound by the current coordinate type
+    bool m_isCoordinateDependentPlanar;
+    bool m_isCoordinateDependentAxisymmetric;
+    // native programs (shared by copies), Python is used if not valid
+    QSharedPointer<CompiledExpression> m_expressionPlanar;
+    QSharedPointer<CompiledExpression> m_expressionAxisymmetric;
 
     // table
     DataTable m_table;
@@ -38,12 +38,16 @@ int main(int argc, char *argv[])
 
         TCLAP::SwitchArg logArg("l", "enable-log", "Enable log", false);
         TCLAP::SwitchArg remoteArg("r", "remote-server", "Run remote server", false);
+        TCLAP::ValueArg<int> jobServerArg("j", "job-server", "Run local job server on given port", false, 0, "int");
+        TCLAP::ValueArg<int> workersArg("w", "workers", "Number of job server workers (default number of cores)", false, 0, "int");
         TCLAP::ValueArg<std::string> problemArg("p", "problem", "Solve problem", false, "", "string");
         TCLAP::ValueArg<std::string> scriptArg("s", "script", "Solve script", false, "", "string");
         TCLAP::ValueArg<std::string> testArg("t", "test", "Run tests", false, "list", "string");
 
         cmd.add(logArg);
         cmd.add(remoteArg);
+        cmd.add(jobServerArg);
+        cmd.add(workersArg);
         cmd.add(problemArg);
         cmd.add(scriptArg);
         cmd.add(testArg);
@@ -64,6 +68,16 @@ int main(int argc, char *argv[])
             return a.exec();
         }
 
+        // run job server
+        if (jobServerArg.getValue() > 0)
+        {
+            // port is not available
+            if (!a.runJobServer(jobServerArg.getValue(), workersArg.getValue()))
+                return 1;
+
+            return a.exec();
+        }
+
         if (!problemArg.getValue().empty())
         {
             if (QFile::exists(QString::fromStdString(problemArg.getValue())))
@@ -65,6 +65,7 @@ public:
 
     // local values
     virtual LocalValue *localValue(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point) { assert(0); return NULL; }
+    virtual LocalValueBatch *localValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const QVector<Point> &points) { assert(0); return NULL; }
     // surface integrals
     virtual IntegralValue *surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType) { assert(0); return NULL; }
     // volume integrals
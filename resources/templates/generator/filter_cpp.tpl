@@ -48,7 +48,42 @@
     dudy = new double*[this->num];
 
     m_coordinateType = Agros2D::problem()->config()->coordinateType();
-    m_labels = Agros2D::scene()->labels;
+
+    m_materials = m_fieldInfo->materialTable();
+    {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->materialValueTable(QLatin1String("{{MATERIAL_VARIABLE}}"), m_materials);
+    {{/VARIABLE_MATERIAL}}
+
+    m_kernel = NULL;
+    {{#VARIABLE_SOURCE}}
+    if ((m_variableHash == {{VARIABLE_HASH}})
+            && (m_coordinateType == {{COORDINATE_TYPE}})
+            && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
+            && (m_physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}}))
+        m_kernel = &{{CLASS}}ViewScalarFilter::{{KERNEL}};
+    {{/VARIABLE_SOURCE}}
+}
+
+{{CLASS}}ViewScalarFilter::{{CLASS}}ViewScalarFilter(const {{CLASS}}ViewScalarFilter *filter, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln)
+    : Hermes::Hermes2D::Filter<double>(sln), m_fieldInfo(filter->m_fieldInfo), m_timeStep(filter->m_timeStep), m_adaptivityStep(filter->m_adaptivityStep), m_solutionType(filter->m_solutionType),
+      m_variable(filter->m_variable), m_physicFieldVariableComp(filter->m_physicFieldVariableComp)
+{
+    m_variableHash = filter->m_variableHash;
+
+    {{#SPECIAL_FUNCTION_SOURCE}}
+    {{SPECIAL_FUNCTION_NAME}} = filter->{{SPECIAL_FUNCTION_NAME}};
+    {{/SPECIAL_FUNCTION_SOURCE}}
+
+    value = new double*[this->num];
+    dudx = new double*[this->num];
+    dudy = new double*[this->num];
+
+    m_coordinateType = filter->m_coordinateType;
+
+    m_materials = filter->m_materials;
+    {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = filter->m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
+
+    m_kernel = filter->m_kernel;
 }
 
 {{CLASS}}ViewScalarFilter::~{{CLASS}}ViewScalarFilter()
@@ -83,23 +118,29 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     double *y = this->refmap->get_phys_y(order);
     Hermes::Hermes2D::Element *e = this->refmap->get_active_element();
 
-    // set material
-    SceneMaterial *material = m_labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().
-                                           get_user_marker(e->marker).marker.c_str()))->marker(m_fieldInfo);
-
-    int elementMarker = e->marker;
-
-    {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
-    {{/VARIABLE_MATERIAL}}    
-    {{#VARIABLE_SOURCE}}
-    if ((m_variableHash == {{VARIABLE_HASH}})
-            && (m_coordinateType == {{COORDINATE_TYPE}})
-            && (m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}})
-            && (m_physicFieldVariableComp == {{PHYSICFIELDVARIABLECOMP_TYPE}}))
+    // markers outside of the material tables are not evaluated
+    if (m_kernel && (e->marker >= 0) && (e->marker < m_materials.size())
+            && m_materials[e->marker] && !m_materials[e->marker]->isNone())
+    {
+        (this->*m_kernel)(np, x, y, e->marker, this->values[0][0]);
+    }
+    else
+    {
         for (int i = 0; i < np; i++)
-            this->values[0][0][i] = {{EXPRESSION}};
-    {{/VARIABLE_SOURCE}}
+            this->values[0][0][i] = 0.0;
+    }
+}
+
+{{#VARIABLE_SOURCE}}
+void {{CLASS}}ViewScalarFilter::{{KERNEL}}(int np, const double *x, const double *y, int elementMarker, double *result)
+{
+    {{#KERNEL_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}[elementMarker];
+    {{/KERNEL_MATERIAL}}{{#KERNEL_MATERIAL_NUMBER}}const double material_{{MATERIAL_VARIABLE}}_number = m_material_{{MATERIAL_VARIABLE}}[elementMarker]->number();
+    {{/KERNEL_MATERIAL_NUMBER}}
+    for (int i = 0; i < np; i++)
+        result[i] = {{EXPRESSION}};
 }
+{{/VARIABLE_SOURCE}}
 
 {{CLASS}}ViewScalarFilter* {{CLASS}}ViewScalarFilter::clone() const
 {
@@ -108,7 +149,7 @@ void {{CLASS}}ViewScalarFilter::precalculate(int order, int mask)
     for (int i = 0; i < this->num; i++)
         slns.push_back(this->sln[i]->clone());
 
-    {{CLASS}}ViewScalarFilter *filter = new {{CLASS}}ViewScalarFilter(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType, slns, m_variable, m_physicFieldVariableComp);
+    {{CLASS}}ViewScalarFilter *filter = new {{CLASS}}ViewScalarFilter(this, slns);
 
     return filter;
 }
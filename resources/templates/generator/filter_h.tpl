@@ -29,8 +29,6 @@
 
 #include "{{ID}}_interface.h"
 
-class SceneLabelContainer;
-
 class {{CLASS}}ViewScalarFilter : public Hermes::Hermes2D::Filter<double>
 {
 public:
@@ -42,9 +40,11 @@ public:
 
     virtual Hermes::Hermes2D::Func<double> *get_pt_value(double x, double y, bool use_MeshHashGrid = false, Hermes::Hermes2D::Element* e = NULL);
 
+    // problem and material tables are not read by the clone (linearizer threads)
     {{CLASS}}ViewScalarFilter* clone() const;
 
 protected:
+    {{CLASS}}ViewScalarFilter(const {{CLASS}}ViewScalarFilter *filter, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > sln);
 
     void precalculate(int order, int mask);
 
@@ -54,13 +54,22 @@ private:
     int m_adaptivityStep;
     SolutionMode m_solutionType;
 
-    SceneLabelContainer *m_labels;
-
+    // materials and material values indexed by hermes element marker
+    QVector<SceneMaterial *> m_materials;
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
     QString m_variable;
     uint m_variableHash;
     PhysicFieldVariableComp m_physicFieldVariableComp;
     CoordinateType m_coordinateType;
 
+    // specialized kernel (variable, component, analysis and coordinate type) selected in constructor
+    typedef void ({{CLASS}}ViewScalarFilter::*Kernel)(int np, const double *x, const double *y, int elementMarker, double *result);
+    Kernel m_kernel;
+
+    {{#VARIABLE_SOURCE}}void {{KERNEL}}(int np, const double *x, const double *y, int elementMarker, double *result);
+    {{/VARIABLE_SOURCE}}
+
     {{#SPECIAL_FUNCTION_SOURCE}}
     QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};{{/SPECIAL_FUNCTION_SOURCE}}
 
@@ -92,7 +92,7 @@ Point3 force{{CLASS}}(const FieldInfo *fieldInfo, int timeStep, int adaptivitySt
             double val;
             if ((fieldInfo->analysisType() == AnalysisType_Transient) && timeStep == 0)
                 // const solution at first time step
-                val = fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
+                val = fieldInfo->snapshot().toDouble(FieldInfo::TransientInitialCondition);
             else
                 val = values->val[0];
 
@@ -160,6 +160,11 @@ LocalValue *{{CLASS}}Interface::localValue(const FieldInfo *fieldInfo, int timeS
     return new {{CLASS}}LocalValue(fieldInfo, timeStep, adaptivityStep, solutionType, point);
 }
 
+LocalValueBatch *{{CLASS}}Interface::localValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const QVector<Point> &points)
+{
+    return new {{CLASS}}LocalValueBatch(fieldInfo, timeStep, adaptivityStep, solutionType, points);
+}
+
 IntegralValue *{{CLASS}}Interface::surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
 {
     return new {{CLASS}}SurfaceIntegral(fieldInfo, timeStep, adaptivityStep, solutionType);
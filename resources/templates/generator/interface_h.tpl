@@ -66,6 +66,7 @@ public:
 
     // local values
     virtual LocalValue *localValue(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const Point &point);
+    virtual LocalValueBatch *localValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType, const QVector<Point> &points);
     // surface integrals
     virtual IntegralValue *surfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType);
     // volume integrals
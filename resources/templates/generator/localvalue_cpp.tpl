@@ -29,6 +29,7 @@
 #include "hermes2d/problem_config.h"
 #include "hermes2d/field.h"
 #include "hermes2d/solutionstore.h"
+#include "particle/mesh_hash.h"
 
 #include "hermes2d/plugin_interface.h"
 
@@ -63,13 +64,13 @@ void {{CLASS}}LocalValue::calculate()
         double x = m_point.x;
         double y = m_point.y;
 
-        Hermes::Hermes2D::Element *e = Hermes::Hermes2D::RefMap::element_on_physical_coordinates(false, m_fieldInfo->initialMesh(),
-                                                                                                 m_point.x, m_point.y);
+        Hermes::Hermes2D::Element *e = Agros2D::solutionStore()->meshHash(m_fieldInfo->initialMesh())->getElement(m_point.x, m_point.y);
         if (e)
         {
             // find marker
-            SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->marker).marker.c_str()));
-            SceneMaterial *material = label->marker(m_fieldInfo);
+            SceneMaterial *material = m_fieldInfo->elementMaterial(e->marker);
+            if (!material || material->isNone())
+                return;
 
             int elementMarker = e->marker;
 
@@ -91,14 +92,15 @@ void {{CLASS}}LocalValue::calculate()
                 {
 
                     // set variables
-                    value[k] = m_fieldInfo->value(FieldInfo::TransientInitialCondition).toDouble();
+                    value[k] = m_fieldInfo->snapshot().toDouble(FieldInfo::TransientInitialCondition);
                     dudx[k] = 0;
                     dudy[k] = 0;
                 }
                 else
                 {
-                    // point values
-                    Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(m_point.x, m_point.y, true);
+                    // point values (solution mesh could differ from the initial mesh)
+                    Hermes::Hermes2D::Element *element = Agros2D::solutionStore()->meshHash(ma.solutions().at(k)->get_mesh())->getElement(m_point.x, m_point.y);
+                    Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(m_point.x, m_point.y, true, element);
 
                     // set variables
                     value[k] = values->val[0];
@@ -124,3 +126,162 @@ void {{CLASS}}LocalValue::calculate()
         }
     }
 }
+
+{{CLASS}}LocalValueBatch::{{CLASS}}LocalValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                                                   const QVector<Point> &points)
+    : LocalValueBatch(fieldInfo, timeStep, adaptivityStep, solutionType, points)
+{
+    calculate();
+}
+
+void {{CLASS}}LocalValueBatch::calculate()
+{
+    int numberOfSolutions = m_fieldInfo->numberOfSolutions();
+    int numberOfPoints = m_points.size();
+
+    m_values.clear();
+    m_found.fill(false, numberOfPoints);
+
+    FieldSolutionID fsid(m_fieldInfo, m_timeStep, m_adaptivityStep, m_solutionType);
+    // check existence
+    if (!Agros2D::solutionStore()->contains(fsid))
+        return;
+
+    MultiArray<double> ma = Agros2D::solutionStore()->multiArray(fsid);
+
+    // update time functions
+    if (!Agros2D::problem()->isSolving() && m_fieldInfo->analysisType() == AnalysisType_Transient)
+    {
+       Module::updateTimeFunctions(Agros2D::problem()->timeStepToTotalTime(m_timeStep));
+    }
+
+    if (!Agros2D::problem()->isSolved())
+        return;
+
+    AnalysisType analysisType = m_fieldInfo->analysisType();
+    CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+    bool initialCondition = (analysisType == AnalysisType_Transient) && (m_timeStep == 0);
+
+    // elements in the initial mesh (markers)
+    QVector<MeshHash::Location> locations = Agros2D::solutionStore()->meshHash(m_fieldInfo->initialMesh())->locate(m_points);
+
+    // elements in the solution meshes (solution mesh could differ from the initial mesh, meshes are usually shared)
+    QMap<Hermes::Hermes2D::Mesh *, QVector<MeshHash::Location> > meshLocations;
+    QVector<const QVector<MeshHash::Location> *> solutionLocations(numberOfSolutions);
+    if (!initialCondition)
+    {
+        for (int k = 0; k < numberOfSolutions; k++)
+        {
+            Hermes::Hermes2D::MeshSharedPtr mesh = ma.solutions().at(k)->get_mesh();
+            if (!meshLocations.contains(mesh.get()))
+                meshLocations[mesh.get()] = Agros2D::solutionStore()->meshHash(mesh)->locate(m_points);
+        }
+        for (int k = 0; k < numberOfSolutions; k++)
+            solutionLocations[k] = &meshLocations[ma.solutions().at(k)->get_mesh().get()];
+    }
+
+    // result arrays
+    QList<LocalPointValues *> variables;
+    {{#VARIABLE_SOURCE}}
+    if ((analysisType == {{ANALYSIS_TYPE}}) && (coordinateType == {{COORDINATE_TYPE}}))
+        variables.append(&m_values[QLatin1String("{{VARIABLE}}")]);
+    {{/VARIABLE_SOURCE}}
+    foreach (LocalPointValues *values, variables)
+    {
+        values->scalar.fill(0.0, numberOfPoints);
+        values->vectorX.fill(0.0, numberOfPoints);
+        values->vectorY.fill(0.0, numberOfPoints);
+    }
+
+    {{#SPECIAL_FUNCTION_SOURCE}}
+    QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};
+    if(m_fieldInfo->functionUsedInAnalysis("{{SPECIAL_FUNCTION_ID}}"))
+        {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));
+    {{/SPECIAL_FUNCTION_SOURCE}}
+
+    // materials are looked up only when marker changes
+    SceneMaterial *material = NULL;
+    int elementMarker = -1;
+    {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = NULL;
+    {{/VARIABLE_MATERIAL}}
+
+    QVector<double> buffer(3 * numberOfSolutions);
+    double *value = buffer.data();
+    double *dudx = value + numberOfSolutions;
+    double *dudy = dudx + numberOfSolutions;
+
+    for (int i = 0; i < numberOfPoints; i++)
+    {
+        Hermes::Hermes2D::Element *e = locations[i].element;
+        if (!e)
+            continue;
+
+        double x = m_points[i].x;
+        double y = m_points[i].y;
+
+        if (e->marker != elementMarker || !material)
+        {
+            // find marker
+            elementMarker = e->marker;
+            material = m_fieldInfo->elementMaterial(elementMarker);
+
+            // label outside the field (LABEL_OUTSIDE_FIELD) or without material, same as LocalValue::calculate
+            if (!material || material->isNone())
+            {
+                material = NULL;
+                m_found[i] = false;
+                continue;
+            }
+
+            {{#VARIABLE_MATERIAL}}material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
+            {{/VARIABLE_MATERIAL}}
+        }
+
+        bool found = true;
+        for (int k = 0; k < numberOfSolutions; k++)
+        {
+            if (initialCondition)
+            {
+                // set variables
+                value[k] = m_fieldInfo->snapshot().toDouble(FieldInfo::TransientInitialCondition);
+                dudx[k] = 0;
+                dudy[k] = 0;
+            }
+            else
+            {
+                Hermes::Hermes2D::Element *element = solutionLocations[k]->at(i).element;
+                if (!element)
+                {
+                    found = false;
+                    break;
+                }
+
+                Hermes::Hermes2D::Func<double> *values = ma.solutions().at(k)->get_pt_value(x, y, true, element);
+
+                // set variables
+                value[k] = values->val[0];
+                dudx[k] = values->dx[0];
+                dudy[k] = values->dy[0];
+
+                delete values;
+            }
+        }
+
+        if (!found)
+            continue;
+
+        m_found[i] = true;
+
+        // expressions
+        int variable = 0;
+        {{#VARIABLE_SOURCE}}
+        if ((analysisType == {{ANALYSIS_TYPE}}) && (coordinateType == {{COORDINATE_TYPE}}))
+        {
+            LocalPointValues *values = variables[variable++];
+            values->scalar[i] = {{EXPRESSION_SCALAR}};
+            values->vectorX[i] = {{EXPRESSION_VECTORX}};
+            values->vectorY[i] = {{EXPRESSION_VECTORY}};
+        }
+        {{/VARIABLE_SOURCE}}
+    }
+}
@@ -38,4 +38,13 @@ public:
     void calculate();
 };
 
+class {{CLASS}}LocalValueBatch : public LocalValueBatch
+{
+public:
+    {{CLASS}}LocalValueBatch(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType,
+                             const QVector<Point> &points);
+
+    void calculate();
+};
+
 #endif // {{ID}}_LOCALVALUE_H
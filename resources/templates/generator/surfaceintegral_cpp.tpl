@@ -38,23 +38,22 @@ public:
     {{CLASS}}SurfaceIntegralCalculator(const FieldInfo *fieldInfo, Hermes::Hermes2D::MeshFunctionSharedPtr<double> source_function, int number_of_integrals)
         : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_function, number_of_integrals), m_fieldInfo(fieldInfo)
     {
+        createKernels();
     }
 
     {{CLASS}}SurfaceIntegralCalculator(const FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
         : Hermes::Hermes2D::PostProcessing::SurfaceIntegralCalculator<double>(source_functions, number_of_integrals), m_fieldInfo(fieldInfo)
     {
+        createKernels();
     }
 
     virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
-        double *x = e->x;
-        double *y = e->y;
-
-        {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
-        {{/VARIABLE_MATERIAL}}
+        int elementMarker = e->elem_marker;
+        // markers outside of the material tables do not contribute
+        if ((elementMarker < 0) || (elementMarker >= m_materials.size())
+                || !m_materials[elementMarker] || m_materials[elementMarker]->isNone())
+            return;
 
         double **value = new double*[source_functions.size()];
         double **dudx = new double*[source_functions.size()];
@@ -68,13 +67,8 @@ public:
         }
 
         // expressions
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        {
-            for (int i = 0; i < n; i++)
-                result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
-        }
-        {{/VARIABLE_SOURCE}}
+        for (int k = 0; k < m_kernels.size(); k++)
+            (this->*m_kernels[k])(n, wt, value, dudx, dudy, e, elementMarker, result);
 
         delete [] value;
         delete [] dudx;
@@ -83,15 +77,101 @@ public:
 
     virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
     {
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-            result[{{POSITION}}] = Hermes::Ord(20);
-        {{/VARIABLE_SOURCE}}
+        for (int k = 0; k < m_orderKernels.size(); k++)
+            (this->*m_orderKernels[k])(fns, result);
+    }
+
+    // order derived from expression (increased by given number) or fixed order
+    void setOrder(bool automatic, int increase)
+    {
+        m_orderAutomatic = automatic;
+        m_orderIncrease = increase;
     }
 
 private:
     // field info
     const FieldInfo *m_fieldInfo;
+
+    // materials and material values indexed by hermes element marker
+    QVector<SceneMaterial *> m_materials;
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
+
+    // specialized kernels (integral, analysis and coordinate type) selected in constructor
+    typedef void ({{CLASS}}SurfaceIntegralCalculator::*Kernel)(int n, const double *wt, double **value, double **dudx, double **dudy,
+                                                  Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result);
+    QVector<Kernel> m_kernels;
+
+    // quadrature order
+    typedef void ({{CLASS}}SurfaceIntegralCalculator::*OrderKernel)(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result);
+    QVector<OrderKernel> m_orderKernels;
+    bool m_orderAutomatic;
+    int m_orderIncrease;
+
+    void createKernels()
+    {
+        m_orderAutomatic = true;
+        m_orderIncrease = 0;
+
+        m_materials = m_fieldInfo->materialTable();
+        {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->materialValueTable(QLatin1String("{{MATERIAL_VARIABLE}}"), m_materials);
+        {{/VARIABLE_MATERIAL}}
+
+        CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+        {{#VARIABLE_SOURCE}}
+        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (coordinateType == {{COORDINATE_TYPE}}))
+        {
+            m_kernels.append(&{{CLASS}}SurfaceIntegralCalculator::{{KERNEL}});
+            m_orderKernels.append(&{{CLASS}}SurfaceIntegralCalculator::{{KERNEL}}_order);
+        }
+        {{/VARIABLE_SOURCE}}
+    }
+
+    {{#VARIABLE_SOURCE}}
+    void {{KERNEL}}(int n, const double *wt, double **value, double **dudx, double **dudy,
+                    Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result)
+    {
+        double *x = e->x;
+        double *y = e->y;
+
+        {{#KERNEL_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}[elementMarker];
+        {{/KERNEL_MATERIAL}}{{#KERNEL_MATERIAL_NUMBER}}const double material_{{MATERIAL_VARIABLE}}_number = m_material_{{MATERIAL_VARIABLE}}[elementMarker]->number();
+        {{/KERNEL_MATERIAL_NUMBER}}
+        double sum = 0.0;
+        for (int i = 0; i < n; i++)
+            sum += wt[i] * ({{EXPRESSION}});
+        result[{{POSITION}}] += sum;
+    }
+
+    void {{KERNEL}}_order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result)
+    {
+        {{#ORDER_SOURCE}}
+        if (m_orderAutomatic)
+        {
+            IntegralOrderGeometry geometry;
+            IntegralOrderGeometry *e = &geometry;
+            Hermes::Ord *x = e->x;
+            Hermes::Ord *y = e->y;
+
+            QVector<Hermes::Ord *> value(source_functions.size());
+            QVector<Hermes::Ord *> dudx(source_functions.size());
+            QVector<Hermes::Ord *> dudy(source_functions.size());
+            for (int k = 0; k < source_functions.size(); k++)
+            {
+                value[k] = fns[k]->val;
+                dudx[k] = fns[k]->dx;
+                dudy[k] = fns[k]->dy;
+            }
+
+            int i = 0;
+            Hermes::Ord order = Hermes::Ord(0) + ({{ORDER_EXPRESSION}});
+            result[{{POSITION}}] = Hermes::Ord(qMin(order.get_order() + m_orderIncrease, INTEGRAL_ORDER_FIXED));
+            return;
+        }
+        {{/ORDER_SOURCE}}
+        result[{{POSITION}}] = Hermes::Ord(INTEGRAL_ORDER_FIXED);
+    }
+    {{/VARIABLE_SOURCE}}
 };
 
 {{CLASS}}SurfaceIntegral::{{CLASS}}SurfaceIntegral(const FieldInfo *fieldInfo, int timeStep, int adaptivityStep, SolutionMode solutionType)
@@ -136,9 +216,10 @@ void {{CLASS}}SurfaceIntegral::calculate()
 
         if (internalMarkers.size() > 0 || boundaryMarkers.size() > 0)
         {
-            {{CLASS}}SurfaceIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}});
-            double *internalValues = calc.calculate(internalMarkers);
-            double *boundaryValues = calc.calculate(boundaryMarkers);
+            IntegralOrderType orderType = (IntegralOrderType) Agros2D::problem()->setting()->value(ProblemSetting::Problem_IntegralOrder).toInt();
+
+            double *internalValues = calculateIntegrals<{{CLASS}}SurfaceIntegralCalculator>(orderType, ma.solutions(), internalMarkers, {{INTEGRAL_COUNT}});
+            double *boundaryValues = calculateIntegrals<{{CLASS}}SurfaceIntegralCalculator>(orderType, ma.solutions(), boundaryMarkers, {{INTEGRAL_COUNT}});
 
             {{#VARIABLE_SOURCE}}
             if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
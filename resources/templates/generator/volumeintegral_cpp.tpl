@@ -40,6 +40,8 @@ public:
     {
         {{#SPECIAL_FUNCTION_SOURCE}}
         {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));{{/SPECIAL_FUNCTION_SOURCE}}
+
+        createKernels();
     }
 
     {{CLASS}}VolumetricIntegralEggShellCalculator(const FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
@@ -47,18 +49,17 @@ public:
     {
         {{#SPECIAL_FUNCTION_SOURCE}}
         {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));{{/SPECIAL_FUNCTION_SOURCE}}
+
+        createKernels();
     }
 
     virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
-        double *x = e->x;
-        double *y = e->y;
-
-        {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
-        {{/VARIABLE_MATERIAL}}
+        int elementMarker = e->elem_marker;
+        // markers outside of the material tables do not contribute
+        if ((elementMarker < 0) || (elementMarker >= m_materials.size())
+                || !m_materials[elementMarker] || m_materials[elementMarker]->isNone())
+            return;
         // {{#SPECIAL_FUNCTION_SOURCE}}
         // QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};
         // if (m_fieldInfo->functionUsedInAnalysis("{{SPECIAL_FUNCTION_ID}}"))
@@ -77,13 +78,8 @@ public:
         }
 
         // expressions
-        {{#VARIABLE_SOURCE_EGGSHELL}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        {
-            for (int i = 0; i < n; i++)
-                result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
-        }
-        {{/VARIABLE_SOURCE_EGGSHELL}}
+        for (int k = 0; k < m_kernels.size(); k++)
+            (this->*m_kernels[k])(n, wt, value, dudx, dudy, e, elementMarker, result);
 
         delete [] value;
         delete [] dudx;
@@ -92,16 +88,102 @@ public:
 
     virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
     {
-        {{#VARIABLE_SOURCE_EGGSHELL}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-            result[{{POSITION}}] = Hermes::Ord(20);
-        {{/VARIABLE_SOURCE_EGGSHELL}}
+        for (int k = 0; k < m_orderKernels.size(); k++)
+            (this->*m_orderKernels[k])(fns, result);
+    }
+
+    // order derived from expression (increased by given number) or fixed order
+    void setOrder(bool automatic, int increase)
+    {
+        m_orderAutomatic = automatic;
+        m_orderIncrease = increase;
     }
 
 private:
     // field info
     const FieldInfo *m_fieldInfo;
 
+    // materials and material values indexed by hermes element marker
+    QVector<SceneMaterial *> m_materials;
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
+
+    // specialized kernels (integral, analysis and coordinate type) selected in constructor
+    typedef void ({{CLASS}}VolumetricIntegralEggShellCalculator::*Kernel)(int n, const double *wt, double **value, double **dudx, double **dudy,
+                                                  Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result);
+    QVector<Kernel> m_kernels;
+
+    // quadrature order
+    typedef void ({{CLASS}}VolumetricIntegralEggShellCalculator::*OrderKernel)(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result);
+    QVector<OrderKernel> m_orderKernels;
+    bool m_orderAutomatic;
+    int m_orderIncrease;
+
+    void createKernels()
+    {
+        m_orderAutomatic = true;
+        m_orderIncrease = 0;
+
+        m_materials = m_fieldInfo->materialTable();
+        {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->materialValueTable(QLatin1String("{{MATERIAL_VARIABLE}}"), m_materials);
+        {{/VARIABLE_MATERIAL}}
+
+        CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+        {{#VARIABLE_SOURCE_EGGSHELL}}
+        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (coordinateType == {{COORDINATE_TYPE}}))
+        {
+            m_kernels.append(&{{CLASS}}VolumetricIntegralEggShellCalculator::{{KERNEL}});
+            m_orderKernels.append(&{{CLASS}}VolumetricIntegralEggShellCalculator::{{KERNEL}}_order);
+        }
+        {{/VARIABLE_SOURCE_EGGSHELL}}
+    }
+
+    {{#VARIABLE_SOURCE_EGGSHELL}}
+    void {{KERNEL}}(int n, const double *wt, double **value, double **dudx, double **dudy,
+                    Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result)
+    {
+        double *x = e->x;
+        double *y = e->y;
+
+        {{#KERNEL_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}[elementMarker];
+        {{/KERNEL_MATERIAL}}{{#KERNEL_MATERIAL_NUMBER}}const double material_{{MATERIAL_VARIABLE}}_number = m_material_{{MATERIAL_VARIABLE}}[elementMarker]->number();
+        {{/KERNEL_MATERIAL_NUMBER}}
+        double sum = 0.0;
+        for (int i = 0; i < n; i++)
+            sum += wt[i] * ({{EXPRESSION}});
+        result[{{POSITION}}] += sum;
+    }
+
+    void {{KERNEL}}_order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result)
+    {
+        {{#ORDER_SOURCE}}
+        if (m_orderAutomatic)
+        {
+            IntegralOrderGeometry geometry;
+            IntegralOrderGeometry *e = &geometry;
+            Hermes::Ord *x = e->x;
+            Hermes::Ord *y = e->y;
+
+            QVector<Hermes::Ord *> value(source_functions.size());
+            QVector<Hermes::Ord *> dudx(source_functions.size());
+            QVector<Hermes::Ord *> dudy(source_functions.size());
+            for (int k = 0; k < source_functions.size(); k++)
+            {
+                value[k] = fns[k]->val;
+                dudx[k] = fns[k]->dx;
+                dudy[k] = fns[k]->dy;
+            }
+
+            int i = 0;
+            Hermes::Ord order = Hermes::Ord(0) + ({{ORDER_EXPRESSION}});
+            result[{{POSITION}}] = Hermes::Ord(qMin(order.get_order() + m_orderIncrease, INTEGRAL_ORDER_FIXED));
+            return;
+        }
+        {{/ORDER_SOURCE}}
+        result[{{POSITION}}] = Hermes::Ord(INTEGRAL_ORDER_FIXED);
+    }
+    {{/VARIABLE_SOURCE_EGGSHELL}}
+
     {{#SPECIAL_FUNCTION_SOURCE}}
     QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};{{/SPECIAL_FUNCTION_SOURCE}}
 };
@@ -114,6 +196,8 @@ public:
     {
         {{#SPECIAL_FUNCTION_SOURCE}}
         {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));{{/SPECIAL_FUNCTION_SOURCE}}
+
+        createKernels();
     }
 
     {{CLASS}}VolumetricIntegralCalculator(const FieldInfo *fieldInfo, Hermes::vector<Hermes::Hermes2D::MeshFunctionSharedPtr<double> > source_functions, int number_of_integrals)
@@ -121,19 +205,17 @@ public:
     {
         {{#SPECIAL_FUNCTION_SOURCE}}
         {{SPECIAL_FUNCTION_NAME}} = QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}>(new {{SPECIAL_EXT_FUNCTION_FULL_NAME}}(m_fieldInfo, 0));{{/SPECIAL_FUNCTION_SOURCE}}
+
+        createKernels();
     }
 
     virtual void integral(int n, double* wt, Hermes::Hermes2D::Func<double> **fns, Hermes::Hermes2D::Geom<double> *e, double* result)
     {
-        SceneLabel *label = Agros2D::scene()->labels->at(atoi(m_fieldInfo->initialMesh()->get_element_markers_conversion().get_user_marker(e->elem_marker).marker.c_str()));
-        SceneMaterial *material = label->marker(m_fieldInfo);
-
-        double *x = e->x;
-        double *y = e->y;
         int elementMarker = e->elem_marker;
-
-        {{#VARIABLE_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = material->valueNakedPtr(QLatin1String("{{MATERIAL_VARIABLE}}"));
-        {{/VARIABLE_MATERIAL}}
+        // markers outside of the material tables do not contribute
+        if ((elementMarker < 0) || (elementMarker >= m_materials.size())
+                || !m_materials[elementMarker] || m_materials[elementMarker]->isNone())
+            return;
         // {{#SPECIAL_FUNCTION_SOURCE}}
         // QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};
         // if (isInCalculation_{{SPECIAL_FUNCTION_ID}})
@@ -152,13 +234,8 @@ public:
         }
 
         // expressions
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-        {
-            for (int i = 0; i < n; i++)
-                result[{{POSITION}}] += wt[i] * ({{EXPRESSION}});
-        }
-        {{/VARIABLE_SOURCE}}
+        for (int k = 0; k < m_kernels.size(); k++)
+            (this->*m_kernels[k])(n, wt, value, dudx, dudy, e, elementMarker, result);
 
         delete [] value;
         delete [] dudx;
@@ -167,16 +244,102 @@ public:
 
     virtual void order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord* result)
     {
-        {{#VARIABLE_SOURCE}}
-        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
-            result[{{POSITION}}] = Hermes::Ord(20);
-        {{/VARIABLE_SOURCE}}
+        for (int k = 0; k < m_orderKernels.size(); k++)
+            (this->*m_orderKernels[k])(fns, result);
+    }
+
+    // order derived from expression (increased by given number) or fixed order
+    void setOrder(bool automatic, int increase)
+    {
+        m_orderAutomatic = automatic;
+        m_orderIncrease = increase;
     }
 
 private:
     // field info
     const FieldInfo *m_fieldInfo;
 
+    // materials and material values indexed by hermes element marker
+    QVector<SceneMaterial *> m_materials;
+    {{#VARIABLE_MATERIAL}}QVector<const Value *> m_material_{{MATERIAL_VARIABLE}};
+    {{/VARIABLE_MATERIAL}}
+
+    // specialized kernels (integral, analysis and coordinate type) selected in constructor
+    typedef void ({{CLASS}}VolumetricIntegralCalculator::*Kernel)(int n, const double *wt, double **value, double **dudx, double **dudy,
+                                                  Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result);
+    QVector<Kernel> m_kernels;
+
+    // quadrature order
+    typedef void ({{CLASS}}VolumetricIntegralCalculator::*OrderKernel)(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result);
+    QVector<OrderKernel> m_orderKernels;
+    bool m_orderAutomatic;
+    int m_orderIncrease;
+
+    void createKernels()
+    {
+        m_orderAutomatic = true;
+        m_orderIncrease = 0;
+
+        m_materials = m_fieldInfo->materialTable();
+        {{#VARIABLE_MATERIAL}}m_material_{{MATERIAL_VARIABLE}} = m_fieldInfo->materialValueTable(QLatin1String("{{MATERIAL_VARIABLE}}"), m_materials);
+        {{/VARIABLE_MATERIAL}}
+
+        CoordinateType coordinateType = Agros2D::problem()->config()->coordinateType();
+        {{#VARIABLE_SOURCE}}
+        if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (coordinateType == {{COORDINATE_TYPE}}))
+        {
+            m_kernels.append(&{{CLASS}}VolumetricIntegralCalculator::{{KERNEL}});
+            m_orderKernels.append(&{{CLASS}}VolumetricIntegralCalculator::{{KERNEL}}_order);
+        }
+        {{/VARIABLE_SOURCE}}
+    }
+
+    {{#VARIABLE_SOURCE}}
+    void {{KERNEL}}(int n, const double *wt, double **value, double **dudx, double **dudy,
+                    Hermes::Hermes2D::Geom<double> *e, int elementMarker, double *result)
+    {
+        double *x = e->x;
+        double *y = e->y;
+
+        {{#KERNEL_MATERIAL}}const Value *material_{{MATERIAL_VARIABLE}} = m_material_{{MATERIAL_VARIABLE}}[elementMarker];
+        {{/KERNEL_MATERIAL}}{{#KERNEL_MATERIAL_NUMBER}}const double material_{{MATERIAL_VARIABLE}}_number = m_material_{{MATERIAL_VARIABLE}}[elementMarker]->number();
+        {{/KERNEL_MATERIAL_NUMBER}}
+        double sum = 0.0;
+        for (int i = 0; i < n; i++)
+            sum += wt[i] * ({{EXPRESSION}});
+        result[{{POSITION}}] += sum;
+    }
+
+    void {{KERNEL}}_order(Hermes::Hermes2D::Func<Hermes::Ord> **fns, Hermes::Ord *result)
+    {
+        {{#ORDER_SOURCE}}
+        if (m_orderAutomatic)
+        {
+            IntegralOrderGeometry geometry;
+            IntegralOrderGeometry *e = &geometry;
+            Hermes::Ord *x = e->x;
+            Hermes::Ord *y = e->y;
+
+            QVector<Hermes::Ord *> value(source_functions.size());
+            QVector<Hermes::Ord *> dudx(source_functions.size());
+            QVector<Hermes::Ord *> dudy(source_functions.size());
+            for (int k = 0; k < source_functions.size(); k++)
+            {
+                value[k] = fns[k]->val;
+                dudx[k] = fns[k]->dx;
+                dudy[k] = fns[k]->dy;
+            }
+
+            int i = 0;
+            Hermes::Ord order = Hermes::Ord(0) + ({{ORDER_EXPRESSION}});
+            result[{{POSITION}}] = Hermes::Ord(qMin(order.get_order() + m_orderIncrease, INTEGRAL_ORDER_FIXED));
+            return;
+        }
+        {{/ORDER_SOURCE}}
+        result[{{POSITION}}] = Hermes::Ord(INTEGRAL_ORDER_FIXED);
+    }
+    {{/VARIABLE_SOURCE}}
+
     {{#SPECIAL_FUNCTION_SOURCE}}
     QSharedPointer<{{SPECIAL_EXT_FUNCTION_FULL_NAME}}> {{SPECIAL_FUNCTION_NAME}};{{/SPECIAL_FUNCTION_SOURCE}}
 };
@@ -207,6 +370,8 @@ void {{CLASS}}VolumeIntegral::calculate()
             Module::updateTimeFunctions(timeLevels[m_timeStep]);
         }
 
+        IntegralOrderType orderType = (IntegralOrderType) Agros2D::problem()->setting()->value(ProblemSetting::Problem_IntegralOrder).toInt();
+
         Hermes::vector<std::string> markers;
         for (int i = 0; i < Agros2D::scene()->labels->count(); i++)
         {
@@ -217,8 +382,7 @@ void {{CLASS}}VolumeIntegral::calculate()
 
         if (markers.size() > 0)
         {
-            {{CLASS}}VolumetricIntegralCalculator calc(m_fieldInfo, ma.solutions(), {{INTEGRAL_COUNT}});
-            double *values = calc.calculate(markers);
+            double *values = calculateIntegrals<{{CLASS}}VolumetricIntegralCalculator>(orderType, ma.solutions(), markers, {{INTEGRAL_COUNT}});
 
             {{#VARIABLE_SOURCE}}
             if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
@@ -250,8 +414,7 @@ void {{CLASS}}VolumeIntegral::calculate()
                     slns.push_back(ma.solutions().at(i));
                 slns.push_back(eggShell);
 
-                {{CLASS}}VolumetricIntegralEggShellCalculator calcEggShell(m_fieldInfo, slns, {{INTEGRAL_COUNT_EGGSHELL}});
-                double *valuesEggShell = calcEggShell.calculate(markersInverted);
+                double *valuesEggShell = calculateIntegrals<{{CLASS}}VolumetricIntegralEggShellCalculator>(orderType, slns, markersInverted, {{INTEGRAL_COUNT_EGGSHELL}});
 
                 {{#VARIABLE_SOURCE_EGGSHELL}}
                 if ((m_fieldInfo->analysisType() == {{ANALYSIS_TYPE}}) && (Agros2D::problem()->config()->coordinateType() == {{COORDINATE_TYPE}}))
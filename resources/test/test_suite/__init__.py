@@ -107,6 +107,7 @@ fields.heat.TestHeatPlanar,
 fields.heat.TestHeatAxisymmetric,
 fields.heat.TestHeatNonlinPlanar,
 fields.heat.TestHeatTransientAxisymmetric,
+fields.heat.TestHeatTransientTimeErrorEstimator,
 # magnetic field
 fields.magnetic_steady.TestMagneticPlanar,
 fields.magnetic_steady.TestMagneticAxisymmetric,
@@ -132,9 +133,11 @@ adaptivity.adaptivity.TestAdaptivityMagneticProfileConductor,
 adaptivity.adaptivity.TestAdaptivityRF_TE,
 adaptivity.adaptivity.TestAdaptivityHLenses,
 adaptivity.adaptivity.TestAdaptivityPAndHCoupled,
+adaptivity.adaptivity.TestAdaptivityWarmStart,
 # particle tracing
 particle_tracing.particle_tracing.TestParticleTracingPlanar,
 particle_tracing.particle_tracing.TestParticleTracingAxisymmetric,
+particle_tracing.particle_tracing.TestParticleTracingInteraction,
 # coupled fields
 coupled_problems.basic_coupled_problems.TestCoupledProblemsBasic1WeakWeak,
 coupled_problems.basic_coupled_problems.TestCoupledProblemsBasic1WeakHard,
@@ -153,5 +156,6 @@ coupled_problems.unrealistic_coupled_problems.TestCoupledProblemsManyDomainsWeak
 coupled_problems.unrealistic_coupled_problems.TestCoupledProblemsManyDomainsHardWeak,
 coupled_problems.unrealistic_coupled_problems.TestCoupledProblemsManyDomainsHardHard,
 # core
-core.matrix_solvers.TestInternalMatrixSolvers
+core.matrix_solvers.TestInternalMatrixSolvers,
+core.matrix_solvers.TestExternalSolverDaemon
 ] + test_script
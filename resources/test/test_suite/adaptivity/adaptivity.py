@@ -482,6 +482,55 @@ class TestAdaptivityPAndHCoupled(Agros2DTestCase):
         self.value_test("Temperature", point_heat["T"], 1.277e+03, 0.006)
         point_mag = self.magnetic.local_values(2.920e-01, 1.333e-01)
         self.value_test("Flux density", point_mag["Br"], 5.893e-01, 0.025)
+
+class TestAdaptivityWarmStart(Agros2DTestCase):
+    def solve(self, warm_start):
+        problem = agros2d.problem(clear = True)
+        problem.coordinate_type = "planar"
+        problem.mesh_type = "triangle"
+        
+        # disable view
+        agros2d.view.mesh.disable()
+        agros2d.view.post2d.disable()
+        
+        # nonlinear heat transfer, warm start is the initial guess of the Newton solver
+        self.heat = agros2d.field("heat")
+        self.heat.analysis_type = "steadystate"
+        self.heat.polynomial_order = 1
+        self.heat.solver = "newton"
+        self.heat.solver_parameters['residual'] = 1e-8
+        self.heat.adaptivity_type = "hp-adaptivity"
+        self.heat.adaptivity_parameters['steps'] = 5
+        self.heat.adaptivity_parameters['tolerance'] = 0.1
+        self.heat.adaptivity_parameters['error_calculator'] = "h1"
+        self.heat.adaptivity_parameters['warm_start'] = warm_start
+        
+        self.heat.add_boundary("Cold", "heat_temperature", {"heat_temperature" : 300})
+        self.heat.add_boundary("Hot", "heat_temperature", {"heat_temperature" : 600})
+        self.heat.add_boundary("Insulated", "heat_heat_flux", {"heat_heat_flux" : 0})
+        self.heat.add_material("Material", {"heat_conductivity" : { "value" : 50, "x" : [200, 400, 600, 800], "y" : [50, 30, 20, 15] },
+                                            "heat_volume_heat" : 1e5})
+        
+        geometry = agros2d.geometry
+        geometry.add_edge(0, 0, 1, 0, boundaries = {"heat" : "Cold"})
+        geometry.add_edge(1, 0, 1, 0.5, boundaries = {"heat" : "Insulated"})
+        geometry.add_edge(1, 0.5, 0.5, 0.5, boundaries = {"heat" : "Insulated"})
+        geometry.add_edge(0.5, 0.5, 0.5, 1, boundaries = {"heat" : "Insulated"})
+        geometry.add_edge(0.5, 1, 0, 1, boundaries = {"heat" : "Hot"})
+        geometry.add_edge(0, 1, 0, 0, boundaries = {"heat" : "Insulated"})
+        geometry.add_label(0.25, 0.25, materials = {"heat" : "Material"})
+        
+        problem.solve()
+        
+        return (self.heat.local_values(0.45, 0.55)["T"], self.heat.adaptivity_info()['dofs'])
+
+    def test_values(self):
+        (value, dofs) = self.solve(False)
+        (value_warm_start, dofs_warm_start) = self.solve(True)
+        
+        # warm start changes only the initial guess
+        self.value_test("Temperature", value_warm_start, value, 1e-5)
+        self.assertEqual(dofs_warm_start, dofs)
         
 if __name__ == '__main__':        
     import unittest as ut
@@ -495,5 +544,6 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestAdaptivityRF_TE))  
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestAdaptivityHLenses))  
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestAdaptivityPAndHCoupled))  
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestAdaptivityWarmStart))
       
     suite.run(result)
\ No newline at end of file
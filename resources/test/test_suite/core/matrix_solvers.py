@@ -161,10 +161,83 @@ class TestInternalMatrixSolvers(Agros2DTestCase):
         self.assertTrue(np.allclose(self.reference_rhs, external_rhs, rtol=1e-15, atol=1e-10), 
                         "EXTERNAL rhs failed.")        
 
+class TestExternalSolverDaemon(Agros2DTestCase):
+    @classmethod
+    def setUpClass(self):
+        self.external_solver_daemon = agros2d.options.external_solver_daemon
+
+    @classmethod
+    def tearDownClass(self):
+        agros2d.options.external_solver_daemon = self.external_solver_daemon
+
+    def solve(self, solver, daemon):
+        agros2d.options.external_solver_daemon = daemon
+
+        TestInternalMatrixSolvers.model(solver)
+        electrostatic = agros2d.field("electrostatic")
+
+        return electrostatic.local_values(0.0284191, 0.123601)["V"], electrostatic.volume_integrals([1])["We"]
+
+    def test_daemon(self):
+        V, We = self.solve("umfpack", False)
+
+        # file exchange and a new process per solve
+        solves = agros2d.external_solver_daemon_statistics()["solves"]
+        V_file, We_file = self.solve("external", False)
+        self.value_test("Potential (files)", V_file, V)
+        self.value_test("Energy (files)", We_file, We)
+        self.assertEqual(agros2d.external_solver_daemon_statistics()["solves"], solves)
+
+        # persistent process, second solve is served by the running daemon
+        for i in range(2):
+            solves = agros2d.external_solver_daemon_statistics()["solves"]
+            V_daemon, We_daemon = self.solve("external", True)
+            self.value_test("Potential (daemon)", V_daemon, V)
+            self.value_test("Energy (daemon)", We_daemon, We)
+            self.assertEqual(agros2d.external_solver_daemon_statistics()["solves"], solves + 1)
+
+    def transient(self, solver, reuse):
+        problem = agros2d.problem(clear = True)
+        problem.time_step_method = "fixed"
+        problem.time_total = 1e2
+        problem.time_steps = 10
+
+        # constant matrix, one solver instance (daemon client) for all time steps
+        heat = agros2d.field("heat")
+        heat.analysis_type = "transient"
+        heat.matrix_solver = solver
+        heat.matrix_solver_parameters['reuse'] = reuse
+        heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10,
+                                                           "heat_convection_external_temperature" : 293})
+        heat.add_material("Copper", {"heat_conductivity" : 200, "heat_volume_heat" : 1e3,
+                                     "heat_density" : 8700, "heat_specific_heat" : 385})
+
+        agros2d.geometry.add_rect(0, 0, 1, 1, boundaries = {"heat" : "Convection"}, materials = {"heat" : "Copper"})
+        problem.solve()
+
+        return heat.local_values(0.3, 0.6)["T"]
+
+    def test_daemon_factorization_reuse(self):
+        agros2d.options.external_solver_daemon = False
+        T = self.transient("umfpack", "disabled")
+
+        agros2d.options.external_solver_daemon = True
+        statistics = agros2d.external_solver_daemon_statistics()
+        T_daemon = self.transient("external", "factorization")
+        self.value_test("Temperature (daemon)", T_daemon, T)
+
+        # every step is served by the daemon, unchanged matrix keeps its factorization
+        solves = agros2d.external_solver_daemon_statistics()["solves"] - statistics["solves"]
+        reused = agros2d.external_solver_daemon_statistics()["reused_factorizations"] - statistics["reused_factorizations"]
+        self.assertGreaterEqual(solves, 10)
+        self.assertGreaterEqual(reused, 1)
+        self.assertLess(reused, solves)
+
 if __name__ == '__main__':        
     import unittest as ut
     
     suite = ut.TestSuite()
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestInternalMatrixSolvers))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestExternalSolverDaemon))
     suite.run(result)
\ No newline at end of file
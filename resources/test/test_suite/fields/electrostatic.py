@@ -81,7 +81,42 @@ class TestElectrostaticPlanar(Agros2DTestCase):
         # surface integral
         surface_integrals = self.electrostatic.surface_integrals([0, 1, 2, 3])
         self.value_test("Electric charge", surface_integrals["Q"], 1.048981e-7)
-            
+
+    def test_values_batch(self):
+        x = [13.257584, 3.0, 10.5, 2.5, 30.0]
+        y = [11.117738, 20.0, 15.0, 1.5, 30.0]
+        values = self.electrostatic.local_values_batch(x, y)
+
+        self.assertEqual(len(values["V"]), len(x))
+        self.value_test("Scalar potential", values["V"][0], 1111.544825)
+        self.value_test("Electric field - y", values["Ey"][0], -109.204896)
+        for i in range(len(x) - 2):
+            point = self.electrostatic.local_values(x[i], y[i])
+            for key in point.keys():
+                self.value_test("{0} ({1}, {2})".format(key, x[i], y[i]), values[key][i], point[key])
+
+        # point in the label without material (not in the field) and point outside the domain
+        for i in [-2, -1]:
+            for key in values.keys():
+                self.assertTrue(values[key][i] != values[key][i])
+
+    def test_sweep(self):
+        parameters = { "U" : ("boundary", "electrostatic", "U = 1000 V", "electrostatic_potential"),
+                       "eps" : ("material", "electrostatic", "Dieletric", "electrostatic_permittivity") }
+        points = agros2d.sweep_grid({ "U" : [1000, 2000], "eps" : [3, 6] })
+        results = { "V" : ("local_value", "electrostatic", 13.257584, 11.117738, "V"),
+                    "We" : ("volume_integral", "electrostatic", [1], "We") }
+
+        for workers in [1, 2]:
+            table = agros2d.problem().sweep(parameters, points, results, workers)
+            self.assertEqual(len(table), len(points))
+            for row in table:
+                if (row["U"] == 1000 and row["eps"] == 3):
+                    self.value_test("Scalar potential ({0} workers)".format(workers), row["V"], 1111.544825)
+                    self.value_test("Energy ({0} workers)".format(workers), row["We"], 1.307484e-7)
+                else:
+                    self.assertNotAlmostEqual(row["V"], 1111.544825, places = 3)
+
 class TestElectrostaticAxisymmetric(Agros2DTestCase):
     def setUp(self):       
         # model
@@ -156,6 +191,18 @@ class TestElectrostaticAxisymmetric(Agros2DTestCase):
         surface = self.electrostatic.surface_integrals([1, 12])
         self.value_test("Electric charge", surface["Q"], -1.291778e-9)
 
+    def test_integral_order(self):
+        problem = agros2d.problem()
+        for order in ["fixed", "automatic", "adaptive"]:
+            problem.integral_order = order
+
+            volume = self.electrostatic.volume_integrals([0, 1, 2])
+            self.value_test("Energy ({0})".format(order), volume["We"], 1.799349e-8)
+            surface = self.electrostatic.surface_integrals([1, 12])
+            self.value_test("Electric charge ({0})".format(order), surface["Q"], -1.291778e-9)
+
+        problem.integral_order = "automatic"
+
 if __name__ == '__main__':        
     import unittest as ut
 
@@ -352,7 +352,84 @@ class TestHeatTransientAxisymmetric(Agros2DTestCase):
         # surface integral
         surface = self.heat.surface_integrals([26])
         #self.value_test("Heat flux", surface["f"], 0.032866, error = 0.05)  #todo: jaky heat flux v comsolu pouzit?
-        
+
+    def test_time_series(self):
+        import os, tempfile
+
+        file_name = tempfile.mktemp(suffix = ".csv")
+        series = self.heat.time_series(points = [[0.00503, 0.134283], [1.0, 1.0]], volume_integrals = [[3]], file_name = file_name)
+
+        times = agros2d.problem().time_steps_total()
+        self.assertEqual(len(series["t"]), len(times))
+        self.value_test("Initial temperature", series["p0_T"][0], 20.0)
+        self.value_test("Temperature", series["p0_T"][-1], 72.88058)
+        self.value_test("Temperature (volume)", series["v0_T"][-1], 0.00458)
+        self.assertTrue(series["p1_T"][-1] != series["p1_T"][-1])
+
+        # same values as local values in the particular time step
+        self.value_test("Temperature (time step)", series["p0_T"][10], self.heat.local_values(0.00503, 0.134283, time_step = 10)["T"])
+
+        # csv export
+        with open(file_name) as f:
+            lines = f.readlines()
+        os.remove(file_name)
+        self.assertEqual(len(lines), len(times) + 1)
+        self.assertTrue("p0_T" in lines[0].split(";"))
+
+class TestHeatTransientTimeErrorEstimator(Agros2DTestCase):
+    def solve(self, estimator, tolerance):
+        # NAFEMS benchmark (see BenchmarkHeatTransientAxisymmetric)
+        problem = agros2d.problem(clear = True)
+        problem.coordinate_type = "axisymmetric"
+        problem.mesh_type = "triangle"
+
+        problem.time_step_method = "adaptive"
+        problem.time_method_order = 2
+        problem.time_method_error_estimator = estimator
+        problem.time_method_tolerance = tolerance
+        problem.time_steps = 20
+        problem.time_total = 190
+
+        # disable view
+        agros2d.view.mesh.disable()
+        agros2d.view.post2d.disable()
+
+        self.heat = agros2d.field("heat")
+        self.heat.analysis_type = "transient"
+        self.heat.transient_initial_condition = 0
+        self.heat.number_of_refinements = 1
+        self.heat.polynomial_order = 3
+        self.heat.solver = "linear"
+
+        self.heat.add_boundary("Symmetry", "heat_heat_flux", {"heat_heat_flux" : 0})
+        self.heat.add_boundary("Temperature", "heat_temperature", {"heat_temperature" : 1000})
+        self.heat.add_material("Material", {"heat_conductivity" : 52, "heat_density" : 7850, "heat_specific_heat" : 460})
+
+        geometry = agros2d.geometry
+        geometry.add_edge(0, 0.4, 0, 0, boundaries = {"heat" : "Symmetry"})
+        geometry.add_edge(0.3, 0.4, 0.3, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0.3, 0, 0, 0, boundaries = {"heat" : "Temperature"})
+        geometry.add_edge(0, 0.4, 0.3, 0.4, boundaries = {"heat" : "Temperature"})
+        geometry.add_label(0.151637, 0.112281, materials = {"heat" : "Material"}, area = 0.01)
+
+        problem.solve()
+
+        return (self.heat.local_values(0.1, 0.3)["T"], problem.time_steps_length())
+
+    def test_embedded(self):
+        (value_lower_order, steps_lower_order) = self.solve("lower_order", 1.0)
+        (value, steps) = self.solve("embedded", 1.0)
+        (value_tight, steps_tight) = self.solve("embedded", 0.1)
+
+        # same accuracy as the lower order estimator
+        self.value_test("Temperature", value, value_lower_order, 0.002)
+        self.value_test("Temperature", value_tight, value_lower_order, 0.002)
+
+        # step length is controlled by the estimator (not fixed, tighter tolerance needs more steps)
+        self.assertTrue(len(set([round(length, 6) for length in steps])) > 1)
+        self.assertTrue(len(steps_tight) > len(steps))
+        self.assertTrue(abs(sum(steps) - 190) < 1e-6)
+
 if __name__ == '__main__':        
     import unittest as ut
 
@@ -363,4 +440,5 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestHeatNonlinPlanar))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestHeatTransientAxisymmetric))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(BenchmarkHeatTransientAxisymmetric))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestHeatTransientTimeErrorEstimator))
     suite.run(result)
\ No newline at end of file
@@ -176,6 +176,128 @@ class TestParticleTracingAxisymmetric(Agros2DTestCase):
         
         self.value_test("Particle position", x[0][-1], 0.004637)        
 
+class TestParticleTracingInteraction(Agros2DTestCase):
+    def setUp(self): 
+        # problem
+        problem = agros2d.problem(clear = True)
+        problem.coordinate_type = "planar"
+        problem.mesh_type = "triangle"
+        
+        # disable view
+        agros2d.view.mesh.disable()
+        agros2d.view.post2d.disable()
+        
+        # field free domain
+        electrostatic = agros2d.field("electrostatic")
+        electrostatic.analysis_type = "steadystate"
+        electrostatic.number_of_refinements = 0
+        electrostatic.polynomial_order = 1
+        electrostatic.adaptivity_type = "disabled"
+        electrostatic.solver = "linear"
+        
+        electrostatic.add_boundary("Ground", "electrostatic_potential", {"electrostatic_potential" : 0})
+        electrostatic.add_material("Air", {"electrostatic_permittivity" : 1, "electrostatic_charge_density" : 0})
+        
+        geometry = agros2d.geometry
+        geometry.add_edge(-0.5, 0, 0.5, 0, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_edge(0.5, 0, 0.5, 1.2, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_edge(0.5, 1.2, -0.5, 1.2, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_edge(-0.5, 1.2, -0.5, 0, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_label(0, 0.6, materials = {"electrostatic" : "Air"})
+        
+        problem.solve()
+        
+    def deflection(self, charge, magnetic, opening_angle = 0):
+        # two equal charges moving side by side in parallel
+        tracing = agros2d.particle_tracing
+        tracing.drag_force_coefficient = 0
+        tracing.include_relativistic_correction = False
+        tracing.reflect_on_different_material = False
+        tracing.reflect_on_boundary = False
+        tracing.maximum_number_of_steps = 1e4
+        tracing.maximum_relative_error = 1e-6
+        tracing.electrostatic_interaction = True
+        tracing.magnetic_interaction = magnetic
+        tracing.interaction_opening_angle = opening_angle
+        
+        tracing.solve(initial_positions = [(0.01, 0.1), (-0.01, 0.1)],
+                      initial_velocities = [(0, self.velocity), (0, self.velocity)],
+                      particle_charges = [charge, charge],
+                      particle_masses = [1e-14, 1e-14])
+        x, y, z = tracing.positions()
+        
+        return self.position(x[0], y[0])
+        
+    def position(self, x, y):
+        # x at y = 1.0
+        for i in range(1, len(y)):
+            if y[i] >= 1.0:
+                t = (1.0 - y[i-1]) / (y[i] - y[i-1])
+                return x[i-1] + t * (x[i] - x[i-1])
+        
+        self.fail("Particle did not reach y = 1.0")
+        
+    def group_deflections(self, opening_angle):
+        # light particles (3 x 3) deflected by a distant group of heavy charged particles (5 x 5),
+        # the heavy group lies in a non-leaf node of the tree and is replaced by its charge center
+        tracing = agros2d.particle_tracing
+        tracing.drag_force_coefficient = 0
+        tracing.include_relativistic_correction = False
+        tracing.reflect_on_different_material = False
+        tracing.reflect_on_boundary = False
+        tracing.maximum_number_of_steps = 1e4
+        tracing.maximum_relative_error = 1e-6
+        tracing.electrostatic_interaction = True
+        tracing.magnetic_interaction = False
+        tracing.interaction_opening_angle = opening_angle
+        
+        velocity = 5e4
+        positions = []
+        velocities = []
+        charges = []
+        masses = []
+        for i in range(3):
+            for j in range(3):
+                positions.append((-0.25 + 0.02 * (i - 1), 0.1 + 0.02 * (j - 1)))
+                velocities.append((0, velocity))
+                charges.append(1e-11)
+                masses.append(1e-14)
+        for i in range(5):
+            for j in range(5):
+                positions.append((0.35 + 0.02 * (i - 2), 0.1 + 0.02 * (j - 2)))
+                velocities.append((0, velocity))
+                charges.append(1e-6)
+                masses.append(1.0)
+        
+        tracing.solve(initial_positions = positions,
+                      initial_velocities = velocities,
+                      particle_charges = charges,
+                      particle_masses = masses)
+        x, y, z = tracing.positions()
+        
+        return [self.position(x[i], y[i]) - positions[i][0] for i in range(9)]
+        
+    def test_magnetic_interaction(self):
+        # magnetic attraction reduces the repulsion by (1 - (v/c)^2), v = 0.6 c
+        self.velocity = 0.6 * 299792458.0
+        charge = 1e-6
+        
+        electric = self.deflection(charge, False)
+        equivalent = self.deflection(charge * 0.8, False)
+        
+        self.value_test("Particle position (direct)", self.deflection(charge, True), equivalent, 0.005)
+        self.value_test("Particle position (tree)", self.deflection(charge, True, 0.5), equivalent, 0.005)
+        self.assertTrue(electric > equivalent)
+        
+    def test_far_field(self):
+        # Barnes-Hut far field approximation against the direct summation
+        direct = self.group_deflections(0)
+        tree = self.group_deflections(1.0)
+        
+        for i in range(len(direct)):
+            self.assertTrue(direct[i] < -0.05)
+            self.value_test("Particle deflection (far field, particle {0})".format(i), tree[i], direct[i], 0.01)
+
 if __name__ == '__main__':        
     import unittest as ut
     
@@ -183,4 +305,5 @@ if __name__ == '__main__':
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestParticleTracingPlanar))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestParticleTracingAxisymmetric))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestParticleTracingInteraction))
     suite.run(result)            
\ No newline at end of file
@@ -74,6 +74,18 @@ class Agros2DTestResult(ut.TestResult):
               "{0}".format("FAILURE".rjust(10, ".")))        
         print(err[1])      
         
+    def addSkip(self, test, reason):
+        ut.TestResult.addSkip(self, test, reason)
+
+        cls = test.id().split(".")[-2]
+        tst = test.id().split(".")[-1]
+        id = cls + "." + tst
+
+        print("{0}".format(id.ljust(60, "."))),
+        print("{0:08.2f}".format(0).rjust(15, " ") + " ms " +
+              "{0}".format("SKIPPED".rjust(10, ".")))
+        print(reason)
+
     def report(self):
         return self.output
 
@@ -364,6 +364,16 @@ class TestFieldMatrixSolver(Agros2DTestCase):
         with self.assertRaises(IndexError):
             self.field.matrix_solver_parameters['iterations'] = 1.1e4
 
+    """ reuse """
+    def test_reuse(self):
+        for reuse in ['disabled', 'structure', 'factorization']:
+            self.field.matrix_solver_parameters['reuse'] = reuse
+            self.assertEqual(self.field.matrix_solver_parameters['reuse'], reuse)
+
+    def test_set_wrong_reuse(self):
+        with self.assertRaises(ValueError):
+            self.field.matrix_solver_parameters['reuse'] = 'wrong_reuse'
+
 class TestFieldAdaptivity(Agros2DTestCase):
     def setUp(self):
         self.problem = a2d.problem(clear = True)
@@ -452,6 +462,11 @@ class TestFieldAdaptivity(Agros2DTestCase):
         self.field.adaptivity_parameters['finer_reference_solution'] = True
         self.assertEqual(self.field.adaptivity_parameters['finer_reference_solution'], True)
 
+    """ warm_start """
+    def test_warm_start(self):
+        self.field.adaptivity_parameters['warm_start'] = True
+        self.assertEqual(self.field.adaptivity_parameters['warm_start'], True)
+
     """ transient_redone_steps """
     def test_transient_redone_steps(self):
         self.field.adaptivity_parameters['transient_redone_steps'] = 10
@@ -512,6 +527,91 @@ class TestFieldLocalValues(Agros2DTestCase):
         with self.assertRaises(RuntimeError):
             self.field.local_values(-1, -1)
 
+class TestFieldExpressions(Agros2DTestCase):
+    def setUp(self):
+        # user variables live in the global dictionary of the engine
+        import __main__
+        self.main = __main__
+        self.main.one = 1.0
+
+    def tearDown(self):
+        del self.main.one
+
+    def model(self, coordinate_type, expression):
+        self.problem = a2d.problem(clear = True)
+        self.problem.coordinate_type = coordinate_type
+
+        self.field = a2d.field("electrostatic")
+        self.field.number_of_refinements = 1
+        self.field.polynomial_order = 2
+        self.field.add_boundary("Ground", "electrostatic_potential", {"electrostatic_potential" : 0})
+        self.field.add_boundary("Source", "electrostatic_potential", {"electrostatic_potential" : { "expression" : expression }})
+        self.field.add_boundary("Neumann", "electrostatic_surface_charge_density", {"electrostatic_surface_charge_density" : 0})
+        self.field.add_material("Air", {"electrostatic_permittivity" : 1})
+
+        geometry = a2d.geometry
+        geometry.add_edge(0.1, 0, 1.1, 0, boundaries = {"electrostatic" : "Ground"})
+        geometry.add_edge(1.1, 0, 1.1, 1, boundaries = {"electrostatic" : "Neumann"})
+        geometry.add_edge(1.1, 1, 0.1, 1, boundaries = {"electrostatic" : "Source"})
+        geometry.add_edge(0.1, 1, 0.1, 0, boundaries = {"electrostatic" : "Neumann"})
+        geometry.add_label(0.6, 0.5, materials = {"electrostatic" : "Air"})
+
+    def permittivity(self, expression):
+        # permittivity is evaluated once, when the value is set
+        self.model("planar", "0")
+        self.field.modify_material("Air", {"electrostatic_permittivity" : { "expression" : expression }})
+        self.problem.solve()
+        return self.field.local_values(0.6, 0.5)["epsr"]
+
+    def python(self, expression):
+        return eval(expression, vars(self.main))
+
+    def potential(self, coordinate_type, expression):
+        self.model(coordinate_type, expression)
+        self.problem.solve()
+        return self.field.local_values(0.6, 0.5)["V"]
+
+    def test_constants(self):
+        for expression in ["2*pi + e", "7/2 + 1", "2**3**0.5", "-2**2 + 10", "(1 < 2) + 3"]:
+            self.value_test("Constant '{0}'".format(expression),
+                            self.permittivity(expression), self.python(expression), 1e-9)
+
+    def test_functions(self):
+        for expression in ["sqrt(2) + sin(0.5) + exp(1)", "atan2(1, 2) + log10(50)",
+                           "abs(-3) + max(1, 2) + min(3, 4)", "pow(2, 0.5) + hypot(3, 4) + fmod(7, 3)"]:
+            self.value_test("Function '{0}'".format(expression),
+                            self.permittivity(expression), self.python(expression), 1e-9)
+
+    def test_user_variables(self):
+        # not compiled, evaluated by Python
+        self.value_test("User variable", self.permittivity("2 * one + 1"), 3.0, 1e-9)
+
+        # user variables take precedence over math constants
+        pi = self.main.pi
+        try:
+            self.main.pi = 3.0
+            self.value_test("Redefined pi", self.permittivity("2 * pi"), 6.0, 1e-9)
+        finally:
+            self.main.pi = pi
+
+    def test_coordinates(self):
+        # compiled and Python evaluation of coordinate dependent expression
+        for (coordinate_type, expression) in [("planar", "1000 * (1 + x) * sin(y)"),
+                                              ("axisymmetric", "1000 * (1 + r) * sin(z)")]:
+            self.value_test("Coordinates ({0})".format(coordinate_type),
+                            self.potential(coordinate_type, expression),
+                            self.potential(coordinate_type, expression + " * one"), 1e-9)
+
+    def test_coordinate_type_change(self):
+        reference = self.potential("axisymmetric", "1000 * (1 + r) * sin(z)")
+
+        # value is set in planar coordinates, variables are bound after the change
+        self.model("planar", "1000 * (1 + r) * sin(z)")
+        self.problem.coordinate_type = "axisymmetric"
+        self.problem.solve()
+
+        self.value_test("Coordinate type change", self.field.local_values(0.6, 0.5)["V"], reference, 1e-9)
+
 class TestFieldIntegrals(Agros2DTestCase):
     def setUp(self):
         self.problem = a2d.problem(clear = True)
@@ -847,6 +947,7 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldMatrixSolver))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldAdaptivity))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldLocalValues))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldExpressions))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldIntegrals))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldAdaptivityInfo))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestFieldAdaptivityInfoTransient))
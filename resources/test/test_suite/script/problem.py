@@ -84,6 +84,16 @@ class TestProblemTime(Agros2DTestCase):
         with self.assertRaises(IndexError):
             self.problem.time_method_order = -1e-3
 
+    """ time_method_error_estimator """
+    def test_time_method_error_estimator(self):
+        for estimator in ['lower_order', 'embedded']:
+            self.problem.time_method_error_estimator = estimator
+            self.assertEqual(self.problem.time_method_error_estimator, estimator)
+
+    def test_set_wrong_time_method_error_estimator(self):
+        with self.assertRaises(ValueError):
+            self.problem.time_method_error_estimator = 'wrong_estimator'
+
     """ time_total """
     def test_time_total(self):
         self.problem.time_total = 300
@@ -166,11 +176,223 @@ class TestProblemSolution(Agros2DTestCase):
         with self.assertRaises(RuntimeError):
             self.problem.elapsed_time()
 
+    """ solution_cache_statistics """
+    def test_solution_cache_statistics(self):
+        self.problem.solve()
+        statistics = a2d.solution_cache_statistics()
+
+        for key in ['hits', 'misses', 'evictions', 'entries', 'pinned', 'memory_size', 'memory_limit']:
+            self.assertTrue(key in statistics)
+        self.assertTrue(statistics['entries'] > 0)
+        self.assertTrue(statistics['memory_size'] > 0)
+
     """ clear """
     def test_clear(self):
         self.problem.clear()
         self.assertEqual(a2d.geometry.nodes_count(), 0)
 
+class TestProblemConcurrentBlocks(Agros2DTestCase):
+    def setUp(self):
+        # user variable, time dependent values are evaluated by Python
+        import __main__
+        self.main = __main__
+        self.main.tau = 50.0
+
+        self.blocks = a2d.options.number_of_concurrent_blocks
+
+    def tearDown(self):
+        a2d.options.number_of_concurrent_blocks = self.blocks
+        del self.main.tau
+
+    def model(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.time_step_method = "fixed"
+        self.problem.time_total = 1e2
+        self.problem.time_steps = 10
+
+        # two independent transient fields (two blocks in one level)
+        self.heat = a2d.field('heat')
+        self.heat.analysis_type = 'transient'
+        self.heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10,
+                                                                "heat_convection_external_temperature" : 293})
+        self.heat.add_material("Copper", {"heat_conductivity" : 200, "heat_volume_heat" : { "expression" : "1e3*(1 + sin(time/10.0))" },
+                                          "heat_density" : 8700, "heat_specific_heat" : 385})
+
+        self.magnetic = a2d.field('magnetic')
+        self.magnetic.analysis_type = 'transient'
+        self.magnetic.add_boundary("A = 0", "magnetic_potential", {"magnetic_potential_real" : 0})
+        self.magnetic.add_material("Copper", {"magnetic_permeability" : 1, "magnetic_conductivity" : 57e6,
+                                              "magnetic_current_density_external_real" : { "expression" : "1e6*exp(-time/tau)" }})
+
+        self.problem.set_coupling_type("magnetic", "heat", "none")
+
+        a2d.geometry.add_rect(0, 0, 1, 1, boundaries = {'heat' : 'Convection', 'magnetic' : 'A = 0'},
+                              materials = {'heat' : 'Copper', 'magnetic' : 'Copper'})
+
+    def solution(self, blocks):
+        a2d.options.number_of_concurrent_blocks = blocks
+
+        self.model()
+        self.problem.solve()
+
+        values = []
+        for time_step in [3, 7, 10]:
+            values.append(self.heat.local_values(0.3, 0.6, time_step = time_step)['T'])
+            values.append(self.magnetic.local_values(0.3, 0.6, time_step = time_step)['Ar'])
+        return values
+
+    def test_concurrent_blocks(self):
+        # number of concurrent blocks is limited by the number of OpenMP threads
+        try:
+            a2d.options.number_of_concurrent_blocks = 2
+        except IndexError:
+            self.skipTest("Concurrent blocks need at least two threads.")
+
+        serial = self.solution(1)
+        concurrent = self.solution(2)
+
+        for i in range(len(serial)):
+            self.value_test("Concurrent blocks", concurrent[i], serial[i], 1e-9)
+
+class TestProblemMatrixReuse(Agros2DTestCase):
+    def setUp(self):
+        self.blocks = a2d.options.number_of_concurrent_blocks
+        self.external_solver_daemon = a2d.options.external_solver_daemon
+
+    def tearDown(self):
+        a2d.options.number_of_concurrent_blocks = self.blocks
+        a2d.options.external_solver_daemon = self.external_solver_daemon
+
+    def solution(self, reuse, blocks):
+        a2d.options.number_of_concurrent_blocks = blocks
+
+        problem = a2d.problem(clear = True)
+        problem.time_step_method = "fixed"
+        problem.time_total = 1e2
+        problem.time_steps = 10
+
+        # matrix is constant except for the step of the conductivity change
+        heat = a2d.field('heat')
+        heat.analysis_type = 'transient'
+        heat.matrix_solver = 'umfpack'
+        heat.matrix_solver_parameters['reuse'] = reuse
+        heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10,
+                                                           "heat_convection_external_temperature" : 293})
+        heat.add_material("Copper", {"heat_conductivity" : { "expression" : "200*(1 + (time > 45))" }, "heat_volume_heat" : 1e3,
+                                     "heat_density" : 8700, "heat_specific_heat" : 385})
+
+        # independent block solved concurrently
+        magnetic = a2d.field('magnetic')
+        magnetic.analysis_type = 'transient'
+        magnetic.matrix_solver = 'umfpack'
+        magnetic.matrix_solver_parameters['reuse'] = reuse
+        magnetic.add_boundary("A = 0", "magnetic_potential", {"magnetic_potential_real" : 0})
+        magnetic.add_material("Copper", {"magnetic_permeability" : 1, "magnetic_conductivity" : { "expression" : "57e6/(1 + (time > 45))" },
+                                         "magnetic_current_density_external_real" : 1e6})
+
+        problem.set_coupling_type("magnetic", "heat", "none")
+
+        a2d.geometry.add_rect(0, 0, 1, 1, boundaries = {'heat' : 'Convection', 'magnetic' : 'A = 0'},
+                              materials = {'heat' : 'Copper', 'magnetic' : 'Copper'})
+        problem.solve()
+
+        values = []
+        for time_step in [3, 5, 6, 10]:
+            values.append(heat.local_values(0.3, 0.6, time_step = time_step)['T'])
+            values.append(magnetic.local_values(0.3, 0.6, time_step = time_step)['Ar'])
+        return values
+
+    def test_factorization_reuse(self):
+        fresh = self.solution('disabled', 1)
+
+        # concurrent blocks need at least two threads
+        number_of_blocks = [1]
+        try:
+            a2d.options.number_of_concurrent_blocks = 2
+            number_of_blocks.append(2)
+        except IndexError:
+            pass
+
+        for blocks in number_of_blocks:
+            reused = self.solution('factorization', blocks)
+            for i in range(len(fresh)):
+                self.value_test("Reused factorization ({0} blocks)".format(blocks), reused[i], fresh[i], 1e-9)
+
+    def source(self, solver, reuse, volume_heat):
+        problem = a2d.problem(clear = True)
+        problem.time_step_method = "fixed"
+        problem.time_total = 1e2
+        problem.time_steps = 10
+
+        # time dependent source changes the right hand side only
+        heat = a2d.field('heat')
+        heat.analysis_type = 'transient'
+        heat.matrix_solver = solver
+        heat.matrix_solver_parameters['reuse'] = reuse
+        heat.add_boundary("Convection", "heat_heat_flux", {"heat_convection_heat_transfer_coefficient" : 10,
+                                                           "heat_convection_external_temperature" : 293})
+        heat.add_material("Copper", {"heat_conductivity" : 200, "heat_volume_heat" : volume_heat,
+                                     "heat_density" : 8700, "heat_specific_heat" : 385})
+
+        a2d.geometry.add_rect(0, 0, 1, 1, boundaries = {'heat' : 'Convection'}, materials = {'heat' : 'Copper'})
+        problem.solve()
+
+        return [heat.local_values(0.3, 0.6, time_step = time_step)['T'] for time_step in [3, 5, 10]]
+
+    def reused_factorizations(self, volume_heat):
+        statistics = a2d.external_solver_daemon_statistics()
+        values = self.source('external', 'factorization', volume_heat)
+        return values, a2d.external_solver_daemon_statistics()['reused_factorizations'] - statistics['reused_factorizations']
+
+    def test_time_dependent_source(self):
+        a2d.options.external_solver_daemon = False
+        fresh = self.source('umfpack', 'disabled', { "expression" : "1e3*(1 + time/10)" })
+
+        # daemon reports kept factorizations
+        a2d.options.external_solver_daemon = True
+        values, reused = self.reused_factorizations({ "expression" : "1e3*(1 + time/10)" })
+        constant_values, constant_reused = self.reused_factorizations(1e3)
+
+        for i in range(len(fresh)):
+            self.value_test("Time dependent source", values[i], fresh[i], 1e-9)
+        self.assertGreaterEqual(reused, 1)
+        self.assertEqual(reused, constant_reused)
+
+class TestProblemSettingSnapshot(Agros2DTestCase):
+    def setUp(self):
+        self.problem = a2d.problem(clear = True)
+        self.problem.time_step_method = "fixed"
+        self.problem.time_total = 1e3
+        self.problem.time_steps = 20
+
+        self.field = a2d.field('heat')
+        self.field.analysis_type = 'transient'
+        self.field.solver = 'newton'
+        self.field.solver_parameters['residual'] = 1e-3
+        self.field.solver_parameters['jacobian_reuse'] = False
+        self.field.solver_parameters['damping_factor_increase_steps'] = 3
+        self.field.matrix_solver_parameters['reuse'] = 'factorization'
+        self.field.adaptivity_parameters['steps'] = 5
+        self.field.transient_time_skip = 10.0
+
+    def test_set_value(self):
+        self.assertTrue(self.problem.__check_setting_snapshot__())
+
+    def test_clear(self):
+        self.problem.clear()
+        self.assertTrue(self.problem.__check_setting_snapshot__())
+
+    def test_load(self):
+        import pythonlab
+        from os import path
+        filename = '{0}/temp.a2d'.format(path.dirname(pythonlab.tempname()))
+        a2d.save_file(filename, True)
+        a2d.open_file(filename, True)
+
+        self.problem = a2d.problem()
+        self.assertEqual(self.problem.time_steps, 20)
+        self.assertTrue(self.problem.__check_setting_snapshot__())
+
 if __name__ == '__main__':        
     import unittest as ut
     
@@ -179,4 +401,7 @@ if __name__ == '__main__':
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblem))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemTime))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemSolution))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemConcurrentBlocks))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemMatrixReuse))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestProblemSettingSnapshot))
     suite.run(result)
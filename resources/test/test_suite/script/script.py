@@ -4,6 +4,13 @@ import pythonlab
 from test_suite.scenario import Agros2DTestCase
 from test_suite.scenario import Agros2DTestResult
 
+import os
+import time
+import base64
+import socket
+import struct
+import subprocess
+
 def compare(first, second):
     for solution, file in zip(first, second):
         solution_values = list(solution.values())
@@ -96,11 +103,133 @@ class TestSaveAdaptiveSolution(Agros2DTestCase):
         self.magnetic.analysis_type = "transient"
         self.problem.solve()
         self.assertTrue(save_solution_test())
-    
+
+    def test_corrupted_solution(self):
+        self.problem.solve()
+
+        from os import path
+        filename = '{0}/temp.a2d'.format(path.dirname(pythonlab.tempname()))
+        agros2d.save_file(filename, True)
+
+        # cut the solution file in the middle of data
+        solution = '{0}/temp.sol'.format(path.dirname(filename))
+        with open(solution, 'rb') as f:
+            data = f.read()
+        with open(solution, 'wb') as f:
+            f.write(data[:len(data) // 2])
+
+        with self.assertRaises(RuntimeError):
+            agros2d.open_file(filename, True)
+
+class TestJobServer(Agros2DTestCase):
+    port = 51935
+
+    def setUp(self):
+        solver = pythonlab.datadir("agros2d_solver")
+        if not os.path.exists(solver):
+            solver = pythonlab.datadir("../../bin/agros2d_solver")
+        self.solver = solver
+
+        self.server = subprocess.Popen([self.solver, "-j", str(self.port), "-w", "1"])
+        self.client = None
+
+        # wait for the server
+        for i in range(50):
+            try:
+                self.client = socket.create_connection(("127.0.0.1", self.port))
+                break
+            except socket.error:
+                time.sleep(0.1)
+        self.assertTrue(self.client is not None)
+
+    def tearDown(self):
+        self.client.close()
+        self.server.kill()
+        self.server.wait()
+
+    def send(self, header, body = ""):
+        frame = header.encode("utf-8")
+        if body:
+            frame += b"\n" + body.encode("utf-8")
+        self.client.sendall(struct.pack(">I", len(frame)) + frame)
+
+    def receive_bytes(self, size):
+        data = b""
+        while len(data) < size:
+            chunk = self.client.recv(size - len(data))
+            if not chunk:
+                return None
+            data += chunk
+        return data
+
+    def receive(self):
+        size = self.receive_bytes(4)
+        if size is None:
+            return None, None
+        frame = self.receive_bytes(struct.unpack(">I", size)[0]).decode("utf-8")
+
+        header, newline, body = frame.partition("\n")
+        return header.split(), body
+
+    def test_submit_output_finish(self):
+        self.send("SUBMIT script", "print('job output')\nwith open('result.txt', 'w') as f:\n    f.write('42')\n")
+
+        header, body = self.receive()
+        self.assertEqual(header[0], "ACCEPTED")
+        id = header[1]
+
+        output = ""
+        while True:
+            header, body = self.receive()
+            self.assertTrue(header is not None)
+            self.assertEqual(header[1], id)
+            if header[0] == "OUTPUT":
+                output += body
+            elif header[0] == "FINISHED":
+                self.assertEqual(header[2], "0")
+                break
+            else:
+                self.assertEqual(header[0], "STARTED")
+        self.assertTrue("job output" in output)
+
+        # results are kept until deleted
+        self.send("FETCH {0}".format(id))
+        results = {}
+        while True:
+            header, body = self.receive()
+            if header[0] == "FETCHED":
+                self.assertEqual(int(header[2]), len(results))
+                break
+            self.assertEqual(header[0], "RESULT")
+            results[header[2]] = base64.b64decode(body)
+        self.assertEqual(results["result.txt"], b"42")
+
+        self.send("DELETE {0}".format(id))
+        header, body = self.receive()
+        self.assertEqual(header, ["DELETED", id])
+
+        self.send("FETCH {0}".format(id))
+        header, body = self.receive()
+        self.assertEqual(header, ["ERROR", id])
+
+    def test_frame_size_limit(self):
+        # header of 1 GB frame, the body is never sent
+        self.client.sendall(struct.pack(">I", 1024 * 1024 * 1024))
+
+        header, body = self.receive()
+        self.assertEqual(header[0], "ERROR")
+        header, body = self.receive()
+        self.assertTrue(header is None)
+
+    def test_port_in_use(self):
+        second = subprocess.Popen([self.solver, "-j", str(self.port)])
+        self.assertNotEqual(second.wait(), 0)
+
 if __name__ == '__main__':
     import unittest as ut
     
     suite = ut.TestSuite()
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestSaveAdaptiveSolution))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestJobServer))
     suite.run(result)
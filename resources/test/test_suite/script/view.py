@@ -199,6 +199,53 @@ class TestMeshViewAdaptiveProblem(TestView):
 
             self.process('adaptive_problem-mesh_view-component-{0}'.format(i))
 
+class TestPostProcessingAsync(Agros2DTestCase):
+    @classmethod
+    def setUpClass(cls):
+        simple_model()
+        a2d.problem().solve()
+
+        a2d.view.post2d.activate()
+        a2d.view.post2d.disable()
+        a2d.view.post2d.scalar = True
+        a2d.view.post2d.scalar_view_parameters["auto_range"] = True
+
+    def set_variable(self, variable, component):
+        a2d.view.post2d.scalar_view_parameters["variable"] = variable
+        a2d.view.post2d.scalar_view_parameters["component"] = component
+
+    def scalar_range(self):
+        return a2d.view.post2d.scalar_view_parameters["range_min"], a2d.view.post2d.scalar_view_parameters["range_max"]
+
+    def reference_range(self, variable, component):
+        self.set_variable(variable, component)
+        a2d.view.post2d.refresh()
+        return self.scalar_range()
+
+    def test_refresh(self):
+        reference = self.reference_range("electrostatic_potential", "scalar")
+
+        a2d.view.post2d.refresh(asynchronous = True)
+        a2d.view.post2d.wait()
+        self.assertEqual(self.scalar_range(), reference)
+
+    def test_new_request(self):
+        potential = self.reference_range("electrostatic_potential", "scalar")
+        field = self.reference_range("electrostatic_electric_field", "magnitude")
+        self.assertNotEqual(potential, field)
+
+        # second request is issued while the first one is running, the first generation is dropped
+        self.set_variable("electrostatic_potential", "scalar")
+        a2d.view.post2d.refresh(asynchronous = True)
+        self.set_variable("electrostatic_electric_field", "magnitude")
+        a2d.view.post2d.refresh(asynchronous = True)
+        a2d.view.post2d.wait()
+        self.assertEqual(self.scalar_range(), field)
+
+        # nothing is left to process
+        a2d.view.post2d.wait()
+        self.assertEqual(self.scalar_range(), field)
+
 if __name__ == '__main__':
     import unittest as ut
     
@@ -206,4 +253,5 @@ if __name__ == '__main__':
     result = Agros2DTestResult()
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestMeshViewSimpleProblem))
     suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestMeshViewAdaptiveProblem))
+    suite.addTest(ut.TestLoader().loadTestsFromTestCase(TestPostProcessingAsync))
     suite.run(result)
\ No newline at end of file
@@ -7,6 +7,8 @@ from libcpp.map cimport map
 from cython.operator cimport preincrement as incr
 from cython.operator cimport dereference as deref
 
+import warnings
+
 cdef extern from "limits.h":
     int c_INT_MIN "INT_MIN"
     int c_INT_MAX "INT_MAX"
@@ -120,14 +122,22 @@ cdef extern from "../../agros2d-library/pythonlab/pythonengine_agros.h":
     # memory
     int appTime()
     void memoryUsage(vector[int] &time, vector[int] &usage)
+    void solutionCacheStatistics(map[string, long long] &statistics)
+    void externalSolverDaemonStatistics(map[string, long long] &statistics)
 
     # PyOptions
     cdef cppclass PyOptions:
         int getNumberOfThreads()
         void setNumberOfThreads(int threads) except +
 
-        int getCacheSize()
-        void setCacheSize(int size) except +
+        int getNumberOfConcurrentBlocks()
+        void setNumberOfConcurrentBlocks(int blocks) except +
+
+        bool getExternalSolverDaemon()
+        void setExternalSolverDaemon(bool daemon)
+
+        int getCacheMemorySize()
+        void setCacheMemorySize(int size) except +
 
         bool getSaveMatrixRHS()
         void setSaveMatrixRHS(bool save)
@@ -160,6 +170,30 @@ def memory_usage():
 
     return time, usage
 
+def solution_cache_statistics():
+    cdef map[string, long long] statistics_map
+    solutionCacheStatistics(statistics_map)
+
+    statistics = dict()
+    it = statistics_map.begin()
+    while it != statistics_map.end():
+        statistics[deref(it).first.c_str()] = deref(it).second
+        incr(it)
+
+    return statistics
+
+def external_solver_daemon_statistics():
+    cdef map[string, long long] statistics_map
+    externalSolverDaemonStatistics(statistics_map)
+
+    statistics = dict()
+    it = statistics_map.begin()
+    while it != statistics_map.end():
+        statistics[deref(it).first.c_str()] = deref(it).second
+        incr(it)
+
+    return statistics
+
 cdef class __Options__:
     cdef PyOptions *thisptr
 
@@ -174,11 +208,38 @@ cdef class __Options__:
         def __set__(self, threads):
             self.thisptr.setNumberOfThreads(threads)
 
+    property number_of_concurrent_blocks:
+        def __get__(self):
+            return self.thisptr.getNumberOfConcurrentBlocks()
+        def __set__(self, blocks):
+            self.thisptr.setNumberOfConcurrentBlocks(blocks)
+
+    property external_solver_daemon:
+        def __get__(self):
+            return self.thisptr.getExternalSolverDaemon()
+        def __set__(self, daemon):
+            self.thisptr.setExternalSolverDaemon(daemon)
+
+    property cache_memory_size:
+        def __get__(self):
+            return self.thisptr.getCacheMemorySize()
+        def __set__(self, size):
+            self.thisptr.setCacheMemorySize(size)
+
+    # deprecated, cache is bounded by memory (cache_memory_size) instead of the number of solutions
+    # number of solutions is mapped onto memory (default 10 solutions corresponds to default 1024 MB)
     property cache_size:
         def __get__(self):
-            return self.thisptr.getCacheSize()
+            warnings.warn("Option cache_size is deprecated, use cache_memory_size (MB).", DeprecationWarning, stacklevel = 2)
+            return max(2, min(50, self.thisptr.getCacheMemorySize() * 10 // 1024))
         def __set__(self, size):
-            self.thisptr.setCacheSize(size)
+            if (size < 2 or size > 50):
+                raise IndexError("Cache size is out of range (2 - 50).")
+
+            memory = size * 1024 // 10
+            warnings.warn("Option cache_size is deprecated, use cache_memory_size (MB). Cache size {0} is set as cache_memory_size = {1}.".format(size, memory),
+                          DeprecationWarning, stacklevel = 2)
+            self.thisptr.setCacheMemorySize(memory)
 
     property save_matrix_and_rhs:
         def __get__(self):
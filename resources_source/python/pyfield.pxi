@@ -33,6 +33,9 @@ cdef extern from "../../agros2d-library/pythonlab/pyfield.h":
         string getLinearSolverPreconditioner()
         void setLinearSolverPreconditioner(string &linearSolverPreconditioner) except +
 
+        string getLinearSolverReuse()
+        void setLinearSolverReuse(string &linearSolverReuse) except +
+
         string getNonlinearDampingType()
         void setNonlinearDampingType(string &dampingType) except +
 
@@ -75,6 +78,11 @@ cdef extern from "../../agros2d-library/pythonlab/pyfield.h":
 
         void localValues(double x, double y, int timeStep, int adaptivityStep,
                          string &solutionType, map[string, double] &results) except +
+        void localValuesBatch(vector[double] &x, vector[double] &y, int timeStep, int adaptivityStep,
+                              string &solutionType, map[string, vector[double]] &results) except +
+        void timeSeries(vector[double] &x, vector[double] &y,
+                        vector[vector[int]] &volumeLabels, vector[vector[int]] &surfaceEdges,
+                        string &solutionType, string &fileName, map[string, vector[double]] &results) except +
         void surfaceIntegrals(vector[int], int timeStep, int adaptivityStep,
                               string &solutionType, map[string, double] &results) except +
         void volumeIntegrals(vector[int], int timeStep, int adaptivityStep,
@@ -310,7 +318,8 @@ cdef class __Field__:
         return {'tolerance' : self.thisptr.getDoubleParameter(string('LinearSolverIterToleranceAbsolute')),
                 'iterations' : self.thisptr.getIntParameter(string('LinearSolverIterIters')),
                 'method' : self.thisptr.getLinearSolverMethod().c_str(),
-                'preconditioner' : self.thisptr.getLinearSolverPreconditioner().c_str()}
+                'preconditioner' : self.thisptr.getLinearSolverPreconditioner().c_str(),
+                'reuse' : self.thisptr.getLinearSolverReuse().c_str()}
 
     def __set_matrix_solver_parameters__(self, parameters):
         # tolerance
@@ -325,6 +334,9 @@ cdef class __Field__:
         self.thisptr.setLinearSolverMethod(string(parameters['method']))
         self.thisptr.setLinearSolverPreconditioner(string(parameters['preconditioner']))
 
+        # reuse of matrix structure and factorization
+        self.thisptr.setLinearSolverReuse(string(parameters['reuse']))
+
     # refinements
     property number_of_refinements:
         def __get__(self):
@@ -360,6 +372,7 @@ cdef class __Field__:
                 'order_increase' : self.thisptr.getIntParameter(string('AdaptivityOrderIncrease')),
                 'space_refinement' : self.thisptr.getBoolParameter(string('AdaptivitySpaceRefinement')),
                 'finer_reference_solution' : self.thisptr.getBoolParameter(string('AdaptivityFinerReference')),
+                'warm_start' : self.thisptr.getBoolParameter(string('AdaptivityWarmStart')),
                 'transient_back_steps' : self.thisptr.getIntParameter(string('AdaptivityTransientBackSteps')),
                 'transient_redone_steps' : self.thisptr.getIntParameter(string('AdaptivityTransientRedoneEach'))}
 
@@ -380,9 +393,10 @@ cdef class __Field__:
         value_in_range(parameters['threshold'], 0.01, 1.0, 'threshold')
         self.thisptr.setParameter(string('AdaptivityThreshold'), <double>parameters['threshold'])
 
-        # aniso, finer reference
+        # aniso, finer reference, warm start
         self.thisptr.setParameter(string('AdaptivityUseAniso'), <bool>parameters['anisotropic_refinement'])
         self.thisptr.setParameter(string('AdaptivityFinerReference'), <bool>parameters['finer_reference_solution'])
+        self.thisptr.setParameter(string('AdaptivityWarmStart'), <bool>parameters['warm_start'])
 
         # space refinement, order increase
         self.thisptr.setParameter(string('AdaptivitySpaceRefinement'), <bool>parameters['space_refinement'])
@@ -526,6 +540,77 @@ cdef class __Field__:
 
         return out
 
+    def local_values_batch(self, x, y, time_step = None, adaptivity_step = None, solution_type = "normal"):
+        """Compute local values in many points at once and return dictionary with arrays of results.
+
+        local_values_batch(x, y, time_step = None, adaptivity_step = None, solution_type = "normal")
+
+        Arrays are of type array.array('d') in order of the points (use numpy.asarray for numpy),
+        values of points outside the domain are NaN.
+
+        Keyword arguments:
+        x -- sequence of x or r coordinates of points
+        y -- sequence of y or z coordinates of points
+        time_step -- time step (default is None - use last time step)
+        adaptivity_step -- adaptivity step (default is None - use adaptive step)
+        solution_type -- solution type (default is "normal")
+        """
+        import array
+
+        out = dict()
+        cdef vector[double] x_vector = x
+        cdef vector[double] y_vector = y
+        cdef map[string, vector[double]] results
+
+        self.thisptr.localValuesBatch(x_vector, y_vector,
+                                      int(-1 if time_step is None else time_step),
+                                      int(-1 if adaptivity_step is None else adaptivity_step),
+                                      string(solution_type), results)
+        it = results.begin()
+        while it != results.end():
+            out[deref(it).first.c_str()] = array.array('d', deref(it).second)
+            incr(it)
+
+        return out
+
+    def time_series(self, points = [], volume_integrals = [], surface_integrals = [], solution_type = "normal", file_name = None):
+        """Compute history of local values and integrals over all time steps and return dictionary with arrays of results.
+
+        time_series(points = [], volume_integrals = [], surface_integrals = [], solution_type = "normal", file_name = None)
+
+        Keys are "t" (time), "p<i>_<variable>" (point i), "v<i>_<variable>" and "s<i>_<variable>"
+        (volume and surface integral i). Arrays are of type array.array('d') (use numpy.asarray for numpy),
+        values of points outside the domain are NaN.
+
+        Keyword arguments:
+        points -- list of points [x, y]
+        volume_integrals -- list of lists of label indices (empty list - all labels)
+        surface_integrals -- list of lists of edge indices (empty list - all edges)
+        solution_type -- solution type (default is "normal")
+        file_name -- export to file, CSV if suffix is .csv, otherwise binary (default is None - no export)
+        """
+        import array
+
+        out = dict()
+        cdef vector[double] x_vector
+        cdef vector[double] y_vector
+        cdef vector[vector[int]] labels_vector = volume_integrals
+        cdef vector[vector[int]] edges_vector = surface_integrals
+        cdef map[string, vector[double]] results
+
+        for point in points:
+            x_vector.push_back(point[0])
+            y_vector.push_back(point[1])
+
+        self.thisptr.timeSeries(x_vector, y_vector, labels_vector, edges_vector,
+                                string(solution_type), string(file_name if file_name is not None else ""), results)
+        it = results.begin()
+        while it != results.end():
+            out[deref(it).first.c_str()] = array.array('d', deref(it).second)
+            incr(it)
+
+        return out
+
     # surface integrals
     def surface_integrals(self, edges = [], time_step = None, adaptivity_step = None, solution_type = "normal"):
         """Compute surface integrals on edges and return dictionary with results.
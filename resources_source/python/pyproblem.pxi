@@ -24,6 +24,9 @@ cdef extern from "../../agros2d-library/pythonlab/pyproblem.h":
         double getTimeMethodTolerance()
         void setTimeMethodTolerance(double timeMethodTolerance) except +
 
+        string getTimeMethodErrorEstimator()
+        void setTimeMethodErrorEstimator(string &timeErrorEstimator) except +
+
         double getTimeTotal()
         void setTimeTotal(double timeTotal) except +
 
@@ -33,15 +36,23 @@ cdef extern from "../../agros2d-library/pythonlab/pyproblem.h":
         double getTimeInitialTimeStep()
         void setTimeInitialTimeStep(double timeInitialTimeStep) except +
 
+        string getIntegralOrder()
+        void setIntegralOrder(string &integralOrder) except +
+
         string getCouplingType(string &sourceField, string &targetField) except +
         void setCouplingType(string &sourceField, string &targetField, string &type) except +
 
         void mesh() except +
         void solve() except +
 
+        void solveSweepPoint() except +
+        string sweepSolverExecutable()
+
         double timeElapsed() except +
         void timeStepsLength(vector[double] &steps) except +
 
+        bool isSettingSnapshotValid()
+
 cdef class __Problem__:
     cdef PyProblem *thisptr
     cdef object time_callback
@@ -101,6 +112,12 @@ cdef class __Problem__:
         def __set__(self, time_method_tolerance):
             self.thisptr.setTimeMethodTolerance(time_method_tolerance)
 
+    property time_method_error_estimator:
+        def __get__(self):
+            return self.thisptr.getTimeMethodErrorEstimator().c_str()
+        def __set__(self, time_method_error_estimator):
+            self.thisptr.setTimeMethodErrorEstimator(string(time_method_error_estimator))
+
     property time_total:
         def __get__(self):
             return self.thisptr.getTimeTotal()
@@ -119,6 +136,12 @@ cdef class __Problem__:
         def __set__(self, time_initial_time_step):
             self.thisptr.setTimeInitialTimeStep(time_initial_time_step)
 
+    property integral_order:
+        def __get__(self):
+            return self.thisptr.getIntegralOrder().c_str()
+        def __set__(self, integral_order):
+            self.thisptr.setIntegralOrder(string(integral_order))
+
     property time_callback:
         def __get__(self):
             return self.time_callback
@@ -156,6 +179,143 @@ cdef class __Problem__:
         """Solve problem."""
         self.thisptr.solve()
 
+    def sweep(self, parameters, points, results, workers = 1):
+        """Solve problem in points of the parametric sweep and return table (list of dicts) with parameters and results.
+
+        Stages not invalidated by the change of parameters are reused (geometry - remesh, material - reassemble, boundary - right hand side only).
+        Geometry is moved back after the sweep, materials and boundaries keep the values of the last solved point.
+
+        sweep(parameters, points, results, workers = 1)
+
+        Keyword arguments:
+        parameters -- dict of parameters {name : ("material", field_id, material, variable) | ("boundary", field_id, boundary, variable) | ("nodes", [nodes], "dx" | "dy")},
+                      value of "nodes" parameter is a displacement of the nodes from the original position
+        points -- list of dicts {name : value} (see sweep_grid)
+        results -- dict of results {name : ("local_value", field_id, x, y, variable) | ("volume_integral", field_id, [labels], variable) | ("surface_integral", field_id, [edges], variable)}
+        workers -- number of worker processes solving independent points in parallel (default is 1 - points are solved in this process)
+        """
+        types = { "nodes" : 0, "material" : 1, "boundary" : 2 }
+        for name, parameter in parameters.items():
+            value_in_list(parameter[0], list(types.keys()), "parameter type")
+        for name, result in results.items():
+            value_in_list(result[0], ["local_value", "volume_integral", "surface_integral"], "result type")
+        for point in points:
+            for name in point:
+                if not name in parameters:
+                    raise KeyError("Parameter '{0}' is not defined.".format(name))
+
+        # geometry changes least often, then materials
+        names = sorted(parameters.keys(), key = lambda name: types[parameters[name][0]])
+        order = sorted(range(len(points)), key = lambda i: [points[i].get(name) for name in names])
+        ordered_points = [points[i] for i in order]
+
+        if (workers > 1 and len(points) > 1):
+            table = self.__sweep_workers__(parameters, ordered_points, results, min(workers, len(points)))
+        else:
+            table = self.__sweep_points__(parameters, ordered_points, results)
+
+        rows = [None] * len(points)
+        for i, row in zip(order, table):
+            rows[i] = row
+
+        return rows
+
+    def __move_nodes__(self, parameter, delta):
+        geometry.select_nodes(parameter[1])
+        if (parameter[2] == "dx"):
+            geometry.move_selection(delta, 0.0)
+        else:
+            geometry.move_selection(0.0, delta)
+
+    def __check_setting_snapshot__(self):
+        return self.thisptr.isSettingSnapshotValid()
+
+    def __sweep_points__(self, parameters, points, results):
+        displacements = dict()
+        table = list()
+        try:
+            for point in points:
+                for name, value in point.items():
+                    parameter = parameters[name]
+                    if (parameter[0] == "material"):
+                        field(parameter[1]).modify_material(parameter[2], { parameter[3] : value })
+                    elif (parameter[0] == "boundary"):
+                        field(parameter[1]).modify_boundary(parameter[2], parameters = { parameter[3] : value })
+                    elif (parameter[0] == "nodes"):
+                        delta = value - displacements.get(name, 0.0)
+                        if (delta != 0.0):
+                            self.__move_nodes__(parameter, delta)
+                            displacements[name] = value
+
+                self.thisptr.solveSweepPoint()
+
+                row = dict(point)
+                for name, result in results.items():
+                    if (result[0] == "local_value"):
+                        row[name] = field(result[1]).local_values(result[2], result[3])[result[4]]
+                    elif (result[0] == "volume_integral"):
+                        row[name] = field(result[1]).volume_integrals(result[2])[result[3]]
+                    elif (result[0] == "surface_integral"):
+                        row[name] = field(result[1]).surface_integrals(result[2])[result[3]]
+                table.append(row)
+        finally:
+            # original geometry
+            for name, value in displacements.items():
+                if (value != 0.0):
+                    self.__move_nodes__(parameters[name], -value)
+
+        return table
+
+    def __sweep_workers__(self, parameters, points, results, workers):
+        import os, subprocess, tempfile, ast
+
+        # each worker solves a chunk of points on the model exported to script
+        model = get_script_from_model()
+        chunk = (len(points) + workers - 1) // workers
+
+        files = list()
+        outputs = list()
+        processes = list()
+        try:
+            for i in range(0, len(points), chunk):
+                script = model + "\n\ntable = a2d.problem().__sweep_points__({0}, {1}, {2})\nprint('__sweep__' + repr(table))\n".format(repr(parameters), repr(points[i:i + chunk]), repr(results))
+
+                fd, fn = tempfile.mkstemp(suffix = ".py")
+                files.append(fn)
+                try:
+                    os.write(fd, script.encode("utf-8"))
+                finally:
+                    os.close(fd)
+
+                # output goes to a file, running workers never block on a full pipe
+                output = tempfile.TemporaryFile()
+                outputs.append(output)
+                processes.append(subprocess.Popen([self.thisptr.sweepSolverExecutable().c_str(), "-s", fn],
+                                                  stdout = output, stderr = subprocess.STDOUT))
+
+            table = list()
+            for process, output in zip(processes, outputs):
+                process.wait()
+                output.seek(0)
+                text = output.read().decode("utf-8")
+                if (process.returncode != 0):
+                    raise RuntimeError("Sweep worker failed:\n{0}".format(text))
+
+                for line in text.splitlines():
+                    if line.startswith("__sweep__"):
+                        table.extend(ast.literal_eval(line[len("__sweep__"):]))
+        finally:
+            for process in processes:
+                if (process.poll() is None):
+                    process.kill()
+                    process.wait()
+            for output in outputs:
+                output.close()
+            for fn in files:
+                os.remove(fn)
+
+        return table
+
     def elapsed_time(self):
         """Return elapsed time in seconds."""
         return self.thisptr.timeElapsed()
@@ -186,3 +346,16 @@ def problem(clear = False):
         __problem__.clear()
         __problem__.time_callback = None
     return __problem__
+
+def sweep_grid(values):
+    """Return list of points (dicts) of the parametric sweep on the grid of values.
+
+    sweep_grid(values)
+
+    Keyword arguments:
+    values -- dict of lists of parameter values {name : [values]}
+    """
+    import itertools
+
+    names = sorted(values.keys())
+    return [dict(zip(names, point)) for point in itertools.product(*[values[name] for name in names])]
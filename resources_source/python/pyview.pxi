@@ -95,7 +95,8 @@ cdef extern from "../../agros2d-library/pythonlab/pyview.h":
         double getDoubleParameter(string &parameter)
 
         void activate() except +
-        void refresh() except +
+        void refresh(bool asynchronous) except +
+        void wait()
 
         void setScalarViewShow(bool show) except +
         bool getScalarViewShow()
@@ -399,8 +400,11 @@ cdef class __ViewPost2D__(__ViewPost__):
     def activate(self):
         self.thisptr2d.activate()
 
-    def refresh(self):
-        self.thisptr2d.refresh()
+    def refresh(self, asynchronous = False):
+        self.thisptr2d.refresh(asynchronous)
+
+    def wait(self):
+        self.thisptr2d.wait()
 
     def disable(self):
       self.scalar = False
@@ -17,11 +17,202 @@
 // University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
 // Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
 
+#include <QtCore>
+#include <QtNetwork>
+
 #include "hermes2d.h"
 #include "util/memory_handling.h"
 
+#include "hermes2d/solver_daemon.h"
+
 #include "../3rdparty/tclap/CmdLine.h"
 
+// matrix, rhs and solver of one client (factorization is kept by the solver)
+struct SolverState
+{
+    SolverState() : matrix(NULL), rhs(NULL), solver(NULL), size(-1), nnz(-1) {}
+    ~SolverState()
+    {
+        delete solver;
+        delete matrix;
+        delete rhs;
+    }
+
+    CSCMatrix<double> *matrix;
+    SimpleVector<double> *rhs;
+    LinearMatrixSolver<double> *solver;
+
+    int size;
+    int nnz;
+};
+
+const int MAX_SOLVER_STATES = 8;
+
+static SolverState *createSolverState(const std::string &solver)
+{
+    SolverState *state = new SolverState();
+    state->rhs = new SimpleVector<double>();
+
+    if (solver == "umfpack")
+    {
+        state->matrix = new CSCMatrix<double>();
+        state->solver = new UMFPackLinearMatrixSolver<double>(state->matrix, state->rhs);
+    }
+    else if (solver == "mumps")
+    {
+        state->matrix = new MumpsMatrix<double>();
+        state->solver = new MumpsSolver<double>(static_cast<MumpsMatrix<double> *>(state->matrix), state->rhs);
+    }
+    else
+    {
+        delete state;
+        return NULL;
+    }
+
+    return state;
+}
+
+static QString solveShared(const std::string &solver, QSharedMemory &memory, QMap<int, SolverState *> &states, QList<int> &order,
+                           const QString &key, int client, bool &reused)
+{
+    reused = false;
+
+    if (memory.key() != key)
+    {
+        if (memory.isAttached())
+            memory.detach();
+        memory.setKey(key);
+        if (!memory.attach())
+            return memory.errorString();
+    }
+
+    ExternalSolverBuffer buffer(memory.data());
+    int size = buffer.header()->size;
+    int nnz = buffer.header()->nnz;
+    ExternalSolverBuffer::Reuse reuse = (ExternalSolverBuffer::Reuse) buffer.header()->reuse;
+
+    // least recently used state is removed
+    SolverState *state = states.value(client);
+    if (state && ((state->size != size) || (state->nnz != nnz)))
+    {
+        delete states.take(client);
+        order.removeOne(client);
+        state = NULL;
+    }
+
+    if (!state)
+    {
+        if (states.size() >= MAX_SOLVER_STATES)
+        {
+            delete states.take(order.first());
+            order.removeFirst();
+        }
+
+        state = createSolverState(solver);
+        if (!state)
+            return QString("unknown solver '%1'").arg(QString::fromStdString(solver));
+
+        states.insert(client, state);
+        reuse = ExternalSolverBuffer::Reuse_None;
+    }
+    order.removeOne(client);
+    order.append(client);
+
+    // matrix values (unchanged matrix is kept with its numeric factorization)
+    if (reuse != ExternalSolverBuffer::Reuse_Matrix)
+    {
+        state->matrix->free();
+        state->matrix->create(size, nnz, buffer.Ap(), buffer.Ai(), buffer.Ax());
+    }
+    state->size = size;
+    state->nnz = nnz;
+
+    state->rhs->free();
+    state->rhs->alloc(size);
+    state->rhs->set_vector(buffer.rhs());
+
+    if (reuse == ExternalSolverBuffer::Reuse_Matrix)
+        state->solver->set_reuse_scheme(HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY);
+    else if (reuse == ExternalSolverBuffer::Reuse_Pattern)
+        state->solver->set_reuse_scheme(HERMES_REUSE_MATRIX_REORDERING);
+    else
+        state->solver->set_reuse_scheme(HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+
+    try
+    {
+        state->solver->solve();
+    }
+    catch (Hermes::Exceptions::Exception &e)
+    {
+        delete states.take(client);
+        order.removeOne(client);
+        return QString::fromStdString(e.info());
+    }
+
+    memcpy(buffer.sln(), state->solver->get_sln_vector(), size * sizeof(double));
+    reused = (reuse == ExternalSolverBuffer::Reuse_Matrix);
+
+    return QString();
+}
+
+// serves one client (the parent process) until it disconnects
+static int runDaemon(const std::string &solver, const QString &serverName, int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QLocalServer::removeServer(serverName);
+    QLocalServer server;
+    if (!server.listen(serverName))
+    {
+        std::cerr << "error: " << server.errorString().toStdString() << std::endl;
+        return 1;
+    }
+
+    if (!server.waitForNewConnection(-1))
+        return 1;
+    QLocalSocket *socket = server.nextPendingConnection();
+
+    QSharedMemory memory;
+    QMap<int, SolverState *> states;
+    QList<int> order;
+
+    bool quit = false;
+    while (!quit && (socket->state() == QLocalSocket::ConnectedState))
+    {
+        if (!socket->canReadLine() && !socket->waitForReadyRead(-1))
+            break;
+
+        while (socket->canReadLine())
+        {
+            QStringList request = QString::fromUtf8(socket->readLine()).trimmed().split(" ");
+
+            if (request.first() == "QUIT")
+            {
+                quit = true;
+                break;
+            }
+            else if ((request.first() == "SOLVE") && (request.size() == 3))
+            {
+                bool reused = false;
+                QString error = solveShared(solver, memory, states, order, request[1], request[2].toInt(), reused);
+                if (error.isEmpty())
+                    socket->write(reused ? "OK REUSED\n" : "OK\n");
+                else
+                    socket->write(QString("ERROR %1\n").arg(error.simplified()).toUtf8());
+            }
+            else
+            {
+                socket->write("ERROR unknown request\n");
+            }
+            socket->waitForBytesWritten(-1);
+        }
+    }
+
+    qDeleteAll(states);
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     try
@@ -30,20 +221,31 @@ int main(int argc, char *argv[])
         TCLAP::CmdLine cmd("Solver MUMPS", ' ');
 
         TCLAP::ValueArg<std::string> solverArg("o", "solver", "Solver", true, "", "string");
-        TCLAP::ValueArg<std::string> matrixArg("m", "matrix", "Matrix", true, "", "string");
-        TCLAP::ValueArg<std::string> rhsArg("r", "rhs", "RHS", true, "", "string");
-        TCLAP::ValueArg<std::string> solutionArg("s", "solution", "Solution", true, "", "string");
+        TCLAP::ValueArg<std::string> matrixArg("m", "matrix", "Matrix", false, "", "string");
+        TCLAP::ValueArg<std::string> rhsArg("r", "rhs", "RHS", false, "", "string");
+        TCLAP::ValueArg<std::string> solutionArg("s", "solution", "Solution", false, "", "string");
         TCLAP::ValueArg<std::string> initialArg("i", "initial", "Initial vector", false, "", "string");
+        TCLAP::ValueArg<std::string> daemonArg("d", "daemon", "Persistent solver listening on local server", false, "", "string");
 
         cmd.add(solverArg);
         cmd.add(matrixArg);
         cmd.add(rhsArg);
         cmd.add(solutionArg);
         cmd.add(initialArg);
+        cmd.add(daemonArg);
 
         // parse the argv array.
         cmd.parse(argc, argv);
 
+        if (daemonArg.isSet())
+            return runDaemon(solverArg.getValue(), QString::fromStdString(daemonArg.getValue()), argc, argv);
+
+        if (!matrixArg.isSet() || !rhsArg.isSet() || !solutionArg.isSet())
+        {
+            std::cerr << "error: matrix, rhs and solution files are required" << std::endl;
+            return 1;
+        }
+
         CSCMatrix<double> *matrix = NULL;
         SimpleVector<double> *rhs = new SimpleVector<double>();
         LinearMatrixSolver<double> *solver;
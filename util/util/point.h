@@ -95,7 +95,7 @@ struct Point3
     inline Point3 operator*(double num) const { return Point3(x * num, y * num, z * num); }
     inline Point3 operator/(double num) const { return Point3(x / num, y / num, z / num); }
     inline double operator&(const Point3 &vec) const { return x*vec.x + y*vec.y + z*vec.z; } // dot product
-    inline Point3 operator%(const Point3 &vec) const { return Point3(- z*vec.y, z*vec.x, x*vec.y - y*vec.x); } // cross product
+    inline Point3 operator%(const Point3 &vec) const { return Point3(y*vec.z - z*vec.y, z*vec.x - x*vec.z, x*vec.y - y*vec.x); } // cross product
 
     inline double magnitude() const { return sqrt(x * x + y * y + z * z); }
     inline double anglexy() const { return atan2(y, x); }